@@ -0,0 +1,411 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use pal/buffer_blur.h directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_BUFFER_BLUR_H_
+# define _PAL_BUFFER_BLUR_H_ 1
+
+// separable 2D filtering of single channel float images, with the
+// rows stride values (floats, not bytes) apart. Pixels outside the
+// image take the value of the nearest edge pixel. The output must not
+// overlap the input.
+//
+// The vertical pass runs first, reading the input rows directly, so
+// the row bands handed to each thread (and the bands of a few rows
+// worked through by each) need no extra rows of intermediate results.
+// It runs down column tiles, so the input rows under the kernel stay
+// in cache while moving down a tile, with the vectors across the
+// columns. The horizontal pass then filters each row of the band
+// with the same FIR kernel as buffer_fir.h.
+//
+// box_blur uses running sums instead, so its cost does not depend on
+// the radius: vertically across the columns, horizontally with
+// blocks of rows transposed so each vector lane runs along a row.
+// gaussian_blur switches to 3 box passes for large radii.
+
+namespace PAL_NAMESPACE
+{
+
+namespace detail
+{
+
+static const size_t kBlurTile = 512;
+static const size_t kBlurBandValues = 32768;
+static const size_t kBlurMinRows = 64;
+static const size_t kGaussMaxRadius = 16;
+
+PAL_INLINE size_t blur_clamp( std::ptrdiff_t i, size_t n )
+{
+	return i < 0 ? 0 : ( size_t( i ) >= n ? n - 1 : size_t( i ) );
+}
+
+/// @brief rows per band, so a band of intermediate rows stays in cache
+inline size_t blur_band_rows( size_t width )
+{
+	return std::max( size_t(4), std::min( size_t(64), kBlurBandValues / std::max( width, size_t(1) ) ) );
+}
+
+inline bool blur_symmetric( const float *k, size_t n )
+{
+	bool sym = n > 1;
+	for ( size_t i = 0; i < n / 2; ++i )
+		sym = sym && k[i] == k[n - 1 - i];
+	return sym;
+}
+
+/// @brief out[x] = sum_j k[j] * rows[j][x0 + x] for x in [0, n)
+inline void blur_vertical( float *out, const float * const *rows, size_t x0, size_t n,
+						   const float *k, size_t nk, bool sym )
+{
+	typedef fir_vec VT;
+	const size_t L = size_t( VT::value_count );
+	// taps folded when symmetric, the middle one left over if odd
+	const size_t nj = sym ? nk / 2 : nk;
+	const bool mid = sym && ( nk & 1 ) != 0;
+	size_t x = 0;
+	for ( ; ( x + 2 * L ) <= n; x += 2 * L )
+	{
+		VT a0 = VT::zero(), a1 = VT::zero();
+		for ( size_t j = 0; j != nj; ++j )
+		{
+			VT t( k[j] );
+			const float *p = rows[j] + x0 + x;
+			VT v0 = fir_load( p ), v1 = fir_load( p + L );
+			if ( sym )
+			{
+				const float *q = rows[nk - 1 - j] + x0 + x;
+				v0 += fir_load( q );
+				v1 += fir_load( q + L );
+			}
+			a0 = fma( t, v0, a0 );
+			a1 = fma( t, v1, a1 );
+		}
+		if ( mid )
+		{
+			VT t( k[nj] );
+			a0 = fma( t, fir_load( rows[nj] + x0 + x ), a0 );
+			a1 = fma( t, fir_load( rows[nj] + x0 + x + L ), a1 );
+		}
+		store( out + x, a0 );
+		store( out + x + L, a1 );
+	}
+	for ( ; x < n; ++x )
+	{
+		float a = 0.F;
+		for ( size_t j = 0; j != nk; ++j )
+			a += k[j] * rows[j][x0 + x];
+		out[x] = a;
+	}
+}
+
+/// @brief out[x] = sum_i k[i] * row[clamp( x + i - r )], with pad
+/// used to hold the row with the edges extended
+inline void blur_horizontal( float *out, const float *row, size_t w,
+							 const float *k, size_t nk, bool sym, std::vector<float> &pad )
+{
+	const size_t r = nk / 2;
+	pad.resize( w + nk - 1 );
+	std::fill( pad.begin(), pad.begin() + std::ptrdiff_t( r ), row[0] );
+	std::copy( row, row + w, pad.begin() + std::ptrdiff_t( r ) );
+	std::fill( pad.begin() + std::ptrdiff_t( r + w ), pad.end(), row[w - 1] );
+	if ( sym )
+		fir_correlate_symmetric( out, pad.data(), w, k, nk );
+	else
+		fir_correlate<false>( out, pad.data(), w, k, nk );
+}
+
+/// @brief runs the filter for the output rows [y0, y1)
+inline void separable_rows( float *out, size_t out_stride,
+							const float *in, size_t in_stride,
+							size_t w, size_t h, size_t y0, size_t y1,
+							const float *hk, size_t nhk, const float *vk, size_t nvk )
+{
+	const bool hsym = blur_symmetric( hk, nhk );
+	const bool vsym = blur_symmetric( vk, nvk );
+	const size_t band = blur_band_rows( w );
+	const std::ptrdiff_t vr = std::ptrdiff_t( nvk / 2 );
+	std::vector<float> tmp( band * w ), pad;
+	std::vector<const float *> rows( band + nvk - 1 );
+	for ( size_t b = y0; b < y1; b += band )
+	{
+		const size_t nb = std::min( band, y1 - b );
+		// output row b + i reads the rows from rows[i]
+		for ( size_t i = 0; i != nb + nvk - 1; ++i )
+			rows[i] = in + blur_clamp( std::ptrdiff_t( b + i ) - vr, h ) * in_stride;
+		for ( size_t x = 0; x < w; x += kBlurTile )
+		{
+			const size_t tw = std::min( kBlurTile, w - x );
+			for ( size_t i = 0; i != nb; ++i )
+				blur_vertical( tmp.data() + i * w + x, rows.data() + i, x, tw, vk, nvk, vsym );
+		}
+		for ( size_t i = 0; i != nb; ++i )
+			blur_horizontal( out + ( b + i ) * out_stride, tmp.data() + i * w, w, hk, nhk, hsym, pad );
+	}
+}
+
+#ifdef PAL_HAS_FVEC8
+PAL_INLINE void blur_transpose( fvec8 (&v)[8] )
+{
+	transpose8x8( v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7] );
+}
+#else
+PAL_INLINE void blur_transpose( fvec4 (&v)[4] )
+{
+	transpose4x4( v[0], v[1], v[2], v[3] );
+}
+#endif
+
+/// @brief horizontal box filter of one lane count of rows at once,
+/// the rows transposed into pad so the running sum is a vector
+inline void box_rows( float * const *out, const float * const *in, size_t w, size_t r, float scale,
+					  std::vector<float> &pad, std::vector<float> &sums )
+{
+	typedef fir_vec VT;
+	const int L = VT::value_count;
+	const size_t SL = size_t( L );
+	// pad[p] in lane l is in[l][clamp( p - r )]
+	pad.resize( ( w + 2 * r ) * SL );
+	sums.resize( w * SL );
+	float *pp = pad.data() + r * SL;
+	size_t x = 0;
+	for ( ; ( x + SL ) <= w; x += SL )
+	{
+		VT v[L];
+		for ( int l = 0; l != L; ++l )
+			v[l] = fir_load( in[l] + x );
+		blur_transpose( v );
+		for ( int l = 0; l != L; ++l )
+			store( pp + ( x + size_t( l ) ) * SL, v[l] );
+	}
+	for ( ; x < w; ++x )
+		for ( size_t l = 0; l != SL; ++l )
+			pp[x * SL + l] = in[l][x];
+	for ( size_t p = 0; p != r; ++p )
+	{
+		for ( size_t l = 0; l != SL; ++l )
+		{
+			pad[p * SL + l] = in[l][0];
+			pp[( w + p ) * SL + l] = in[l][w - 1];
+		}
+	}
+
+	const float *lo = pad.data(), *hi = pad.data() + ( 2 * r + 1 ) * SL;
+	VT s = VT::zero();
+	for ( size_t p = 0; p != 2 * r + 1; ++p )
+		s += fir_load( lo + p * SL );
+	VT sc( scale );
+	for ( x = 0; x + 1 < w; ++x, lo += SL, hi += SL )
+	{
+		store( sums.data() + x * SL, s * sc );
+		s += fir_load( hi ) - fir_load( lo );
+	}
+	store( sums.data() + x * SL, s * sc );
+
+	for ( x = 0; ( x + SL ) <= w; x += SL )
+	{
+		VT v[L];
+		for ( int l = 0; l != L; ++l )
+			v[l] = fir_load( sums.data() + ( x + size_t( l ) ) * SL );
+		blur_transpose( v );
+		for ( int l = 0; l != L; ++l )
+			store( out[l] + x, v[l] );
+	}
+	for ( ; x < w; ++x )
+		for ( size_t l = 0; l != SL; ++l )
+			out[l][x] = sums[x * SL + l];
+}
+
+/// @brief acc[x] += add[x] - sub[x], writing the previous acc to out
+inline void box_step( float *out, float *acc, const float *add, const float *sub, size_t n )
+{
+	typedef fir_vec VT;
+	const size_t L = size_t( VT::value_count );
+	size_t x = 0;
+	for ( ; ( x + L ) <= n; x += L )
+	{
+		VT a = fir_load( acc + x );
+		store( out + x, a );
+		store( acc + x, a + ( fir_load( add + x ) - fir_load( sub + x ) ) );
+	}
+	for ( ; x < n; ++x )
+	{
+		out[x] = acc[x];
+		acc[x] += add[x] - sub[x];
+	}
+}
+
+/// @brief box filters the output rows [y0, y1)
+inline void box_rows_range( float *out, size_t out_stride,
+							const float *in, size_t in_stride,
+							size_t w, size_t h, size_t y0, size_t y1, size_t r )
+{
+	const size_t L = size_t( fir_vec::value_count );
+	const size_t band = ( blur_band_rows( w ) + L - 1 ) / L * L;
+	const float scale = 1.F / float( ( 2 * r + 1 ) * ( 2 * r + 1 ) );
+	const std::ptrdiff_t sr = std::ptrdiff_t( r );
+	std::vector<float> acc( w, 0.F ), tmp( band * w ), dummy( w ), pad, sums;
+
+	// the column sums of the window of rows around y0, which then
+	// slides down a row at a time
+	for ( std::ptrdiff_t j = -sr; j <= sr; ++j )
+	{
+		const float *row = in + blur_clamp( std::ptrdiff_t( y0 ) + j, h ) * in_stride;
+		for ( size_t x = 0; x != w; ++x )
+			acc[x] += row[x];
+	}
+
+	for ( size_t b = y0; b < y1; b += band )
+	{
+		const size_t nb = std::min( band, y1 - b );
+		for ( size_t x = 0; x < w; x += kBlurTile )
+		{
+			const size_t tw = std::min( kBlurTile, w - x );
+			for ( size_t i = 0; i != nb; ++i )
+			{
+				const std::ptrdiff_t y = std::ptrdiff_t( b + i );
+				const float *add = in + blur_clamp( y + sr + 1, h ) * in_stride + x;
+				const float *sub = in + blur_clamp( y - sr, h ) * in_stride + x;
+				box_step( tmp.data() + i * w + x, acc.data() + x, add, sub, tw );
+			}
+		}
+		for ( size_t i = 0; i < nb; i += L )
+		{
+			const float *src[fir_vec::value_count];
+			float *dst[fir_vec::value_count];
+			// the lanes past the band repeat its last row, into a
+			// dummy output row
+			for ( size_t l = 0; l != L; ++l )
+			{
+				bool live = ( i + l ) < nb;
+				src[l] = tmp.data() + ( live ? i + l : nb - 1 ) * w;
+				dst[l] = live ? out + ( b + i + l ) * out_stride : dummy.data();
+			}
+			box_rows( dst, src, w, r, scale, pad, sums );
+		}
+	}
+}
+
+/// @brief widths of the n box filters approximating a gaussian,
+/// following Wells, "Efficient synthesis of Gaussian filters by
+/// cascaded uniform filters"
+inline void gauss_boxes( size_t *radii, int n, float sigma )
+{
+	const double s2 = double( sigma ) * double( sigma );
+	int wl = int( std::floor( std::sqrt( 12.0 * s2 / n + 1.0 ) ) );
+	if ( ( wl & 1 ) == 0 )
+		--wl;
+	double mi = ( 12.0 * s2 - n * wl * wl - 4.0 * n * wl - 3.0 * n ) / ( -4.0 * wl - 4.0 );
+	int m = int( std::lround( mi ) );
+	for ( int i = 0; i != n; ++i )
+		radii[i] = size_t( ( ( i < m ? wl : wl + 2 ) - 1 ) / 2 );
+}
+
+template <typename F>
+inline void blur_run( size_t h, int nthreads, F func )
+{
+	int nchunks = parallel_chunks( h, nthreads, kBlurMinRows );
+	parallel_for( h, nchunks, [&func]( int, size_t b, size_t e ) {
+			if ( b < e )
+				func( b, e );
+		} );
+}
+
+} // namespace detail
+
+////////////////////////////////////////
+
+/// @brief filters the image with the horizontal kernel hk along the
+/// rows and the vertical kernel vk down the columns.
+///
+/// The kernels are centered on element n / 2, and applied without
+/// being flipped, i.e. out( x, y ) = sum_i sum_j hk[i] vk[j] in( x + i
+/// - nhk / 2, y + j - nvk / 2 ), which for the usual symmetric kernels
+/// is the same as a convolution. Symmetric kernels are detected and
+/// folded. The nthreads work on bands of rows, 0 meaning all hardware
+/// threads.
+inline void
+separable_filter( float *out, size_t out_stride, const float *in, size_t in_stride,
+				  size_t width, size_t height,
+				  const float *hk, size_t nhk, const float *vk, size_t nvk, int nthreads = 1 )
+{
+	if ( width == 0 || height == 0 || nhk == 0 || nvk == 0 )
+		return;
+	detail::blur_run( height, nthreads, [=]( size_t b, size_t e ) {
+			detail::separable_rows( out, out_stride, in, in_stride, width, height, b, e, hk, nhk, vk, nvk );
+		} );
+}
+
+/// @brief averages the ( 2 radius + 1 )^2 pixels around each pixel
+///
+/// The cost per pixel does not depend on the radius. The running sums
+/// are kept in float, so the result for an image of very large values
+/// next to very small ones may drift by a few ulp of the large ones.
+/// Each thread's band of rows starts its sums afresh, so the result
+/// with more than one thread differs from the single thread one by
+/// that rounding (about 4e-6 for values of magnitude 8).
+inline void
+box_blur( float *out, size_t out_stride, const float *in, size_t in_stride,
+		  size_t width, size_t height, size_t radius, int nthreads = 1 )
+{
+	if ( width == 0 || height == 0 )
+		return;
+	detail::blur_run( height, nthreads, [=]( size_t b, size_t e ) {
+			detail::box_rows_range( out, out_stride, in, in_stride, width, height, b, e, radius );
+		} );
+}
+
+/// @brief gaussian blur with standard deviation sigma (in pixels)
+///
+/// The kernel is cut off at 3 sigma. When that is more than 16 pixels,
+/// the gaussian is approximated by 3 box blurs instead, which is
+/// faster from there on and within a few percent of it, away from the
+/// edges (each box pass extends the edges of the previous one, so
+/// within 3 sigma of them it is less close).
+inline void
+gaussian_blur( float *out, size_t out_stride, const float *in, size_t in_stride,
+			   size_t width, size_t height, float sigma, int nthreads = 1 )
+{
+	if ( width == 0 || height == 0 )
+		return;
+	const size_t r = size_t( std::ceil( 3.F * std::max( sigma, 0.F ) ) );
+	if ( r > detail::kGaussMaxRadius )
+	{
+		size_t radii[3];
+		detail::gauss_boxes( radii, 3, sigma );
+		std::vector<float> tmp( width * height );
+		box_blur( out, out_stride, in, in_stride, width, height, radii[0], nthreads );
+		box_blur( tmp.data(), width, out, out_stride, width, height, radii[1], nthreads );
+		box_blur( out, out_stride, tmp.data(), width, width, height, radii[2], nthreads );
+		return;
+	}
+
+	std::vector<float> k( 2 * r + 1 );
+	if ( r == 0 )
+		k[0] = 1.F;
+	else
+	{
+		double sum = 0.0;
+		for ( size_t i = 0; i != k.size(); ++i )
+		{
+			double d = double( i ) - double( r );
+			double v = std::exp( -d * d / ( 2.0 * double( sigma ) * double( sigma ) ) );
+			k[i] = float( v );
+			sum += v;
+		}
+		for ( float &v: k )
+			v = float( double( v ) / sum );
+	}
+	separable_filter( out, out_stride, in, in_stride, width, height,
+					  k.data(), k.size(), k.data(), k.size(), nthreads );
+}
+
+} // namespace pal
+
+#endif // _PAL_BUFFER_BLUR_H_
@@ -0,0 +1,117 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use pal/buffer_compact.h directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_BUFFER_COMPACT_H_
+# define _PAL_BUFFER_COMPACT_H_ 1
+
+// stream compaction of float and int32_t buffers by a vectorized
+// predicate, called with a search_vec<T> as for the searches in
+// buffer_search.h. Each register is written with compress_store, so
+// the outputs are written a whole register at a time and need room
+// for n values, the values past the returned count are unspecified.
+// The order of the values is kept.
+
+namespace PAL_NAMESPACE
+{
+
+namespace detail
+{
+
+/// @brief copies the selected values of the last n ( < lanes )
+/// values from in to out_true, and the rest to out_false when not
+/// null, only writing the values needed. in is copied first, as it may
+/// be the same as either output
+template <typename T, typename P>
+inline size_t compact_tail( T *out_true, T *out_false, const T *in, size_t n, P &pred )
+{
+	typedef search_types<T> st;
+	typedef typename st::vec_type VT;
+	PAL_ALIGN_256 T tmp[VT::value_count] = {}, rest[VT::value_count];
+	for ( size_t i = 0; i != n; ++i )
+		tmp[i] = rest[i] = in[i];
+	// the padding lanes are cut off by the bits past n
+	const int live = ( 1 << n ) - 1;
+	int bits = pred( st::load_vec( tmp ) ).which() & live;
+	int count = compress_lanes( tmp, bits );
+	for ( int i = 0; i != count; ++i )
+		out_true[i] = tmp[i];
+	if ( out_false )
+	{
+		int nf = compress_lanes( rest, ~bits & live );
+		for ( int i = 0; i != nf; ++i )
+			out_false[i] = rest[i];
+	}
+	return size_t( count );
+}
+
+} // namespace detail
+
+////////////////////////////////////////
+
+/// @brief copies the values for which pred is true to out, returning
+/// how many there are (as with std::copy_if). out may be the same as
+/// in, compacting in place
+template <typename T, typename P>
+inline size_t copy_if( T *out, const T *in, size_t n, P pred )
+{
+	typedef detail::search_types<T> st;
+	const size_t L = size_t( st::vec_type::value_count );
+	size_t o = 0, i = 0;
+	for ( ; ( i + L ) <= n; i += L )
+	{
+		typename st::vec_type v = st::load_vec( in + i );
+		o += size_t( compress_store( out + o, v, pred( v ) ) );
+	}
+	if ( i < n )
+		o += detail::compact_tail( out + o, static_cast<T *>( nullptr ), in + i, n - i, pred );
+	return o;
+}
+
+/// @brief copies the values for which pred is true to out_true, and
+/// the rest to out_false, returning how many are true (as with
+/// std::partition_copy)
+template <typename T, typename P>
+inline size_t partition_copy( T *out_true, T *out_false, const T *in, size_t n, P pred )
+{
+	typedef detail::search_types<T> st;
+	const size_t L = size_t( st::vec_type::value_count );
+	size_t t = 0, f = 0, i = 0;
+	for ( ; ( i + L ) <= n; i += L )
+	{
+		typename st::vec_type v = st::load_vec( in + i );
+		typename st::vec_type::mask_type m = pred( v );
+		int c = compress_store( out_true + t, v, m );
+		compress_store( out_false + f, v, ! m );
+		t += size_t( c );
+		f += L - size_t( c );
+	}
+	if ( i < n )
+		t += detail::compact_tail( out_true + t, out_false + f, in + i, n - i, pred );
+	return t;
+}
+
+/// @brief moves the values for which pred is true to the front,
+/// returning how many there are. This is a stable partition (both
+/// sides keep their order), the false values go through a temporary
+/// buffer.
+template <typename T, typename P>
+inline size_t partition( T *a, size_t n, P pred )
+{
+	std::vector<T> rest( n );
+	size_t t = partition_copy( a, rest.data(), a, n, pred );
+	if ( n > t )
+		std::memcpy( a + t, rest.data(), ( n - t ) * sizeof(T) );
+	return t;
+}
+
+} // namespace pal
+
+#endif // _PAL_BUFFER_COMPACT_H_
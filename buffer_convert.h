@@ -0,0 +1,475 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use pal/buffer_convert.h directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_BUFFER_CONVERT_H_
+# define _PAL_BUFFER_CONVERT_H_ 1
+
+// converts buffers of integers between 8, 16 and 32-bit types. The
+// widening conversions are exact, the narrowing conversions saturate
+// to the range of the output type. The 256-bit loops are only used
+// with AVX2, as the AVX1 integer emulation is no faster than 128-bit.
+
+namespace PAL_NAMESPACE
+{
+
+namespace detail
+{
+
+template <typename T>
+PAL_INLINE T convert_clamp( int32_t v )
+{
+	return static_cast<T>( v < int32_t(std::numeric_limits<T>::min()) ? std::numeric_limits<T>::min() :
+						   ( v > int32_t(std::numeric_limits<T>::max()) ? std::numeric_limits<T>::max() : v ) );
+}
+
+} // namespace detail
+
+/// @brief zero extends n 8-bit values to 16-bit
+inline void
+convert( PAL_RESTRICT_PTR(uint16_t) out, PAL_RESTRICT_PTR(const uint8_t) in, size_t n )
+{
+#if defined(PAL_HAS_IVEC256) && defined(PAL_ENABLE_AVX2)
+	while ( n >= 32 )
+	{
+		ucvec32 v = load256( in );
+		store( out, widen_lo( v ) ); store( out + 16, widen_hi( v ) );
+		out += 32; in += 32;
+		n -= 32;
+	}
+#endif
+#if defined(PAL_HAS_IVEC128)
+	while ( n >= 16 )
+	{
+		ucvec16 v = load( in );
+		store( out, widen_lo( v ) ); store( out + 8, widen_hi( v ) );
+		out += 16; in += 16;
+		n -= 16;
+	}
+#endif
+	while ( n > 0 )
+	{
+		*out++ = *in++;
+		--n;
+	}
+}
+
+/// @brief zero extends n 8-bit values to 32-bit
+inline void
+convert( PAL_RESTRICT_PTR(int32_t) out, PAL_RESTRICT_PTR(const uint8_t) in, size_t n )
+{
+#if defined(PAL_HAS_IVEC256) && defined(PAL_ENABLE_AVX2)
+	while ( n >= 32 )
+	{
+		ucvec32 v = load256( in );
+		usvec16 l = widen_lo( v ), h = widen_hi( v );
+		store( out, lvec8( widen_lo( l ) ) ); store( out + 8, lvec8( widen_hi( l ) ) );
+		store( out + 16, lvec8( widen_lo( h ) ) ); store( out + 24, lvec8( widen_hi( h ) ) );
+		out += 32; in += 32;
+		n -= 32;
+	}
+#endif
+#if defined(PAL_HAS_IVEC128)
+	while ( n >= 16 )
+	{
+		ucvec16 v = load( in );
+		usvec8 l = widen_lo( v ), h = widen_hi( v );
+		store( out, lvec4( widen_lo( l ) ) ); store( out + 4, lvec4( widen_hi( l ) ) );
+		store( out + 8, lvec4( widen_lo( h ) ) ); store( out + 12, lvec4( widen_hi( h ) ) );
+		out += 16; in += 16;
+		n -= 16;
+	}
+#endif
+	while ( n > 0 )
+	{
+		*out++ = *in++;
+		--n;
+	}
+}
+
+/// @brief zero extends n 16-bit values to 32-bit
+inline void
+convert( PAL_RESTRICT_PTR(int32_t) out, PAL_RESTRICT_PTR(const uint16_t) in, size_t n )
+{
+#if defined(PAL_HAS_IVEC256) && defined(PAL_ENABLE_AVX2)
+	while ( n >= 16 )
+	{
+		usvec16 v = load256( in );
+		store( out, lvec8( widen_lo( v ) ) ); store( out + 8, lvec8( widen_hi( v ) ) );
+		out += 16; in += 16;
+		n -= 16;
+	}
+#endif
+#if defined(PAL_HAS_IVEC128)
+	while ( n >= 8 )
+	{
+		usvec8 v = load( in );
+		store( out, lvec4( widen_lo( v ) ) ); store( out + 4, lvec4( widen_hi( v ) ) );
+		out += 8; in += 8;
+		n -= 8;
+	}
+#endif
+	while ( n > 0 )
+	{
+		*out++ = *in++;
+		--n;
+	}
+}
+
+/// @brief narrows n 16-bit values to 8-bit, values above 255 become
+/// 255
+inline void
+convert( PAL_RESTRICT_PTR(uint8_t) out, PAL_RESTRICT_PTR(const uint16_t) in, size_t n )
+{
+#if defined(PAL_HAS_IVEC256) && defined(PAL_ENABLE_AVX2)
+	while ( n >= 32 )
+	{
+		store( out, pack_sat( load256( in ), load256( in + 16 ) ) );
+		out += 32; in += 32;
+		n -= 32;
+	}
+#endif
+#if defined(PAL_HAS_IVEC128)
+	while ( n >= 16 )
+	{
+		store( out, pack_sat( load( in ), load( in + 8 ) ) );
+		out += 16; in += 16;
+		n -= 16;
+	}
+#endif
+	while ( n > 0 )
+	{
+		*out++ = static_cast<uint8_t>( *in > 255 ? 255 : *in );
+		++in;
+		--n;
+	}
+}
+
+/// @brief narrows n 32-bit values to 8-bit, clamping to [0, 255]
+inline void
+convert( PAL_RESTRICT_PTR(uint8_t) out, PAL_RESTRICT_PTR(const int32_t) in, size_t n )
+{
+#if defined(PAL_HAS_IVEC256) && defined(PAL_ENABLE_AVX2)
+	while ( n >= 32 )
+	{
+		usvec16 l = pack_usat( load256( in ), load256( in + 8 ) );
+		usvec16 h = pack_usat( load256( in + 16 ), load256( in + 24 ) );
+		store( out, pack_sat( l, h ) );
+		out += 32; in += 32;
+		n -= 32;
+	}
+#endif
+#if defined(PAL_HAS_IVEC128)
+	while ( n >= 16 )
+	{
+		usvec8 l = pack_usat( load( in ), load( in + 4 ) );
+		usvec8 h = pack_usat( load( in + 8 ), load( in + 12 ) );
+		store( out, pack_sat( l, h ) );
+		out += 16; in += 16;
+		n -= 16;
+	}
+#endif
+	while ( n > 0 )
+	{
+		*out++ = detail::convert_clamp<uint8_t>( *in++ );
+		--n;
+	}
+}
+
+/// @brief narrows n 32-bit values to 16-bit, clamping to [0, 65535]
+inline void
+convert( PAL_RESTRICT_PTR(uint16_t) out, PAL_RESTRICT_PTR(const int32_t) in, size_t n )
+{
+#if defined(PAL_HAS_IVEC256) && defined(PAL_ENABLE_AVX2)
+	while ( n >= 16 )
+	{
+		store( out, pack_usat( load256( in ), load256( in + 8 ) ) );
+		out += 16; in += 16;
+		n -= 16;
+	}
+#endif
+#if defined(PAL_HAS_IVEC128)
+	while ( n >= 8 )
+	{
+		store( out, pack_usat( load( in ), load( in + 4 ) ) );
+		out += 8; in += 8;
+		n -= 8;
+	}
+#endif
+	while ( n > 0 )
+	{
+		*out++ = detail::convert_clamp<uint16_t>( *in++ );
+		--n;
+	}
+}
+
+////////////////////////////////////////
+// normalized float <-> unorm conversions
+
+/// @brief dithering applied when quantizing float values to unorm
+///
+/// ordered uses an 8x8 Bayer matrix, noise uses interleaved gradient
+/// noise, which has blue-noise-like spectral properties without
+/// needing a texture. Both are indexed by image position, so the
+/// caller passes the x, y of the first value in the buffer.
+enum class dither
+{
+	none,
+	ordered,
+	noise
+};
+
+namespace detail
+{
+
+/// @brief a * b + c, rounded the same way as the vector fma so the
+/// scalar tails match the vector loops wherever n splits
+PAL_INLINE float unorm_fma( float a, float b, float c )
+{
+#ifdef PAL_ENABLE_FMA_EXT
+	return std::fma( a, b, c );
+#else
+	return a * b + c;
+#endif
+}
+
+/// @brief generates the dither offset (in [-0.5, 0.5) LSB) for the
+/// value at index i of a row
+class unorm_dither
+{
+public:
+	unorm_dither( dither d, int x, int y )
+		: _noise( d == dither::noise ), _x( float( x ) ), _y( 0.00583715F * float( y ) )
+	{
+		static const int bayer[8][8] = {
+			{ 0, 32,  8, 40,  2, 34, 10, 42 },
+			{ 48, 16, 56, 24, 50, 18, 58, 26 },
+			{ 12, 44,  4, 36, 14, 46,  6, 38 },
+			{ 60, 28, 52, 20, 62, 30, 54, 22 },
+			{ 3, 35, 11, 43,  1, 33,  9, 41 },
+			{ 51, 19, 59, 27, 49, 17, 57, 25 },
+			{ 15, 47,  7, 39, 13, 45,  5, 37 },
+			{ 63, 31, 55, 23, 61, 29, 53, 21 }
+		};
+		// stored twice so any 4 or 8 wide window starting in the
+		// first period is contiguous
+		for ( int i = 0; i < 16; ++i )
+		{
+			if ( d == dither::ordered )
+				_pat[i] = ( float( bayer[y & 7][( x + i ) & 7] ) + 0.5F ) / 64.F - 0.5F;
+			else
+				_pat[i] = 0.F;
+		}
+	}
+
+	PAL_INLINE float at( size_t i ) const
+	{
+		if ( _noise )
+		{
+			float t = unorm_fma( _x + float( i ), 0.06711056F, _y );
+			t = 52.9829189F * ( t - std::floor( t ) );
+			return t - std::floor( t ) - 0.5F;
+		}
+		return _pat[i & 7];
+	}
+
+#if defined(PAL_HAS_FVEC4)
+	PAL_INLINE fvec4 at4( size_t i ) const
+	{
+		if ( _noise )
+			return noise( fvec4( _x + float( i ) ) + load4f( iota() ) );
+		return load4f( _pat + ( i & 7 ) );
+	}
+#endif
+#if defined(PAL_HAS_FVEC8)
+	PAL_INLINE fvec8 at8( size_t i ) const
+	{
+		if ( _noise )
+			return noise( fvec8( _x + float( i ) ) + load8f( iota() ) );
+		return load8f( _pat + ( i & 7 ) );
+	}
+#endif
+
+private:
+	static PAL_INLINE const float *iota( void )
+	{
+		static const float v[8] = { 0.F, 1.F, 2.F, 3.F, 4.F, 5.F, 6.F, 7.F };
+		return v;
+	}
+
+	template <typename VT>
+	PAL_INLINE VT noise( VT x ) const
+	{
+		VT t = fma( x, VT( 0.06711056F ), VT( _y ) );
+		t = VT( 52.9829189F ) * ( t - floorf( t ) );
+		return t - floorf( t ) - VT( 0.5F );
+	}
+
+	bool _noise;
+	float _x;
+	float _y;
+	float _pat[16];
+};
+
+/// @brief scales, dithers and clamps to [0, s], then rounds to
+/// nearest (ties to even, matching the vector conversion). NaN
+/// becomes s, as with clamp
+PAL_INLINE int32_t unorm_quantize( float v, float s, float d )
+{
+	v = unorm_fma( v, s, d );
+	v = v < s ? v : s;
+	v = v > 0.F ? v : 0.F;
+	return static_cast<int32_t>( std::nearbyint( v ) );
+}
+
+template <typename VT>
+PAL_INLINE typename VT::int_vec_type unorm_quantize( VT v, VT s, VT d )
+{
+	return max( min( fma( v, s, d ), s ), VT::zero() ).convert_to_int();
+}
+
+} // namespace detail
+
+/// @brief converts n floats in [0, 1] to 8-bit unorm, rounding to
+/// nearest and saturating out of range values. x and y are the image
+/// position of in[0], used to index the dither pattern
+inline void
+convert_to_unorm( PAL_RESTRICT_PTR(uint8_t) out, PAL_RESTRICT_PTR(const float) in, size_t n,
+				  dither d = dither::none, int x = 0, int y = 0 )
+{
+	detail::unorm_dither dith( d, x, y );
+	size_t i = 0;
+#if defined(PAL_HAS_FVEC8) && defined(PAL_ENABLE_AVX2)
+	const fvec8 s8( 255.F );
+	for ( ; i + 32 <= n; i += 32 )
+	{
+		lvec8 a = detail::unorm_quantize( load8f( in + i ), s8, dith.at8( i ) );
+		lvec8 b = detail::unorm_quantize( load8f( in + i + 8 ), s8, dith.at8( i + 8 ) );
+		lvec8 c = detail::unorm_quantize( load8f( in + i + 16 ), s8, dith.at8( i + 16 ) );
+		lvec8 e = detail::unorm_quantize( load8f( in + i + 24 ), s8, dith.at8( i + 24 ) );
+		store( out + i, pack_sat( pack_usat( a, b ), pack_usat( c, e ) ) );
+	}
+#endif
+#if defined(PAL_HAS_FVEC4) && defined(PAL_HAS_IVEC128)
+	const fvec4 s4( 255.F );
+	for ( ; i + 16 <= n; i += 16 )
+	{
+		lvec4 a = detail::unorm_quantize( load4f( in + i ), s4, dith.at4( i ) );
+		lvec4 b = detail::unorm_quantize( load4f( in + i + 4 ), s4, dith.at4( i + 4 ) );
+		lvec4 c = detail::unorm_quantize( load4f( in + i + 8 ), s4, dith.at4( i + 8 ) );
+		lvec4 e = detail::unorm_quantize( load4f( in + i + 12 ), s4, dith.at4( i + 12 ) );
+		store( out + i, pack_sat( pack_usat( a, b ), pack_usat( c, e ) ) );
+	}
+#endif
+	for ( ; i < n; ++i )
+		out[i] = static_cast<uint8_t>( detail::unorm_quantize( in[i], 255.F, dith.at( i ) ) );
+}
+
+/// @brief converts n floats in [0, 1] to 16-bit unorm
+///
+/// @sa convert_to_unorm
+inline void
+convert_to_unorm( PAL_RESTRICT_PTR(uint16_t) out, PAL_RESTRICT_PTR(const float) in, size_t n,
+				  dither d = dither::none, int x = 0, int y = 0 )
+{
+	detail::unorm_dither dith( d, x, y );
+	size_t i = 0;
+#if defined(PAL_HAS_FVEC8) && defined(PAL_ENABLE_AVX2)
+	const fvec8 s8( 65535.F );
+	for ( ; i + 16 <= n; i += 16 )
+	{
+		lvec8 a = detail::unorm_quantize( load8f( in + i ), s8, dith.at8( i ) );
+		lvec8 b = detail::unorm_quantize( load8f( in + i + 8 ), s8, dith.at8( i + 8 ) );
+		store( out + i, pack_usat( a, b ) );
+	}
+#endif
+#if defined(PAL_HAS_FVEC4) && defined(PAL_HAS_IVEC128)
+	const fvec4 s4( 65535.F );
+	for ( ; i + 8 <= n; i += 8 )
+	{
+		lvec4 a = detail::unorm_quantize( load4f( in + i ), s4, dith.at4( i ) );
+		lvec4 b = detail::unorm_quantize( load4f( in + i + 4 ), s4, dith.at4( i + 4 ) );
+		store( out + i, pack_usat( a, b ) );
+	}
+#endif
+	for ( ; i < n; ++i )
+		out[i] = static_cast<uint16_t>( detail::unorm_quantize( in[i], 65535.F, dith.at( i ) ) );
+}
+
+/// @brief converts n 8-bit unorm values to float in [0, 1]
+inline void
+convert_from_unorm( PAL_RESTRICT_PTR(float) out, PAL_RESTRICT_PTR(const uint8_t) in, size_t n )
+{
+	const float s = 1.F / 255.F;
+#if defined(PAL_HAS_FVEC8) && defined(PAL_ENABLE_AVX2)
+	while ( n >= 16 )
+	{
+		usvec16 v( _mm256_cvtepu8_epi16( load( in ) ) );
+		store( out, fvec8::convert_int( lvec8( widen_lo( v ) ) ) * s );
+		store( out + 8, fvec8::convert_int( lvec8( widen_hi( v ) ) ) * s );
+		out += 16; in += 16;
+		n -= 16;
+	}
+#endif
+#if defined(PAL_HAS_FVEC4) && defined(PAL_HAS_IVEC128)
+	while ( n >= 16 )
+	{
+		ucvec16 v = load( in );
+		usvec8 l = widen_lo( v ), h = widen_hi( v );
+		store( out, fvec4::convert_int( lvec4( widen_lo( l ) ) ) * s );
+		store( out + 4, fvec4::convert_int( lvec4( widen_hi( l ) ) ) * s );
+		store( out + 8, fvec4::convert_int( lvec4( widen_lo( h ) ) ) * s );
+		store( out + 12, fvec4::convert_int( lvec4( widen_hi( h ) ) ) * s );
+		out += 16; in += 16;
+		n -= 16;
+	}
+#endif
+	while ( n > 0 )
+	{
+		*out++ = float( *in++ ) * s;
+		--n;
+	}
+}
+
+/// @brief converts n 16-bit unorm values to float in [0, 1]
+inline void
+convert_from_unorm( PAL_RESTRICT_PTR(float) out, PAL_RESTRICT_PTR(const uint16_t) in, size_t n )
+{
+	const float s = 1.F / 65535.F;
+#if defined(PAL_HAS_FVEC8) && defined(PAL_ENABLE_AVX2)
+	while ( n >= 16 )
+	{
+		usvec16 v = load256( in );
+		store( out, fvec8::convert_int( lvec8( widen_lo( v ) ) ) * s );
+		store( out + 8, fvec8::convert_int( lvec8( widen_hi( v ) ) ) * s );
+		out += 16; in += 16;
+		n -= 16;
+	}
+#endif
+#if defined(PAL_HAS_FVEC4) && defined(PAL_HAS_IVEC128)
+	while ( n >= 8 )
+	{
+		usvec8 v = load( in );
+		store( out, fvec4::convert_int( lvec4( widen_lo( v ) ) ) * s );
+		store( out + 4, fvec4::convert_int( lvec4( widen_hi( v ) ) ) * s );
+		out += 8; in += 8;
+		n -= 8;
+	}
+#endif
+	while ( n > 0 )
+	{
+		*out++ = float( *in++ ) * s;
+		--n;
+	}
+}
+
+} // namespace pal
+
+#endif // _PAL_BUFFER_CONVERT_H_
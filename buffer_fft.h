@@ -0,0 +1,709 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use pal/buffer_fft.h directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_BUFFER_FFT_H_
+# define _PAL_BUFFER_FFT_H_ 1
+
+// power of two FFTs of float and double data, with the complex values
+// in split layout: separate arrays of the real and imaginary parts.
+//
+// The transform is a Stockham autosort FFT, so there is no bit
+// reversal pass, made of radix-4 passes (and a final radix-2 pass for
+// odd powers of two) which ping-pong between the data and a work
+// buffer of the plan. Once the stride of a pass is at least a vector,
+// the vectors run over the stride with the twiddles broadcast. The
+// first passes (stride 1, and 4 with 8 floats to a vector) run over
+// the butterflies instead, with the twiddles stored once for each
+// lane and the outputs interleaved back with transposes.
+//
+// Sizes past kFftBlocked use the four step algorithm: the data is
+// taken as an n1 x n2 matrix, and transformed with n2 FFTs of size n1
+// on the transposed columns, a twiddle multiply, and n1 FFTs of size
+// n2 on the rows, so each of the smaller FFTs works in cache.
+//
+// The plans hold the twiddles and the work buffers, so one plan
+// should not be used by several threads at once.
+
+namespace PAL_NAMESPACE
+{
+
+namespace detail
+{
+
+// past the size where the data and work buffer outgrow a typical
+// last level cache, the transposes cost less than the cache misses of
+// the long strides
+static const size_t kFftBlocked = size_t(1) << 22;
+
+template <typename T> struct fft_types;
+
+template <> struct fft_types<float>
+{
+#ifdef PAL_HAS_FVEC8
+	typedef fvec8 vec_type;
+	static PAL_INLINE vec_type load_vec( const float *in ) { return load8f( in ); }
+	/// @brief out[4 i + k] = y_k[i]
+	static PAL_INLINE void interleave4( float *out, vec_type y0, vec_type y1, vec_type y2, vec_type y3 )
+	{
+		transpose4x4_lanes( y0, y1, y2, y3 );
+		store( out, fvec8( _mm256_permute2f128_ps( y0, y1, 0x20 ) ) );
+		store( out + 8, fvec8( _mm256_permute2f128_ps( y2, y3, 0x20 ) ) );
+		store( out + 16, fvec8( _mm256_permute2f128_ps( y0, y1, 0x31 ) ) );
+		store( out + 24, fvec8( _mm256_permute2f128_ps( y2, y3, 0x31 ) ) );
+	}
+	/// @brief the lanes in reverse order
+	static PAL_INLINE vec_type reverse( vec_type v )
+	{
+		__m256 t = _mm256_permute2f128_ps( v, v, 0x01 );
+		return vec_type( _mm256_permute_ps( t, _MM_SHUFFLE( 0, 1, 2, 3 ) ) );
+	}
+	/// @brief transposes the 8 x 8 tile at in into out
+	static PAL_INLINE void transpose_tile( float *out, size_t os, const float *in, size_t is )
+	{
+		vec_type r[8];
+		for ( size_t i = 0; i != 8; ++i )
+			r[i] = load_vec( in + i * is );
+		transpose8x8( r[0], r[1], r[2], r[3], r[4], r[5], r[6], r[7] );
+		for ( size_t i = 0; i != 8; ++i )
+			store( out + i * os, r[i] );
+	}
+#else
+	typedef fvec4 vec_type;
+	static PAL_INLINE vec_type load_vec( const float *in ) { return load4f( in ); }
+	static PAL_INLINE void interleave4( float *out, vec_type y0, vec_type y1, vec_type y2, vec_type y3 )
+	{
+		transpose4x4( y0, y1, y2, y3 );
+		store( out, y0 );
+		store( out + 4, y1 );
+		store( out + 8, y2 );
+		store( out + 12, y3 );
+	}
+	static PAL_INLINE vec_type reverse( vec_type v )
+	{
+		return vec_type( _mm_shuffle_ps( v, v, _MM_SHUFFLE( 0, 1, 2, 3 ) ) );
+	}
+	static PAL_INLINE void transpose_tile( float *out, size_t os, const float *in, size_t is )
+	{
+		vec_type r0 = load_vec( in ), r1 = load_vec( in + is );
+		vec_type r2 = load_vec( in + 2 * is ), r3 = load_vec( in + 3 * is );
+		transpose4x4( r0, r1, r2, r3 );
+		store( out, r0 );
+		store( out + os, r1 );
+		store( out + 2 * os, r2 );
+		store( out + 3 * os, r3 );
+	}
+#endif
+};
+
+template <> struct fft_types<double>
+{
+#ifdef PAL_HAS_DVEC4
+	typedef dvec4 vec_type;
+	static PAL_INLINE vec_type load_vec( const double *in ) { return load4d( in ); }
+	static PAL_INLINE void interleave4( double *out, vec_type y0, vec_type y1, vec_type y2, vec_type y3 )
+	{
+		transpose4x4( y0, y1, y2, y3 );
+		store( out, y0 );
+		store( out + 4, y1 );
+		store( out + 8, y2 );
+		store( out + 12, y3 );
+	}
+	static PAL_INLINE vec_type reverse( vec_type v )
+	{
+		__m256d t = _mm256_permute2f128_pd( v, v, 0x01 );
+		return vec_type( _mm256_permute_pd( t, 0x5 ) );
+	}
+	static PAL_INLINE void transpose_tile( double *out, size_t os, const double *in, size_t is )
+	{
+		vec_type r0 = load_vec( in ), r1 = load_vec( in + is );
+		vec_type r2 = load_vec( in + 2 * is ), r3 = load_vec( in + 3 * is );
+		transpose4x4( r0, r1, r2, r3 );
+		store( out, r0 );
+		store( out + os, r1 );
+		store( out + 2 * os, r2 );
+		store( out + 3 * os, r3 );
+	}
+#else
+	typedef dvec2 vec_type;
+	static PAL_INLINE vec_type load_vec( const double *in ) { return load2d( in ); }
+	static PAL_INLINE void interleave4( double *out, vec_type y0, vec_type y1, vec_type y2, vec_type y3 )
+	{
+		transpose2x2( y0, y1 );
+		transpose2x2( y2, y3 );
+		store( out, y0 );
+		store( out + 2, y2 );
+		store( out + 4, y1 );
+		store( out + 6, y3 );
+	}
+	static PAL_INLINE vec_type reverse( vec_type v )
+	{
+		return vec_type( _mm_shuffle_pd( v, v, 0x1 ) );
+	}
+	static PAL_INLINE void transpose_tile( double *out, size_t os, const double *in, size_t is )
+	{
+		vec_type r0 = load_vec( in ), r1 = load_vec( in + is );
+		transpose2x2( r0, r1 );
+		store( out, r0 );
+		store( out + os, r1 );
+	}
+#endif
+};
+
+/// @brief the radix-4 butterfly of a, b, c, d, with the outputs
+/// other than the first multiplied by w1, w2, w3 when twiddle is set
+template <bool twiddle, typename VT>
+PAL_INLINE void fft_butterfly4( VT &ar, VT &ai, VT &br, VT &bi, VT &cr, VT &ci, VT &dr, VT &di,
+								VT w1r, VT w1i, VT w2r, VT w2i, VT w3r, VT w3i )
+{
+	VT apcr = ar + cr, apci = ai + ci;
+	VT amcr = ar - cr, amci = ai - ci;
+	VT bpdr = br + dr, bpdi = bi + di;
+	VT bmdr = br - dr, bmdi = bi - di;
+	ar = apcr + bpdr;
+	ai = apci + bpdi;
+	// (a - c) -/+ j (b - d)
+	VT t1r = amcr + bmdi, t1i = amci - bmdr;
+	VT t2r = apcr - bpdr, t2i = apci - bpdi;
+	VT t3r = amcr - bmdi, t3i = amci + bmdr;
+	if ( twiddle )
+	{
+		br = fms( t1r, w1r, t1i * w1i );
+		bi = fma( t1r, w1i, t1i * w1r );
+		cr = fms( t2r, w2r, t2i * w2i );
+		ci = fma( t2r, w2i, t2i * w2r );
+		dr = fms( t3r, w3r, t3i * w3i );
+		di = fma( t3r, w3i, t3i * w3r );
+	}
+	else
+	{
+		br = t1r; bi = t1i;
+		cr = t2r; ci = t2i;
+		dr = t3r; di = t3i;
+	}
+}
+
+/// @brief the scalar radix-4 Stockham pass for the sub length 4 m at
+/// stride s, with the m twiddles each of w1, w2, w3 in tw (only used
+/// for sizes below a few vectors, which have no per lane twiddles)
+template <typename T>
+inline void fft_pass4_scalar( T *yr, T *yi, const T *xr, const T *xi, size_t s, size_t m,
+							  const T *twr, const T *twi )
+{
+	const size_t sm = s * m;
+	for ( size_t p = 0; p != m; ++p )
+	{
+		T w1r = twr[p], w1i = twi[p];
+		T w2r = twr[m + p], w2i = twi[m + p];
+		T w3r = twr[2 * m + p], w3i = twi[2 * m + p];
+		for ( size_t q = 0; q != s; ++q )
+		{
+			size_t i = q + s * p;
+			T ar = xr[i], ai = xi[i];
+			T br = xr[i + sm], bi = xi[i + sm];
+			T cr = xr[i + 2 * sm], ci = xi[i + 2 * sm];
+			T dr = xr[i + 3 * sm], di = xi[i + 3 * sm];
+			T apcr = ar + cr, apci = ai + ci, amcr = ar - cr, amci = ai - ci;
+			T bpdr = br + dr, bpdi = bi + di, bmdr = br - dr, bmdi = bi - di;
+			T t1r = amcr + bmdi, t1i = amci - bmdr;
+			T t2r = apcr - bpdr, t2i = apci - bpdi;
+			T t3r = amcr - bmdi, t3i = amci + bmdr;
+			size_t o = q + s * 4 * p;
+			yr[o] = apcr + bpdr;
+			yi[o] = apci + bpdi;
+			yr[o + s] = t1r * w1r - t1i * w1i;
+			yi[o + s] = t1r * w1i + t1i * w1r;
+			yr[o + 2 * s] = t2r * w2r - t2i * w2i;
+			yi[o + 2 * s] = t2r * w2i + t2i * w2r;
+			yr[o + 3 * s] = t3r * w3r - t3i * w3i;
+			yi[o + 3 * s] = t3r * w3i + t3i * w3r;
+		}
+	}
+}
+
+/// @brief the radix-4 pass with the vectors over the stride s, which
+/// is a whole number of vectors
+template <typename T>
+inline void fft_pass4_stride( T *yr, T *yi, const T *xr, const T *xi, size_t s, size_t m,
+							  const T *twr, const T *twi )
+{
+	typedef fft_types<T> ft;
+	typedef typename ft::vec_type VT;
+	const size_t L = size_t( VT::value_count );
+	const size_t sm = s * m;
+	for ( size_t p = 0; p != m; ++p )
+	{
+		VT w1r( twr[p] ), w1i( twi[p] );
+		VT w2r( twr[m + p] ), w2i( twi[m + p] );
+		VT w3r( twr[2 * m + p] ), w3i( twi[2 * m + p] );
+		for ( size_t q = 0; q != s; q += L )
+		{
+			size_t i = q + s * p;
+			VT ar = ft::load_vec( xr + i ), ai = ft::load_vec( xi + i );
+			VT br = ft::load_vec( xr + i + sm ), bi = ft::load_vec( xi + i + sm );
+			VT cr = ft::load_vec( xr + i + 2 * sm ), ci = ft::load_vec( xi + i + 2 * sm );
+			VT dr = ft::load_vec( xr + i + 3 * sm ), di = ft::load_vec( xi + i + 3 * sm );
+			// the first twiddles are all 1
+			if ( p == 0 )
+				fft_butterfly4<false>( ar, ai, br, bi, cr, ci, dr, di, w1r, w1i, w2r, w2i, w3r, w3i );
+			else
+				fft_butterfly4<true>( ar, ai, br, bi, cr, ci, dr, di, w1r, w1i, w2r, w2i, w3r, w3i );
+			size_t o = q + s * 4 * p;
+			store( yr + o, ar ); store( yi + o, ai );
+			store( yr + o + s, br ); store( yi + o + s, bi );
+			store( yr + o + 2 * s, cr ); store( yi + o + 2 * s, ci );
+			store( yr + o + 3 * s, dr ); store( yi + o + 3 * s, di );
+		}
+	}
+}
+
+/// @brief the radix-4 pass for a stride s less than a vector, with the
+/// vectors over consecutive butterflies and the twiddles per lane
+template <typename T>
+inline void fft_pass4_lanes( T *yr, T *yi, const T *xr, const T *xi, size_t s, size_t m,
+							 const T *twr, const T *twi )
+{
+	typedef fft_types<T> ft;
+	typedef typename ft::vec_type VT;
+	const int L = VT::value_count;
+	const size_t sm = s * m;
+	for ( size_t i = 0; i != sm; i += size_t( L ) )
+	{
+		VT ar = ft::load_vec( xr + i ), ai = ft::load_vec( xi + i );
+		VT br = ft::load_vec( xr + i + sm ), bi = ft::load_vec( xi + i + sm );
+		VT cr = ft::load_vec( xr + i + 2 * sm ), ci = ft::load_vec( xi + i + 2 * sm );
+		VT dr = ft::load_vec( xr + i + 3 * sm ), di = ft::load_vec( xi + i + 3 * sm );
+		fft_butterfly4<true>( ar, ai, br, bi, cr, ci, dr, di,
+							  ft::load_vec( twr + i ), ft::load_vec( twi + i ),
+							  ft::load_vec( twr + sm + i ), ft::load_vec( twi + sm + i ),
+							  ft::load_vec( twr + 2 * sm + i ), ft::load_vec( twi + 2 * sm + i ) );
+		if ( s == 1 )
+		{
+			ft::interleave4( yr + 4 * i, ar, br, cr, dr );
+			ft::interleave4( yi + 4 * i, ai, bi, ci, di );
+		}
+		else
+		{
+			// each run of s lanes is one butterfly, with its 4 outputs
+			// s apart
+			PAL_ALIGN_256 T tr[4][L], ti[4][L];
+			store( tr[0], ar ); store( ti[0], ai );
+			store( tr[1], br ); store( ti[1], bi );
+			store( tr[2], cr ); store( ti[2], ci );
+			store( tr[3], dr ); store( ti[3], di );
+			for ( size_t g = 0; g < size_t( L ); g += s )
+			{
+				size_t o = 4 * ( i + g );
+				for ( int k = 0; k != 4; ++k )
+				{
+					std::memcpy( yr + o + size_t( k ) * s, tr[k] + g, s * sizeof(T) );
+					std::memcpy( yi + o + size_t( k ) * s, ti[k] + g, s * sizeof(T) );
+				}
+			}
+		}
+	}
+}
+
+/// @brief the final radix-2 pass, at stride s = n / 2
+template <typename T>
+inline void fft_pass2( T *yr, T *yi, const T *xr, const T *xi, size_t s )
+{
+	typedef fft_types<T> ft;
+	typedef typename ft::vec_type VT;
+	const size_t L = size_t( VT::value_count );
+	size_t q = 0;
+	if ( s >= L )
+	{
+		for ( ; q != s; q += L )
+		{
+			VT ar = ft::load_vec( xr + q ), ai = ft::load_vec( xi + q );
+			VT br = ft::load_vec( xr + q + s ), bi = ft::load_vec( xi + q + s );
+			store( yr + q, ar + br ); store( yi + q, ai + bi );
+			store( yr + q + s, ar - br ); store( yi + q + s, ai - bi );
+		}
+	}
+	for ( ; q != s; ++q )
+	{
+		T ar = xr[q], ai = xi[q], br = xr[q + s], bi = xi[q + s];
+		yr[q] = ar + br; yi[q] = ai + bi;
+		yr[q + s] = ar - br; yi[q + s] = ai - bi;
+	}
+}
+
+/// @brief out[c][r] = in[r][c] for the rows x cols matrix in, both
+/// multiples of the vector size, in blocks small enough that both
+/// sides stay in cache
+template <typename T>
+inline void fft_transpose( T *out, const T *in, size_t rows, size_t cols )
+{
+	typedef fft_types<T> ft;
+	const size_t L = size_t( ft::vec_type::value_count );
+	const size_t B = 32;
+	for ( size_t r0 = 0; r0 < rows; r0 += B )
+	{
+		const size_t r1 = std::min( rows, r0 + B );
+		for ( size_t c0 = 0; c0 < cols; c0 += B )
+		{
+			const size_t c1 = std::min( cols, c0 + B );
+			for ( size_t r = r0; r != r1; r += L )
+				for ( size_t c = c0; c != c1; c += L )
+					ft::transpose_tile( out + c * rows + r, rows, in + r * cols + c, cols );
+		}
+	}
+}
+
+} // namespace detail
+
+////////////////////////////////////////
+
+/// @brief plan for complex FFTs of size n, a power of two, of float or
+/// double data
+///
+/// The transforms are unnormalized, so inverse( forward( x ) ) is n x.
+/// If n is not a power of two, the plan is empty (size() is 0) and the
+/// transforms do nothing. Sizes past blocked use the four step
+/// algorithm, lowering it is only useful to test that path on small
+/// sizes (from 64 on, so the matrix sides hold whole vectors).
+template <typename T>
+class fft_plan
+{
+public:
+	explicit fft_plan( size_t n, size_t blocked = detail::kFftBlocked )
+		: _n( ( n != 0 && ( n & ( n - 1 ) ) == 0 ) ? n : 0 ), _n1( 0 ), _n2( 0 )
+	{
+		if ( _n == 0 )
+			return;
+		_wr.resize( _n );
+		_wi.resize( _n );
+		if ( _n > blocked && _n >= 64 )
+			init_blocked();
+		else
+			init_passes();
+	}
+
+	size_t size( void ) const { return _n; }
+
+	/// @brief forward transform of the n values in re, im in place
+	/// (with the exponent -2 pi i j k / n)
+	void forward( T *re, T *im )
+	{
+		if ( _n == 0 )
+			return;
+		if ( _n1 != 0 )
+			forward_blocked( re, im );
+		else
+			forward_passes( re, im );
+	}
+
+	/// @brief inverse transform in place (with the exponent +2 pi i j k
+	/// / n), without the 1 / n scale
+	void inverse( T *re, T *im )
+	{
+		// swapping the real and imaginary parts conjugates the
+		// transform
+		forward( im, re );
+	}
+
+private:
+	struct pass
+	{
+		size_t s;
+		size_t m;
+		size_t tw;
+		size_t twlen;
+	};
+
+	void init_passes( void )
+	{
+		const size_t L = size_t( detail::fft_types<T>::vec_type::value_count );
+		_vector = _n >= 4 * L;
+		size_t s = 1;
+		for ( size_t len = _n; len >= 4; len /= 4, s *= 4 )
+		{
+			pass ps;
+			ps.s = s;
+			ps.m = len / 4;
+			ps.tw = _twr.size();
+			// the short strides have the twiddles repeated for each lane
+			ps.twlen = ( _vector && s < L ) ? ps.m * s : ps.m;
+			const size_t rep = ps.twlen / ps.m;
+			for ( size_t k = 1; k <= 3; ++k )
+			{
+				for ( size_t p = 0; p != ps.m; ++p )
+				{
+					double a = -2.0 * 3.14159265358979323846 * double( k * p ) / double( len );
+					for ( size_t r = 0; r != rep; ++r )
+					{
+						_twr.push_back( T( std::cos( a ) ) );
+						_twi.push_back( T( std::sin( a ) ) );
+					}
+				}
+			}
+			_passes.push_back( ps );
+		}
+		_radix2 = ( ( _n / s ) == 2 );
+	}
+
+	void forward_passes( T *re, T *im )
+	{
+		const size_t L = size_t( detail::fft_types<T>::vec_type::value_count );
+		T *xr = re, *xi = im, *yr = _wr.data(), *yi = _wi.data();
+		for ( const pass &ps: _passes )
+		{
+			const T *twr = _twr.data() + ps.tw, *twi = _twi.data() + ps.tw;
+			if ( ! _vector )
+				detail::fft_pass4_scalar( yr, yi, xr, xi, ps.s, ps.m, twr, twi );
+			else if ( ps.s >= L )
+				detail::fft_pass4_stride( yr, yi, xr, xi, ps.s, ps.m, twr, twi );
+			else
+				detail::fft_pass4_lanes( yr, yi, xr, xi, ps.s, ps.m, twr, twi );
+			std::swap( xr, yr );
+			std::swap( xi, yi );
+		}
+		if ( _radix2 )
+		{
+			detail::fft_pass2( yr, yi, xr, xi, _n / 2 );
+			std::swap( xr, yr );
+			std::swap( xi, yi );
+		}
+		if ( xr != re )
+		{
+			std::copy( xr, xr + _n, re );
+			std::copy( xi, xi + _n, im );
+		}
+	}
+
+	void init_blocked( void )
+	{
+		size_t lg = 0;
+		while ( ( size_t(1) << lg ) < _n )
+			++lg;
+		_n1 = size_t(1) << ( lg / 2 );
+		_n2 = _n / _n1;
+		_p1.reset( new fft_plan( _n1 ) );
+		if ( _n2 != _n1 )
+			_p2.reset( new fft_plan( _n2 ) );
+		// the twiddles of the transposed rows, W^( j2 k1 )
+		_twr.resize( _n );
+		_twi.resize( _n );
+		for ( size_t j2 = 0; j2 != _n2; ++j2 )
+		{
+			for ( size_t k1 = 0; k1 != _n1; ++k1 )
+			{
+				double a = -2.0 * 3.14159265358979323846 * double( ( j2 * k1 ) % _n ) / double( _n );
+				_twr[j2 * _n1 + k1] = T( std::cos( a ) );
+				_twi[j2 * _n1 + k1] = T( std::sin( a ) );
+			}
+		}
+	}
+
+	void forward_blocked( T *re, T *im )
+	{
+		typedef detail::fft_types<T> ft;
+		typedef typename ft::vec_type VT;
+		const size_t L = size_t( VT::value_count );
+		fft_plan &p2 = _p2 ? *_p2 : *_p1;
+		// x is n1 rows of n2, the columns are transformed as the rows
+		// of the transpose
+		detail::fft_transpose( _wr.data(), re, _n1, _n2 );
+		detail::fft_transpose( _wi.data(), im, _n1, _n2 );
+		for ( size_t j2 = 0; j2 != _n2; ++j2 )
+		{
+			T *r = _wr.data() + j2 * _n1, *i = _wi.data() + j2 * _n1;
+			_p1->forward( r, i );
+			const T *twr = _twr.data() + j2 * _n1, *twi = _twi.data() + j2 * _n1;
+			for ( size_t k = 0; k < _n1; k += L )
+			{
+				VT xr = ft::load_vec( r + k ), xi = ft::load_vec( i + k );
+				VT wr = ft::load_vec( twr + k ), wi = ft::load_vec( twi + k );
+				store( r + k, fms( xr, wr, xi * wi ) );
+				store( i + k, fma( xr, wi, xi * wr ) );
+			}
+		}
+		detail::fft_transpose( re, _wr.data(), _n2, _n1 );
+		detail::fft_transpose( im, _wi.data(), _n2, _n1 );
+		for ( size_t k1 = 0; k1 != _n1; ++k1 )
+			p2.forward( re + k1 * _n2, im + k1 * _n2 );
+		// X[k1 + n1 k2] is at row k1, column k2
+		detail::fft_transpose( _wr.data(), re, _n1, _n2 );
+		detail::fft_transpose( _wi.data(), im, _n1, _n2 );
+		std::copy( _wr.begin(), _wr.end(), re );
+		std::copy( _wi.begin(), _wi.end(), im );
+	}
+
+	size_t _n;
+	std::vector<pass> _passes;
+	std::vector<T> _twr;
+	std::vector<T> _twi;
+	std::vector<T> _wr;
+	std::vector<T> _wi;
+	bool _vector = false;
+	bool _radix2 = false;
+	size_t _n1;
+	size_t _n2;
+	std::unique_ptr<fft_plan> _p1;
+	std::unique_ptr<fft_plan> _p2;
+};
+
+////////////////////////////////////////
+
+/// @brief plan for FFTs of n real values, n a power of two of at least
+/// 2, giving the n / 2 + 1 complex values of the non-negative
+/// frequencies (the rest are their conjugates)
+///
+/// The n values are transformed as n / 2 complex values, which are
+/// then separated into the transforms of the even and odd values and
+/// combined.
+template <typename T>
+class real_fft_plan
+{
+public:
+	explicit real_fft_plan( size_t n )
+		: _n( ( n >= 2 && ( n & ( n - 1 ) ) == 0 ) ? n : 0 ), _half( _n / 2 )
+	{
+		const size_t h = _n / 2;
+		_wr.resize( h );
+		_wi.resize( h );
+		for ( size_t k = 0; k != h; ++k )
+		{
+			double a = -2.0 * 3.14159265358979323846 * double( k ) / double( _n );
+			_wr[k] = T( std::cos( a ) );
+			_wi[k] = T( std::sin( a ) );
+		}
+		_zr.resize( h );
+		_zi.resize( h );
+	}
+
+	size_t size( void ) const { return _n; }
+
+	/// @brief transforms the n values of in, writing the n / 2 + 1
+	/// complex values to re, im
+	void forward( T *re, T *im, const T *in )
+	{
+		const size_t h = _n / 2;
+		if ( h == 0 )
+			return;
+		for ( size_t k = 0; k != h; ++k )
+		{
+			re[k] = in[2 * k];
+			im[k] = in[2 * k + 1];
+		}
+		_half.forward( re, im );
+
+		T z0r = re[0], z0i = im[0];
+		re[0] = z0r + z0i;
+		im[0] = T(0);
+		re[h] = z0r - z0i;
+		im[h] = T(0);
+		combine<false>( re, im, re, im );
+	}
+
+	/// @brief inverse of forward, from the n / 2 + 1 complex values of
+	/// re, im to the n values of out, without the 1 / n scale
+	void inverse( T *out, const T *re, const T *im )
+	{
+		const size_t h = _n / 2;
+		if ( h == 0 )
+			return;
+		T *zr = _zr.data(), *zi = _zi.data();
+		zr[0] = re[0] + re[h];
+		zi[0] = re[0] - re[h];
+		combine<true>( zr, zi, re, im );
+		_half.inverse( zr, zi );
+		for ( size_t k = 0; k != h; ++k )
+		{
+			out[2 * k] = zr[k];
+			out[2 * k + 1] = zi[k];
+		}
+	}
+
+private:
+	/// @brief the pairs k, h - k for k in [1, h / 2]
+	///
+	/// forward, with E = ( Z[k] + Z*[h-k] ) / 2 and O = -i / 2 ( Z[k] -
+	/// Z*[h-k] ): X[k] = E + W^k O, X[h-k] = ( E - W^k O )*
+	///
+	/// inverse, with E = X[k] + X*[h-k] and Q = W^-k ( X[k] - X*[h-k] ):
+	/// Z[k] = E + i Q, Z[h-k] = ( E - i Q )*
+	template <bool inv>
+	void combine( T *outr, T *outi, const T *inr, const T *ini )
+	{
+		typedef detail::fft_types<T> ft;
+		typedef typename ft::vec_type VT;
+		const size_t L = size_t( VT::value_count );
+		const size_t h = _n / 2;
+		const T half = inv ? T(1) : T(0.5);
+		size_t k = 1;
+		// vectors of k from the front and of h - k from the back, until
+		// they meet
+		for ( ; ( k + L ) <= ( h / 2 ); k += L )
+		{
+			const size_t b = h - k - ( L - 1 );
+			VT ar = ft::load_vec( inr + k ), ai = ft::load_vec( ini + k );
+			VT br = ft::reverse( ft::load_vec( inr + b ) ), bi = ft::reverse( ft::load_vec( ini + b ) );
+			VT wr = ft::load_vec( _wr.data() + k ), wi = ft::load_vec( _wi.data() + k );
+			VT xr, xi, yr, yi;
+			combine_pair<inv>( xr, xi, yr, yi, ar, ai, br, bi, wr, wi, VT( half ) );
+			store( outr + k, xr );
+			store( outi + k, xi );
+			store( outr + b, ft::reverse( yr ) );
+			store( outi + b, ft::reverse( yi ) );
+		}
+		for ( ; k <= h / 2; ++k )
+		{
+			T xr, xi, yr, yi;
+			combine_pair<inv>( xr, xi, yr, yi, inr[k], ini[k], inr[h - k], ini[h - k],
+							   _wr[k], _wi[k], half );
+			outr[k] = xr;
+			outi[k] = xi;
+			outr[h - k] = yr;
+			outi[h - k] = yi;
+		}
+	}
+
+	template <bool inv, typename V>
+	static PAL_INLINE void combine_pair( V &xr, V &xi, V &yr, V &yi, V ar, V ai, V br, V bi,
+										 V wr, V wi, V half )
+	{
+		// E and D = a - b* (times a half going forward)
+		V er = ( ar + br ) * half, ei = ( ai - bi ) * half;
+		V dr = ( ar - br ) * half, di = ( ai + bi ) * half;
+		if ( inv )
+		{
+			// Q = W* D, Z[k] = E + i Q
+			V qr = dr * wr + di * wi, qi = di * wr - dr * wi;
+			xr = er - qi;
+			xi = ei + qr;
+			yr = er + qi;
+			yi = qr - ei;
+		}
+		else
+		{
+			// O = -i D, W O
+			V orr = di, oi = -dr;
+			V tr = orr * wr - oi * wi, ti = orr * wi + oi * wr;
+			xr = er + tr;
+			xi = ei + ti;
+			yr = er - tr;
+			yi = ti - ei;
+		}
+	}
+
+	size_t _n;
+	fft_plan<T> _half;
+	std::vector<T> _wr;
+	std::vector<T> _wi;
+	std::vector<T> _zr;
+	std::vector<T> _zi;
+};
+
+} // namespace pal
+
+#endif // _PAL_BUFFER_FFT_H_
@@ -0,0 +1,274 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use pal/buffer_fir.h directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_BUFFER_FIR_H_
+# define _PAL_BUFFER_FIR_H_ 1
+
+// FIR filtering of float streams, y[t] = sum_k h[k] * x[t - k].
+//
+// The vectors run over consecutive output samples: each tap is
+// broadcast and multiplied into several accumulator registers of
+// outputs with fma, loading the inputs unaligned. Symmetric (linear
+// phase) taps are detected and folded, adding the two inputs sharing
+// a tap to halve the multiplies. Decimating filters split the input
+// into its polyphase components, so each sub-filter still reads
+// contiguous inputs and only the kept outputs are computed.
+//
+// fir_filter keeps the last ntaps - 1 inputs between calls so a long
+// stream can be processed in blocks of any size.
+
+namespace PAL_NAMESPACE
+{
+
+namespace detail
+{
+
+#ifdef PAL_HAS_FVEC8
+typedef fvec8 fir_vec;
+PAL_INLINE fir_vec fir_load( const float *in ) { return load8f( in ); }
+#else
+typedef fvec4 fir_vec;
+PAL_INLINE fir_vec fir_load( const float *in ) { return load4f( in ); }
+#endif
+
+static const size_t kFirChunk = 8192;
+
+/// @brief out[m] (+)= sum_j h[j] * x[m + j] for m in [0, n)
+template <bool accumulate>
+inline void fir_correlate( float *out, const float *x, size_t n, const float *h, size_t nh )
+{
+	typedef fir_vec VT;
+	const size_t L = size_t( VT::value_count );
+	size_t i = 0;
+	for ( ; ( i + 4 * L ) <= n; i += 4 * L )
+	{
+		const float *p = x + i;
+		VT a0 = accumulate ? fir_load( out + i ) : VT::zero();
+		VT a1 = accumulate ? fir_load( out + i + L ) : VT::zero();
+		VT a2 = accumulate ? fir_load( out + i + 2 * L ) : VT::zero();
+		VT a3 = accumulate ? fir_load( out + i + 3 * L ) : VT::zero();
+		for ( size_t j = 0; j != nh; ++j, ++p )
+		{
+			VT t( h[j] );
+			a0 = fma( t, fir_load( p ), a0 );
+			a1 = fma( t, fir_load( p + L ), a1 );
+			a2 = fma( t, fir_load( p + 2 * L ), a2 );
+			a3 = fma( t, fir_load( p + 3 * L ), a3 );
+		}
+		store( out + i, a0 );
+		store( out + i + L, a1 );
+		store( out + i + 2 * L, a2 );
+		store( out + i + 3 * L, a3 );
+	}
+	for ( ; ( i + L ) <= n; i += L )
+	{
+		VT a = accumulate ? fir_load( out + i ) : VT::zero();
+		for ( size_t j = 0; j != nh; ++j )
+			a = fma( VT( h[j] ), fir_load( x + i + j ), a );
+		store( out + i, a );
+	}
+	for ( ; i < n; ++i )
+	{
+		float a = accumulate ? out[i] : 0.F;
+		for ( size_t j = 0; j != nh; ++j )
+			a += h[j] * x[i + j];
+		out[i] = a;
+	}
+}
+
+/// @brief out[m] = sum_j h[j] * x[m + j] for m in [0, n), where the
+/// nh taps are symmetric, h[j] == h[nh - 1 - j]
+inline void fir_correlate_symmetric( float *out, const float *x, size_t n, const float *h, size_t nh )
+{
+	typedef fir_vec VT;
+	const size_t L = size_t( VT::value_count );
+	const size_t half = nh / 2;
+	const bool odd = ( nh & 1 ) != 0;
+	size_t i = 0;
+	for ( ; ( i + 4 * L ) <= n; i += 4 * L )
+	{
+		const float *p = x + i, *q = x + i + nh - 1;
+		VT a0 = VT::zero(), a1 = VT::zero(), a2 = VT::zero(), a3 = VT::zero();
+		for ( size_t j = 0; j != half; ++j, ++p, --q )
+		{
+			VT t( h[j] );
+			a0 = fma( t, fir_load( p ) + fir_load( q ), a0 );
+			a1 = fma( t, fir_load( p + L ) + fir_load( q + L ), a1 );
+			a2 = fma( t, fir_load( p + 2 * L ) + fir_load( q + 2 * L ), a2 );
+			a3 = fma( t, fir_load( p + 3 * L ) + fir_load( q + 3 * L ), a3 );
+		}
+		if ( odd )
+		{
+			VT t( h[half] );
+			a0 = fma( t, fir_load( p ), a0 );
+			a1 = fma( t, fir_load( p + L ), a1 );
+			a2 = fma( t, fir_load( p + 2 * L ), a2 );
+			a3 = fma( t, fir_load( p + 3 * L ), a3 );
+		}
+		store( out + i, a0 );
+		store( out + i + L, a1 );
+		store( out + i + 2 * L, a2 );
+		store( out + i + 3 * L, a3 );
+	}
+	if ( i < n )
+		fir_correlate<false>( out + i, x + i, n - i, h, nh );
+}
+
+} // namespace detail
+
+////////////////////////////////////////
+
+/// @brief streaming FIR filter, optionally decimating
+///
+/// With a decimation of D, only the outputs at input times t (counted
+/// from the first sample after construction or reset) with t % D == 0
+/// are produced.
+class fir_filter
+{
+public:
+	fir_filter( const float *taps, size_t ntaps, size_t decimation = 1 )
+		: _ntaps( ntaps ), _dec( std::max( decimation, size_t(1) ) ), _skip( 0 ), _sym( false )
+	{
+		// the inputs are read forwards, so the taps are stored reversed
+		_rev.assign( taps, taps + ntaps );
+		std::reverse( _rev.begin(), _rev.end() );
+		if ( _dec == 1 )
+		{
+			_sym = ntaps > 1;
+			for ( size_t k = 0; k < ntaps / 2; ++k )
+				_sym = _sym && taps[k] == taps[ntaps - 1 - k];
+		}
+		else
+		{
+			// sub-filter r holds the reversed taps r, r + D, ...
+			_poly.reserve( ntaps );
+			for ( size_t r = 0; r != _dec; ++r )
+			{
+				_polyStart.push_back( _poly.size() );
+				for ( size_t j = r; j < ntaps; j += _dec )
+					_poly.push_back( _rev[j] );
+			}
+			_polyStart.push_back( _poly.size() );
+		}
+		reset();
+	}
+
+	/// @brief clears the history, as if the stream was preceded by zeros
+	void reset( void )
+	{
+		_buf.assign( history(), 0.F );
+		_skip = 0;
+	}
+
+	size_t taps( void ) const { return _ntaps; }
+	size_t decimation( void ) const { return _dec; }
+	/// @brief true if the taps were found to be symmetric (only checked
+	/// without decimation)
+	bool symmetric( void ) const { return _sym; }
+
+	/// @brief number of outputs the next n inputs produce
+	size_t output_count( size_t n ) const
+	{
+		return n > _skip ? ( n - _skip + _dec - 1 ) / _dec : 0;
+	}
+
+	/// @brief filters the next n inputs of the stream, writing
+	/// output_count( n ) values to out and returning that count
+	size_t process( float *out, const float *in, size_t n )
+	{
+		size_t nout = 0;
+		for ( size_t b = 0; b < n; b += detail::kFirChunk )
+			nout += process_chunk( out + nout, in + b, std::min( n - b, detail::kFirChunk ) );
+		return nout;
+	}
+
+private:
+	size_t history( void ) const { return _ntaps > 0 ? _ntaps - 1 : 0; }
+
+	size_t process_chunk( float *out, const float *in, size_t c )
+	{
+		const size_t h = history();
+		_buf.resize( h + c );
+		std::copy( in, in + c, _buf.begin() + std::ptrdiff_t( h ) );
+
+		size_t nout = output_count( c );
+		if ( nout > 0 )
+		{
+			// the window of the output for input j starts at _buf[j]
+			const float *x = _buf.data() + _skip;
+			if ( _ntaps == 0 )
+				std::fill( out, out + nout, 0.F );
+			else if ( _dec == 1 )
+			{
+				if ( _sym )
+					detail::fir_correlate_symmetric( out, x, nout, _rev.data(), _ntaps );
+				else
+					detail::fir_correlate<false>( out, x, nout, _rev.data(), _ntaps );
+			}
+			else
+				decimate( out, x, nout );
+			_skip += nout * _dec;
+		}
+		_skip -= std::min( _skip, c );
+
+		std::copy( _buf.end() - std::ptrdiff_t( h ), _buf.end(), _buf.begin() );
+		_buf.resize( h );
+		return nout;
+	}
+
+	// out[m] = sum_j rev[j] * x[m D + j], with j = q D + r each phase r
+	// is a correlation of the sub-filter with x[s D + r]
+	void decimate( float *out, const float *x, size_t nout )
+	{
+		const size_t D = _dec;
+		const size_t maxq = _polyStart[1] - _polyStart[0];
+		const size_t plen = nout + maxq;
+		_phase.resize( plen );
+		for ( size_t r = 0; r != D; ++r )
+		{
+			const float *sub = _poly.data() + _polyStart[r];
+			size_t nq = _polyStart[r + 1] - _polyStart[r];
+			if ( nq == 0 )
+				continue;
+			size_t len = nout + nq - 1;
+			for ( size_t s = 0; s != len; ++s )
+				_phase[s] = x[s * D + r];
+			if ( r == 0 )
+				detail::fir_correlate<false>( out, _phase.data(), nout, sub, nq );
+			else
+				detail::fir_correlate<true>( out, _phase.data(), nout, sub, nq );
+		}
+	}
+
+	std::vector<float> _rev;
+	std::vector<float> _poly;
+	std::vector<size_t> _polyStart;
+	std::vector<float> _buf;
+	std::vector<float> _phase;
+	size_t _ntaps;
+	size_t _dec;
+	size_t _skip;
+	bool _sym;
+};
+
+////////////////////////////////////////
+
+/// @brief filters n inputs with the taps, treating the inputs before
+/// the start as zero, writing n outputs
+inline void fir( float *out, const float *in, size_t n, const float *taps, size_t ntaps )
+{
+	fir_filter f( taps, ntaps );
+	f.process( out, in, n );
+}
+
+} // namespace pal
+
+#endif // _PAL_BUFFER_FIR_H_
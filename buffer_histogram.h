@@ -0,0 +1,283 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use pal/buffer_histogram.h directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_BUFFER_HISTOGRAM_H_
+# define _PAL_BUFFER_HISTOGRAM_H_ 1
+
+// histograms of 8 / 16-bit integer and float buffers.
+//
+// Incrementing a single table stalls whenever neighbouring values land
+// in the same bin, as each increment waits on the store of the one
+// before. Consecutive values are instead counted into one of 4
+// sub-histograms in turn, which are summed with vector adds at the
+// end. Float values are binned with vector scaling and truncation,
+// values outside [lo, hi) (and NaN, into the first bin) are clamped
+// to the end bins. Integer values past the last bin count in the last
+// bin. Any number of 16-bit bins may be used, past 65536 the extra
+// bins stay 0.
+//
+// Each function overwrites the nbins counts in bins (none for 0
+// bins). The nthreads argument splits the work across threads (0
+// uses all hardware threads), each with its own sub-histograms. The
+// float bin indices are computed in int32, so the float histograms
+// take fewer than 2^31 bins (nx * ny for histogram2d), and leave bins
+// untouched otherwise.
+
+namespace PAL_NAMESPACE
+{
+
+namespace detail
+{
+
+static const int kHistogramSubs = 4;
+static const size_t kHistogramMinChunk = size_t(1) << 16;
+
+/// @brief sums the nsub tables of nbins counts, laid out one after
+/// another, into bins
+inline void
+histogram_merge( uint32_t *bins, const uint32_t *sub, size_t nbins, size_t nsub )
+{
+	// the counts are summed modulo 2^32, the same as signed adds
+	int32_t *out = reinterpret_cast<int32_t *>( bins );
+	const int32_t *in = reinterpret_cast<const int32_t *>( sub );
+	size_t i = 0, nvec = nbins & ~size_t(3);
+	for ( ; i != nvec; i += 4 )
+	{
+		lvec4 acc = load( in + i );
+		for ( size_t s = 1; s < nsub; ++s )
+			acc = acc + load( in + s * nbins + i );
+		store( out + i, acc );
+	}
+	for ( ; i < nbins; ++i )
+	{
+		uint32_t acc = 0;
+		for ( size_t s = 0; s < nsub; ++s )
+			acc += sub[s * nbins + i];
+		bins[i] = acc;
+	}
+}
+
+/// @brief counts n indices from idx into the 4 sub-histograms
+PAL_INLINE void
+histogram_count( uint32_t *sub, size_t nbins, const int32_t *idx, size_t n )
+{
+	size_t i = 0;
+	for ( ; ( i + 4 ) <= n; i += 4 )
+	{
+		++sub[idx[i]];
+		++sub[nbins + size_t( idx[i + 1] )];
+		++sub[2 * nbins + size_t( idx[i + 2] )];
+		++sub[3 * nbins + size_t( idx[i + 3] )];
+	}
+	for ( ; i < n; ++i )
+		++sub[idx[i]];
+}
+
+/// @brief float to bin index conversion, clamped to [0, nbins)
+struct histogram_binner
+{
+	float lo, scale, top;
+
+	histogram_binner( size_t nbins, float l, float h )
+		: lo( l ), scale( float( nbins ) / ( h - l ) ), top( nbins > 0 ? float( nbins - 1 ) : 0.F )
+	{}
+
+	// max first so NaN becomes 0, then the clamp avoids the
+	// conversion overflowing
+	template <typename VT>
+	PAL_INLINE typename VT::int_vec_type operator()( VT v ) const
+	{
+		VT f = min( max( ( v - VT( lo ) ) * VT( scale ), VT::zero() ), VT( top ) );
+		return f.convert_to_int_trunc();
+	}
+
+	PAL_INLINE int32_t operator()( float v ) const
+	{
+		return operator()( fvec4( v ) )[0];
+	}
+};
+
+/// @brief computes the bin indices for count values, at most 8
+template <typename F>
+PAL_INLINE void
+histogram_index( int32_t *idx, const float *in, size_t count, const F &bin )
+{
+	size_t i = 0;
+#ifdef PAL_HAS_FVEC8
+	if ( count == 8 )
+	{
+		store( idx, bin( load8f( in ) ) );
+		return;
+	}
+#endif
+	for ( ; ( i + 4 ) <= count; i += 4 )
+		store( idx + i, bin( load4f( in + i ) ) );
+	for ( ; i < count; ++i )
+		idx[i] = bin( in[i] );
+}
+
+#ifdef PAL_HAS_FVEC8
+static const size_t kHistogramBlock = 8;
+#else
+static const size_t kHistogramBlock = 4;
+#endif
+
+inline void
+histogram_chunk( uint32_t *sub, size_t nbins, const uint8_t *in, size_t n )
+{
+	size_t i = 0;
+	for ( ; ( i + 8 ) <= n; i += 8 )
+	{
+		uint64_t w;
+		std::memcpy( &w, in + i, 8 );
+		++sub[w & 0xFF];
+		++sub[nbins + ( ( w >> 8 ) & 0xFF )];
+		++sub[2 * nbins + ( ( w >> 16 ) & 0xFF )];
+		++sub[3 * nbins + ( ( w >> 24 ) & 0xFF )];
+		++sub[( w >> 32 ) & 0xFF];
+		++sub[nbins + ( ( w >> 40 ) & 0xFF )];
+		++sub[2 * nbins + ( ( w >> 48 ) & 0xFF )];
+		++sub[3 * nbins + ( w >> 56 )];
+	}
+	for ( ; i < n; ++i )
+		++sub[in[i]];
+}
+
+inline void
+histogram_chunk( uint32_t *sub, size_t nbins, const uint16_t *in, size_t n )
+{
+	// in size_t, so more than 65536 bins do not truncate the top
+	const size_t top = nbins - 1;
+	size_t i = 0;
+	for ( ; ( i + 4 ) <= n; i += 4 )
+	{
+		++sub[std::min<size_t>( in[i], top )];
+		++sub[nbins + std::min<size_t>( in[i + 1], top )];
+		++sub[2 * nbins + std::min<size_t>( in[i + 2], top )];
+		++sub[3 * nbins + std::min<size_t>( in[i + 3], top )];
+	}
+	for ( ; i < n; ++i )
+		++sub[std::min<size_t>( in[i], top )];
+}
+
+inline void
+histogram_chunk( uint32_t *sub, size_t nbins, const float *in, size_t n, const histogram_binner &bin )
+{
+	const size_t B = kHistogramBlock;
+	PAL_ALIGN_256 int32_t idx[B];
+	size_t i = 0;
+	for ( ; ( i + B ) <= n; i += B )
+	{
+		histogram_index( idx, in + i, B, bin );
+		histogram_count( sub, nbins, idx, B );
+	}
+	histogram_index( idx, in + i, n - i, bin );
+	histogram_count( sub, nbins, idx, n - i );
+}
+
+inline void
+histogram2d_chunk( uint32_t *sub, size_t nx, size_t nbins, const float *x, const float *y, size_t n,
+				   const histogram_binner &xbin, const histogram_binner &ybin )
+{
+	const size_t B = kHistogramBlock;
+	PAL_ALIGN_256 int32_t ix[B], iy[B];
+	const int32_t stride = int32_t( nx );
+	size_t i = 0;
+	while ( i < n )
+	{
+		size_t count = std::min( B, n - i );
+		histogram_index( ix, x + i, count, xbin );
+		histogram_index( iy, y + i, count, ybin );
+		size_t j = 0;
+		for ( ; ( j + 4 ) <= count; j += 4 )
+			store( ix + j, lvec4( load( iy + j ) ) * lvec4( stride ) + lvec4( load( ix + j ) ) );
+		for ( ; j < count; ++j )
+			ix[j] += iy[j] * stride;
+		histogram_count( sub, nbins, ix, count );
+		i += count;
+	}
+}
+
+/// @brief runs count( sub, begin, end ) over the chunks of n values,
+/// each chunk with its own sub-histograms, then merges into bins
+template <typename F>
+inline void
+histogram_run( uint32_t *bins, size_t nbins, size_t n, int nthreads, F count )
+{
+	// no bins to count into (the chunks would index an empty table)
+	if ( nbins == 0 )
+		return;
+	int nchunks = parallel_chunks( n, nthreads, kHistogramMinChunk );
+	size_t per = nbins * size_t( kHistogramSubs );
+	std::vector<uint32_t> sub( per * size_t( nchunks ), uint32_t(0) );
+	uint32_t *s = sub.data();
+	parallel_for( n, nchunks, [s, per, &count]( int c, size_t b, size_t e ) {
+			count( s + size_t( c ) * per, b, e );
+		} );
+	histogram_merge( bins, s, nbins, size_t( kHistogramSubs * nchunks ) );
+}
+
+} // namespace detail
+
+////////////////////////////////////////
+
+/// @brief 256 bin histogram of 8-bit values
+inline void
+histogram( uint32_t *bins, const uint8_t *in, size_t n, int nthreads = 1 )
+{
+	detail::histogram_run( bins, 256, n, nthreads, [in]( uint32_t *sub, size_t b, size_t e ) {
+			detail::histogram_chunk( sub, 256, in + b, e - b );
+		} );
+}
+
+/// @brief nbins bin histogram of 16-bit values (i.e. 1024 for 10-bit
+/// data), values past the last bin are counted in the last bin
+inline void
+histogram( uint32_t *bins, size_t nbins, const uint16_t *in, size_t n, int nthreads = 1 )
+{
+	detail::histogram_run( bins, nbins, n, nthreads, [nbins, in]( uint32_t *sub, size_t b, size_t e ) {
+			detail::histogram_chunk( sub, nbins, in + b, e - b );
+		} );
+}
+
+/// @brief nbins bin histogram of the float values in [lo, hi)
+inline void
+histogram( uint32_t *bins, size_t nbins, const float *in, size_t n, float lo, float hi, int nthreads = 1 )
+{
+	if ( nbins > size_t( std::numeric_limits<int32_t>::max() ) )
+		return;
+	detail::histogram_binner bin( nbins, lo, hi );
+	detail::histogram_run( bins, nbins, n, nthreads, [nbins, in, &bin]( uint32_t *sub, size_t b, size_t e ) {
+			detail::histogram_chunk( sub, nbins, in + b, e - b, bin );
+		} );
+}
+
+/// @brief joint histogram of the float pairs (x, y), with nx bins over
+/// [xlo, xhi) and ny bins over [ylo, yhi), bins is stored as ny rows
+/// of nx counts
+inline void
+histogram2d( uint32_t *bins, size_t nx, size_t ny, const float *x, const float *y, size_t n,
+			 float xlo, float xhi, float ylo, float yhi, int nthreads = 1 )
+{
+	// the iy * nx + ix index is computed in int32
+	if ( nx != 0 && ny > size_t( std::numeric_limits<int32_t>::max() ) / nx )
+		return;
+	detail::histogram_binner xbin( nx, xlo, xhi ), ybin( ny, ylo, yhi );
+	const size_t nbins = nx * ny;
+	detail::histogram_run( bins, nbins, n, nthreads,
+						   [nx, nbins, x, y, &xbin, &ybin]( uint32_t *sub, size_t b, size_t e ) {
+							   detail::histogram2d_chunk( sub, nx, nbins, x + b, y + b, e - b, xbin, ybin );
+						   } );
+}
+
+} // namespace pal
+
+#endif // _PAL_BUFFER_HISTOGRAM_H_
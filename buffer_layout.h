@@ -0,0 +1,246 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use pal/buffer_layout.h directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_BUFFER_LAYOUT_H_
+# define _PAL_BUFFER_LAYOUT_H_ 1
+
+namespace PAL_NAMESPACE
+{
+
+/// @brief converts n interleaved 2-component values (AoS, i.e. the
+/// real and imaginary parts of complex values) into 2 planar buffers
+/// (SoA)
+inline void
+deinterleave2( PAL_RESTRICT_PTR(float) c0, PAL_RESTRICT_PTR(float) c1,
+			   PAL_RESTRICT_PTR(const float) in, size_t n )
+{
+#if defined(PAL_HAS_FVEC8)
+	while ( n >= 8 )
+	{
+		fvec8 a, b;
+		deinterleave2( load8f_split( in, in + 8 ), load8f_split( in + 4, in + 12 ), a, b );
+		store( c0, a ); store( c1, b );
+		c0 += 8; c1 += 8; in += 16;
+		n -= 8;
+	}
+#endif
+#if defined(PAL_HAS_FVEC4)
+	while ( n >= 4 )
+	{
+		fvec4 a, b;
+		deinterleave2( load4f( in ), load4f( in + 4 ), a, b );
+		store( c0, a ); store( c1, b );
+		c0 += 4; c1 += 4; in += 8;
+		n -= 4;
+	}
+#endif
+	while ( n > 0 )
+	{
+		*c0++ = in[0]; *c1++ = in[1];
+		in += 2;
+		--n;
+	}
+}
+
+/// @brief converts 2 planar buffers (SoA) into n interleaved
+/// 2-component values (AoS)
+inline void
+interleave2( PAL_RESTRICT_PTR(float) out, PAL_RESTRICT_PTR(const float) c0,
+			 PAL_RESTRICT_PTR(const float) c1, size_t n )
+{
+#if defined(PAL_HAS_FVEC8)
+	while ( n >= 8 )
+	{
+		fvec8 a, b;
+		interleave2( load8f( c0 ), load8f( c1 ), a, b );
+		store_split( out, out + 8, a );
+		store_split( out + 4, out + 12, b );
+		c0 += 8; c1 += 8; out += 16;
+		n -= 8;
+	}
+#endif
+#if defined(PAL_HAS_FVEC4)
+	while ( n >= 4 )
+	{
+		fvec4 a, b;
+		interleave2( load4f( c0 ), load4f( c1 ), a, b );
+		store( out, a ); store( out + 4, b );
+		c0 += 4; c1 += 4; out += 8;
+		n -= 4;
+	}
+#endif
+	while ( n > 0 )
+	{
+		out[0] = *c0++; out[1] = *c1++;
+		out += 2;
+		--n;
+	}
+}
+
+/// @brief converts n interleaved 3-component values (AoS, i.e. rgb
+/// rgb rgb...) into 3 planar buffers (SoA)
+inline void
+deinterleave3( PAL_RESTRICT_PTR(float) c0, PAL_RESTRICT_PTR(float) c1, PAL_RESTRICT_PTR(float) c2,
+			   PAL_RESTRICT_PTR(const float) in, size_t n )
+{
+#if defined(PAL_HAS_FVEC8)
+	while ( n >= 8 )
+	{
+		fvec8 a, b, c;
+		deinterleave3( load8f_split( in, in + 12 ), load8f_split( in + 4, in + 16 ),
+					   load8f_split( in + 8, in + 20 ), a, b, c );
+		store( c0, a ); store( c1, b ); store( c2, c );
+		c0 += 8; c1 += 8; c2 += 8; in += 24;
+		n -= 8;
+	}
+#endif
+#if defined(PAL_HAS_FVEC4)
+	while ( n >= 4 )
+	{
+		fvec4 a, b, c;
+		deinterleave3( load4f( in ), load4f( in + 4 ), load4f( in + 8 ), a, b, c );
+		store( c0, a ); store( c1, b ); store( c2, c );
+		c0 += 4; c1 += 4; c2 += 4; in += 12;
+		n -= 4;
+	}
+#endif
+	while ( n > 0 )
+	{
+		*c0++ = in[0]; *c1++ = in[1]; *c2++ = in[2];
+		in += 3;
+		--n;
+	}
+}
+
+/// @brief converts 3 planar buffers (SoA) into n interleaved
+/// 3-component values (AoS)
+inline void
+interleave3( PAL_RESTRICT_PTR(float) out, PAL_RESTRICT_PTR(const float) c0,
+			 PAL_RESTRICT_PTR(const float) c1, PAL_RESTRICT_PTR(const float) c2, size_t n )
+{
+#if defined(PAL_HAS_FVEC8)
+	while ( n >= 8 )
+	{
+		fvec8 a, b, c;
+		interleave3( load8f( c0 ), load8f( c1 ), load8f( c2 ), a, b, c );
+		store_split( out, out + 12, a );
+		store_split( out + 4, out + 16, b );
+		store_split( out + 8, out + 20, c );
+		c0 += 8; c1 += 8; c2 += 8; out += 24;
+		n -= 8;
+	}
+#endif
+#if defined(PAL_HAS_FVEC4)
+	while ( n >= 4 )
+	{
+		fvec4 a, b, c;
+		interleave3( load4f( c0 ), load4f( c1 ), load4f( c2 ), a, b, c );
+		store( out, a ); store( out + 4, b ); store( out + 8, c );
+		c0 += 4; c1 += 4; c2 += 4; out += 12;
+		n -= 4;
+	}
+#endif
+	while ( n > 0 )
+	{
+		out[0] = *c0++; out[1] = *c1++; out[2] = *c2++;
+		out += 3;
+		--n;
+	}
+}
+
+/// @brief converts n interleaved 4-component values (AoS, i.e. rgba
+/// rgba...) into 4 planar buffers (SoA)
+inline void
+deinterleave4( PAL_RESTRICT_PTR(float) c0, PAL_RESTRICT_PTR(float) c1,
+			   PAL_RESTRICT_PTR(float) c2, PAL_RESTRICT_PTR(float) c3,
+			   PAL_RESTRICT_PTR(const float) in, size_t n )
+{
+#if defined(PAL_HAS_FVEC8)
+	while ( n >= 8 )
+	{
+		fvec8 a = load8f_split( in, in + 16 );
+		fvec8 b = load8f_split( in + 4, in + 20 );
+		fvec8 c = load8f_split( in + 8, in + 24 );
+		fvec8 d = load8f_split( in + 12, in + 28 );
+		transpose4x4_lanes( a, b, c, d );
+		store( c0, a ); store( c1, b ); store( c2, c ); store( c3, d );
+		c0 += 8; c1 += 8; c2 += 8; c3 += 8; in += 32;
+		n -= 8;
+	}
+#endif
+#if defined(PAL_HAS_FVEC4)
+	while ( n >= 4 )
+	{
+		fvec4 a = load4f( in );
+		fvec4 b = load4f( in + 4 );
+		fvec4 c = load4f( in + 8 );
+		fvec4 d = load4f( in + 12 );
+		transpose4x4( a, b, c, d );
+		store( c0, a ); store( c1, b ); store( c2, c ); store( c3, d );
+		c0 += 4; c1 += 4; c2 += 4; c3 += 4; in += 16;
+		n -= 4;
+	}
+#endif
+	while ( n > 0 )
+	{
+		*c0++ = in[0]; *c1++ = in[1]; *c2++ = in[2]; *c3++ = in[3];
+		in += 4;
+		--n;
+	}
+}
+
+/// @brief converts 4 planar buffers (SoA) into n interleaved
+/// 4-component values (AoS)
+inline void
+interleave4( PAL_RESTRICT_PTR(float) out,
+			 PAL_RESTRICT_PTR(const float) c0, PAL_RESTRICT_PTR(const float) c1,
+			 PAL_RESTRICT_PTR(const float) c2, PAL_RESTRICT_PTR(const float) c3, size_t n )
+{
+#if defined(PAL_HAS_FVEC8)
+	while ( n >= 8 )
+	{
+		fvec8 a = load8f( c0 );
+		fvec8 b = load8f( c1 );
+		fvec8 c = load8f( c2 );
+		fvec8 d = load8f( c3 );
+		transpose4x4_lanes( a, b, c, d );
+		store_split( out, out + 16, a );
+		store_split( out + 4, out + 20, b );
+		store_split( out + 8, out + 24, c );
+		store_split( out + 12, out + 28, d );
+		c0 += 8; c1 += 8; c2 += 8; c3 += 8; out += 32;
+		n -= 8;
+	}
+#endif
+#if defined(PAL_HAS_FVEC4)
+	while ( n >= 4 )
+	{
+		fvec4 a = load4f( c0 );
+		fvec4 b = load4f( c1 );
+		fvec4 c = load4f( c2 );
+		fvec4 d = load4f( c3 );
+		transpose4x4( a, b, c, d );
+		store( out, a ); store( out + 4, b ); store( out + 8, c ); store( out + 12, d );
+		c0 += 4; c1 += 4; c2 += 4; c3 += 4; out += 16;
+		n -= 4;
+	}
+#endif
+	while ( n > 0 )
+	{
+		out[0] = *c0++; out[1] = *c1++; out[2] = *c2++; out[3] = *c3++;
+		out += 4;
+		--n;
+	}
+}
+
+} // namespace pal
+
+#endif // _PAL_BUFFER_LAYOUT_H_
@@ -0,0 +1,138 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use pal/buffer_random.h directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_BUFFER_RANDOM_H_
+# define _PAL_BUFFER_RANDOM_H_ 1
+
+// fills buffers with random values from the philox4x32 generator in
+// simd_random.h. Value k of a buffer is word k % 4 of the block for
+// counter (k / 4, stream) under key seed, so the result does not
+// depend on the vector width, and threads filling separate buffers
+// (or separate parts of a larger problem) get independent,
+// reproducible sequences by using a distinct stream each.
+
+namespace PAL_NAMESPACE
+{
+
+namespace detail
+{
+
+#if defined(PAL_HAS_FVEC8) && defined(PAL_ENABLE_AVX2)
+typedef fvec8 random_fill_type;
+#else
+typedef fvec4 random_fill_type;
+#endif
+
+/// @brief stores the 4 words of each lane's block contiguously
+PAL_INLINE void random_block_store( float *out, fvec4 (&v)[4] )
+{
+	transpose4x4( v[0], v[1], v[2], v[3] );
+	store( out, v[0] );
+	store( out + 4, v[1] );
+	store( out + 8, v[2] );
+	store( out + 12, v[3] );
+}
+
+#ifdef PAL_HAS_FVEC8
+PAL_INLINE void random_block_store( float *out, fvec8 (&v)[4] )
+{
+	// lane i of the low half is counter i, of the high half i + 4
+	transpose4x4_lanes( v[0], v[1], v[2], v[3] );
+	store( out, permute_lanes<0, 2>( v[0], v[1] ) );
+	store( out + 8, permute_lanes<0, 2>( v[2], v[3] ) );
+	store( out + 16, permute_lanes<1, 3>( v[0], v[1] ) );
+	store( out + 24, permute_lanes<1, 3>( v[2], v[3] ) );
+}
+#endif
+
+/// @brief runs gen over full blocks, then generates one more block
+/// for any tail
+///
+/// T is float, or uint32_t for the raw bits. The vector stores do not
+/// care about the type of the memory, the tail is copied with memcpy
+/// so the bits are never read or written as scalar floats
+template <typename T, typename Gen>
+inline void random_fill( T *out, size_t n, Gen gen )
+{
+	static_assert( sizeof( T ) == sizeof( float ), "random_fill writes 32-bit values" );
+	typedef random_fill_type VT;
+	const size_t per = size_t( 4 * VT::value_count );
+	size_t i = 0;
+	VT v[4];
+	for ( ; ( i + per ) <= n; i += per )
+	{
+		gen( v );
+		random_block_store( reinterpret_cast<float *>( out + i ), v );
+	}
+	if ( i < n )
+	{
+		float tmp[4 * 8];
+		gen( v );
+		random_block_store( tmp, v );
+		std::memcpy( out + i, tmp, ( n - i ) * sizeof( T ) );
+	}
+}
+
+struct random_uniform_gen
+{
+	philox4x32<random_fill_type> &g;
+	PAL_INLINE void operator()( random_fill_type (&v)[4] ) const { g.uniform( v ); }
+};
+
+struct random_normal_gen
+{
+	philox4x32<random_fill_type> &g;
+	PAL_INLINE void operator()( random_fill_type (&v)[4] ) const { g.normal( v ); }
+};
+
+struct random_bits_gen
+{
+	philox4x32<random_fill_type> &g;
+	PAL_INLINE void operator()( random_fill_type (&v)[4] ) const
+	{
+		philox4x32<random_fill_type>::u32_type r[4];
+		g.next( r );
+		for ( int i = 0; i != 4; ++i )
+			v[i] = random_fill_type( r[i].as_float() );
+	}
+};
+
+} // namespace detail
+
+////////////////////////////////////////
+
+/// @brief fills out with n uniform values in [0, 1)
+inline void
+fill_uniform( float *out, size_t n, uint64_t seed, uint64_t stream = 0 )
+{
+	philox4x32<detail::random_fill_type> g( seed, stream );
+	detail::random_fill( out, n, detail::random_uniform_gen{ g } );
+}
+
+/// @brief fills out with n standard normal values (Box-Muller)
+inline void
+fill_normal( float *out, size_t n, uint64_t seed, uint64_t stream = 0 )
+{
+	philox4x32<detail::random_fill_type> g( seed, stream );
+	detail::random_fill( out, n, detail::random_normal_gen{ g } );
+}
+
+/// @brief fills out with n random 32-bit values
+inline void
+fill_random( uint32_t *out, size_t n, uint64_t seed, uint64_t stream = 0 )
+{
+	philox4x32<detail::random_fill_type> g( seed, stream );
+	detail::random_fill( out, n, detail::random_bits_gen{ g } );
+}
+
+} // namespace pal
+
+#endif // _PAL_BUFFER_RANDOM_H_
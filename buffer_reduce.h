@@ -0,0 +1,276 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use pal/buffer_reduce.h directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_BUFFER_REDUCE_H_
+# define _PAL_BUFFER_REDUCE_H_ 1
+
+// min / max with the location of the value for float, double and
+// int32_t buffers.
+//
+// Each lane keeps its best value so far along with the iteration it
+// was found in, updated with a compare and select, and the lanes are
+// only resolved to a single value at the end. As with
+// std::min_element and std::max_element, the first index wins when
+// the extreme value occurs more than once, and an empty buffer
+// returns index n. Unordered (NaN) values are not supported.
+
+namespace PAL_NAMESPACE
+{
+
+/// @brief a value from a buffer and where it was found
+template <typename T>
+struct value_index
+{
+	T value;
+	size_t index;
+};
+
+namespace detail
+{
+
+static const size_t kReduceMinChunk = size_t(1) << 16;
+// keeps the 32-bit iteration counters from overflowing
+static const size_t kReduceBlock = size_t(1) << 28;
+// independent accumulators, to hide the compare / select latency
+static const int kReduceUnroll = 2;
+
+template <typename T> struct reduce_types;
+
+template <> struct reduce_types<float>
+{
+#ifdef PAL_ENABLE_AVX2
+	typedef fvec8 vec_type;
+	static PAL_INLINE vec_type load_vec( const float *in ) { return load8f( in ); }
+#else
+	typedef fvec4 vec_type;
+	static PAL_INLINE vec_type load_vec( const float *in ) { return load4f( in ); }
+#endif
+	typedef vec_type::int_vec_type index_type;
+};
+
+template <> struct reduce_types<int32_t>
+{
+#ifdef PAL_ENABLE_AVX2
+	typedef lvec8 vec_type;
+	static PAL_INLINE vec_type load_vec( const int32_t *in ) { return load256( in ); }
+#else
+	typedef lvec4 vec_type;
+	static PAL_INLINE vec_type load_vec( const int32_t *in ) { return load( in ); }
+#endif
+	typedef vec_type index_type;
+};
+
+template <> struct reduce_types<double>
+{
+#ifdef PAL_HAS_DVEC4
+	typedef dvec4 vec_type;
+	static PAL_INLINE vec_type load_vec( const double *in ) { return load4d( in ); }
+#else
+	typedef dvec2 vec_type;
+	static PAL_INLINE vec_type load_vec( const double *in ) { return load2d( in ); }
+#endif
+	// counting in doubles is exact well past any buffer size, and
+	// avoids needing 64-bit integer compares / adds
+	typedef vec_type index_type;
+};
+
+struct reduce_less
+{
+	template <typename V>
+	PAL_INLINE auto operator()( V a, V b ) const -> decltype( a < b ) { return a < b; }
+};
+
+struct reduce_greater
+{
+	template <typename V>
+	PAL_INLINE auto operator()( V a, V b ) const -> decltype( a > b ) { return a > b; }
+};
+
+/// @brief replaces r with v if v is better, or equal at an earlier index
+template <typename T, typename C>
+PAL_INLINE void reduce_pick( value_index<T> &r, const value_index<T> &v, C better )
+{
+	if ( better( v.value, r.value ) || ( ! better( r.value, v.value ) && v.index < r.index ) )
+		r = v;
+}
+
+/// @brief scalar search of [b, e), continuing from r which must hold an
+/// earlier index
+template <typename T, typename C>
+inline void reduce_scalar( value_index<T> &r, const T *in, size_t b, size_t e, C better )
+{
+	for ( size_t i = b; i < e; ++i )
+	{
+		if ( better( in[i], r.value ) )
+		{
+			r.value = in[i];
+			r.index = i;
+		}
+	}
+}
+
+/// @brief searches n ( <= kReduceBlock ) values from in
+template <typename T, typename C>
+inline value_index<T> reduce_block( const T *in, size_t n, C better )
+{
+	typedef reduce_types<T> rt;
+	typedef typename rt::vec_type VT;
+	typedef typename rt::index_type IT;
+	typedef typename IT::value_type ival;
+	const int L = VT::value_count;
+	const int U = kReduceUnroll;
+	const size_t step = size_t( L * U );
+
+	value_index<T> r;
+	r.index = n;
+	if ( n < step )
+	{
+		if ( n == 0 )
+		{
+			r.value = T(0);
+			return r;
+		}
+		r.value = in[0];
+		r.index = 0;
+		reduce_scalar( r, in, 1, n, better );
+		return r;
+	}
+
+	VT best[U];
+	IT where[U];
+	for ( int u = 0; u != U; ++u )
+	{
+		best[u] = rt::load_vec( in + u * L );
+		where[u] = IT::zero();
+	}
+
+	const IT one( ival(1) );
+	IT iter = IT::zero();
+	const size_t nvec = n - ( n % step );
+	for ( size_t i = step; i != nvec; i += step )
+	{
+		iter = iter + one;
+		for ( int u = 0; u != U; ++u )
+		{
+			VT v = rt::load_vec( in + i + size_t( u * L ) );
+			typename VT::mask_type m = better( v, best[u] );
+			best[u] = ifthen( m, v, best[u] );
+			where[u] = ifthen( m, iter, where[u] );
+		}
+	}
+
+	// the index in lane l of accumulator u, found in iteration k, is
+	// k * step + u * L + l
+	PAL_ALIGN_256 T vals[L];
+	PAL_ALIGN_256 ival its[L];
+	for ( int u = 0; u != U; ++u )
+	{
+		store( vals, best[u] );
+		store( its, where[u] );
+		for ( int l = 0; l != L; ++l )
+		{
+			value_index<T> c;
+			c.value = vals[l];
+			c.index = size_t( its[l] ) * step + size_t( u * L + l );
+			if ( u == 0 && l == 0 )
+				r = c;
+			else
+				reduce_pick( r, c, better );
+		}
+	}
+
+	reduce_scalar( r, in, nvec, n, better );
+	return r;
+}
+
+/// @brief searches n values from in, in blocks small enough for the
+/// iteration counters
+template <typename T, typename C>
+inline value_index<T> reduce_range( const T *in, size_t n, C better )
+{
+	value_index<T> r = reduce_block( in, std::min( n, kReduceBlock ), better );
+	for ( size_t b = kReduceBlock; b < n; b += kReduceBlock )
+	{
+		value_index<T> c = reduce_block( in + b, std::min( n - b, kReduceBlock ), better );
+		c.index += b;
+		// later blocks only win when strictly better
+		if ( better( c.value, r.value ) )
+			r = c;
+	}
+	return r;
+}
+
+template <typename T, typename C>
+inline value_index<T> reduce_index( const T *in, size_t n, int nthreads, C better )
+{
+	int nchunks = parallel_chunks( n, nthreads, kReduceMinChunk );
+	if ( nchunks <= 1 )
+		return reduce_range( in, n, better );
+
+	std::vector< value_index<T> > res( static_cast<size_t>( nchunks ) );
+	value_index<T> *rp = res.data();
+	parallel_for( n, nchunks, [rp, in, better]( int c, size_t b, size_t e ) {
+			rp[c] = reduce_range( in + b, e - b, better );
+			rp[c].index += b;
+		} );
+
+	// the chunks are in order, so the first one holding the best
+	// value has the lowest index
+	value_index<T> r = res[0];
+	for ( int c = 1; c < nchunks; ++c )
+	{
+		if ( better( res[size_t( c )].value, r.value ) )
+			r = res[size_t( c )];
+	}
+	return r;
+}
+
+} // namespace detail
+
+////////////////////////////////////////
+
+/// @brief smallest value in the buffer and the first index it occurs
+/// at, for float, double or int32_t values. nthreads splits the work
+/// across threads (0 uses all hardware threads)
+template <typename T>
+inline value_index<T> min_with_index( const T *in, size_t n, int nthreads = 1 )
+{
+	return detail::reduce_index( in, n, nthreads, detail::reduce_less() );
+}
+
+/// @brief largest value in the buffer and the first index it occurs at
+///
+/// @sa min_with_index
+template <typename T>
+inline value_index<T> max_with_index( const T *in, size_t n, int nthreads = 1 )
+{
+	return detail::reduce_index( in, n, nthreads, detail::reduce_greater() );
+}
+
+/// @brief index of the (first) smallest value in the buffer, the same
+/// as std::min_element( in, in + n ) - in
+template <typename T>
+inline size_t argmin( const T *in, size_t n, int nthreads = 1 )
+{
+	return min_with_index( in, n, nthreads ).index;
+}
+
+/// @brief index of the (first) largest value in the buffer, the same
+/// as std::max_element( in, in + n ) - in
+template <typename T>
+inline size_t argmax( const T *in, size_t n, int nthreads = 1 )
+{
+	return max_with_index( in, n, nthreads ).index;
+}
+
+} // namespace pal
+
+#endif // _PAL_BUFFER_REDUCE_H_
@@ -0,0 +1,415 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use pal/buffer_resample.h directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_BUFFER_RESAMPLE_H_
+# define _PAL_BUFFER_RESAMPLE_H_ 1
+
+// resampling of float rows, images and audio streams by arbitrary
+// ratios with a windowed filter kernel, stretched when downsampling so
+// it also band limits.
+//
+// The weights are worked out up front: for the rows and images, one
+// set per output sample (there is a phase per output for arbitrary
+// ratios), for the streams a table of phases between which the
+// weights are interpolated. Each set of weights is padded with zeros
+// to a whole number of vectors and stored next to those of the
+// following outputs, so a vector of outputs is produced with vector
+// multiply-adds of the contiguous inputs and weights of each output,
+// and a transpose adding the partial sums of the lanes together.
+//
+// Images are resampled along the rows first, then down the columns,
+// where the vectors run across the output columns with each weight
+// broadcast, as for the vertical pass of the separable filters in
+// buffer_blur.h. Samples outside the input take the value of the
+// nearest edge sample, and the output must not overlap the input.
+
+namespace PAL_NAMESPACE
+{
+
+/// @brief resampling filter kernels
+///
+/// cubic is the Catmull-Rom spline, lanczos2 and lanczos3 are the
+/// lanczos windowed sinc with 2 and 3 lobes
+enum class resample_filter
+{
+	linear,
+	cubic,
+	lanczos2,
+	lanczos3
+};
+
+namespace detail
+{
+
+static const size_t kResamplePhases = 256;
+
+inline double resample_radius( resample_filter f )
+{
+	switch ( f )
+	{
+		case resample_filter::linear: return 1.0;
+		case resample_filter::cubic: return 2.0;
+		case resample_filter::lanczos2: return 2.0;
+		case resample_filter::lanczos3: return 3.0;
+	}
+	return 1.0;
+}
+
+inline double resample_sinc( double x )
+{
+	if ( x == 0.0 )
+		return 1.0;
+	x *= 3.14159265358979323846;
+	return std::sin( x ) / x;
+}
+
+inline double resample_kernel( resample_filter f, double x )
+{
+	x = std::fabs( x );
+	switch ( f )
+	{
+		case resample_filter::linear:
+			return x < 1.0 ? 1.0 - x : 0.0;
+		case resample_filter::cubic:
+			if ( x < 1.0 )
+				return ( 1.5 * x - 2.5 ) * x * x + 1.0;
+			if ( x < 2.0 )
+				return ( ( -0.5 * x + 2.5 ) * x - 4.0 ) * x + 2.0;
+			return 0.0;
+		case resample_filter::lanczos2:
+			return x < 2.0 ? resample_sinc( x ) * resample_sinc( x / 2.0 ) : 0.0;
+		case resample_filter::lanczos3:
+			return x < 3.0 ? resample_sinc( x ) * resample_sinc( x / 3.0 ) : 0.0;
+	}
+	return 0.0;
+}
+
+/// @brief fills w[0, stride) with the normalized weights of the taps
+/// at offsets first, first + 1, ... from a sample at position center,
+/// zero past ntaps
+inline void resample_weights( float *w, size_t ntaps, size_t stride, double first, double center,
+							  resample_filter f, double stretch )
+{
+	double sum = 0.0;
+	std::vector<double> tmp( ntaps );
+	for ( size_t t = 0; t != ntaps; ++t )
+	{
+		tmp[t] = resample_kernel( f, ( first + double( t ) - center ) / stretch );
+		sum += tmp[t];
+	}
+	for ( size_t t = 0; t != stride; ++t )
+		w[t] = t < ntaps && sum != 0.0 ? float( tmp[t] / sum ) : 0.F;
+}
+
+/// @brief the sum of the lanes of each of the vectors, as one vector
+PAL_INLINE fir_vec resample_reduce( fir_vec (&acc)[fir_vec::value_count] )
+{
+	blur_transpose( acc );
+	fir_vec r = acc[0];
+	for ( int l = 1; l != fir_vec::value_count; ++l )
+		r += acc[l];
+	return r;
+}
+
+/// @brief the dot products of the lanes from l on, unrolled by
+/// recursion so the accumulators are kept in registers
+template <int l>
+struct resample_lanes
+{
+	static PAL_INLINE void dot( fir_vec (&acc)[fir_vec::value_count], const float *x,
+								const std::ptrdiff_t *start, const float *w, size_t stride )
+	{
+		const size_t L = size_t( fir_vec::value_count );
+		const float *xp = x + start[l];
+		const float *wp = w + size_t( l ) * stride;
+		fir_vec a = fir_load( xp ) * fir_load( wp );
+		for ( size_t c = L; c < stride; c += L )
+			a = fma( fir_load( xp + c ), fir_load( wp + c ), a );
+		acc[l] = a;
+		resample_lanes<l + 1>::dot( acc, x, start, w, stride );
+	}
+};
+
+template <>
+struct resample_lanes<fir_vec::value_count>
+{
+	static PAL_INLINE void dot( fir_vec (&)[fir_vec::value_count], const float *,
+								const std::ptrdiff_t *, const float *, size_t )
+	{
+	}
+};
+
+/// @brief one vector of outputs, output l the dot product of the
+/// stride weights at w + l * stride with the inputs at x + start[l]
+PAL_INLINE fir_vec resample_block( const float *x, const std::ptrdiff_t *start,
+								   const float *w, size_t stride )
+{
+	fir_vec acc[fir_vec::value_count];
+	resample_lanes<0>::dot( acc, x, start, w, stride );
+	return resample_reduce( acc );
+}
+
+/// @brief weights for resampling n_in samples to n_out, with the
+/// sample centers lined up, one set per output
+struct resample_table
+{
+	resample_table( size_t n_in, size_t n_out, resample_filter f )
+	{
+		const size_t L = size_t( fir_vec::value_count );
+		const double scale = double( n_in ) / double( n_out );
+		const double stretch = std::max( scale, 1.0 );
+		const double support = resample_radius( f ) * stretch;
+		ntaps = size_t( std::ceil( 2.0 * support ) ) + 1;
+		stride = ( ntaps + L - 1 ) / L * L;
+		start.resize( n_out );
+		weights.resize( n_out * stride );
+		lo = 0;
+		hi = std::ptrdiff_t( n_in );
+		for ( size_t i = 0; i != n_out; ++i )
+		{
+			double center = ( double( i ) + 0.5 ) * scale - 0.5;
+			std::ptrdiff_t s = std::ptrdiff_t( std::floor( center - support ) ) + 1;
+			resample_weights( weights.data() + i * stride, ntaps, stride, double( s ), center, f, stretch );
+			start[i] = s;
+			lo = std::min( lo, s );
+			hi = std::max( hi, s + std::ptrdiff_t( stride ) );
+		}
+	}
+
+	size_t ntaps;
+	size_t stride;
+	// the padded input runs over [lo, hi)
+	std::ptrdiff_t lo;
+	std::ptrdiff_t hi;
+	std::vector<std::ptrdiff_t> start;
+	std::vector<float> weights;
+};
+
+/// @brief resamples the row in with the table, using pad for the
+/// input with the edges extended
+inline void resample_row( float *out, const float *in, size_t n_in,
+						  const resample_table &t, std::vector<float> &pad )
+{
+	typedef fir_vec VT;
+	const size_t L = size_t( VT::value_count );
+	const size_t before = size_t( -t.lo );
+	pad.resize( size_t( t.hi - t.lo ) );
+	std::fill( pad.begin(), pad.begin() + std::ptrdiff_t( before ), in[0] );
+	std::copy( in, in + n_in, pad.begin() + std::ptrdiff_t( before ) );
+	std::fill( pad.begin() + std::ptrdiff_t( before + n_in ), pad.end(), in[n_in - 1] );
+
+	const float *x = pad.data() + before;
+	const size_t n_out = t.start.size();
+	size_t i = 0;
+	for ( ; ( i + L ) <= n_out; i += L )
+		store( out + i, resample_block( x, t.start.data() + i, t.weights.data() + i * t.stride, t.stride ) );
+	for ( ; i < n_out; ++i )
+	{
+		const float *xp = x + t.start[i];
+		const float *wp = t.weights.data() + i * t.stride;
+		float a = 0.F;
+		for ( size_t j = 0; j != t.ntaps; ++j )
+			a += wp[j] * xp[j];
+		out[i] = a;
+	}
+}
+
+/// @brief resamples the output rows [y0, y1) of an image
+inline void resize_rows( float *out, size_t out_stride, size_t ow,
+						 const float *in, size_t in_stride, size_t iw, size_t ih,
+						 const resample_table &ht, const resample_table &vt,
+						 size_t y0, size_t y1 )
+{
+	// the input rows under the vertical taps of these outputs, which
+	// are resampled horizontally first
+	std::ptrdiff_t r0 = std::ptrdiff_t( ih ), r1 = 0;
+	for ( size_t y = y0; y != y1; ++y )
+	{
+		r0 = std::min( r0, vt.start[y] );
+		r1 = std::max( r1, vt.start[y] + std::ptrdiff_t( vt.ntaps ) );
+	}
+	const size_t first = blur_clamp( r0, ih );
+	const size_t last = blur_clamp( r1 - 1, ih );
+	std::vector<float> tmp( ( last - first + 1 ) * ow ), pad;
+	for ( size_t r = first; r <= last; ++r )
+		resample_row( tmp.data() + ( r - first ) * ow, in + r * in_stride, iw, ht, pad );
+
+	std::vector<const float *> rows( vt.ntaps );
+	for ( size_t x = 0; x < ow; x += kBlurTile )
+	{
+		const size_t tw = std::min( kBlurTile, ow - x );
+		for ( size_t y = y0; y != y1; ++y )
+		{
+			for ( size_t j = 0; j != vt.ntaps; ++j )
+				rows[j] = tmp.data() + ( blur_clamp( vt.start[y] + std::ptrdiff_t( j ), ih ) - first ) * ow;
+			blur_vertical( out + y * out_stride + x, rows.data(), x, tw,
+						   vt.weights.data() + y * vt.stride, vt.ntaps, false );
+		}
+	}
+}
+
+} // namespace detail
+
+////////////////////////////////////////
+
+/// @brief resamples the n_in values of in to the n_out values of out,
+/// with the first and last samples of each at the edges of the same
+/// interval (i.e. as for image rows of those widths)
+inline void
+resample( float *out, size_t n_out, const float *in, size_t n_in,
+		  resample_filter f = resample_filter::lanczos3 )
+{
+	if ( n_out == 0 || n_in == 0 )
+		return;
+	detail::resample_table t( n_in, n_out, f );
+	std::vector<float> pad;
+	detail::resample_row( out, in, n_in, t, pad );
+}
+
+/// @brief resizes an image from iw x ih to ow x oh
+///
+/// The strides are in floats, the nthreads work on bands of output
+/// rows, 0 meaning all hardware threads.
+inline void
+resize( float *out, size_t out_stride, size_t ow, size_t oh,
+		const float *in, size_t in_stride, size_t iw, size_t ih,
+		resample_filter f = resample_filter::lanczos3, int nthreads = 1 )
+{
+	if ( ow == 0 || oh == 0 || iw == 0 || ih == 0 )
+		return;
+	detail::resample_table ht( iw, ow, f ), vt( ih, oh, f );
+	detail::blur_run( oh, nthreads, [&]( size_t b, size_t e ) {
+			detail::resize_rows( out, out_stride, ow, in, in_stride, iw, ih, ht, vt, b, e );
+		} );
+}
+
+////////////////////////////////////////
+
+/// @brief streaming sample rate conversion of a single channel
+///
+/// Output k is the input at time k / ratio, in input samples, where
+/// the input before the first sample is taken as zero. As the filter
+/// looks a few samples ahead, each call produces the outputs whose
+/// inputs have all arrived, the rest come with the next call (feed
+/// zeros to flush the end of a stream).
+///
+/// The weights are taken from a table of 256 phases between input
+/// samples, interpolated linearly for the phase of each output.
+class resampler
+{
+public:
+	/// @brief ratio is the output rate over the input rate
+	explicit resampler( double ratio, resample_filter f = resample_filter::lanczos3 )
+		: _step( 1.0 / ratio )
+	{
+		const size_t L = size_t( detail::fir_vec::value_count );
+		const double stretch = std::max( _step, 1.0 );
+		const double support = detail::resample_radius( f ) * stretch;
+		// the taps run from the input before floor( t ) - support up
+		// to the one after floor( t ) + 1 + support
+		_first = -std::ptrdiff_t( std::ceil( support ) );
+		_ntaps = size_t( 2 * std::ceil( support ) ) + 2;
+		_stride = ( _ntaps + L - 1 ) / L * L;
+		const size_t P = detail::kResamplePhases;
+		_table.resize( ( P + 1 ) * _stride );
+		for ( size_t p = 0; p <= P; ++p )
+			detail::resample_weights( _table.data() + p * _stride, _ntaps, _stride, double( _first ),
+									  double( p ) / double( P ), f, stretch );
+		reset();
+	}
+
+	/// @brief clears the history, as if starting a new stream
+	void reset( void )
+	{
+		_buf.assign( size_t( -_first ), 0.F );
+		_t = double( -_first );
+	}
+
+	/// @brief the most outputs the next n inputs can produce
+	size_t max_output_count( size_t n ) const
+	{
+		return size_t( std::ceil( double( _buf.size() + n ) / _step ) ) + 1;
+	}
+
+	/// @brief resamples the next n inputs of the stream, returning the
+	/// number of outputs written to out, at most max_output_count( n )
+	size_t process( float *out, const float *in, size_t n )
+	{
+		typedef detail::fir_vec VT;
+		const size_t L = size_t( VT::value_count );
+		const double P = double( detail::kResamplePhases );
+		_buf.insert( _buf.end(), in, in + n );
+		// outputs from t can be made while the padded taps fit
+		const double tmax = double( std::ptrdiff_t( _buf.size() ) - _first - std::ptrdiff_t( _stride ) );
+
+		std::ptrdiff_t start[VT::value_count];
+		_w.resize( L * _stride );
+		size_t nout = 0;
+		while ( std::floor( _t ) <= tmax )
+		{
+			size_t l = 0;
+			for ( ; l != L && std::floor( _t ) <= tmax; ++l, _t += _step )
+			{
+				double fl = std::floor( _t );
+				double ph = ( _t - fl ) * P;
+				size_t p = std::min( size_t( ph ), detail::kResamplePhases - 1 );
+				float f = float( ph - double( p ) );
+				start[l] = std::ptrdiff_t( fl ) + _first;
+				const float *w0 = _table.data() + p * _stride;
+				const float *w1 = w0 + _stride;
+				float *w = _w.data() + l * _stride;
+				for ( size_t c = 0; c < _stride; c += L )
+				{
+					VT a = detail::fir_load( w0 + c );
+					store( w + c, fma( VT( f ), detail::fir_load( w1 + c ) - a, a ) );
+				}
+			}
+			if ( l == L )
+			{
+				store( out + nout, detail::resample_block( _buf.data(), start, _w.data(), _stride ) );
+				nout += L;
+			}
+			else
+			{
+				for ( size_t i = 0; i != l; ++i )
+				{
+					const float *xp = _buf.data() + start[i];
+					const float *wp = _w.data() + i * _stride;
+					float a = 0.F;
+					for ( size_t j = 0; j != _stride; ++j )
+						a += wp[j] * xp[j];
+					out[nout++] = a;
+				}
+			}
+		}
+
+		// drop the inputs no later output reaches
+		std::ptrdiff_t keep = std::ptrdiff_t( std::floor( _t ) ) + _first;
+		keep = std::max( std::ptrdiff_t(0), std::min( keep, std::ptrdiff_t( _buf.size() ) ) );
+		_buf.erase( _buf.begin(), _buf.begin() + keep );
+		_t -= double( keep );
+		return nout;
+	}
+
+private:
+	double _step;
+	double _t;
+	std::ptrdiff_t _first;
+	size_t _ntaps;
+	size_t _stride;
+	std::vector<float> _table;
+	std::vector<float> _buf;
+	std::vector<float> _w;
+};
+
+} // namespace pal
+
+#endif // _PAL_BUFFER_RESAMPLE_H_
@@ -0,0 +1,207 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use pal/buffer_search.h directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_BUFFER_SEARCH_H_
+# define _PAL_BUFFER_SEARCH_H_ 1
+
+// predicate searches over float, double and int32_t buffers.
+//
+// The predicate is called with a search_vec<T> of values and returns
+// its mask type, i.e.
+//
+//   find_first_if( in, n, []( search_vec<float> v ) { return isnan( v ); } )
+//
+// Several registers are tested per iteration with their masks
+// combined, so the loop only has one branch, and the position is
+// only worked out (with which() and a bit scan) once something is
+// found. The last partial register is copied to a zero padded
+// buffer, so the predicate must not have side effects.
+
+namespace PAL_NAMESPACE
+{
+
+namespace detail
+{
+
+template <typename T> struct search_types;
+
+template <> struct search_types<float>
+{
+#ifdef PAL_HAS_FVEC8
+	typedef fvec8 vec_type;
+	static PAL_INLINE vec_type load_vec( const float *in ) { return load8f( in ); }
+#else
+	typedef fvec4 vec_type;
+	static PAL_INLINE vec_type load_vec( const float *in ) { return load4f( in ); }
+#endif
+};
+
+template <> struct search_types<int32_t>
+{
+	typedef reduce_types<int32_t>::vec_type vec_type;
+	static PAL_INLINE vec_type load_vec( const int32_t *in ) { return reduce_types<int32_t>::load_vec( in ); }
+};
+
+template <> struct search_types<double>
+{
+	typedef reduce_types<double>::vec_type vec_type;
+	static PAL_INLINE vec_type load_vec( const double *in ) { return reduce_types<double>::load_vec( in ); }
+};
+
+static const int kSearchUnroll = 4;
+
+/// @brief predicate result bits for the n ( < lanes ) values at in,
+/// with the bits past n cleared
+template <typename T, typename P>
+inline int search_tail( const T *in, size_t n, P &pred )
+{
+	typedef search_types<T> st;
+	typedef typename st::vec_type VT;
+	PAL_ALIGN_256 T tmp[VT::value_count] = {};
+	for ( size_t i = 0; i != n; ++i )
+		tmp[i] = in[i];
+	return pred( st::load_vec( tmp ) ).which() & ( ( 1 << n ) - 1 );
+}
+
+/// @brief first index in [0, n) for which the predicate is match,
+/// or n
+template <bool match, typename T, typename P>
+inline size_t search_first( const T *in, size_t n, P &pred )
+{
+	typedef search_types<T> st;
+	typedef typename st::vec_type VT;
+	typedef typename VT::mask_type MT;
+	const int L = VT::value_count;
+	const int full = ( 1 << L ) - 1;
+	const size_t step = size_t( L * kSearchUnroll );
+	// flips the bits when searching for a false result
+	const int flip = match ? 0 : full;
+
+	size_t i = 0;
+	for ( ; ( i + step ) <= n; i += step )
+	{
+		MT m0 = pred( st::load_vec( in + i ) );
+		MT m1 = pred( st::load_vec( in + i + L ) );
+		MT m2 = pred( st::load_vec( in + i + 2 * L ) );
+		MT m3 = pred( st::load_vec( in + i + 3 * L ) );
+		bool found = match ? ( ( m0 | m1 ) | ( m2 | m3 ) ).any() : ! ( ( m0 & m1 ) & ( m2 & m3 ) ).all();
+		if ( found )
+		{
+			MT m[4] = { m0, m1, m2, m3 };
+			for ( int u = 0; u != 4; ++u )
+			{
+				int b = m[u].which() ^ flip;
+				if ( b )
+					return i + size_t( u * L + first_set_bit( b ) );
+			}
+		}
+	}
+	for ( ; ( i + size_t( L ) ) <= n; i += size_t( L ) )
+	{
+		int b = pred( st::load_vec( in + i ) ).which() ^ flip;
+		if ( b )
+			return i + size_t( first_set_bit( b ) );
+	}
+	if ( i < n )
+	{
+		int b = search_tail( in + i, n - i, pred ) ^ ( flip & ( ( 1 << ( n - i ) ) - 1 ) );
+		if ( b )
+			return i + size_t( first_set_bit( b ) );
+	}
+	return n;
+}
+
+} // namespace detail
+
+/// @brief the vector type the predicates of the searches are called
+/// with for values of type T
+template <typename T>
+using search_vec = typename detail::search_types<T>::vec_type;
+
+////////////////////////////////////////
+
+/// @brief index of the first value for which pred is true, or n if
+/// there are none (as with std::find_if)
+template <typename T, typename P>
+inline size_t find_first_if( const T *in, size_t n, P pred )
+{
+	return detail::search_first<true>( in, n, pred );
+}
+
+/// @brief index of the first value for which pred is false, or n
+template <typename T, typename P>
+inline size_t find_first_if_not( const T *in, size_t n, P pred )
+{
+	return detail::search_first<false>( in, n, pred );
+}
+
+/// @brief true if pred is true for any value
+template <typename T, typename P>
+inline bool any_of( const T *in, size_t n, P pred )
+{
+	return find_first_if( in, n, pred ) != n;
+}
+
+/// @brief true if pred is true for every value (or n is 0)
+template <typename T, typename P>
+inline bool all_of( const T *in, size_t n, P pred )
+{
+	return find_first_if_not( in, n, pred ) == n;
+}
+
+/// @brief true if pred is false for every value
+template <typename T, typename P>
+inline bool none_of( const T *in, size_t n, P pred )
+{
+	return find_first_if( in, n, pred ) == n;
+}
+
+/// @brief number of values for which pred is true
+template <typename T, typename P>
+inline size_t count_if( const T *in, size_t n, P pred )
+{
+	typedef detail::search_types<T> st;
+	const int L = st::vec_type::value_count;
+	const size_t step = size_t( L * detail::kSearchUnroll );
+
+	size_t c0 = 0, c1 = 0, i = 0;
+	for ( ; ( i + step ) <= n; i += step )
+	{
+		c0 += size_t( detail::count_set_bits( pred( st::load_vec( in + i ) ).which() ) );
+		c1 += size_t( detail::count_set_bits( pred( st::load_vec( in + i + L ) ).which() ) );
+		c0 += size_t( detail::count_set_bits( pred( st::load_vec( in + i + 2 * L ) ).which() ) );
+		c1 += size_t( detail::count_set_bits( pred( st::load_vec( in + i + 3 * L ) ).which() ) );
+	}
+	for ( ; ( i + size_t( L ) ) <= n; i += size_t( L ) )
+		c0 += size_t( detail::count_set_bits( pred( st::load_vec( in + i ) ).which() ) );
+	if ( i < n )
+		c1 += size_t( detail::count_set_bits( detail::search_tail( in + i, n - i, pred ) ) );
+	return c0 + c1;
+}
+
+////////////////////////////////////////
+
+/// @brief index of the first NaN or infinite value, or n if all are
+/// finite
+inline size_t find_first_nonfinite( const float *in, size_t n )
+{
+	return find_first_if_not( in, n, []( search_vec<float> v ) { return isfinite( v ); } );
+}
+
+/// @brief index of the first NaN value, or n if there are none
+inline size_t find_first_nan( const float *in, size_t n )
+{
+	return find_first_if( in, n, []( search_vec<float> v ) { return isnan( v ); } );
+}
+
+} // namespace pal
+
+#endif // _PAL_BUFFER_SEARCH_H_
@@ -0,0 +1,290 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use pal/buffer_sort.h directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_BUFFER_SORT_H_
+# define _PAL_BUFFER_SORT_H_ 1
+
+// ascending in-place sort of float and int32 buffers. This is a
+// quicksort where the partition step compresses each vector into the
+// values going left and right with a shuffle from a lookup table
+// (pshufb, or vpermd for 8 wide with AVX2), writing both ends of the
+// range in place. Short ranges are finished with the sorting
+// networks in simd_sort.h, padded out to the register size. The
+// depth is limited, falling back to heap sort as std::sort does.
+//
+// Without SSSE3 there is no variable shuffle, and the partition is a
+// branchless scalar loop. NaN values are not supported.
+
+namespace PAL_NAMESPACE
+{
+
+namespace detail
+{
+
+template <typename T> struct sort_types {};
+
+template <> struct sort_types<float>
+{
+#if defined(PAL_HAS_FVEC8) && defined(PAL_ENABLE_AVX2)
+	typedef fvec8 vec_type;
+#else
+	typedef fvec4 vec_type;
+#endif
+	static PAL_INLINE float pad( void ) { return std::numeric_limits<float>::infinity(); }
+};
+
+template <> struct sort_types<int32_t>
+{
+#if defined(PAL_HAS_IVEC256) && defined(PAL_ENABLE_AVX2)
+	typedef lvec8 vec_type;
+#else
+	typedef lvec4 vec_type;
+#endif
+	static PAL_INLINE int32_t pad( void ) { return std::numeric_limits<int32_t>::max(); }
+};
+
+template <typename VT> PAL_INLINE VT load_vec( const float *a ) { return load4f( a ); }
+template <typename VT> PAL_INLINE VT load_vec( const int32_t *a ) { return load( a ); }
+#ifdef PAL_ENABLE_AVX
+template <> PAL_INLINE fvec8 load_vec<fvec8>( const float *a ) { return load8f( a ); }
+template <> PAL_INLINE lvec8 load_vec<lvec8>( const int32_t *a ) { return load256( a ); }
+#endif
+
+#ifdef PAL_ENABLE_SSSE3
+# define PAL_HAS_SIMD_PARTITION 1
+
+/// @brief partitions the values of v into the range being written
+/// from both ends, see partition_vec
+template <typename VT, bool strict, typename T>
+PAL_INLINE void partition_one( const partition_table<VT::value_count> &t, T *a, VT v, VT p,
+							   size_t &ls, size_t &rs )
+{
+	const int L = VT::value_count;
+	int left;
+	VT s = partition_shuffle( t, v, ( strict ? ( v >= p ) : ( v > p ) ).which(), left );
+	store( a + ls, s );
+	store( a + rs - L, s );
+	ls += size_t( left );
+	rs -= size_t( L - left );
+}
+
+/// @brief number of vectors read at a time by partition_vec
+template <typename VT> struct partition_unroll
+{
+	static const size_t value = size_t( 16 / VT::value_count );
+};
+
+/// @brief in place partition of [lo, hi), which must hold a multiple
+/// of the vector size and at least 2 unrolls worth
+///
+/// The first and last unroll of vectors are held back so there is
+/// always free space at both write positions, and the next vectors
+/// are read from whichever side has less room. The side depends on
+/// the previous results, so reading several vectors per decision
+/// keeps the loads off that dependency chain.
+template <typename VT, bool strict, typename T>
+inline size_t partition_vec( T *a, size_t lo, size_t hi, T pivot )
+{
+	const size_t L = size_t( VT::value_count );
+	const size_t U = partition_unroll<VT>::value;
+	const size_t UL = U * L;
+	const partition_table<VT::value_count> &t = partition_table<VT::value_count>::get();
+	VT p( pivot );
+	VT vl[U], vr[U];
+	for ( size_t u = 0; u != U; ++u )
+	{
+		vl[u] = load_vec<VT>( a + lo + u * L );
+		vr[u] = load_vec<VT>( a + hi - UL + u * L );
+	}
+	size_t ls = lo, rs = hi;
+	size_t rl = lo + UL, rr = hi - UL;
+	while ( ( rr - rl ) >= UL )
+	{
+		// the side is data dependent, so select instead of branching
+		size_t take = ( ( rl - ls ) <= ( rs - rr ) ) ? UL : 0;
+		const T *at = a + ( take ? rl : rr - UL );
+		rl += take;
+		rr -= UL - take;
+		VT cur[U];
+		for ( size_t u = 0; u != U; ++u )
+			cur[u] = load_vec<VT>( at + u * L );
+		for ( size_t u = 0; u != U; ++u )
+			partition_one<VT, strict>( t, a, cur[u], p, ls, rs );
+	}
+	while ( rl != rr )
+	{
+		size_t take = ( ( rl - ls ) <= ( rs - rr ) ) ? L : 0;
+		VT cur = load_vec<VT>( a + ( take ? rl : rr - L ) );
+		rl += take;
+		rr -= L - take;
+		partition_one<VT, strict>( t, a, cur, p, ls, rs );
+	}
+	for ( size_t u = 0; u != U; ++u )
+		partition_one<VT, strict>( t, a, vl[u], p, ls, rs );
+	for ( size_t u = 0; u != U; ++u )
+		partition_one<VT, strict>( t, a, vr[u], p, ls, rs );
+	return ls;
+}
+#endif
+
+/// @brief partitions [lo, hi) such that [lo, m) are less than (strict)
+/// or not greater than pivot, returning m
+template <bool strict, typename T>
+inline size_t sort_partition( T *a, size_t lo, size_t hi, T pivot )
+{
+	size_t m = lo, e = hi;
+#ifdef PAL_HAS_SIMD_PARTITION
+	typedef typename sort_types<T>::vec_type VT;
+	const size_t L = size_t( VT::value_count );
+	size_t n = hi - lo;
+	if ( n >= 2 * partition_unroll<VT>::value * L )
+	{
+		// the tail is held aside, then fed in after the bulk, moving
+		// the first right value to the end for each left value
+		size_t rem = n % L;
+		T tail[8];
+		e = hi - rem;
+		for ( size_t i = 0; i != rem; ++i )
+			tail[i] = a[e + i];
+		m = partition_vec<VT, strict>( a, lo, e, pivot );
+		for ( size_t i = 0; i != rem; ++i )
+		{
+			T x = tail[i];
+			if ( strict ? ( x < pivot ) : !( pivot < x ) )
+			{
+				a[e++] = a[m];
+				a[m++] = x;
+			}
+			else
+				a[e++] = x;
+		}
+		return m;
+	}
+#endif
+	// branchless Lomuto, every value is swapped with the first right
+	// value, which only moves it when it goes left
+	for ( size_t j = lo; j != e; ++j )
+	{
+		T x = a[j];
+		a[j] = a[m];
+		a[m] = x;
+		m += ( strict ? ( x < pivot ) : !( pivot < x ) ) ? 1 : 0;
+	}
+	return m;
+}
+
+/// @brief sorts up to 4 registers worth of values with the networks
+template <typename T>
+inline void sort_small( T *a, size_t n )
+{
+	typedef typename sort_types<T>::vec_type VT;
+	const size_t L = size_t( VT::value_count );
+	T tmp[4 * 8];
+	for ( size_t i = 0; i != n; ++i )
+		tmp[i] = a[i];
+	for ( size_t i = n; i < 4 * L; ++i )
+		tmp[i] = sort_types<T>::pad();
+	VT v0 = load_vec<VT>( tmp );
+	if ( n <= L )
+		store( tmp, sort_network( v0 ) );
+	else
+	{
+		VT v1 = load_vec<VT>( tmp + L );
+		if ( n <= 2 * L )
+		{
+			sort_network( v0, v1 );
+			store( tmp, v0 );
+			store( tmp + L, v1 );
+		}
+		else
+		{
+			VT v2 = load_vec<VT>( tmp + 2 * L );
+			VT v3 = load_vec<VT>( tmp + 3 * L );
+			sort_network( v0, v1, v2, v3 );
+			store( tmp, v0 );
+			store( tmp + L, v1 );
+			store( tmp + 2 * L, v2 );
+			store( tmp + 3 * L, v3 );
+		}
+	}
+	for ( size_t i = 0; i != n; ++i )
+		a[i] = tmp[i];
+}
+
+template <typename T>
+PAL_INLINE T median3( T a, T b, T c )
+{
+	return std::max( std::min( a, b ), std::min( std::max( a, b ), c ) );
+}
+
+template <typename T>
+inline void sort_range( T *a, size_t lo, size_t hi, int depth )
+{
+	typedef typename sort_types<T>::vec_type VT;
+	const size_t small = size_t( 4 * VT::value_count );
+	while ( ( hi - lo ) > small )
+	{
+		if ( depth-- == 0 )
+		{
+			std::make_heap( a + lo, a + hi );
+			std::sort_heap( a + lo, a + hi );
+			return;
+		}
+		size_t n = hi - lo;
+		size_t q = n / 4;
+		T pivot = median3( median3( a[lo], a[lo + q / 2], a[lo + q] ),
+						   median3( a[lo + q * 2 - 1], a[lo + q * 2], a[lo + q * 2 + 1] ),
+						   median3( a[hi - q - 1], a[hi - q / 2 - 1], a[hi - 1] ) );
+		size_t m = sort_partition<true>( a, lo, hi, pivot );
+		if ( m == lo )
+		{
+			// pivot is the minimum, split off the values equal to it,
+			// which are done
+			lo = sort_partition<false>( a, lo, hi, pivot );
+			continue;
+		}
+		// recurse on the smaller side to bound the stack
+		if ( ( m - lo ) < ( hi - m ) )
+		{
+			sort_range( a, lo, m, depth );
+			lo = m;
+		}
+		else
+		{
+			sort_range( a, m, hi, depth );
+			hi = m;
+		}
+	}
+	sort_small( a + lo, hi - lo );
+}
+
+template <typename T>
+inline void sort_buffer( T *a, size_t n )
+{
+	int depth = 0;
+	for ( size_t x = n; x > 1; x >>= 1 )
+		depth += 2;
+	sort_range( a, 0, n, depth );
+}
+
+} // namespace detail
+
+////////////////////////////////////////
+
+/// @brief sorts the n values of a ascending, in place
+inline void sort( float *a, size_t n ) { detail::sort_buffer( a, n ); }
+
+/// @brief sorts the n values of a ascending, in place
+inline void sort( int32_t *a, size_t n ) { detail::sort_buffer( a, n ); }
+
+} // namespace pal
+
+#endif // _PAL_BUFFER_SORT_H_
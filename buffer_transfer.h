@@ -0,0 +1,59 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use pal/buffer_transfer.h directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_BUFFER_TRANSFER_H_
+# define _PAL_BUFFER_TRANSFER_H_ 1
+
+// buffer versions of the transfer functions in simd_transfer.h, out
+// may be the same as in
+
+namespace PAL_NAMESPACE
+{
+
+#define PAL_TRANSFER_BUFFER_FUNC( name )								\
+	namespace detail													\
+	{																	\
+	struct name ## _op													\
+	{																	\
+		template <typename VT>											\
+		PAL_INLINE VT operator()( VT v ) const { return name( v ); }	\
+		PAL_INLINE float operator()( float v ) const { return name( fvec4( v ) )[0]; } \
+	};																	\
+	}																	\
+	inline void															\
+	name( PAL_RESTRICT_PTR(float) out, PAL_RESTRICT_PTR(const float) in, size_t n ) \
+	{																	\
+		process( out, in, n, detail::name ## _op() );					\
+	}
+
+/// @brief sRGB decode of n values
+/// @sa srgb_to_linear
+PAL_TRANSFER_BUFFER_FUNC( srgb_to_linear )
+/// @brief sRGB encode of n values
+PAL_TRANSFER_BUFFER_FUNC( linear_to_srgb )
+/// @brief BT.709 decode of n values
+PAL_TRANSFER_BUFFER_FUNC( rec709_to_linear )
+/// @brief BT.709 encode of n values
+PAL_TRANSFER_BUFFER_FUNC( linear_to_rec709 )
+/// @brief PQ decode of n values
+PAL_TRANSFER_BUFFER_FUNC( pq_to_linear )
+/// @brief PQ encode of n values
+PAL_TRANSFER_BUFFER_FUNC( linear_to_pq )
+/// @brief HLG decode of n values
+PAL_TRANSFER_BUFFER_FUNC( hlg_to_linear )
+/// @brief HLG encode of n values
+PAL_TRANSFER_BUFFER_FUNC( linear_to_hlg )
+
+#undef PAL_TRANSFER_BUFFER_FUNC
+
+} // namespace pal
+
+#endif // _PAL_BUFFER_TRANSFER_H_
@@ -0,0 +1,344 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use pal/buffer_transform.h directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_BUFFER_TRANSFORM_H_
+# define _PAL_BUFFER_TRANSFORM_H_ 1
+
+namespace PAL_NAMESPACE
+{
+
+namespace detail
+{
+
+template <typename VT>
+PAL_INLINE VT xform_madd( VT a, VT b, VT c ) { return fma( a, b, c ); }
+/// rounds as the vector fma does, so the results do not depend on
+/// where n splits between the vector loops and the scalar tail
+PAL_INLINE float xform_madd( float a, float b, float c )
+{
+#ifdef PAL_ENABLE_FMA_EXT
+	return std::fma( a, b, c );
+#else
+	return a * b + c;
+#endif
+}
+
+/// @brief row-major 3x3 matrix times (x, y, z)
+///
+/// The kernels broadcast the matrix once up front, since the output
+/// stores could alias the matrix, which would otherwise force a
+/// reload and broadcast every iteration.
+template <typename VT>
+struct xform_mat3
+{
+	VT m[9];
+
+	explicit xform_mat3( const float *mm )
+	{
+		for ( int i = 0; i != 9; ++i )
+			m[i] = VT( mm[i] );
+	}
+
+	PAL_INLINE void operator()( VT &x, VT &y, VT &z ) const
+	{
+		VT ox = xform_madd( m[0], x, xform_madd( m[1], y, m[2] * z ) );
+		VT oy = xform_madd( m[3], x, xform_madd( m[4], y, m[5] * z ) );
+		VT oz = xform_madd( m[6], x, xform_madd( m[7], y, m[8] * z ) );
+		x = ox; y = oy; z = oz;
+	}
+};
+
+/// @brief row-major 4x4 matrix times (x, y, z, 1), ignoring the
+/// bottom row
+template <typename VT>
+struct xform_affine
+{
+	VT m[12];
+
+	explicit xform_affine( const float *mm )
+	{
+		for ( int i = 0; i != 12; ++i )
+			m[i] = VT( mm[i] );
+	}
+
+	PAL_INLINE void operator()( VT &x, VT &y, VT &z ) const
+	{
+		VT ox = xform_madd( m[0], x, xform_madd( m[1], y, xform_madd( m[2], z, m[3] ) ) );
+		VT oy = xform_madd( m[4], x, xform_madd( m[5], y, xform_madd( m[6], z, m[7] ) ) );
+		VT oz = xform_madd( m[8], x, xform_madd( m[9], y, xform_madd( m[10], z, m[11] ) ) );
+		x = ox; y = oy; z = oz;
+	}
+};
+
+/// @brief row-major 4x4 matrix times (x, y, z, 1), followed by the
+/// divide by w
+template <typename VT>
+struct xform_projective
+{
+	VT m[16];
+
+	explicit xform_projective( const float *mm )
+	{
+		for ( int i = 0; i != 16; ++i )
+			m[i] = VT( mm[i] );
+	}
+
+	PAL_INLINE void operator()( VT &x, VT &y, VT &z ) const
+	{
+		VT ow = xform_madd( m[12], x, xform_madd( m[13], y, xform_madd( m[14], z, m[15] ) ) );
+		VT ox = xform_madd( m[0], x, xform_madd( m[1], y, xform_madd( m[2], z, m[3] ) ) );
+		VT oy = xform_madd( m[4], x, xform_madd( m[5], y, xform_madd( m[6], z, m[7] ) ) );
+		VT oz = xform_madd( m[8], x, xform_madd( m[9], y, xform_madd( m[10], z, m[11] ) ) );
+		VT iw = VT( 1.F ) / ow;
+		x = ox * iw; y = oy * iw; z = oz * iw;
+	}
+};
+
+/// @brief row-major 4x4 matrix times (x, y, z, w)
+template <typename VT>
+struct xform_mat4
+{
+	VT m[16];
+
+	explicit xform_mat4( const float *mm )
+	{
+		for ( int i = 0; i != 16; ++i )
+			m[i] = VT( mm[i] );
+	}
+
+	PAL_INLINE void operator()( VT &x, VT &y, VT &z, VT &w ) const
+	{
+		VT ox = xform_madd( m[0], x, xform_madd( m[1], y, xform_madd( m[2], z, m[3] * w ) ) );
+		VT oy = xform_madd( m[4], x, xform_madd( m[5], y, xform_madd( m[6], z, m[7] * w ) ) );
+		VT oz = xform_madd( m[8], x, xform_madd( m[9], y, xform_madd( m[10], z, m[11] * w ) ) );
+		VT ow = xform_madd( m[12], x, xform_madd( m[13], y, xform_madd( m[14], z, m[15] * w ) ) );
+		x = ox; y = oy; z = oz; w = ow;
+	}
+};
+
+template <template <typename> class K>
+inline void
+xform_planar3( float *o0, float *o1, float *o2,
+			   const float *i0, const float *i1, const float *i2,
+			   size_t n, const float *m )
+{
+	size_t i = 0;
+#if defined(PAL_HAS_FVEC8)
+	const K<fvec8> k8( m );
+	for ( ; i + 8 <= n; i += 8 )
+	{
+		fvec8 x = load8f( i0 + i ), y = load8f( i1 + i ), z = load8f( i2 + i );
+		k8( x, y, z );
+		store( o0 + i, x ); store( o1 + i, y ); store( o2 + i, z );
+	}
+#endif
+#if defined(PAL_HAS_FVEC4)
+	const K<fvec4> k4( m );
+	for ( ; i + 4 <= n; i += 4 )
+	{
+		fvec4 x = load4f( i0 + i ), y = load4f( i1 + i ), z = load4f( i2 + i );
+		k4( x, y, z );
+		store( o0 + i, x ); store( o1 + i, y ); store( o2 + i, z );
+	}
+#endif
+	const K<float> k1( m );
+	for ( ; i < n; ++i )
+	{
+		float x = i0[i], y = i1[i], z = i2[i];
+		k1( x, y, z );
+		o0[i] = x; o1[i] = y; o2[i] = z;
+	}
+}
+
+template <template <typename> class K>
+inline void
+xform_interleaved3( float *out, const float *in, size_t n, const float *m )
+{
+#if defined(PAL_HAS_FVEC8)
+	const K<fvec8> k8( m );
+	for ( ; n >= 8; n -= 8, in += 24, out += 24 )
+	{
+		fvec8 x, y, z, x0, x1, x2;
+		deinterleave3( load8f_split( in, in + 12 ), load8f_split( in + 4, in + 16 ),
+					   load8f_split( in + 8, in + 20 ), x, y, z );
+		k8( x, y, z );
+		interleave3( x, y, z, x0, x1, x2 );
+		store_split( out, out + 12, x0 );
+		store_split( out + 4, out + 16, x1 );
+		store_split( out + 8, out + 20, x2 );
+	}
+#endif
+#if defined(PAL_HAS_FVEC4)
+	const K<fvec4> k4( m );
+	for ( ; n >= 4; n -= 4, in += 12, out += 12 )
+	{
+		fvec4 x, y, z, x0, x1, x2;
+		deinterleave3( load4f( in ), load4f( in + 4 ), load4f( in + 8 ), x, y, z );
+		k4( x, y, z );
+		interleave3( x, y, z, x0, x1, x2 );
+		store( out, x0 ); store( out + 4, x1 ); store( out + 8, x2 );
+	}
+#endif
+	const K<float> k1( m );
+	for ( ; n > 0; --n, in += 3, out += 3 )
+	{
+		float x = in[0], y = in[1], z = in[2];
+		k1( x, y, z );
+		out[0] = x; out[1] = y; out[2] = z;
+	}
+}
+
+inline bool
+is_affine( const float *m )
+{
+	return m[12] == 0.F && m[13] == 0.F && m[14] == 0.F && m[15] == 1.F;
+}
+
+} // namespace detail
+
+////////////////////////////////////////
+
+/// @brief applies a row-major 3x3 matrix to n planar 3-component
+/// values (i.e. a color matrix on separate r, g, b planes)
+///
+/// The outputs may alias the inputs.
+inline void
+transform3x3( float *out0, float *out1, float *out2,
+			  const float *in0, const float *in1, const float *in2,
+			  const float (&m)[9], size_t n )
+{
+	detail::xform_planar3<detail::xform_mat3>( out0, out1, out2, in0, in1, in2, n, m );
+}
+
+/// @brief applies a row-major 3x3 matrix to n interleaved 3-component
+/// values (rgb rgb...)
+///
+/// out may be the same as in.
+inline void
+transform3x3_interleaved( float *out, const float *in, const float (&m)[9], size_t n )
+{
+	detail::xform_interleaved3<detail::xform_mat3>( out, in, n, m );
+}
+
+/// @brief applies a row-major 4x4 matrix to n planar 4-component
+/// values, no divide is performed
+///
+/// The outputs may alias the inputs.
+inline void
+transform4x4( float *out0, float *out1, float *out2, float *out3,
+			  const float *in0, const float *in1, const float *in2, const float *in3,
+			  const float (&m)[16], size_t n )
+{
+	size_t i = 0;
+#if defined(PAL_HAS_FVEC8)
+	const detail::xform_mat4<fvec8> k8( m );
+	for ( ; i + 8 <= n; i += 8 )
+	{
+		fvec8 x = load8f( in0 + i ), y = load8f( in1 + i ), z = load8f( in2 + i ), w = load8f( in3 + i );
+		k8( x, y, z, w );
+		store( out0 + i, x ); store( out1 + i, y ); store( out2 + i, z ); store( out3 + i, w );
+	}
+#endif
+#if defined(PAL_HAS_FVEC4)
+	const detail::xform_mat4<fvec4> k4( m );
+	for ( ; i + 4 <= n; i += 4 )
+	{
+		fvec4 x = load4f( in0 + i ), y = load4f( in1 + i ), z = load4f( in2 + i ), w = load4f( in3 + i );
+		k4( x, y, z, w );
+		store( out0 + i, x ); store( out1 + i, y ); store( out2 + i, z ); store( out3 + i, w );
+	}
+#endif
+	const detail::xform_mat4<float> k1( m );
+	for ( ; i < n; ++i )
+	{
+		float x = in0[i], y = in1[i], z = in2[i], w = in3[i];
+		k1( x, y, z, w );
+		out0[i] = x; out1[i] = y; out2[i] = z; out3[i] = w;
+	}
+}
+
+/// @brief applies a row-major 4x4 matrix to n interleaved 4-component
+/// values (xyzw xyzw... or rgba rgba...), no divide is performed
+///
+/// Blocks of 4 values are transposed to planar in registers, so this
+/// runs the same kernel as transform4x4. out may be the same as in.
+inline void
+transform4x4_interleaved( float *out, const float *in, const float (&m)[16], size_t n )
+{
+#if defined(PAL_HAS_FVEC8)
+	const detail::xform_mat4<fvec8> k8( m );
+	for ( ; n >= 8; n -= 8, in += 32, out += 32 )
+	{
+		// values 0 - 3 in the low lanes, 4 - 7 in the high
+		fvec8 x = load8f_split( in, in + 16 ), y = load8f_split( in + 4, in + 20 );
+		fvec8 z = load8f_split( in + 8, in + 24 ), w = load8f_split( in + 12, in + 28 );
+		transpose4x4_lanes( x, y, z, w );
+		k8( x, y, z, w );
+		transpose4x4_lanes( x, y, z, w );
+		store_split( out, out + 16, x ); store_split( out + 4, out + 20, y );
+		store_split( out + 8, out + 24, z ); store_split( out + 12, out + 28, w );
+	}
+#endif
+#if defined(PAL_HAS_FVEC4)
+	const detail::xform_mat4<fvec4> k4( m );
+	for ( ; n >= 4; n -= 4, in += 16, out += 16 )
+	{
+		fvec4 x = load4f( in ), y = load4f( in + 4 ), z = load4f( in + 8 ), w = load4f( in + 12 );
+		transpose4x4( x, y, z, w );
+		k4( x, y, z, w );
+		transpose4x4( x, y, z, w );
+		store( out, x ); store( out + 4, y ); store( out + 8, z ); store( out + 12, w );
+	}
+#endif
+	const detail::xform_mat4<float> k1( m );
+	for ( ; n > 0; --n, in += 4, out += 4 )
+	{
+		float x = in[0], y = in[1], z = in[2], w = in[3];
+		k1( x, y, z, w );
+		out[0] = x; out[1] = y; out[2] = z; out[3] = w;
+	}
+}
+
+/// @brief transforms n planar points (x, y, z, 1) by a row-major 4x4
+/// matrix
+///
+/// If the bottom row of the matrix is (0, 0, 0, 1), the affine path
+/// skips computing w, otherwise the result is divided by w (set
+/// project to false to skip the divide and the w computation
+/// regardless, i.e. for the affine part of a projective matrix). The
+/// outputs may alias the inputs.
+inline void
+transform_points( float *out0, float *out1, float *out2,
+				  const float *in0, const float *in1, const float *in2,
+				  const float (&m)[16], size_t n, bool project = true )
+{
+	if ( ! project || detail::is_affine( m ) )
+		detail::xform_planar3<detail::xform_affine>( out0, out1, out2, in0, in1, in2, n, m );
+	else
+		detail::xform_planar3<detail::xform_projective>( out0, out1, out2, in0, in1, in2, n, m );
+}
+
+/// @brief transforms n interleaved points (xyz xyz...) by a row-major
+/// 4x4 matrix
+///
+/// @sa transform_points
+inline void
+transform_points_interleaved( float *out, const float *in, const float (&m)[16], size_t n, bool project = true )
+{
+	if ( ! project || detail::is_affine( m ) )
+		detail::xform_interleaved3<detail::xform_affine>( out, in, n, m );
+	else
+		detail::xform_interleaved3<detail::xform_projective>( out, in, n, m );
+}
+
+} // namespace pal
+
+#endif // _PAL_BUFFER_TRANSFORM_H_
@@ -124,7 +124,15 @@
 #  define PAL_ENABLE_AVX_512 1
 #  define PAL_ENABLE_512BIT_X86_VALUES 1
 # endif
-// TODO: add checks for various extnsions of AVX512
+// TODO: add checks for the rest of the extensions of AVX512
+# if defined(__AVX512DQ__)
+// 64-bit multiply, conversions between 64-bit integers and float
+#  define PAL_ENABLE_AVX_512DQ 1
+# endif
+# if defined(__AVX512VL__)
+// the AVX512 instructions on 128 and 256-bit registers
+#  define PAL_ENABLE_AVX_512VL 1
+# endif
 
 // The following are useful processor extensions that
 // may be enabled by compiling for one of the above
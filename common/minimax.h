@@ -0,0 +1,361 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use <pal/common/minimax.h> directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_COMMON_MINIMAX_H_
+# define _PAL_COMMON_MINIMAX_H_ 1
+
+#include <vector>
+#include <array>
+#include <cmath>
+#include <limits>
+
+////////////////////////////////////////
+
+namespace PAL_NAMESPACE
+{
+
+/// @brief result of a minimax polynomial fit
+///
+/// coefficients are lowest order first, so as<float>() can be passed
+/// directly to polyval
+template <size_t Degree>
+struct minimax_poly_result
+{
+	std::array<double, Degree + 1> coeffs;
+	/// maximum (absolute or relative, per the fit) error on the interval
+	double max_error = 0.0;
+	int iterations = 0;
+	/// false if the exchange did not settle, coeffs are then the best
+	/// found
+	bool converged = false;
+
+	template <typename T>
+	std::array<T, Degree + 1> as( void ) const
+	{
+		std::array<T, Degree + 1> r;
+		for ( size_t i = 0; i != Degree + 1; ++i )
+			r[i] = static_cast<T>( coeffs[i] );
+		return r;
+	}
+};
+
+/// @brief result of a minimax rational fit p( x ) / q( x ), q[0] is
+/// always 1
+///
+/// coefficients are lowest order first, so p_as<float>() and
+/// q_as<float>() can be passed directly to ratval
+template <size_t NumDegree, size_t DenDegree>
+struct minimax_rational_result
+{
+	std::array<double, NumDegree + 1> p;
+	std::array<double, DenDegree + 1> q;
+	double max_error = 0.0;
+	int iterations = 0;
+	bool converged = false;
+
+	template <typename T>
+	std::array<T, NumDegree + 1> p_as( void ) const
+	{
+		std::array<T, NumDegree + 1> r;
+		for ( size_t i = 0; i != NumDegree + 1; ++i )
+			r[i] = static_cast<T>( p[i] );
+		return r;
+	}
+
+	template <typename T>
+	std::array<T, DenDegree + 1> q_as( void ) const
+	{
+		std::array<T, DenDegree + 1> r;
+		for ( size_t i = 0; i != DenDegree + 1; ++i )
+			r[i] = static_cast<T>( q[i] );
+		return r;
+	}
+};
+
+namespace detail
+{
+
+/// @brief gaussian elimination with partial pivoting, A is n x n row
+/// major, the solution replaces b
+inline bool
+minimax_solve( std::vector<long double> &A, std::vector<long double> &b, size_t n )
+{
+	for ( size_t c = 0; c != n; ++c )
+	{
+		size_t piv = c;
+		for ( size_t r = c + 1; r < n; ++r )
+			if ( std::fabs( A[r * n + c] ) > std::fabs( A[piv * n + c] ) )
+				piv = r;
+		if ( A[piv * n + c] == 0.0L )
+			return false;
+		if ( piv != c )
+		{
+			for ( size_t k = 0; k != n; ++k )
+				std::swap( A[c * n + k], A[piv * n + k] );
+			std::swap( b[c], b[piv] );
+		}
+		for ( size_t r = 0; r != n; ++r )
+		{
+			if ( r == c )
+				continue;
+			long double f = A[r * n + c] / A[c * n + c];
+			if ( f == 0.0L )
+				continue;
+			for ( size_t k = c; k != n; ++k )
+				A[r * n + k] -= f * A[c * n + k];
+			b[r] -= f * b[c];
+		}
+	}
+	for ( size_t c = 0; c != n; ++c )
+		b[c] /= A[c * n + c];
+	return true;
+}
+
+inline long double
+minimax_horner( const std::vector<long double> &c, long double x )
+{
+	long double r = 0.0L;
+	for ( size_t i = c.size(); i > 0; --i )
+		r = r * x + c[i - 1];
+	return r;
+}
+
+/// @brief rational remez exchange, with nq == 0 it is the classic
+/// polynomial remez
+///
+/// Solves for p, q (q0 == 1) and the levelled error E on a reference
+/// of np + nq + 2 points, then moves the reference to the extrema of
+/// the error curve, until the extrema are level.
+template <typename F>
+bool
+remez( F f, double lo, double hi, size_t np, size_t nq, bool relative,
+	   std::vector<long double> &p, std::vector<long double> &q,
+	   double &maxerr, int &iters )
+{
+	const size_t N = np + nq + 2;
+	const size_t M = 4096 + 256 * N;
+	const long double mid = ( (long double)lo + hi ) * 0.5L;
+	const long double half = ( (long double)hi - lo ) * 0.5L;
+	const long double pi = 3.14159265358979323846264338327950288L;
+	iters = 0;
+
+	// chebyshev extrema as the initial reference, and a chebyshev
+	// distributed grid to search for the extrema of the error
+	std::vector<long double> ref( N ), grid( M + 1 ), fg( M + 1 ), err( M + 1 );
+	for ( size_t i = 0; i != N; ++i )
+		ref[i] = mid - half * std::cos( pi * (long double)i / (long double)( N - 1 ) );
+	for ( size_t i = 0; i <= M; ++i )
+	{
+		grid[i] = mid - half * std::cos( pi * (long double)i / (long double)M );
+		fg[i] = f( (double)grid[i] );
+		// relative error is undefined across a zero of f
+		if ( relative && ( fg[i] == 0.0L || ( fg[i] < 0.0L ) != ( fg[0] < 0.0L ) ) )
+			return false;
+	}
+
+	auto weight = [relative]( long double fx ) -> long double {
+		return relative ? 1.0L / std::fabs( fx ) : 1.0L;
+	};
+	auto evalerr = [&]( long double x, long double fx ) -> long double {
+		long double r = minimax_horner( p, x ) / minimax_horner( q, x );
+		return ( r - fx ) * weight( fx );
+	};
+
+	std::vector<long double> A( N * N ), b( N );
+	std::vector<long double> bestp, bestq;
+	double besterr = std::numeric_limits<double>::infinity();
+	bool converged = false;
+	long double E = 0.0L;
+
+	for ( int it = 0; it < 64; ++it )
+	{
+		iters = it + 1;
+		// solve for p, q and E on the reference. The E * q( x ) term
+		// makes the rational system non-linear, so the linearized
+		// solution (using the previous E in that term) is refined with
+		// newton's method, the polynomial case is exact in one pass
+		bool ok = true;
+		for ( size_t i = 0; i != N; ++i )
+		{
+			long double x = ref[i];
+			long double fx = f( (double)x );
+			long double ew = ( ( i & 1 ) ? -1.0L : 1.0L ) / weight( fx );
+			long double y = fx + ew * E;
+			long double xp = 1.0L;
+			for ( size_t k = 0; k <= np; ++k, xp *= x )
+				A[i * N + k] = xp;
+			xp = x;
+			for ( size_t k = 0; k != nq; ++k, xp *= x )
+				A[i * N + np + 1 + k] = - y * xp;
+			A[i * N + N - 1] = - ew;
+			b[i] = fx;
+		}
+		ok = minimax_solve( A, b, N );
+		std::vector<long double> z( b );
+		for ( int step = 0; ok && nq && step < 32; ++step )
+		{
+			p.assign( z.begin(), z.begin() + np + 1 );
+			q.assign( 1, 1.0L );
+			q.insert( q.end(), z.begin() + np + 1, z.begin() + np + 1 + nq );
+			E = z[N - 1];
+			for ( size_t i = 0; i != N; ++i )
+			{
+				long double x = ref[i];
+				long double fx = f( (double)x );
+				long double ew = ( ( i & 1 ) ? -1.0L : 1.0L ) / weight( fx );
+				long double y = fx + ew * E;
+				long double xp = 1.0L;
+				for ( size_t k = 0; k <= np; ++k, xp *= x )
+					A[i * N + k] = xp;
+				xp = x;
+				for ( size_t k = 0; k != nq; ++k, xp *= x )
+					A[i * N + np + 1 + k] = - y * xp;
+				A[i * N + N - 1] = - ew * minimax_horner( q, x );
+				b[i] = y * minimax_horner( q, x ) - minimax_horner( p, x );
+			}
+			ok = minimax_solve( A, b, N );
+			for ( size_t k = 0; ok && k != N; ++k )
+				z[k] += b[k];
+			if ( ok && std::fabs( b[N - 1] ) <= 1e-12L * std::fabs( z[N - 1] ) )
+				break;
+		}
+		if ( ! ok )
+			break;
+		p.assign( z.begin(), z.begin() + np + 1 );
+		q.assign( 1, 1.0L );
+		q.insert( q.end(), z.begin() + np + 1, z.begin() + np + 1 + nq );
+		E = z[N - 1];
+
+		// a sign change in the denominator is a pole in the interval
+		bool pole = false;
+		const bool qneg = minimax_horner( q, grid[0] ) < 0.0L;
+		for ( size_t i = 0; i <= M; ++i )
+		{
+			long double qx = minimax_horner( q, grid[i] );
+			if ( qx == 0.0L || ( qx < 0.0L ) != qneg )
+			{
+				pole = true;
+				break;
+			}
+			err[i] = evalerr( grid[i], fg[i] );
+		}
+		if ( pole )
+			break;
+
+		// split the error curve at the sign changes and take the
+		// extremum of each section
+		std::vector<size_t> ext;
+		size_t best = 0;
+		for ( size_t i = 1; i <= M; ++i )
+		{
+			if ( ( err[i] >= 0.0L ) != ( err[best] >= 0.0L ) )
+			{
+				ext.push_back( best );
+				best = i;
+			}
+			else if ( std::fabs( err[i] ) > std::fabs( err[best] ) )
+				best = i;
+		}
+		ext.push_back( best );
+
+		long double emax = 0.0L;
+		for ( size_t i = 0; i <= M; ++i )
+			emax = std::max( emax, std::fabs( err[i] ) );
+		if ( double( emax ) < besterr )
+		{
+			besterr = double( emax );
+			bestp = p;
+			bestq = q;
+		}
+
+		if ( ext.size() < N )
+			break;
+		while ( ext.size() > N )
+		{
+			if ( std::fabs( err[ext.front()] ) < std::fabs( err[ext.back()] ) )
+				ext.erase( ext.begin() );
+			else
+				ext.pop_back();
+		}
+
+		long double emin = emax;
+		for ( size_t i = 0; i != N; ++i )
+		{
+			ref[i] = grid[ext[i]];
+			emin = std::min( emin, std::fabs( err[ext[i]] ) );
+		}
+		if ( emax - emin <= 1e-4L * emax )
+		{
+			converged = true;
+			break;
+		}
+	}
+
+	if ( bestp.empty() )
+		return false;
+	p = bestp;
+	q = bestq;
+	maxerr = besterr;
+	return converged;
+}
+
+} // namespace detail
+
+////////////////////////////////////////
+
+/// @brief computes the minimax polynomial of the given degree
+/// approximating f on [lo, hi]
+///
+/// This is meant to be used offline (see the minimax_fit tool) or
+/// once at startup, not in inner loops. With relative set the
+/// relative error is minimized, so f must not have a zero in the
+/// interval. The coefficients are in terms of x, so keep the
+/// interval reasonably near the origin or the fit becomes ill
+/// conditioned; shift the argument first if needed.
+template <size_t Degree, typename F>
+minimax_poly_result<Degree>
+minimax_poly( F f, double lo, double hi, bool relative = false )
+{
+	minimax_poly_result<Degree> r;
+	std::vector<long double> p, q;
+	r.max_error = std::numeric_limits<double>::infinity();
+	r.converged = detail::remez( f, lo, hi, Degree, 0, relative, p, q, r.max_error, r.iterations );
+	for ( size_t i = 0; i != Degree + 1; ++i )
+		r.coeffs[i] = i < p.size() ? double( p[i] ) : 0.0;
+	return r;
+}
+
+/// @brief computes the minimax rational approximation p( x ) / q( x )
+/// of f on [lo, hi]
+///
+/// A rational can be much more accurate than a polynomial with the
+/// same number of coefficients for functions with steep sections
+/// (log curves, PQ), at the cost of a division.
+///
+/// @sa minimax_poly
+template <size_t NumDegree, size_t DenDegree, typename F>
+minimax_rational_result<NumDegree, DenDegree>
+minimax_rational( F f, double lo, double hi, bool relative = false )
+{
+	minimax_rational_result<NumDegree, DenDegree> r;
+	std::vector<long double> p, q;
+	r.max_error = std::numeric_limits<double>::infinity();
+	r.converged = detail::remez( f, lo, hi, NumDegree, DenDegree, relative, p, q, r.max_error, r.iterations );
+	for ( size_t i = 0; i != NumDegree + 1; ++i )
+		r.p[i] = i < p.size() ? double( p[i] ) : 0.0;
+	for ( size_t i = 0; i != DenDegree + 1; ++i )
+		r.q[i] = i < q.size() ? double( q[i] ) : ( i == 0 ? 1.0 : 0.0 );
+	return r;
+}
+
+} // namespace pal
+
+#endif // _PAL_COMMON_MINIMAX_H_
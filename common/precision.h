@@ -0,0 +1,78 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use <pal/common/precision.h> directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_COMMON_PRECISION_H_
+# define _PAL_COMMON_PRECISION_H_ 1
+
+#include <type_traits>
+
+////////////////////////////////////////
+
+namespace PAL_NAMESPACE
+{
+
+/// @brief compile-time precision policy for the math functions
+///
+/// The transcendental functions (logf, expf, powf, sinf, ...) accept
+/// an optional trailing precision tag which requests a minimum
+/// number of correct mantissa bits. The implementation picks the
+/// cheapest polynomial which meets that request, so a whole pipeline
+/// can be switched to a cheaper approximation by changing one
+/// typedef:
+///
+/// @code
+/// typedef pal::precision<12> prec;
+/// y = pal::powf( x, g, prec() );
+/// @endcode
+///
+/// There are currently three tiers: up to 12 bits, up to 18 bits,
+/// and full single precision. logf / log2f / log10f, expf / exp2f /
+/// exp10f, powf, cbrtf, sinf / cosf / sincosf, recip, rsqrtf and
+/// sqrtf have cheaper kernels for the lower tiers. The other float
+/// functions (atanf / atan2f, erff / erfcf, tgammaf / lgammaf,
+/// normcdfinvf, expm1f / log1pf, sinhf / coshf / tanhf) accept the
+/// tag but are always full precision. The bit counts are relative error
+/// bounds on the primary range of the function. Anything which
+/// amplifies error (powf with large exponents, trig with large
+/// arguments) is bounded by the kernels, not the final result.
+template <int bits>
+struct precision
+{
+	static_assert( bits > 0 && bits <= 24, "precision is specified as bits of float mantissa" );
+	static const int value = bits;
+};
+
+typedef precision<12> precision_low;
+typedef precision<18> precision_medium;
+typedef precision<23> precision_full;
+
+namespace detail
+{
+
+typedef std::integral_constant<int, 0> tier_low;
+typedef std::integral_constant<int, 1> tier_medium;
+typedef std::integral_constant<int, 2> tier_full;
+
+/// @brief maps a requested bit count to the implementation tier
+///
+/// Derives from one of the tier_ integral constants above such that
+/// implementations can use normal overload resolution to select a
+/// kernel.
+template <int bits>
+struct precision_tier
+	: std::integral_constant<int, ( bits <= 12 ? 0 : ( bits <= 18 ? 1 : 2 ) )>
+{};
+
+} // namespace detail
+
+} // namespace pal
+
+#endif // _PAL_COMMON_PRECISION_H_
@@ -19,17 +19,41 @@
 namespace PAL_NAMESPACE
 {
 
+namespace detail
+{
+
+template <typename... Ts> struct make_void { typedef void type; };
+
+/// @brief true for the types with the value_type and mask_type of
+/// the vectors, so the traits below are false (instead of an error)
+/// for scalars and overloads like exp( double ) stay usable next to
+/// the vector versions
+template <typename V, typename = void>
+struct has_vec_types : std::false_type {};
+
 template <typename V>
+struct has_vec_types<V, typename make_void<typename V::value_type, typename V::mask_type>::type>
+	: std::true_type {};
+
+} // namespace detail
+
+template <typename V, bool = detail::has_vec_types<V>::value>
 struct is_float_vec : std::integral_constant<bool,std::is_floating_point<typename V::value_type>::value && sizeof(typename V::value_type) == 4 && std::is_class<typename V::mask_type>::value>
 {};
-
 template <typename V>
+struct is_float_vec<V, false> : std::false_type {};
+
+template <typename V, bool = detail::has_vec_types<V>::value>
 struct is_double_vec : std::integral_constant<bool,std::is_floating_point<typename V::value_type>::value && sizeof(typename V::value_type) == 8 && std::is_class<typename V::mask_type>::value>
 {};
-
 template <typename V>
+struct is_double_vec<V, false> : std::false_type {};
+
+template <typename V, bool = detail::has_vec_types<V>::value>
 struct is_floating_point_vec : std::integral_constant<bool,std::is_floating_point<typename V::value_type>::value && std::is_class<typename V::mask_type>::value>
 {};
+template <typename V>
+struct is_floating_point_vec<V, false> : std::false_type {};
 
 #if __cplusplus >= 201703L
 template <typename V> inline constexpr bool is_float_vec_v = is_float_vec<V>::value;
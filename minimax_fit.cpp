@@ -0,0 +1,317 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+// Generates minimax polynomial / rational coefficients for custom
+// approximations.
+//
+// Fits one of the known functions over an interval using the remez
+// exchange in common/minimax.h, then re-checks the fit with the
+// coefficients rounded to float and evaluated with pal::polyval, and
+// prints a coefficient array ready to paste next to a kernel.
+//
+// usage: minimax_fit [-rel] [-p exponent] [-den M] [-name ident] func lo hi degree
+//
+// examples:
+//   minimax_fit -rel exp -0.34657359 0.34657359 5
+//   minimax_fit -p 0.41666667 pow 0.5 1 6
+//   minimax_fit -den 3 pq_to_linear 0 1 4
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <math.h>
+
+#include "pal.h"
+
+using namespace pal;
+
+////////////////////////////////////////
+
+namespace
+{
+
+static double theParam = 1.0;
+
+static double pq_to_linear( double x )
+{
+	const double m1 = 2610.0 / 16384.0, m2 = 2523.0 / 4096.0 * 128.0;
+	const double c1 = 3424.0 / 4096.0, c2 = 2413.0 / 4096.0 * 32.0, c3 = 2392.0 / 4096.0 * 32.0;
+	double p = pow( x, 1.0 / m2 );
+	return pow( std::max( p - c1, 0.0 ) / ( c2 - c3 * p ), 1.0 / m1 );
+}
+
+static double linear_to_pq( double x )
+{
+	const double m1 = 2610.0 / 16384.0, m2 = 2523.0 / 4096.0 * 128.0;
+	const double c1 = 3424.0 / 4096.0, c2 = 2413.0 / 4096.0 * 32.0, c3 = 2392.0 / 4096.0 * 32.0;
+	double p = pow( x, m1 );
+	return pow( ( c1 + c2 * p ) / ( 1.0 + c3 * p ), m2 );
+}
+
+static const double hlg_a = 0.17883277, hlg_b = 0.28466892, hlg_c = 0.55991073;
+
+struct fit_function
+{
+	const char *name;
+	double (*f)( double );
+	const char *desc;
+};
+
+static fit_function theFunctions[] =
+{
+	{ "exp", []( double x ) { return exp( x ); }, "e^x" },
+	{ "exp2", []( double x ) { return exp2( x ); }, "2^x" },
+	{ "expm1", []( double x ) { return expm1( x ); }, "e^x - 1" },
+	{ "log", []( double x ) { return log( x ); }, "ln( x )" },
+	{ "log2", []( double x ) { return log2( x ); }, "log2( x )" },
+	{ "log1p", []( double x ) { return log1p( x ); }, "ln( 1 + x )" },
+	{ "sin", []( double x ) { return sin( x ); }, "sin( x )" },
+	{ "cos", []( double x ) { return cos( x ); }, "cos( x )" },
+	{ "tan", []( double x ) { return tan( x ); }, "tan( x )" },
+	{ "atan", []( double x ) { return atan( x ); }, "atan( x )" },
+	{ "sqrt", []( double x ) { return sqrt( x ); }, "sqrt( x )" },
+	{ "cbrt", []( double x ) { return cbrt( x ); }, "cbrt( x )" },
+	{ "pow", []( double x ) { return pow( x, theParam ); }, "x^p (-p)" },
+	{ "srgb_to_linear", []( double x ) {
+			return x <= 0.04045 ? x / 12.92 : pow( ( x + 0.055 ) / 1.055, 2.4 ); }, "sRGB EOTF" },
+	{ "linear_to_srgb", []( double x ) {
+			return x <= 0.0031308 ? x * 12.92 : 1.055 * pow( x, 1.0 / 2.4 ) - 0.055; }, "sRGB inverse EOTF" },
+	{ "rec709_to_linear", []( double x ) {
+			return x < 0.081 ? x / 4.5 : pow( ( x + 0.099 ) / 1.099, 1.0 / 0.45 ); }, "BT.709 inverse OETF" },
+	{ "linear_to_rec709", []( double x ) {
+			return x < 0.018 ? x * 4.5 : 1.099 * pow( x, 0.45 ) - 0.099; }, "BT.709 OETF" },
+	{ "pq_to_linear", pq_to_linear, "ST 2084 EOTF, 1 == 10000 nits" },
+	{ "linear_to_pq", linear_to_pq, "ST 2084 inverse EOTF" },
+	{ "hlg_to_linear", []( double x ) {
+			return x <= 0.5 ? x * x / 3.0 : ( exp( ( x - hlg_c ) / hlg_a ) + hlg_b ) / 12.0; }, "BT.2100 HLG inverse OETF" },
+	{ "linear_to_hlg", []( double x ) {
+			return x <= 1.0 / 12.0 ? sqrt( 3.0 * x ) : hlg_a * log( 12.0 * x - hlg_b ) + hlg_c; }, "BT.2100 HLG OETF" },
+	{ "logc3_to_linear", []( double x ) {
+			return x > 5.367655 * 0.010591 + 0.092809
+				? ( pow( 10.0, ( x - 0.385537 ) / 0.247190 ) - 0.052272 ) / 5.555556
+				: ( x - 0.092809 ) / 5.367655; }, "ARRI LogC3 (EI 800) decode" },
+	{ "linear_to_logc3", []( double x ) {
+			return x > 0.010591
+				? 0.247190 * log10( 5.555556 * x + 0.052272 ) + 0.385537
+				: 5.367655 * x + 0.092809; }, "ARRI LogC3 (EI 800) encode" },
+	{ "slog3_to_linear", []( double x ) {
+			return x >= 171.2102946929 / 1023.0
+				? pow( 10.0, ( x * 1023.0 - 420.0 ) / 261.5 ) * ( 0.18 + 0.01 ) - 0.01
+				: ( x * 1023.0 - 95.0 ) * 0.01125 / ( 171.2102946929 - 95.0 ); }, "Sony S-Log3 decode" },
+	{ "linear_to_slog3", []( double x ) {
+			return x >= 0.01125
+				? ( 420.0 + log10( ( x + 0.01 ) / ( 0.18 + 0.01 ) ) * 261.5 ) / 1023.0
+				: ( x * ( 171.2102946929 - 95.0 ) / 0.01125 + 95.0 ) / 1023.0; }, "Sony S-Log3 encode" },
+};
+
+////////////////////////////////////////
+
+/// re-checks the fit in single precision, as it will be used
+template <typename E>
+static double
+float_error( double (*f)( double ), double lo, double hi, bool relative, E eval )
+{
+	const int N = 1 << 20;
+	double maxerr = 0.0;
+	for ( int i = 0; i < N; i += 4 )
+	{
+		float xs[4];
+		for ( int k = 0; k < 4; ++k )
+			xs[k] = float( lo + ( hi - lo ) * double( i + k ) / double( N - 1 ) );
+		fvec4 r = eval( fvec4( xs[0], xs[1], xs[2], xs[3] ) );
+		for ( int k = 0; k < 4; ++k )
+		{
+			double fx = f( double( xs[k] ) );
+			double e = fabs( double( r[k] ) - fx );
+			if ( relative )
+				e /= fabs( fx );
+			maxerr = std::max( maxerr, e );
+		}
+	}
+	return maxerr;
+}
+
+static void
+print_coeffs( std::ostream &os, const std::string &name, const std::vector<double> &c )
+{
+	os << "static constexpr float " << name << "[] = {\n";
+	for ( size_t i = 0; i != c.size(); ++i )
+		os << "\t" << std::scientific << std::setprecision( 9 ) << float( c[i] ) << "F"
+		   << ( i + 1 != c.size() ? "," : "" ) << "\n";
+	os << "};\n";
+}
+
+static double bits( double err )
+{
+	return err > 0.0 ? -log2( err ) : 64.0;
+}
+
+template <size_t N, size_t M>
+static int
+fit_rational( const fit_function &fn, double lo, double hi, bool relative, const std::string &name )
+{
+	auto r = minimax_rational<N, M>( fn.f, lo, hi, relative );
+	if ( ! std::isfinite( r.max_error ) )
+	{
+		std::cerr << "Fit failed, the denominator has a pole in the interval" << std::endl;
+		return -1;
+	}
+	std::vector<double> p( r.p.begin(), r.p.end() ), q( r.q.begin(), r.q.end() );
+	std::array<float, N + 1> pf = r.template p_as<float>();
+	std::array<float, M + 1> qf = r.template q_as<float>();
+	double ferr = float_error( fn.f, lo, hi, relative, [&]( fvec4 x ) { return ratval( x, pf, qf ); } );
+
+	std::cout << "// " << fn.name << " on [" << lo << ", " << hi << "], degree "
+			  << N << " / " << M << ( r.converged ? "" : " (not converged)" ) << "\n"
+			  << "// " << ( relative ? "relative" : "absolute" ) << " error "
+			  << std::scientific << std::setprecision( 3 ) << r.max_error
+			  << " (~" << std::fixed << std::setprecision( 1 ) << bits( r.max_error ) << " bits), in float "
+			  << std::scientific << std::setprecision( 3 ) << ferr
+			  << " (~" << std::fixed << std::setprecision( 1 ) << bits( ferr ) << " bits)\n"
+			  << "// y = ratval( x, " << name << "_p, " << name << "_q )\n";
+	print_coeffs( std::cout, name + "_p", p );
+	print_coeffs( std::cout, name + "_q", q );
+	return 0;
+}
+
+template <size_t N>
+static int
+fit_poly( const fit_function &fn, double lo, double hi, bool relative, const std::string &name )
+{
+	auto r = minimax_poly<N>( fn.f, lo, hi, relative );
+	if ( ! std::isfinite( r.max_error ) )
+	{
+		std::cerr << "Fit failed, check the interval (and that f has no zero in it for -rel)" << std::endl;
+		return -1;
+	}
+	std::vector<double> c( r.coeffs.begin(), r.coeffs.end() );
+	std::array<float, N + 1> cf = r.template as<float>();
+	double ferr = float_error( fn.f, lo, hi, relative, [&]( fvec4 x ) { return polyval( x, cf ); } );
+
+	std::cout << "// " << fn.name << " on [" << lo << ", " << hi << "], degree " << N
+			  << ( r.converged ? "" : " (not converged)" ) << "\n"
+			  << "// " << ( relative ? "relative" : "absolute" ) << " error "
+			  << std::scientific << std::setprecision( 3 ) << r.max_error
+			  << " (~" << std::fixed << std::setprecision( 1 ) << bits( r.max_error ) << " bits), in float "
+			  << std::scientific << std::setprecision( 3 ) << ferr
+			  << " (~" << std::fixed << std::setprecision( 1 ) << bits( ferr ) << " bits)\n"
+			  << "// y = polyval( x, " << name << " )\n";
+	print_coeffs( std::cout, name, c );
+	return 0;
+}
+
+typedef int (*fit_func)( const fit_function &, double, double, bool, const std::string & );
+
+// the degrees are template parameters, so the supported range is
+// enumerated here
+static const fit_func thePolyFits[] =
+{
+	fit_poly<1>, fit_poly<2>, fit_poly<3>, fit_poly<4>, fit_poly<5>, fit_poly<6>,
+	fit_poly<7>, fit_poly<8>, fit_poly<9>, fit_poly<10>, fit_poly<11>, fit_poly<12>
+};
+
+static const fit_func theRationalFits[][4] =
+{
+	{ fit_rational<1, 1>, fit_rational<1, 2>, fit_rational<1, 3>, fit_rational<1, 4> },
+	{ fit_rational<2, 1>, fit_rational<2, 2>, fit_rational<2, 3>, fit_rational<2, 4> },
+	{ fit_rational<3, 1>, fit_rational<3, 2>, fit_rational<3, 3>, fit_rational<3, 4> },
+	{ fit_rational<4, 1>, fit_rational<4, 2>, fit_rational<4, 3>, fit_rational<4, 4> },
+	{ fit_rational<5, 1>, fit_rational<5, 2>, fit_rational<5, 3>, fit_rational<5, 4> },
+	{ fit_rational<6, 1>, fit_rational<6, 2>, fit_rational<6, 3>, fit_rational<6, 4> }
+};
+
+static void
+usage( const char *argv0 )
+{
+	std::cout << "Usage: " << argv0 << " [-rel] [-p exponent] [-den M] [-name ident] func lo hi degree\n\n"
+			  << "  -rel        minimize relative instead of absolute error\n"
+			  << "  -p E        exponent for pow\n"
+			  << "  -den M      fit a rational with denominator degree M (1-4, numerator 1-6)\n"
+			  << "  -name N     name of the emitted array\n\n"
+			  << "Functions:\n";
+	for ( const fit_function &fn: theFunctions )
+		std::cout << "  " << std::left << std::setw( 18 ) << fn.name << fn.desc << "\n";
+}
+
+} // empty namespace
+
+////////////////////////////////////////
+
+int main( int argc, char *argv[] )
+{
+	bool relative = false;
+	int den = 0;
+	std::string name;
+	std::vector<std::string> args;
+
+	for ( int a = 1; a < argc; ++a )
+	{
+		std::string arg = argv[a];
+		if ( arg == "-rel" )
+			relative = true;
+		else if ( arg == "-p" && ( a + 1 ) < argc )
+			theParam = atof( argv[++a] );
+		else if ( arg == "-den" && ( a + 1 ) < argc )
+			den = atoi( argv[++a] );
+		else if ( arg == "-name" && ( a + 1 ) < argc )
+			name = argv[++a];
+		else if ( arg == "-h" || arg == "-help" )
+		{
+			usage( argv[0] );
+			return 0;
+		}
+		else
+			args.push_back( arg );
+	}
+
+	if ( args.size() != 4 )
+	{
+		usage( argv[0] );
+		return -1;
+	}
+
+	const fit_function *fn = nullptr;
+	for ( const fit_function &f: theFunctions )
+		if ( args[0] == f.name )
+			fn = &f;
+	if ( ! fn )
+	{
+		std::cerr << "Unknown function '" << args[0] << "', use -h for the list" << std::endl;
+		return -1;
+	}
+
+	double lo = atof( args[1].c_str() );
+	double hi = atof( args[2].c_str() );
+	int degree = atoi( args[3].c_str() );
+	if ( ! ( lo < hi ) )
+	{
+		std::cerr << "Invalid interval [" << lo << ", " << hi << "]" << std::endl;
+		return -1;
+	}
+	if ( name.empty() )
+		name = args[0] + "_coeffs";
+
+	if ( den > 0 )
+	{
+		if ( degree < 1 || degree > 6 || den > 4 )
+		{
+			std::cerr << "Rational fits support numerator degree 1-6 and denominator degree 1-4" << std::endl;
+			return -1;
+		}
+		return theRationalFits[degree - 1][den - 1]( *fn, lo, hi, relative, name );
+	}
+
+	if ( degree < 1 || degree > 12 )
+	{
+		std::cerr << "Polynomial fits support degree 1-12" << std::endl;
+		return -1;
+	}
+	return thePolyFits[degree - 1]( *fn, lo, hi, relative, name );
+}
@@ -22,6 +22,11 @@
 #include <iomanip>
 #include <initializer_list>
 #include <array>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <thread>
+#include <memory>
 
 /// @brief namespace that will be used by this library
 ///
@@ -33,6 +38,8 @@ namespace pal = PAL_v1_0;
 #define PAL_NAMESPACE PAL_v1_0
 
 #include "common/type_utils.h"
+#include "common/precision.h"
+#include "common/minimax.h"
 
 /// @brief The top-level namespace for all elements declared.
 ///
@@ -74,9 +81,18 @@ template <typename vtype> struct vector_limits {};
 #  include "x86/simd_constants.h"
 #  include "x86/simd_permute.h"
 #  include "x86/simd_load_store.h"
+#  include "x86/simd_transpose.h"
+#  include "x86/simd_sort.h"
+#  include "x86/simd_compress.h"
 #  include "x86/simd_math.h"
+#  include "x86/simd_poly.h"
 #  include "x86/simd_log_exp.h"
 #  include "x86/simd_trig.h"
+#  include "x86/simd_special.h"
+#  include "x86/simd_hyperbolic.h"
+#  include "x86/simd_transfer.h"
+#  include "x86/simd_random.h"
+#  include "x86/simd_complex.h"
 # elif defined(PAL_ENABLE_ALTIVEC_SIMD)
 //# include "altivec/simd_types.h"
 # elif defined(PAL_ENABLE_NEON_SIMD)
@@ -88,6 +104,21 @@ template <typename vtype> struct vector_limits {};
 # endif
 
 // include the buffer processing implementations
+# include "parallel.h"
 # include "buffer_process.h"
+# include "buffer_layout.h"
+# include "buffer_transform.h"
+# include "buffer_convert.h"
+# include "buffer_transfer.h"
+# include "buffer_random.h"
+# include "buffer_sort.h"
+# include "buffer_histogram.h"
+# include "buffer_reduce.h"
+# include "buffer_search.h"
+# include "buffer_compact.h"
+# include "buffer_fir.h"
+# include "buffer_blur.h"
+# include "buffer_resample.h"
+# include "buffer_fft.h"
 
 #endif // _PAL_H_
@@ -0,0 +1,72 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use pal/parallel.h directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_PARALLEL_H_
+# define _PAL_PARALLEL_H_ 1
+
+// minimal fork / join helpers for the buffer routines which offer a
+// threaded mode. There is no pool, so these are only worth it for
+// large buffers, which is what the min_chunk size is for.
+
+namespace PAL_NAMESPACE
+{
+
+/// @brief how many chunks to split n values into for the requested
+/// number of threads, where 0 requests all hardware threads, such that
+/// no chunk is smaller than min_chunk
+inline int
+parallel_chunks( size_t n, int nthreads, size_t min_chunk )
+{
+	if ( nthreads <= 0 )
+		nthreads = int( std::thread::hardware_concurrency() );
+	if ( nthreads < 1 )
+		nthreads = 1;
+	size_t maxc = n / std::max( min_chunk, size_t(1) );
+	return int( std::max( size_t(1), std::min( size_t( nthreads ), maxc ) ) );
+}
+
+/// @brief start of chunk c of n values split nchunks ways, rounded
+/// down to a multiple of 64 values so the vector loops stay whole
+inline size_t
+parallel_chunk_begin( size_t n, int nchunks, int c )
+{
+	if ( c >= nchunks )
+		return n;
+	return ( ( n / size_t( nchunks ) ) * size_t( c ) ) & ~size_t(63);
+}
+
+/// @brief calls func( chunk, begin, end ) for each of the nchunks
+/// parts of [0, n), the calling thread runs chunk 0
+template <typename F>
+inline void
+parallel_for( size_t n, int nchunks, F func )
+{
+	if ( nchunks <= 1 )
+	{
+		func( 0, size_t(0), n );
+		return;
+	}
+	std::vector<std::thread> threads;
+	threads.reserve( size_t( nchunks - 1 ) );
+	for ( int c = 1; c < nchunks; ++c )
+	{
+		threads.emplace_back( [&func, n, nchunks, c]() {
+				func( c, parallel_chunk_begin( n, nchunks, c ), parallel_chunk_begin( n, nchunks, c + 1 ) );
+			} );
+	}
+	func( 0, size_t(0), parallel_chunk_begin( n, nchunks, 1 ) );
+	for ( std::thread &t: threads )
+		t.join();
+}
+
+} // namespace pal
+
+#endif // _PAL_PARALLEL_H_
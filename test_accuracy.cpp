@@ -0,0 +1,606 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+// Accuracy vs. speed report for the pal math functions.
+//
+// Each function is swept over its domain (or over all 2^32 floats
+// with -full) and compared against the double precision libm result,
+// reporting an ULP error histogram, the max / mean error and the
+// approximate bits of precision next to the measured throughput, so
+// the fastest tier that meets a precision budget can be chosen.
+//
+// usage: test_accuracy [-full] [-samples N] [-threads N] [-hist] [name ...]
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <math.h>
+
+#include "pal.h"
+
+using namespace pal;
+
+////////////////////////////////////////
+
+namespace
+{
+
+static const int kNumBuckets = 28;
+
+struct accuracy_result
+{
+	accuracy_result( void )
+	{
+		for ( int i = 0; i != kNumBuckets; ++i )
+			hist[i] = 0;
+	}
+
+	void merge( const accuracy_result &o )
+	{
+		count += o.count;
+		special += o.special;
+		sum += o.sum;
+		if ( o.max_err > max_err )
+		{
+			max_err = o.max_err;
+			worst_input = o.worst_input;
+		}
+		if ( special_input_set == false && o.special_input_set )
+		{
+			special_input = o.special_input;
+			special_input_set = true;
+		}
+		for ( int i = 0; i != kNumBuckets; ++i )
+			hist[i] += o.hist[i];
+	}
+
+	uint64_t count = 0;
+	uint64_t special = 0;
+	double sum = 0.0;
+	double max_err = 0.0;
+	float worst_input = 0.F;
+	float special_input = 0.F;
+	bool special_input_set = false;
+	uint64_t hist[kNumBuckets];
+};
+
+// bucket 0 is exact, 1 is (0, 0.5], 2 is (0.5, 1], then powers of 2
+// up to 2^24 ulps, with the last bucket catching everything beyond
+inline int ulp_bucket( double err )
+{
+	if ( err == 0.0 )
+		return 0;
+	if ( err <= 0.5 )
+		return 1;
+	int b = 2;
+	double lim = 1.0;
+	while ( err > lim && b < ( kNumBuckets - 1 ) )
+	{
+		lim *= 2.0;
+		++b;
+	}
+	return b;
+}
+
+inline std::string bucket_label( int b )
+{
+	std::stringstream s;
+	if ( b == 0 )
+		s << "exact";
+	else if ( b == 1 )
+		s << "<= 0.5";
+	else if ( b == ( kNumBuckets - 1 ) )
+		s << "> 2^" << ( b - 3 );
+	else
+		s << "<= " << std::ldexp( 1.0, b - 2 );
+	return s.str();
+}
+
+inline float bits_to_float( uint32_t x )
+{
+	float f;
+	memcpy( &f, &x, sizeof(float) );
+	return f;
+}
+
+inline uint32_t float_to_bits( float f )
+{
+	uint32_t x;
+	memcpy( &x, &f, sizeof(float) );
+	return x;
+}
+
+// maps floats onto a monotonic integer line (-0 and +0 coincide) so
+// a domain can be swept uniformly in representable values
+inline int64_t ordered_key( float f )
+{
+	uint32_t x = float_to_bits( f );
+	if ( x & 0x80000000 )
+		return - int64_t( x & 0x7FFFFFFF );
+	return int64_t( x );
+}
+
+inline float from_ordered_key( int64_t k )
+{
+	if ( k < 0 )
+		return bits_to_float( uint32_t( -k ) | 0x80000000 );
+	return bits_to_float( uint32_t( k ) );
+}
+
+// error of the float result y in units of the float spacing at the
+// (double precision) reference value. Returns a negative number when
+// the special value handling (nan, inf, overflow) does not match
+inline double ulp_error( float y, double ref )
+{
+	if ( std::isnan( ref ) )
+		return std::isnan( y ) ? 0.0 : -1.0;
+	float fref = static_cast<float>( ref );
+	if ( std::isinf( fref ) )
+		return ( y == fref ) ? 0.0 : -1.0;
+	if ( ! std::isfinite( y ) )
+		return -1.0;
+
+	double aref = std::fabs( ref );
+	int e = ( aref < double(FLT_MIN) ) ? -126 : std::ilogb( aref );
+	double ulp = std::ldexp( 1.0, e - 23 );
+	return std::fabs( double(y) - ref ) / ulp;
+}
+
+////////////////////////////////////////
+
+template <typename F>
+void sweep_range( accuracy_result &res, int64_t start, int64_t stride, uint64_t n )
+{
+	alignas(16) float in[4];
+	alignas(16) float out[4];
+
+	uint64_t i = 0;
+	while ( i < n )
+	{
+		int c = 0;
+		for ( ; c < 4 && ( i + c ) < n; ++c )
+			in[c] = from_ordered_key( start + int64_t( i + c ) * stride );
+		for ( int p = c; p < 4; ++p )
+			in[p] = in[0];
+
+		store_aligned( out, F::eval( load4f_aligned( in ) ) );
+
+		for ( int p = 0; p < c; ++p )
+		{
+			double err = ulp_error( out[p], F::ref( double( in[p] ) ) );
+			if ( err < 0.0 )
+			{
+				++res.special;
+				if ( ! res.special_input_set )
+				{
+					res.special_input = in[p];
+					res.special_input_set = true;
+				}
+				continue;
+			}
+			++res.count;
+			res.sum += err;
+			if ( err > res.max_err )
+			{
+				res.max_err = err;
+				res.worst_input = in[p];
+			}
+			++res.hist[ulp_bucket( err )];
+		}
+		i += uint64_t( c );
+	}
+}
+
+template <typename F>
+accuracy_result
+run_accuracy( bool full, uint64_t samples, int nthreads )
+{
+	int64_t start, stride;
+	uint64_t n;
+	if ( full )
+	{
+		// every float, both signs, once (the -0 bit pattern is
+		// not visited separately)
+		start = - int64_t( 0x7FFFFFFF );
+		stride = 1;
+		n = uint64_t( 0xFFFFFFFF );
+	}
+	else
+	{
+		start = ordered_key( F::lo() );
+		int64_t end = ordered_key( F::hi() );
+		uint64_t span = uint64_t( end - start ) + 1;
+		stride = std::max( int64_t(1), int64_t( span / std::max( samples, uint64_t(1) ) ) );
+		n = ( span + uint64_t( stride ) - 1 ) / uint64_t( stride );
+	}
+
+	std::vector<accuracy_result> results( static_cast<size_t>( nthreads ) );
+	std::vector<std::thread> threads;
+	uint64_t per = ( n + uint64_t( nthreads ) - 1 ) / uint64_t( nthreads );
+	for ( int t = 0; t < nthreads; ++t )
+	{
+		uint64_t b = per * uint64_t( t );
+		if ( b >= n )
+			break;
+		uint64_t cnt = std::min( per, n - b );
+		int64_t tstart = start + int64_t( b ) * stride;
+		accuracy_result *r = &( results[size_t( t )] );
+		threads.push_back( std::thread( [=]() { sweep_range<F>( *r, tstart, stride, cnt ); } ) );
+	}
+	for ( auto &t: threads )
+		t.join();
+
+	accuracy_result ret;
+	for ( auto &r: results )
+		ret.merge( r );
+	return ret;
+}
+
+////////////////////////////////////////
+
+template <typename F>
+void
+run_throughput( double &palRate, double &libmRate )
+{
+	static const size_t kBufSize = 1 << 16;
+	static const int kReps = 64;
+
+	std::vector<float> in( kBufSize ), out( kBufSize );
+	int64_t start = ordered_key( F::lo() );
+	int64_t span = ordered_key( F::hi() ) - start;
+	for ( size_t i = 0; i != kBufSize; ++i )
+		in[i] = from_ordered_key( start + int64_t( double( span ) * double( i ) / double( kBufSize ) ) );
+
+	auto t0 = std::chrono::high_resolution_clock::now();
+	for ( int r = 0; r < kReps; ++r )
+	{
+		const float *ip = in.data();
+		float *op = out.data();
+		for ( size_t i = 0; i < kBufSize; i += 4 )
+			store( op + i, F::eval( load4f( ip + i ) ) );
+		barrier( op );
+	}
+	auto t1 = std::chrono::high_resolution_clock::now();
+	for ( int r = 0; r < kReps; ++r )
+	{
+		const float *ip = in.data();
+		float *op = out.data();
+		for ( size_t i = 0; i < kBufSize; ++i )
+			op[i] = F::libm( ip[i] );
+		barrier( op );
+	}
+	auto t2 = std::chrono::high_resolution_clock::now();
+
+	double total = double( kBufSize ) * double( kReps );
+	palRate = total / std::chrono::duration<double>( t1 - t0 ).count() * 1e-6;
+	libmRate = total / std::chrono::duration<double>( t2 - t1 ).count() * 1e-6;
+}
+
+////////////////////////////////////////
+
+struct report_entry
+{
+	const char *name;
+	const char *domain;
+	accuracy_result (*accuracy)( bool, uint64_t, int );
+	void (*throughput)( double &, double & );
+};
+
+// inverse of the standard normal CDF: a rough start (Abramowitz and
+// Stegun 26.2.23) polished by Newton steps on 0.5 erfc( -x / sqrt 2 ),
+// with p > 0.5 by symmetry (1 - p of a float is exact in double).
+// The steps leave about 1e-18 at p = 0.5, which is exactly 0
+static double ref_normcdfinv( double p )
+{
+	if ( p > 0.5 )
+		return -ref_normcdfinv( 1.0 - p );
+	if ( p == 0.5 )
+		return 0.0;
+	if ( p <= 0.0 )
+		return p == 0.0 ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+	double t = std::sqrt( -2.0 * std::log( p ) );
+	double x = ( 2.515517 + t * ( 0.802853 + t * 0.010328 ) ) / ( 1.0 + t * ( 1.432788 + t * ( 0.189269 + t * 0.001308 ) ) ) - t;
+	for ( int i = 0; i != 4; ++i )
+	{
+		double e = 0.5 * std::erfc( -x * 0.70710678118654752440 ) - p;
+		x -= e / ( 0.39894228040143267794 * std::exp( -0.5 * x * x ) );
+	}
+	return x;
+}
+
+// defines a function under test: eval is the pal implementation,
+// ref the double precision reference, libm the scalar float
+// function used as the throughput baseline, and [lo, hi] the
+// domain swept when not running the full sweep
+#define ACCURACY_FUNC( nm, expr, refexpr, libmexpr, vlo, vhi )			\
+	struct acc_##nm														\
+	{																	\
+		static fvec4 eval( fvec4 x ) { return expr; }					\
+		static double ref( double x ) { return refexpr; }				\
+		static float libm( float x ) { return libmexpr; }				\
+		static float lo( void ) { return vlo; }							\
+		static float hi( void ) { return vhi; }							\
+	}
+
+// transfer curves, T is double for the reference and float for the
+// libm baseline
+template <typename T> static T tf_srgb_to_linear( T x ) { return x <= T(0.04045) ? x / T(12.92) : std::pow( ( x + T(0.055) ) / T(1.055), T(2.4) ); }
+template <typename T> static T tf_linear_to_srgb( T x ) { return x <= T(0.0031308) ? x * T(12.92) : T(1.055) * std::pow( x, T(1) / T(2.4) ) - T(0.055); }
+template <typename T> static T tf_rec709_to_linear( T x ) { return x < T(0.081) ? x / T(4.5) : std::pow( ( x + T(0.099) ) / T(1.099), T(1) / T(0.45) ); }
+template <typename T> static T tf_linear_to_rec709( T x ) { return x < T(0.018) ? x * T(4.5) : T(1.099) * std::pow( x, T(0.45) ) - T(0.099); }
+template <typename T> static T tf_pq_to_linear( T x )
+{
+	T p = std::pow( x, T(32) / T(2523) );
+	return std::pow( std::max( p - T(3424) / T(4096), T(0) ) / ( T(2413) / T(128) - T(2392) / T(128) * p ), T(16384) / T(2610) );
+}
+template <typename T> static T tf_linear_to_pq( T x )
+{
+	T p = std::pow( x, T(2610) / T(16384) );
+	return std::pow( ( T(3424) / T(4096) + T(2413) / T(128) * p ) / ( T(1) + T(2392) / T(128) * p ), T(2523) / T(32) );
+}
+template <typename T> static T tf_hlg_to_linear( T x )
+{
+	return x <= T(0.5) ? x * x / T(3) : ( std::exp( ( x - T(0.55991073) ) / T(0.17883277) ) + T(0.28466892) ) / T(12);
+}
+template <typename T> static T tf_linear_to_hlg( T x )
+{
+	return x <= T(1) / T(12) ? std::sqrt( T(3) * x ) : T(0.17883277) * std::log( T(12) * x - T(0.28466892) ) + T(0.55991073);
+}
+
+ACCURACY_FUNC( logf, logf( x ), ::log( x ), ::logf( x ), 1e-30F, 1e30F );
+ACCURACY_FUNC( fast_logf, fast_logf( x ), ::log( x ), ::logf( x ), 1e-30F, 1e30F );
+ACCURACY_FUNC( log2f, log2f( x ), ::log2( x ), ::log2f( x ), 1e-30F, 1e30F );
+ACCURACY_FUNC( fast_log2f, fast_log2f( x ), ::log2( x ), ::log2f( x ), 1e-30F, 1e30F );
+ACCURACY_FUNC( faster_log2f, faster_log2f( x ), ::log2( x ), ::log2f( x ), 1e-30F, 1e30F );
+ACCURACY_FUNC( log10f, log10f( x ), ::log10( x ), ::log10f( x ), 1e-30F, 1e30F );
+ACCURACY_FUNC( fast_log10f, fast_log10f( x ), ::log10( x ), ::log10f( x ), 1e-30F, 1e30F );
+ACCURACY_FUNC( expf, expf( x ), ::exp( x ), ::expf( x ), -87.F, 88.F );
+ACCURACY_FUNC( fast_expf, fast_expf( x ), ::exp( x ), ::expf( x ), -87.F, 88.F );
+ACCURACY_FUNC( exp2f, exp2f( x ), ::exp2( x ), ::exp2f( x ), -126.F, 127.F );
+ACCURACY_FUNC( fast_exp2f, fast_exp2f( x ), ::exp2( x ), ::exp2f( x ), -126.F, 127.F );
+ACCURACY_FUNC( faster_exp2f, faster_exp2f( x ), ::exp2( x ), ::exp2f( x ), -126.F, 127.F );
+ACCURACY_FUNC( exp10f, exp10f( x ), ::pow( 10.0, x ), ::powf( 10.F, x ), -37.F, 38.F );
+ACCURACY_FUNC( fast_exp10f, fast_exp10f( x ), ::pow( 10.0, x ), ::powf( 10.F, x ), -37.F, 38.F );
+ACCURACY_FUNC( powf_2_4, powf( x, 2.4F ), ::pow( x, double(2.4F) ), ::powf( x, 2.4F ), 1e-10F, 1e10F );
+ACCURACY_FUNC( fast_powf_2_4, fast_powf( x, 2.4F ), ::pow( x, double(2.4F) ), ::powf( x, 2.4F ), 1e-10F, 1e10F );
+ACCURACY_FUNC( faster_powf_2_4, faster_powf( x, 2.4F ), ::pow( x, double(2.4F) ), ::powf( x, 2.4F ), 1e-10F, 1e10F );
+ACCURACY_FUNC( powf_1_2_4, powf( x, 1.F/2.4F ), ::pow( x, double(1.F/2.4F) ), ::powf( x, 1.F/2.4F ), 1e-10F, 1e10F );
+ACCURACY_FUNC( cbrtf, cbrtf( x ), ::cbrt( x ), ::cbrtf( x ), -1e30F, 1e30F );
+ACCURACY_FUNC( sinf, sinf( x ), ::sin( x ), ::sinf( x ), -10.F, 10.F );
+ACCURACY_FUNC( cosf, cosf( x ), ::cos( x ), ::cosf( x ), -10.F, 10.F );
+ACCURACY_FUNC( atanf, atanf( x ), ::atan( x ), ::atanf( x ), -1e10F, 1e10F );
+ACCURACY_FUNC( erff, erff( x ), ::erf( x ), ::erff( x ), -5.F, 5.F );
+ACCURACY_FUNC( erfcf, erfcf( x ), ::erfc( x ), ::erfcf( x ), -5.F, 10.F );
+ACCURACY_FUNC( tgammaf, tgammaf( x ), ::tgamma( x ), ::tgammaf( x ), -30.F, 30.F );
+ACCURACY_FUNC( lgammaf, lgammaf( x ), ::lgamma( x ), ::lgammaf( x ), 0.F, 1e6F );
+// libm has no inverse normal CDF, so the baseline is the reference
+ACCURACY_FUNC( normcdfinvf, normcdfinvf( x ), ref_normcdfinv( x ), float( ref_normcdfinv( x ) ), 1e-30F, 0.99999994F );
+ACCURACY_FUNC( expm1f, expm1f( x ), ::expm1( x ), ::expm1f( x ), -20.F, 88.F );
+ACCURACY_FUNC( log1pf, log1pf( x ), ::log1p( x ), ::log1pf( x ), -0.999F, 1e30F );
+ACCURACY_FUNC( sinhf, sinhf( x ), ::sinh( x ), ::sinhf( x ), -89.F, 89.F );
+ACCURACY_FUNC( coshf, coshf( x ), ::cosh( x ), ::coshf( x ), -89.F, 89.F );
+ACCURACY_FUNC( tanhf, tanhf( x ), ::tanh( x ), ::tanhf( x ), -10.F, 10.F );
+ACCURACY_FUNC( sqrtf, sqrtf( x ), ::sqrt( x ), ::sqrtf( x ), 0.F, 1e30F );
+ACCURACY_FUNC( rsqrtf, rsqrtf( x ), 1.0 / ::sqrt( x ), 1.F / ::sqrtf( x ), 1e-30F, 1e30F );
+ACCURACY_FUNC( fast_rsqrtf, fast_rsqrtf( x ), 1.0 / ::sqrt( x ), 1.F / ::sqrtf( x ), 1e-30F, 1e30F );
+ACCURACY_FUNC( faster_rsqrtf, faster_rsqrtf( x ), 1.0 / ::sqrt( x ), 1.F / ::sqrtf( x ), 1e-30F, 1e30F );
+ACCURACY_FUNC( recip, recip( x ), 1.0 / x, 1.F / x, 1e-30F, 1e30F );
+ACCURACY_FUNC( fast_recip, fast_recip( x ), 1.0 / x, 1.F / x, 1e-30F, 1e30F );
+ACCURACY_FUNC( faster_recip, faster_recip( x ), 1.0 / x, 1.F / x, 1e-30F, 1e30F );
+
+// precision tiers, see pal::precision
+ACCURACY_FUNC( logf_p12, logf( x, precision<12>() ), ::log( x ), ::logf( x ), 1e-30F, 1e30F );
+ACCURACY_FUNC( logf_p18, logf( x, precision<18>() ), ::log( x ), ::logf( x ), 1e-30F, 1e30F );
+ACCURACY_FUNC( log2f_p12, log2f( x, precision<12>() ), ::log2( x ), ::log2f( x ), 1e-30F, 1e30F );
+ACCURACY_FUNC( log2f_p18, log2f( x, precision<18>() ), ::log2( x ), ::log2f( x ), 1e-30F, 1e30F );
+ACCURACY_FUNC( expf_p12, expf( x, precision<12>() ), ::exp( x ), ::expf( x ), -87.F, 88.F );
+ACCURACY_FUNC( expf_p18, expf( x, precision<18>() ), ::exp( x ), ::expf( x ), -87.F, 88.F );
+ACCURACY_FUNC( exp2f_p12, exp2f( x, precision<12>() ), ::exp2( x ), ::exp2f( x ), -126.F, 127.F );
+ACCURACY_FUNC( exp2f_p18, exp2f( x, precision<18>() ), ::exp2( x ), ::exp2f( x ), -126.F, 127.F );
+ACCURACY_FUNC( powf_2_4_p12, powf( x, 2.4F, precision<12>() ), ::pow( x, double(2.4F) ), ::powf( x, 2.4F ), 1e-10F, 1e10F );
+ACCURACY_FUNC( powf_2_4_p18, powf( x, 2.4F, precision<18>() ), ::pow( x, double(2.4F) ), ::powf( x, 2.4F ), 1e-10F, 1e10F );
+ACCURACY_FUNC( cbrtf_p12, cbrtf( x, precision<12>() ), ::cbrt( x ), ::cbrtf( x ), -1e30F, 1e30F );
+ACCURACY_FUNC( sinf_p12, sinf( x, precision<12>() ), ::sin( x ), ::sinf( x ), -10.F, 10.F );
+ACCURACY_FUNC( sinf_p18, sinf( x, precision<18>() ), ::sin( x ), ::sinf( x ), -10.F, 10.F );
+ACCURACY_FUNC( cosf_p12, cosf( x, precision<12>() ), ::cos( x ), ::cosf( x ), -10.F, 10.F );
+ACCURACY_FUNC( cosf_p18, cosf( x, precision<18>() ), ::cos( x ), ::cosf( x ), -10.F, 10.F );
+ACCURACY_FUNC( sqrtf_p11, sqrtf( x, precision<11>() ), ::sqrt( x ), ::sqrtf( x ), 0.F, 1e30F );
+ACCURACY_FUNC( sqrtf_p21, sqrtf( x, precision<21>() ), ::sqrt( x ), ::sqrtf( x ), 0.F, 1e30F );
+ACCURACY_FUNC( srgb_to_linear, srgb_to_linear( x ), tf_srgb_to_linear( x ), tf_srgb_to_linear( x ), 1e-3F, 1.F );
+ACCURACY_FUNC( linear_to_srgb, linear_to_srgb( x ), tf_linear_to_srgb( x ), tf_linear_to_srgb( x ), 1e-3F, 1.F );
+ACCURACY_FUNC( rec709_to_linear, rec709_to_linear( x ), tf_rec709_to_linear( x ), tf_rec709_to_linear( x ), 1e-3F, 1.F );
+ACCURACY_FUNC( linear_to_rec709, linear_to_rec709( x ), tf_linear_to_rec709( x ), tf_linear_to_rec709( x ), 1e-3F, 1.F );
+ACCURACY_FUNC( pq_to_linear, pq_to_linear( x ), tf_pq_to_linear( x ), tf_pq_to_linear( x ), 0.01F, 1.F );
+ACCURACY_FUNC( linear_to_pq, linear_to_pq( x ), tf_linear_to_pq( x ), tf_linear_to_pq( x ), 1e-6F, 1.F );
+ACCURACY_FUNC( hlg_to_linear, hlg_to_linear( x ), tf_hlg_to_linear( x ), tf_hlg_to_linear( x ), 1e-3F, 1.F );
+ACCURACY_FUNC( linear_to_hlg, linear_to_hlg( x ), tf_linear_to_hlg( x ), tf_linear_to_hlg( x ), 1e-3F, 1.F );
+
+
+#define ACCURACY_ENTRY( nm, dom ) { #nm, dom, &run_accuracy<acc_##nm>, &run_throughput<acc_##nm> }
+
+static const report_entry theEntries[] =
+{
+	ACCURACY_ENTRY( logf, "[1e-30, 1e30]" ),
+	ACCURACY_ENTRY( fast_logf, "[1e-30, 1e30]" ),
+	ACCURACY_ENTRY( log2f, "[1e-30, 1e30]" ),
+	ACCURACY_ENTRY( fast_log2f, "[1e-30, 1e30]" ),
+	ACCURACY_ENTRY( faster_log2f, "[1e-30, 1e30]" ),
+	ACCURACY_ENTRY( log10f, "[1e-30, 1e30]" ),
+	ACCURACY_ENTRY( fast_log10f, "[1e-30, 1e30]" ),
+	ACCURACY_ENTRY( expf, "[-87, 88]" ),
+	ACCURACY_ENTRY( fast_expf, "[-87, 88]" ),
+	ACCURACY_ENTRY( exp2f, "[-126, 127]" ),
+	ACCURACY_ENTRY( fast_exp2f, "[-126, 127]" ),
+	ACCURACY_ENTRY( faster_exp2f, "[-126, 127]" ),
+	ACCURACY_ENTRY( exp10f, "[-37, 38]" ),
+	ACCURACY_ENTRY( fast_exp10f, "[-37, 38]" ),
+	ACCURACY_ENTRY( powf_2_4, "[1e-10, 1e10]" ),
+	ACCURACY_ENTRY( fast_powf_2_4, "[1e-10, 1e10]" ),
+	ACCURACY_ENTRY( faster_powf_2_4, "[1e-10, 1e10]" ),
+	ACCURACY_ENTRY( powf_1_2_4, "[1e-10, 1e10]" ),
+	ACCURACY_ENTRY( cbrtf, "[-1e30, 1e30]" ),
+	ACCURACY_ENTRY( sinf, "[-10, 10]" ),
+	ACCURACY_ENTRY( cosf, "[-10, 10]" ),
+	ACCURACY_ENTRY( atanf, "[-1e10, 1e10]" ),
+	ACCURACY_ENTRY( erff, "[-5, 5]" ),
+	ACCURACY_ENTRY( erfcf, "[-5, 10]" ),
+	ACCURACY_ENTRY( tgammaf, "[-30, 30]" ),
+	ACCURACY_ENTRY( lgammaf, "[0, 1e6]" ),
+	ACCURACY_ENTRY( normcdfinvf, "[1e-30, 1)" ),
+	ACCURACY_ENTRY( expm1f, "[-20, 88]" ),
+	ACCURACY_ENTRY( log1pf, "[-0.999, 1e30]" ),
+	ACCURACY_ENTRY( sinhf, "[-89, 89]" ),
+	ACCURACY_ENTRY( coshf, "[-89, 89]" ),
+	ACCURACY_ENTRY( tanhf, "[-10, 10]" ),
+	ACCURACY_ENTRY( sqrtf, "[0, 1e30]" ),
+	ACCURACY_ENTRY( rsqrtf, "[1e-30, 1e30]" ),
+	ACCURACY_ENTRY( fast_rsqrtf, "[1e-30, 1e30]" ),
+	ACCURACY_ENTRY( faster_rsqrtf, "[1e-30, 1e30]" ),
+	ACCURACY_ENTRY( recip, "[1e-30, 1e30]" ),
+	ACCURACY_ENTRY( fast_recip, "[1e-30, 1e30]" ),
+	ACCURACY_ENTRY( faster_recip, "[1e-30, 1e30]" ),
+	ACCURACY_ENTRY( logf_p12, "[1e-30, 1e30]" ),
+	ACCURACY_ENTRY( logf_p18, "[1e-30, 1e30]" ),
+	ACCURACY_ENTRY( log2f_p12, "[1e-30, 1e30]" ),
+	ACCURACY_ENTRY( log2f_p18, "[1e-30, 1e30]" ),
+	ACCURACY_ENTRY( expf_p12, "[-87, 88]" ),
+	ACCURACY_ENTRY( expf_p18, "[-87, 88]" ),
+	ACCURACY_ENTRY( exp2f_p12, "[-126, 127]" ),
+	ACCURACY_ENTRY( exp2f_p18, "[-126, 127]" ),
+	ACCURACY_ENTRY( powf_2_4_p12, "[1e-10, 1e10]" ),
+	ACCURACY_ENTRY( powf_2_4_p18, "[1e-10, 1e10]" ),
+	ACCURACY_ENTRY( cbrtf_p12, "[-1e30, 1e30]" ),
+	ACCURACY_ENTRY( sinf_p12, "[-10, 10]" ),
+	ACCURACY_ENTRY( sinf_p18, "[-10, 10]" ),
+	ACCURACY_ENTRY( cosf_p12, "[-10, 10]" ),
+	ACCURACY_ENTRY( cosf_p18, "[-10, 10]" ),
+	ACCURACY_ENTRY( sqrtf_p11, "[0, 1e30]" ),
+	ACCURACY_ENTRY( sqrtf_p21, "[0, 1e30]" ),
+	ACCURACY_ENTRY( srgb_to_linear, "[1e-3, 1]" ),
+	ACCURACY_ENTRY( linear_to_srgb, "[1e-3, 1]" ),
+	ACCURACY_ENTRY( rec709_to_linear, "[1e-3, 1]" ),
+	ACCURACY_ENTRY( linear_to_rec709, "[1e-3, 1]" ),
+	ACCURACY_ENTRY( pq_to_linear, "[0.01, 1]" ),
+	ACCURACY_ENTRY( linear_to_pq, "[1e-6, 1]" ),
+	ACCURACY_ENTRY( hlg_to_linear, "[1e-3, 1]" ),
+	ACCURACY_ENTRY( linear_to_hlg, "[1e-3, 1]" ),
+};
+
+////////////////////////////////////////
+
+void report( const report_entry &e, bool full, uint64_t samples, int nthreads, bool hist )
+{
+	accuracy_result r = e.accuracy( full, samples, nthreads );
+	double palRate = 0.0, libmRate = 0.0;
+	e.throughput( palRate, libmRate );
+
+	double mean = r.count > 0 ? r.sum / double( r.count ) : 0.0;
+	// correctly rounded is 0.5 ulp, or 24 bits of mantissa
+	double bits = 24.0;
+	if ( r.max_err > 0.5 )
+		bits = std::max( 0.0, 23.0 - std::log2( r.max_err ) );
+
+	std::cout << std::left << std::setw( 18 ) << e.name
+			  << std::setw( 16 ) << ( full ? "all floats" : e.domain )
+			  << std::right << std::setw( 12 ) << r.count
+			  << std::setw( 14 ) << std::setprecision( 4 ) << r.max_err
+			  << std::setw( 12 ) << std::setprecision( 4 ) << mean
+			  << std::setw( 7 ) << std::fixed << std::setprecision( 1 ) << bits
+			  << std::setw( 10 ) << r.special
+			  << std::setw( 10 ) << std::setprecision( 1 ) << palRate
+			  << std::setw( 10 ) << std::setprecision( 1 ) << libmRate
+			  << std::defaultfloat << std::endl;
+
+	if ( hist )
+	{
+		std::cout << "    worst input " << std::setprecision( 9 ) << r.worst_input;
+		if ( r.special_input_set )
+			std::cout << ", first special mismatch at " << r.special_input;
+		std::cout << std::setprecision( 6 ) << '\n';
+		for ( int b = 0; b != kNumBuckets; ++b )
+		{
+			if ( r.hist[b] == 0 )
+				continue;
+			std::cout << "    " << std::left << std::setw( 10 ) << bucket_label( b ) << std::right
+					  << std::setw( 12 ) << r.hist[b]
+					  << std::setw( 10 ) << std::fixed << std::setprecision( 4 )
+					  << ( 100.0 * double( r.hist[b] ) / double( r.count ) ) << '%'
+					  << std::defaultfloat << '\n';
+		}
+	}
+}
+
+} // empty namespace
+
+////////////////////////////////////////
+
+int main( int argc, char *argv[] )
+{
+	bool full = false;
+	bool hist = false;
+	uint64_t samples = uint64_t(1) << 22;
+	int nthreads = int( std::thread::hardware_concurrency() );
+	if ( nthreads < 1 )
+		nthreads = 1;
+	std::vector<std::string> names;
+
+	for ( int a = 1; a < argc; ++a )
+	{
+		std::string arg = argv[a];
+		if ( arg == "-full" )
+			full = true;
+		else if ( arg == "-hist" )
+			hist = true;
+		else if ( arg == "-samples" && ( a + 1 ) < argc )
+			samples = std::strtoull( argv[++a], nullptr, 10 );
+		else if ( arg == "-threads" && ( a + 1 ) < argc )
+			nthreads = std::max( 1, atoi( argv[++a] ) );
+		else if ( arg == "-h" || arg == "-help" )
+		{
+			std::cout << "Usage: " << argv[0] << " [-full] [-samples N] [-threads N] [-hist] [name ...]\n\n";
+			std::cout << "Functions:";
+			for ( const report_entry &e: theEntries )
+				std::cout << ' ' << e.name;
+			std::cout << std::endl;
+			return 0;
+		}
+		else
+			names.push_back( arg );
+	}
+
+	std::cout << std::left << std::setw( 18 ) << "function"
+			  << std::setw( 16 ) << "domain"
+			  << std::right << std::setw( 12 ) << "samples"
+			  << std::setw( 14 ) << "max ulp"
+			  << std::setw( 12 ) << "mean ulp"
+			  << std::setw( 7 ) << "~bits"
+			  << std::setw( 10 ) << "special"
+			  << std::setw( 10 ) << "Mval/s"
+			  << std::setw( 10 ) << "libm" << std::endl;
+
+	int ran = 0;
+	for ( const report_entry &e: theEntries )
+	{
+		if ( ! names.empty() && std::find( names.begin(), names.end(), std::string( e.name ) ) == names.end() )
+			continue;
+		report( e, full, samples, nthreads, hist );
+		++ran;
+	}
+	if ( ran == 0 )
+	{
+		std::cerr << "No matching functions, use -h for the list" << std::endl;
+		return -1;
+	}
+	return 0;
+}
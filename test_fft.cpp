@@ -0,0 +1,155 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+// Speed comparison of pal::fft_plan against a naive DFT.
+//
+// For each size, the same random signal is transformed repeatedly by
+// both, the naive DFT with a precomputed table of the n twiddles, and
+// the transforms per second of each are reported. The FFT result is
+// checked against the DFT, relative to the largest output value.
+//
+// usage: test_fft [-total N] [-blocked N] [size ...]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+
+#include "pal.h"
+
+////////////////////////////////////////
+
+namespace
+{
+
+/// the DFT by its definition, W^( j k ) looked up in the n twiddles
+template <typename T>
+static void
+naive_dft( T *outr, T *outi, const T *re, const T *im, const T *twr, const T *twi, size_t n )
+{
+	for ( size_t k = 0; k != n; ++k )
+	{
+		T sr = T(0), si = T(0);
+		size_t w = 0;
+		for ( size_t j = 0; j != n; ++j )
+		{
+			sr += re[j] * twr[w] - im[j] * twi[w];
+			si += re[j] * twi[w] + im[j] * twr[w];
+			w += k;
+			if ( w >= n )
+				w -= n;
+		}
+		outr[k] = sr;
+		outi[k] = si;
+	}
+}
+
+template <typename T>
+static bool
+run_size( const char *tname, size_t n, size_t total, size_t blocked )
+{
+	std::mt19937 rng( 1234 );
+	std::uniform_real_distribution<T> dist( T(-1), T(1) );
+	std::vector<T> re( n ), im( n ), twr( n ), twi( n );
+	for ( size_t i = 0; i != n; ++i )
+	{
+		re[i] = dist( rng );
+		im[i] = dist( rng );
+		double a = -2.0 * 3.14159265358979323846 * double( i ) / double( n );
+		twr[i] = T( std::cos( a ) );
+		twi[i] = T( std::sin( a ) );
+	}
+
+	// about total multiply adds for each, at least one transform
+	const size_t ndft = std::max( size_t(1), total / ( n * n ) );
+	std::vector<T> dr( n ), di( n );
+	auto t0 = std::chrono::high_resolution_clock::now();
+	for ( size_t r = 0; r != ndft; ++r )
+		naive_dft( dr.data(), di.data(), re.data(), im.data(), twr.data(), twi.data(), n );
+	auto t1 = std::chrono::high_resolution_clock::now();
+
+	const size_t nfft = std::max( size_t(1), total / n );
+	pal::fft_plan<T> plan( n, blocked );
+	std::vector<T> fr( n ), fi( n );
+	auto t2 = std::chrono::high_resolution_clock::now();
+	for ( size_t r = 0; r != nfft; ++r )
+	{
+		std::copy( re.begin(), re.end(), fr.begin() );
+		std::copy( im.begin(), im.end(), fi.begin() );
+		plan.forward( fr.data(), fi.data() );
+	}
+	auto t3 = std::chrono::high_resolution_clock::now();
+
+	double big = 0.0, err = 0.0;
+	for ( size_t k = 0; k != n; ++k )
+	{
+		big = std::max( big, double( std::abs( dr[k] ) + std::abs( di[k] ) ) );
+		err = std::max( err, double( std::abs( fr[k] - dr[k] ) + std::abs( fi[k] - di[k] ) ) );
+	}
+	err /= std::max( big, 1e-30 );
+
+	double dftT = std::chrono::duration<double>( t1 - t0 ).count() / double( ndft );
+	double fftT = std::chrono::duration<double>( t3 - t2 ).count() / double( nfft );
+	bool ok = err < ( sizeof(T) == 4 ? 1e-4 : 1e-12 );
+	std::cout << std::left << std::setw( 8 ) << tname
+			  << std::right << std::setw( 10 ) << n
+			  << std::fixed << std::setprecision( 2 )
+			  << std::setw( 14 ) << ( 1.0 / dftT )
+			  << std::setw( 14 ) << ( 1.0 / fftT )
+			  << std::setw( 12 ) << ( dftT / fftT )
+			  << std::scientific << std::setprecision( 2 )
+			  << std::setw( 12 ) << err
+			  << ( ok ? "" : "   MISMATCH" ) << std::endl;
+	return ok;
+}
+
+} // empty namespace
+
+////////////////////////////////////////
+
+int main( int argc, char *argv[] )
+{
+	size_t total = size_t(1) << 24;
+	size_t blocked = pal::detail::kFftBlocked;
+	std::vector<size_t> sizes;
+
+	for ( int a = 1; a < argc; ++a )
+	{
+		std::string arg = argv[a];
+		if ( arg == "-total" && ( a + 1 ) < argc )
+			total = std::strtoull( argv[++a], nullptr, 10 );
+		else if ( arg == "-blocked" && ( a + 1 ) < argc )
+			blocked = std::strtoull( argv[++a], nullptr, 10 );
+		else if ( arg == "-h" || arg == "-help" )
+		{
+			std::cout << "Usage: " << argv[0] << " [-total N] [-blocked N] [size ...]" << std::endl;
+			return 0;
+		}
+		else
+			sizes.push_back( std::strtoull( argv[a], nullptr, 10 ) );
+	}
+	if ( sizes.empty() )
+		sizes = { 8, 16, 64, 128, 256, 1024, 4096 };
+
+	std::cout << std::left << std::setw( 8 ) << "type"
+			  << std::right << std::setw( 10 ) << "size"
+			  << std::setw( 14 ) << "DFT / s"
+			  << std::setw( 14 ) << "FFT / s"
+			  << std::setw( 12 ) << "speedup"
+			  << std::setw( 12 ) << "rel err" << std::endl;
+
+	bool ok = true;
+	for ( size_t n: sizes )
+		ok = run_size<float>( "float", n, total, blocked ) && ok;
+	for ( size_t n: sizes )
+		ok = run_size<double>( "double", n, total, blocked ) && ok;
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+// Speed comparison of pal::sort against std::sort.
+//
+// For each size, a buffer of random values is cut into arrays of that
+// size which are all sorted, so the small sizes measure many
+// independent sorts (as for per pixel samples) rather than the timer.
+// Each result is checked against std::sort.
+//
+// usage: test_sort [-total N] [size ...]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+
+#include "pal.h"
+
+////////////////////////////////////////
+
+namespace
+{
+
+template <typename T, typename Dist>
+static bool
+run_size( const char *tname, size_t n, size_t total, Dist dist )
+{
+	std::mt19937 rng( 1234 );
+	total = std::max( total, n );
+	total -= total % n;
+	std::vector<T> src( total );
+	for ( T &v: src )
+		v = dist( rng );
+
+	std::vector<T> ref = src;
+	auto t0 = std::chrono::high_resolution_clock::now();
+	for ( size_t o = 0; o != total; o += n )
+		std::sort( ref.data() + o, ref.data() + o + n );
+	auto t1 = std::chrono::high_resolution_clock::now();
+
+	std::vector<T> vals = src;
+	auto t2 = std::chrono::high_resolution_clock::now();
+	for ( size_t o = 0; o != total; o += n )
+		pal::sort( vals.data() + o, n );
+	auto t3 = std::chrono::high_resolution_clock::now();
+
+	double stdT = std::chrono::duration<double>( t1 - t0 ).count();
+	double palT = std::chrono::duration<double>( t3 - t2 ).count();
+	bool ok = ( vals == ref );
+	std::cout << std::left << std::setw( 8 ) << tname
+			  << std::right << std::setw( 10 ) << n
+			  << std::fixed << std::setprecision( 2 )
+			  << std::setw( 14 ) << ( double( total ) / stdT * 1e-6 )
+			  << std::setw( 14 ) << ( double( total ) / palT * 1e-6 )
+			  << std::setw( 10 ) << ( stdT / palT )
+			  << ( ok ? "" : "   MISMATCH" ) << std::endl;
+	return ok;
+}
+
+} // empty namespace
+
+////////////////////////////////////////
+
+int main( int argc, char *argv[] )
+{
+	size_t total = size_t(1) << 22;
+	std::vector<size_t> sizes;
+
+	for ( int a = 1; a < argc; ++a )
+	{
+		std::string arg = argv[a];
+		if ( arg == "-total" && ( a + 1 ) < argc )
+			total = std::strtoull( argv[++a], nullptr, 10 );
+		else if ( arg == "-h" || arg == "-help" )
+		{
+			std::cout << "Usage: " << argv[0] << " [-total N] [size ...]" << std::endl;
+			return 0;
+		}
+		else
+			sizes.push_back( std::strtoull( argv[a], nullptr, 10 ) );
+	}
+	if ( sizes.empty() )
+		sizes = { 8, 16, 32, 64, 256, 1024, 65536, 1 << 22 };
+
+	std::cout << std::left << std::setw( 8 ) << "type"
+			  << std::right << std::setw( 10 ) << "size"
+			  << std::setw( 14 ) << "std Mval/s"
+			  << std::setw( 14 ) << "pal Mval/s"
+			  << std::setw( 10 ) << "speedup" << std::endl;
+
+	bool ok = true;
+	for ( size_t n: sizes )
+		ok = run_size<float>( "float", n, total, std::uniform_real_distribution<float>( -1e6F, 1e6F ) ) && ok;
+	for ( size_t n: sizes )
+		ok = run_size<int32_t>( "int32", n, total, std::uniform_int_distribution<int32_t>() ) && ok;
+	return ok ? 0 : 1;
+}
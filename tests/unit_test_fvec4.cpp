@@ -10,11 +10,66 @@
 #include <pal.h>
 #include <cfloat>
 #include <cmath>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <complex>
 
 typedef match_test<PAL_NAMESPACE::fvec4> match;
 typedef match_test<PAL_NAMESPACE::lvec4> intmatch;
+typedef match_test<PAL_NAMESPACE::dvec2> dmatch;
+#ifdef PAL_HAS_FVEC8
+typedef match_test<PAL_NAMESPACE::fvec8> match8;
+typedef match_test<PAL_NAMESPACE::dvec4> dmatch4;
+typedef match_test<PAL_NAMESPACE::lvec8> intmatch8;
+typedef match_test<PAL_NAMESPACE::llvec4> llmatch4;
+#endif
 static const int kFastULPprec = 16;
 
+// indices of the k values of got furthest from ref (repeating the
+// first index when n < k)
+template <typename T>
+static void
+worst_index( size_t *idx, size_t k, const T *got, const T *ref, size_t n )
+{
+	std::vector<size_t> order( n );
+	for ( size_t i = 0; i != n; ++i )
+		order[i] = i;
+	size_t m = std::min( k, n );
+	std::partial_sort( order.begin(), order.begin() + std::ptrdiff_t( m ), order.end(),
+					   [got, ref]( size_t a, size_t b ) {
+						   return std::fabs( got[a] - ref[a] ) > std::fabs( got[b] - ref[b] );
+					   } );
+	for ( size_t i = 0; i != k; ++i )
+		idx[i] = i < m ? order[i] : order[0];
+}
+
+// the 4 values of got furthest from ref against their reference
+// values, so a precision match over a whole buffer reports the worst
+static match
+worst4( const float *got, const float *ref, size_t n )
+{
+	size_t idx[4];
+	float g[4], r[4];
+	worst_index( idx, 4, got, ref, n );
+	for ( int i = 0; i != 4; ++i )
+	{
+		g[i] = got[idx[i]];
+		r[i] = ref[idx[i]];
+	}
+	return match( PAL_NAMESPACE::fvec4( g ), r );
+}
+
+// the 2 values of got furthest from ref against their reference
+// values, as worst4 for double buffers
+static dmatch
+worst2( const double *got, const double *ref, size_t n )
+{
+	size_t idx[2];
+	worst_index( idx, 2, got, ref, n );
+	return dmatch( PAL_NAMESPACE::dvec2( got[idx[0]], got[idx[1]] ), { ref[idx[0]], ref[idx[1]] } );
+}
+
 // these tests test all the various members of the fvec4 class
 static void
 add_class_tests( unit_test &test )
@@ -128,6 +183,87 @@ add_class_tests( unit_test &test )
 						 []() {
 							 return match(
 								 fvec4::convert_int(fvec4::int_vec_type(1,2,3,4)), {1.F,2.F,3.F,4.F} ); } );
+		TEST_CODE_VAL_EQ(test, "permute",
+						 []() {
+							 return match( permute<3,1,2,0>( fvec4( 1.F, 2.F, 3.F, 4.F ) ), {4.F,2.F,3.F,1.F} ); } );
+		TEST_CODE_VAL_EQ(test, "permute_var",
+						 []() {
+							 return match( permute( fvec4( 1.F, 2.F, 3.F, 4.F ), lvec4( 2, 2, 0, 3 ) ), {3.F,3.F,1.F,4.F} ); } );
+		TEST_CODE_VAL_EQ(test, "blend",
+						 []() {
+							 return match( blend<0,1,1,0>( fvec4( 1.F ), fvec4( 2.F ) ), {1.F,2.F,2.F,1.F} ); } );
+#ifdef PAL_HAS_FVEC8
+		// one pattern per instruction choice: in lane (uniform and not),
+		// lane swap, lane broadcast (uniform and not) and general cross
+		// lane
+		const fvec8 v8( 0.F, 1.F, 2.F, 3.F, 4.F, 5.F, 6.F, 7.F );
+		TEST_CODE_VAL_EQ(test, "permute fvec8 (identity)",
+						 [=]() { return match8( permute<0,1,2,3,4,5,6,7>( v8 ), {0.F,1.F,2.F,3.F,4.F,5.F,6.F,7.F} ); } );
+		TEST_CODE_VAL_EQ(test, "permute fvec8 (in lane)",
+						 [=]() { return match8( permute<1,0,3,2,5,4,7,6>( v8 ), {1.F,0.F,3.F,2.F,5.F,4.F,7.F,6.F} ); } );
+		TEST_CODE_VAL_EQ(test, "permute fvec8 (in lane, per lane)",
+						 [=]() { return match8( permute<3,2,1,0,4,4,5,7>( v8 ), {3.F,2.F,1.F,0.F,4.F,4.F,5.F,7.F} ); } );
+		TEST_CODE_VAL_EQ(test, "permute fvec8 (lane swap)",
+						 [=]() { return match8( permute<5,4,7,6,1,0,3,2>( v8 ), {5.F,4.F,7.F,6.F,1.F,0.F,3.F,2.F} ); } );
+		TEST_CODE_VAL_EQ(test, "permute fvec8 (broadcast)",
+						 [=]() { return match8( permute<6,7,4,5,6,7,4,5>( v8 ), {6.F,7.F,4.F,5.F,6.F,7.F,4.F,5.F} ); } );
+		TEST_CODE_VAL_EQ(test, "permute fvec8 (broadcast, per lane)",
+						 [=]() { return match8( permute<0,3,1,2,2,2,0,1>( v8 ), {0.F,3.F,1.F,2.F,2.F,2.F,0.F,1.F} ); } );
+		TEST_CODE_VAL_EQ(test, "permute fvec8 (cross lane)",
+						 [=]() { return match8( permute<7,0,5,2,3,4,1,6>( v8 ), {7.F,0.F,5.F,2.F,3.F,4.F,1.F,6.F} ); } );
+		TEST_CODE_VAL_EQ(test, "permute_var fvec8",
+						 [=]() {
+							 return match8( permute( v8, lvec8( 7, 0, 5, 2, 3, 4, 9, 6 ) ),
+											{7.F,0.F,5.F,2.F,3.F,4.F,1.F,6.F} ); } );
+		TEST_CODE_VAL_EQ(test, "blend fvec8",
+						 [=]() {
+							 return match8( blend<1,0,0,1,1,1,0,0>( v8, fvec8( -1.F ) ),
+											{-1.F,1.F,2.F,-1.F,-1.F,-1.F,6.F,7.F} ); } );
+		TEST_CODE_VAL_EQ(test, "permute_lanes fvec8",
+						 [=]() {
+							 fvec8 b = v8 + fvec8( 10.F );
+							 return match8( permute_lanes<3,0>( v8, b ), {14.F,15.F,16.F,17.F,0.F,1.F,2.F,3.F} ); } );
+		TEST_CODE_VAL_EQ(test, "swap_lanes fvec8",
+						 [=]() { return match8( swap_lanes( v8 ), {4.F,5.F,6.F,7.F,0.F,1.F,2.F,3.F} ); } );
+
+		const dvec4 v4( 0.0, 1.0, 2.0, 3.0 );
+		TEST_CODE_VAL_EQ(test, "permute dvec4 (in lane)",
+						 [=]() { return dmatch4( permute<1,0,3,2>( v4 ), {1.0,0.0,3.0,2.0} ); } );
+		TEST_CODE_VAL_EQ(test, "permute dvec4 (lane swap)",
+						 [=]() { return dmatch4( permute<3,2,2,3>( v4 ), {3.0,2.0,2.0,3.0} ); } );
+		TEST_CODE_VAL_EQ(test, "permute dvec4 (cross lane)",
+						 [=]() { return dmatch4( permute<3,0,2,1>( v4 ), {3.0,0.0,2.0,1.0} ); } );
+		TEST_CODE_VAL_EQ(test, "permute_var dvec4",
+						 [=]() { return dmatch4( permute( v4, llvec4( 3, 0, 6, 1 ) ), {3.0,0.0,2.0,1.0} ); } );
+		TEST_CODE_VAL_EQ(test, "blend dvec4",
+						 [=]() { return dmatch4( blend<0,1,1,0>( v4, dvec4( -1.0 ) ), {0.0,-1.0,-1.0,3.0} ); } );
+		TEST_CODE_VAL_EQ(test, "permute_lanes dvec4",
+						 [=]() { return dmatch4( permute_lanes<1,2>( v4, dvec4( -1.0 ) ), {2.0,3.0,-1.0,-1.0} ); } );
+		TEST_CODE_VAL_EQ(test, "swap_lanes dvec4",
+						 [=]() { return dmatch4( swap_lanes( v4 ), {2.0,3.0,0.0,1.0} ); } );
+
+		const lvec8 i8( 0, 1, 2, 3, 4, 5, 6, 7 );
+		TEST_CODE_VAL_EQ(test, "permute lvec8 (in lane)",
+						 [=]() { return intmatch8( permute<1,0,3,2,5,4,7,6>( i8 ), {1,0,3,2,5,4,7,6} ); } );
+		TEST_CODE_VAL_EQ(test, "permute lvec8 (cross lane)",
+						 [=]() { return intmatch8( permute<7,0,5,2,3,4,1,6>( i8 ), {7,0,5,2,3,4,1,6} ); } );
+		TEST_CODE_VAL_EQ(test, "permute_var lvec8",
+						 [=]() { return intmatch8( permute( i8, lvec8( 7, 0, 5, 2, 3, 4, 1, 14 ) ), {7,0,5,2,3,4,1,6} ); } );
+		TEST_CODE_VAL_EQ(test, "blend lvec8",
+						 [=]() { return intmatch8( blend<1,0,0,1,1,1,0,0>( i8, lvec8( -1 ) ), {-1,1,2,-1,-1,-1,6,7} ); } );
+		TEST_CODE_VAL_EQ(test, "permute_lanes lvec8",
+						 [=]() { return intmatch8( permute_lanes<2,1>( i8, lvec8( -1 ) ), {-1,-1,-1,-1,4,5,6,7} ); } );
+		TEST_CODE_VAL_EQ(test, "swap_lanes lvec8",
+						 [=]() { return intmatch8( swap_lanes( i8 ), {4,5,6,7,0,1,2,3} ); } );
+
+		const llvec4 l4( int64_t( 0 ), int64_t( 1 ), int64_t( 2 ), int64_t( -3 ) );
+		TEST_CODE_VAL_EQ(test, "permute llvec4",
+						 [=]() { return llmatch4( permute<3,0,2,1>( l4 ), {-3,0,2,1} ); } );
+		TEST_CODE_VAL_EQ(test, "blend llvec4",
+						 [=]() { return llmatch4( blend<0,1,1,0>( l4, llvec4( int64_t( -1 ) ) ), {0,-1,-1,-3} ); } );
+		TEST_CODE_VAL_EQ(test, "swap_lanes llvec4",
+						 [=]() { return llmatch4( swap_lanes( l4 ), {2,-3,0,1} ); } );
+#endif
 	};
 }
 
@@ -345,7 +481,7 @@ add_op_tests( unit_test &test )
 							 fvec4 tmp2( tval2 );
 							 fvec4::mask_type m = ( tmp < tmp2 );
 
-							 return match_val<int>( m.which(), m.active_mask( 0 ) );
+							 return match_val<int>( m.which(), m.active_mask( 0 ) | m.active_mask( 2 ) );
 						 } );
 		TEST_CODE_VAL_EQ(test, "any",
 						 []() {
@@ -372,6 +508,41 @@ add_op_tests( unit_test &test )
 }
 
 // test the fvec4-specific math functions
+// a row-major dim x dim matrix times v in double, the reference for
+// the transform tests
+static void
+xform_ref( double *o, const float *m, const double *v, int dim )
+{
+	for ( int r = 0; r != dim; ++r )
+	{
+		o[r] = 0.0;
+		for ( int c = 0; c != dim; ++c )
+			o[r] += double( m[r * dim + c] ) * v[c];
+	}
+}
+
+// values in [-3.5, 3.5] for the transform tests
+static float
+xform_value( size_t i )
+{
+	return float( ( i * 37 ) % 29 ) * 0.25F - 3.5F;
+}
+
+// the 3 components of point i (planar when stride is 1, interleaved
+// when it is 3) transformed by a row-major 4x4 matrix in double, with
+// the divide by w when project is set
+static void
+xform_point_ref( float *o, const float *m, const float *in, size_t i, size_t n, bool planar, bool project )
+{
+	double v[4], r[4];
+	for ( size_t c = 0; c != 3; ++c )
+		v[c] = in[planar ? c * n + i : i * 3 + c];
+	v[3] = 1.0;
+	xform_ref( r, m, v, 4 );
+	for ( size_t c = 0; c != 3; ++c )
+		o[planar ? c * n + i : i * 3 + c] = float( project ? r[c] / r[3] : r[c] );
+}
+
 static void
 add_load_store_tests( unit_test &test )
 {
@@ -488,6 +659,287 @@ add_load_store_tests( unit_test &test )
 							 fvec4 tmp = load4f_aligned( tval );
 							 return match( tmp, cval );
 						 } );
+		TEST_CODE_VAL_EQ(test, "transpose4x4",
+						 []() {
+							 fvec4 r0( 0.F, 1.F, 2.F, 3.F ), r1( 4.F, 5.F, 6.F, 7.F );
+							 fvec4 r2( 8.F, 9.F, 10.F, 11.F ), r3( 12.F, 13.F, 14.F, 15.F );
+							 transpose4x4( r0, r1, r2, r3 );
+							 return match( r1, {1.F,5.F,9.F,13.F} );
+						 } );
+		TEST_CODE_VAL_EQ(test, "transpose2x2",
+						 []() {
+							 dvec2 r0( 0.0, 1.0 ), r1( 2.0, 3.0 );
+							 transpose2x2( r0, r1 );
+							 return match( fvec4( float( r0[0] ), float( r0[1] ), float( r1[0] ), float( r1[1] ) ),
+										   {0.F,2.F,1.F,3.F} );
+						 } );
+		TEST_CODE_VAL_EQ(test, "transpose2x2 (round trip)",
+						 []() {
+							 dvec2 r0( 0.0, 1.0 ), r1( 2.0, 3.0 );
+							 transpose2x2( r0, r1 );
+							 transpose2x2( r0, r1 );
+							 return match( fvec4( float( r0[0] ), float( r0[1] ), float( r1[0] ), float( r1[1] ) ),
+										   {0.F,1.F,2.F,3.F} );
+						 } );
+#ifdef PAL_HAS_FVEC8
+		{
+			// r_i[j] = 8 i + j, so after the transpose r_i[j] = 8 j + i
+			fvec8 r[8];
+			lvec8 ri[8];
+			for ( int i = 0; i != 8; ++i )
+			{
+				r[i] = fvec8( float( 8 * i ) ) + fvec8( 0.F, 1.F, 2.F, 3.F, 4.F, 5.F, 6.F, 7.F );
+				ri[i] = lvec8( 8 * i ) + lvec8( 0, 1, 2, 3, 4, 5, 6, 7 );
+			}
+			transpose8x8( r[0], r[1], r[2], r[3], r[4], r[5], r[6], r[7] );
+			transpose8x8( ri[0], ri[1], ri[2], ri[3], ri[4], ri[5], ri[6], ri[7] );
+			for ( int i = 0; i != 8; ++i )
+			{
+				float cval[8];
+				int ival[8];
+				for ( int j = 0; j != 8; ++j )
+				{
+					cval[j] = float( 8 * j + i );
+					ival[j] = 8 * j + i;
+				}
+				TEST_CODE_VAL_EQ(test, "transpose8x8 fvec8 row " + std::to_string( i ),
+								 [&]() { return match8( r[i], cval ); } );
+				TEST_CODE_VAL_EQ(test, "transpose8x8 lvec8 row " + std::to_string( i ),
+								 [&]() { return intmatch8( ri[i], ival ); } );
+			}
+			transpose8x8( r[0], r[1], r[2], r[3], r[4], r[5], r[6], r[7] );
+			TEST_CODE_VAL_EQ(test, "transpose8x8 (round trip)",
+							 [&]() { return match8( r[5], {40.F,41.F,42.F,43.F,44.F,45.F,46.F,47.F} ); } );
+		}
+		TEST_CODE_VAL_EQ(test, "transpose4x4_lanes",
+						 []() {
+							 fvec8 r0( 0.F, 1.F, 2.F, 3.F, 16.F, 17.F, 18.F, 19.F );
+							 fvec8 r1( 4.F, 5.F, 6.F, 7.F, 20.F, 21.F, 22.F, 23.F );
+							 fvec8 r2( 8.F, 9.F, 10.F, 11.F, 24.F, 25.F, 26.F, 27.F );
+							 fvec8 r3( 12.F, 13.F, 14.F, 15.F, 28.F, 29.F, 30.F, 31.F );
+							 transpose4x4_lanes( r0, r1, r2, r3 );
+							 return match8( r2, {2.F,6.F,10.F,14.F,18.F,22.F,26.F,30.F} );
+						 } );
+		TEST_CODE_VAL_EQ(test, "transpose4x4 dvec4",
+						 []() {
+							 dvec4 r0( 0.0, 1.0, 2.0, 3.0 ), r1( 4.0, 5.0, 6.0, 7.0 );
+							 dvec4 r2( 8.0, 9.0, 10.0, 11.0 ), r3( 12.0, 13.0, 14.0, 15.0 );
+							 transpose4x4( r0, r1, r2, r3 );
+							 return dmatch4( r3, {3.0,7.0,11.0,15.0} );
+						 } );
+		TEST_CODE_VAL_EQ(test, "transpose4x4 dvec4 (round trip)",
+						 []() {
+							 dvec4 r0( 0.0, 1.0, 2.0, 3.0 ), r1( 4.0, 5.0, 6.0, 7.0 );
+							 dvec4 r2( 8.0, 9.0, 10.0, 11.0 ), r3( 12.0, 13.0, 14.0, 15.0 );
+							 transpose4x4( r0, r1, r2, r3 );
+							 transpose4x4( r0, r1, r2, r3 );
+							 return dmatch4( r1, {4.0,5.0,6.0,7.0} );
+						 } );
+#endif
+		TEST_CODE_VAL_EQ(test, "deinterleave3",
+						 []() {
+							 // 9 values so the vector and scalar paths both run
+							 float tval[27], c0[9], c1[9], c2[9];
+							 for ( int i = 0; i != 27; ++i )
+								 tval[i] = float( i );
+							 deinterleave3( c0, c1, c2, tval, 9 );
+							 return match( fvec4( c1[0], c1[3], c1[8], c2[8] ), {1.F,10.F,25.F,26.F} );
+						 } );
+		TEST_CODE_VAL_EQ(test, "interleave3",
+						 []() {
+							 float tval[27], c0[9], c1[9], c2[9], out[27];
+							 for ( int i = 0; i != 27; ++i )
+								 tval[i] = float( i );
+							 deinterleave3( c0, c1, c2, tval, 9 );
+							 interleave3( out, c0, c1, c2, 9 );
+							 return match( fvec4( out[4], out[13], out[25], out[26] ), {4.F,13.F,25.F,26.F} );
+						 } );
+		TEST_CODE_VAL_EQ(test, "interleave4",
+						 []() {
+							 float tval[36], c0[9], c1[9], c2[9], c3[9], out[36];
+							 for ( int i = 0; i != 36; ++i )
+								 tval[i] = float( i );
+							 deinterleave4( c0, c1, c2, c3, tval, 9 );
+							 interleave4( out, c0, c1, c2, c3, 9 );
+							 return match( fvec4( c3[4], out[17], out[31], out[35] ), {19.F,17.F,31.F,35.F} );
+						 } );
+		TEST_CODE_VAL_EQ(test, "transform3x3",
+						 []() {
+							 const float m[9] = { 1.F, 2.F, 3.F, 0.F, 1.F, 0.F, 0.F, 0.F, 2.F };
+							 float tval[27], out[27];
+							 for ( int i = 0; i != 27; ++i )
+								 tval[i] = float( i );
+							 transform3x3_interleaved( out, tval, m, 9 );
+							 // rgb 24, 25, 26 -> 24 + 50 + 78, 25, 52
+							 return match( fvec4( out[24], out[25], out[26], out[1] ), {152.F,25.F,52.F,1.F} );
+						 } );
+		TEST_CODE_VAL_EQ(test, "transform_points",
+						 []() {
+							 const float m[16] = { 1.F, 0.F, 0.F, 1.F, 0.F, 1.F, 0.F, 0.F,
+												   0.F, 0.F, 1.F, 0.F, 0.F, 0.F, 1.F, 0.F };
+							 float x[9], y[9], z[9];
+							 for ( int i = 0; i != 9; ++i )
+							 {
+								 x[i] = float( i ); y[i] = 2.F; z[i] = 2.F;
+							 }
+							 transform_points( x, y, z, x, y, z, m, 9 );
+							 return match( fvec4( x[0], x[8], y[8], z[8] ), {0.5F,4.5F,1.F,1.F} );
+						 } );
+		// 15 values run the fvec8, fvec4 and scalar paths (3 fvec4
+		// blocks without fvec8), every output is compared
+		TEST_CODE_VAL_EQ_PREC(
+			test, "transform3x3 (planar)",
+			[]() {
+				const float m[9] = { 0.4124F, 0.3576F, 0.1805F, 0.2126F, 0.7152F, 0.0722F, 0.0193F, 0.1192F, 0.9505F };
+				const size_t n = 15;
+				float in[3 * n], got[3 * n], ref[3 * n];
+				for ( size_t i = 0; i != 3 * n; ++i )
+					in[i] = xform_value( i );
+				transform3x3( got, got + n, got + 2 * n, in, in + n, in + 2 * n, m, n );
+				for ( size_t i = 0; i != n; ++i )
+				{
+					double v[3] = { in[i], in[n + i], in[2 * n + i] }, o[3];
+					xform_ref( o, m, v, 3 );
+					for ( size_t c = 0; c != 3; ++c )
+						ref[c * n + i] = float( o[c] );
+				}
+				return worst4( got, ref, 3 * n );
+			}, 2e-6F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "transform3x3_interleaved",
+			[]() {
+				const float m[9] = { 3.2406F, -1.5372F, -0.4986F, -0.9689F, 1.8758F, 0.0415F, 0.0557F, -0.2040F, 1.0570F };
+				const size_t n = 15;
+				float in[3 * n], got[3 * n], ref[3 * n];
+				for ( size_t i = 0; i != 3 * n; ++i )
+					in[i] = xform_value( i );
+				transform3x3_interleaved( got, in, m, n );
+				for ( size_t i = 0; i != n; ++i )
+				{
+					double v[3] = { in[i * 3], in[i * 3 + 1], in[i * 3 + 2] }, o[3];
+					xform_ref( o, m, v, 3 );
+					for ( size_t c = 0; c != 3; ++c )
+						ref[i * 3 + c] = float( o[c] );
+				}
+				return worst4( got, ref, 3 * n );
+			}, 4e-6F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "transform4x4 (planar)",
+			[]() {
+				const float m[16] = { 0.5F, -1.25F, 2.F, 0.75F, 1.5F, 0.25F, -0.5F, -2.F,
+									  -0.75F, 1.F, 0.125F, 1.25F, 0.3F, -0.2F, 0.1F, 1.1F };
+				const size_t n = 15;
+				float in[4 * n], got[4 * n], ref[4 * n];
+				for ( size_t i = 0; i != 4 * n; ++i )
+					in[i] = xform_value( i );
+				transform4x4( got, got + n, got + 2 * n, got + 3 * n, in, in + n, in + 2 * n, in + 3 * n, m, n );
+				for ( size_t i = 0; i != n; ++i )
+				{
+					double v[4] = { in[i], in[n + i], in[2 * n + i], in[3 * n + i] }, o[4];
+					xform_ref( o, m, v, 4 );
+					for ( size_t c = 0; c != 4; ++c )
+						ref[c * n + i] = float( o[c] );
+				}
+				return worst4( got, ref, 4 * n );
+			}, 4e-6F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "transform4x4_interleaved (in place)",
+			[]() {
+				const float m[16] = { 0.5F, -1.25F, 2.F, 0.75F, 1.5F, 0.25F, -0.5F, -2.F,
+									  -0.75F, 1.F, 0.125F, 1.25F, 0.3F, -0.2F, 0.1F, 1.1F };
+				const size_t n = 15;
+				float got[4 * n], ref[4 * n];
+				for ( size_t i = 0; i != 4 * n; ++i )
+					got[i] = xform_value( i );
+				for ( size_t i = 0; i != n; ++i )
+				{
+					double v[4] = { got[i * 4], got[i * 4 + 1], got[i * 4 + 2], got[i * 4 + 3] }, o[4];
+					xform_ref( o, m, v, 4 );
+					for ( size_t c = 0; c != 4; ++c )
+						ref[i * 4 + c] = float( o[c] );
+				}
+				transform4x4_interleaved( got, got, m, n );
+				return worst4( got, ref, 4 * n );
+			}, 4e-6F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "transform_points (affine)",
+			[]() {
+				const float m[16] = { 0.5F, -1.25F, 2.F, 0.75F, 1.5F, 0.25F, -0.5F, -2.F,
+									  -0.75F, 1.F, 0.125F, 1.25F, 0.F, 0.F, 0.F, 1.F };
+				const size_t n = 15;
+				float in[3 * n], got[3 * n], ref[3 * n];
+				for ( size_t i = 0; i != 3 * n; ++i )
+					in[i] = xform_value( i );
+				transform_points( got, got + n, got + 2 * n, in, in + n, in + 2 * n, m, n );
+				for ( size_t i = 0; i != n; ++i )
+					xform_point_ref( ref, m, in, i, n, true, false );
+				return worst4( got, ref, 3 * n );
+			}, 4e-6F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "transform_points (projective)",
+			[]() {
+				const float m[16] = { 0.5F, -1.25F, 2.F, 0.75F, 1.5F, 0.25F, -0.5F, -2.F,
+									  -0.75F, 1.F, 0.125F, 1.25F, 0.03F, -0.02F, 0.05F, 1.5F };
+				const size_t n = 15;
+				float in[3 * n], got[3 * n], ref[3 * n];
+				for ( size_t i = 0; i != 3 * n; ++i )
+					in[i] = xform_value( i );
+				transform_points( got, got + n, got + 2 * n, in, in + n, in + 2 * n, m, n );
+				for ( size_t i = 0; i != n; ++i )
+					xform_point_ref( ref, m, in, i, n, true, true );
+				return worst4( got, ref, 3 * n );
+			}, 4e-6F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "transform_points_interleaved (projective)",
+			[]() {
+				const float m[16] = { 0.5F, -1.25F, 2.F, 0.75F, 1.5F, 0.25F, -0.5F, -2.F,
+									  -0.75F, 1.F, 0.125F, 1.25F, 0.03F, -0.02F, 0.05F, 1.5F };
+				const size_t n = 15;
+				float in[3 * n], got[3 * n], ref[3 * n];
+				for ( size_t i = 0; i != 3 * n; ++i )
+					in[i] = xform_value( i );
+				transform_points_interleaved( got, in, m, n );
+				for ( size_t i = 0; i != n; ++i )
+					xform_point_ref( ref, m, in, i, n, false, true );
+				return worst4( got, ref, 3 * n );
+			}, 4e-6F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "transform_points_interleaved (project off)",
+			[]() {
+				// only the affine part of the projective matrix
+				const float m[16] = { 0.5F, -1.25F, 2.F, 0.75F, 1.5F, 0.25F, -0.5F, -2.F,
+									  -0.75F, 1.F, 0.125F, 1.25F, 0.03F, -0.02F, 0.05F, 1.5F };
+				const size_t n = 15;
+				float in[3 * n], got[3 * n], ref[3 * n];
+				for ( size_t i = 0; i != 3 * n; ++i )
+					in[i] = xform_value( i );
+				transform_points_interleaved( got, in, m, n, false );
+				for ( size_t i = 0; i != n; ++i )
+					xform_point_ref( ref, m, in, i, n, false, false );
+				return worst4( got, ref, 3 * n );
+			}, 4e-6F );
+		TEST_CODE_VAL_EQ(test, "transforms (vector and scalar tail agree)",
+						 []() {
+							 // all at once against one value at a time, which
+							 // is only the scalar tail. The products need to
+							 // round for a fused multiply add to differ
+							 const float m[16] = { 0.4124F, -1.5372F, 0.1805F, 0.7F, 0.2126F, 1.8758F, 0.0722F, -0.3F,
+												   0.0193F, -0.2040F, 0.9505F, 0.11F, 0.03F, -0.02F, 0.05F, 1.5F };
+							 const size_t n = 15;
+							 float in[4 * n], all[4 * n], one[4 * n], pall[3 * n], pone[3 * n];
+							 for ( size_t i = 0; i != 4 * n; ++i )
+								 in[i] = xform_value( i ) * 1.37F;
+							 transform4x4_interleaved( all, in, m, n );
+							 transform_points_interleaved( pall, in, m, n );
+							 for ( size_t i = 0; i != n; ++i )
+							 {
+								 transform4x4_interleaved( one + i * 4, in + i * 4, m, 1 );
+								 transform_points_interleaved( pone + i * 3, in + i * 3, m, 1 );
+							 }
+							 std::copy( pall, pall + 3 * n, all + n );
+							 std::copy( pone, pone + 3 * n, one + n );
+							 return worst4( all, one, 4 * n );
+						 } );
 	};
 }
 
@@ -896,6 +1348,70 @@ add_math_tests( unit_test &test )
 								 cval[i] = tval[i] * tval[i];
 							 return match( square( tmp ), cval );
 						 } );
+
+		TEST_CODE_VAL_EQ(test, "horner",
+						 []() {
+							 float tval[4] = {0.2F, -2.F, 3.F, 0.F};
+							 float cval[4];
+							 for ( int i = 0; i != 4; ++i )
+								 cval[i] = ( ( 0.25F * tval[i] + 0.5F ) * tval[i] - 1.F ) * tval[i] + 2.F;
+							 return match( horner( fvec4( tval ), 2.F, -1.F, 0.5F, 0.25F ), cval );
+						 } );
+		TEST_CODE_VAL_EQ_ULPS(test, "estrin",
+							  []() {
+								  float tval[4] = {0.2F, -0.7F, 0.9F, 0.F};
+								  float cval[4];
+								  for ( int i = 0; i != 4; ++i )
+								  {
+									  double x = tval[i];
+									  double r = 0.0;
+									  for ( int c = 7; c >= 0; --c )
+										  r = r * x + 1.0 / double( c + 1 );
+									  cval[i] = float( r );
+								  }
+								  return match( estrin( fvec4( tval ), 1.F, 1.F/2.F, 1.F/3.F, 1.F/4.F,
+														1.F/5.F, 1.F/6.F, 1.F/7.F, 1.F/8.F ), cval );
+							  }, 2 );
+		TEST_CODE_VAL_EQ_ULPS(test, "polyval_array",
+							  []() {
+								  static const float coeffs[6] = { 1.F, -1.F, 0.5F, -0.25F, 0.125F, -0.0625F };
+								  float tval[4] = {0.2F, -0.7F, 0.9F, 0.F};
+								  float cval[4];
+								  for ( int i = 0; i != 4; ++i )
+									  cval[i] = horner( tval[i], 1.F, -1.F, 0.5F, -0.25F, 0.125F, -0.0625F );
+								  return match( polyval( fvec4( tval ), coeffs ), cval );
+							  }, 2 );
+		TEST_CODE_VAL_EQ_ULPS(test, "minimax_exp",
+							  []() {
+								  auto fit = minimax_poly<5>( []( double x ) { return std::exp( x ); },
+															  -0.34657359, 0.34657359, true );
+								  float tval[4] = {-0.34F, -0.1F, 0.25F, 0.3F};
+								  float cval[4];
+								  for ( int i = 0; i != 4; ++i )
+									  cval[i] = std::exp( tval[i] );
+								  return match( polyval( fvec4( tval ), fit.as<float>() ), cval );
+							  }, 4 );
+		TEST_CODE_VAL_EQ_ULPS(test, "minimax_rational_log1p",
+							  []() {
+								  auto fit = minimax_rational<3, 2>( []( double x ) { return std::log1p( x ); },
+																	 0.0, 1.0, false );
+								  float tval[4] = {0.01F, 0.3F, 0.65F, 0.99F};
+								  float cval[4];
+								  for ( int i = 0; i != 4; ++i )
+									  cval[i] = std::log1p( tval[i] );
+								  // an absolute fit, 14 ulp relative at 0.01
+								  return match( ratval( fvec4( tval ), fit.p_as<float>(), fit.q_as<float>() ), cval );
+							  }, 32 );
+		TEST_CODE_VAL_EQ_ULPS(test, "ratval_array",
+							  []() {
+								  static const float p[3] = { 1.F, 0.5F, 0.25F };
+								  static const float q[2] = { 1.F, -0.5F };
+								  float tval[4] = {0.2F, -0.7F, 0.9F, 0.F};
+								  float cval[4];
+								  for ( int i = 0; i != 4; ++i )
+									  cval[i] = horner( tval[i], 1.F, 0.5F, 0.25F ) / horner( tval[i], 1.F, -0.5F );
+								  return match( ratval( fvec4( tval ), p, q ), cval );
+							  }, 2 );
 	};
 }
 
@@ -1314,6 +1830,1362 @@ add_trig_tests( unit_test &test )
 					cval[i] = std::cos( v[i] );
 				return match( cosf( tmp ), cval );
 			} );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "atanf",
+			[]() {
+				float v[4] = { 0.25F, -0.7F, 3.F, -1e6F };
+				fvec4 tmp( v );
+				float cval[4];
+				for ( int i = 0; i != 4; ++i )
+					cval[i] = std::atan( v[i] );
+				return match( atanf( tmp ), cval );
+			}, 1e-6F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "atan2f",
+			[]() {
+				// one point in each quadrant
+				float y[4] = { 0.5F, 2.F, -0.1F, -3.F };
+				float x[4] = { 2.F, -0.5F, -3.F, 0.2F };
+				float cval[4];
+				for ( int i = 0; i != 4; ++i )
+					cval[i] = std::atan2( y[i], x[i] );
+				return match( atan2f( fvec4( y ), fvec4( x ) ), cval );
+			}, 1e-6F );
+		TEST_CODE_VAL_EQ(test, "atan2f (zeros, infinities)",
+						 []() {
+							 float y[4] = { 0.F, -0.F, std::numeric_limits<float>::infinity(), 1.F };
+							 float x[4] = { -0.F, 1.F, std::numeric_limits<float>::infinity(), 0.F };
+							 fvec4 r = atan2f( fvec4( y ), fvec4( x ) );
+							 // exact_equal compares the bits, so the -0 is checked
+							 return match( r, { float(M_PI), -0.F, float(M_PI_4), float(M_PI_2) } );
+						 } );
+	};
+}
+
+// reference transfer curves in double precision
+static double ref_srgb_to_linear( double x ) { return x <= 0.04045 ? x / 12.92 : std::pow( ( x + 0.055 ) / 1.055, 2.4 ); }
+static double ref_linear_to_srgb( double x ) { return x <= 0.0031308 ? x * 12.92 : 1.055 * std::pow( x, 1.0 / 2.4 ) - 0.055; }
+static double ref_rec709_to_linear( double x ) { return x < 0.081 ? x / 4.5 : std::pow( ( x + 0.099 ) / 1.099, 1.0 / 0.45 ); }
+static double ref_linear_to_rec709( double x ) { return x < 0.018 ? x * 4.5 : 1.099 * std::pow( x, 0.45 ) - 0.099; }
+static double ref_pq_to_linear( double x )
+{
+	double p = std::pow( x, 32.0 / 2523.0 );
+	return std::pow( std::max( p - 3424.0 / 4096.0, 0.0 ) / ( 2413.0 / 128.0 - 2392.0 / 128.0 * p ), 16384.0 / 2610.0 );
+}
+static double ref_linear_to_pq( double x )
+{
+	double p = std::pow( x, 2610.0 / 16384.0 );
+	return std::pow( ( 3424.0 / 4096.0 + 2413.0 / 128.0 * p ) / ( 1.0 + 2392.0 / 128.0 * p ), 2523.0 / 32.0 );
+}
+static double ref_hlg_to_linear( double x )
+{
+	return x <= 0.5 ? x * x / 3.0 : ( std::exp( ( x - 0.55991073 ) / 0.17883277 ) + 0.28466892 ) / 12.0;
+}
+static double ref_linear_to_hlg( double x )
+{
+	return x <= 1.0 / 12.0 ? std::sqrt( 3.0 * x ) : 0.17883277 * std::log( 12.0 * x - 0.28466892 ) + 0.55991073;
+}
+
+// the relative errors of f against ref, in units of 2^-23, at 4096
+// geometrically spaced values in [lo, hi], the worst 4 against 0. The
+// lanes of each vector come from the 4 quarters of the range, so the
+// pieces of a curve are mixed in a register
+template <typename F, typename R>
+static match
+transfer_sweep( F f, R ref, double lo, double hi )
+{
+	const size_t n = 4096;
+	std::vector<float> err( n ), zero( n, 0.F );
+	for ( size_t i = 0; i != n / 4; ++i )
+	{
+		size_t idx[4];
+		float v[4];
+		for ( size_t k = 0; k != 4; ++k )
+		{
+			idx[k] = k * ( n / 4 ) + i;
+			v[k] = float( lo * std::pow( hi / lo, double( idx[k] ) / double( n - 1 ) ) );
+		}
+		PAL_NAMESPACE::fvec4 r = f( PAL_NAMESPACE::fvec4( v[0], v[1], v[2], v[3] ) );
+		for ( size_t k = 0; k != 4; ++k )
+			err[idx[k]] = float( ( double( r[int( k )] ) / ref( double( v[k] ) ) - 1.0 ) * 8388608.0 );
+	}
+	return worst4( err.data(), zero.data(), n );
+}
+
+#define TEST_TRANSFER(test, func, ref, inv, eps)						\
+	TEST_CODE_VAL_EQ_PREC(												\
+		test, #func,													\
+		[]() {															\
+			float v[4] = { 0.001F, 0.05F, 0.5F, 1.F };					\
+			float cval[4];												\
+			for ( int i = 0; i != 4; ++i )								\
+				cval[i] = float( ref( v[i] ) );							\
+			return match( func( fvec4( v ) ), cval );					\
+		}, eps );														\
+	TEST_CODE_VAL_EQ_PREC(												\
+		test, #inv,														\
+		[]() {															\
+			float v[4] = { 0.001F, 0.05F, 0.5F, 1.F };					\
+			float cval[4];												\
+			for ( int i = 0; i != 4; ++i )								\
+				cval[i] = float( ref( v[i] ) );							\
+			return match( inv( fvec4( cval ) ), v );					\
+		}, eps )
+
+static void
+add_transfer_tests( unit_test &test )
+{
+	using namespace PAL_NAMESPACE;
+	test["transfer"] = [&]() {
+		TEST_TRANSFER( test, linear_to_srgb, ref_linear_to_srgb, srgb_to_linear, 1e-6F );
+		TEST_TRANSFER( test, linear_to_rec709, ref_linear_to_rec709, rec709_to_linear, 1e-6F );
+		TEST_TRANSFER( test, linear_to_pq, ref_linear_to_pq, pq_to_linear, 5e-5F );
+		TEST_TRANSFER( test, linear_to_hlg, ref_linear_to_hlg, hlg_to_linear, 1e-6F );
+		TEST_CODE_VAL_EQ(test, "pq_to_linear (black, out of range)",
+						 []() { return match( pq_to_linear( fvec4( 0.F, -0.5F, 1.5F, 1e6F ) ), {0.F,0.F,1.F,1.F} ); } );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "linear_to_pq (black, out of range)",
+			[]() {
+				float black = float( ref_linear_to_pq( 0.0 ) );
+				return match( linear_to_pq( fvec4( 0.F, -0.5F, 1.5F, 1e6F ) ), {black,black,1.F,1.F} );
+			}, 1e-6F );
+		// the bounds documented in simd_transfer.h
+		TEST_CODE_VAL_EQ_PREC(
+			test, "srgb_to_linear (relative error)",
+			[]() { return transfer_sweep( []( fvec4 x ) { return srgb_to_linear( x ); }, ref_srgb_to_linear, 1e-6, 1.0 ); },
+			4.F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "linear_to_srgb (relative error)",
+			[]() { return transfer_sweep( []( fvec4 x ) { return linear_to_srgb( x ); }, ref_linear_to_srgb, 1e-6, 1.0 ); },
+			7.F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "rec709_to_linear (relative error)",
+			[]() { return transfer_sweep( []( fvec4 x ) { return rec709_to_linear( x ); }, ref_rec709_to_linear, 1e-6, 1.0 ); },
+			4.F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "linear_to_rec709 (relative error)",
+			[]() { return transfer_sweep( []( fvec4 x ) { return linear_to_rec709( x ); }, ref_linear_to_rec709, 1e-6, 1.0 ); },
+			6.F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "hlg_to_linear (relative error)",
+			[]() { return transfer_sweep( []( fvec4 x ) { return hlg_to_linear( x ); }, ref_hlg_to_linear, 1e-6, 1.0 ); },
+			4.F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "linear_to_hlg (relative error)",
+			[]() { return transfer_sweep( []( fvec4 x ) { return linear_to_hlg( x ); }, ref_linear_to_hlg, 1e-6, 1.0 ); },
+			3.F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "pq_to_linear (relative error)",
+			[]() { return transfer_sweep( []( fvec4 x ) { return pq_to_linear( x ); }, ref_pq_to_linear, 1e-3, 1.0 ); },
+			24.F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "linear_to_pq (relative error)",
+			[]() { return transfer_sweep( []( fvec4 x ) { return linear_to_pq( x ); }, ref_linear_to_pq, 1e-8, 1.0 ); },
+			12.F );
+		// the closed form near black
+		TEST_CODE_VAL_EQ_PREC(
+			test, "pq_to_linear (relative error, near black)",
+			[]() { return transfer_sweep( []( fvec4 x ) { return pq_to_linear( x ); }, ref_pq_to_linear, 1e-5, 0.1 ); },
+			400.F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "linear_to_pq (relative error, near black)",
+			[]() { return transfer_sweep( []( fvec4 x ) { return linear_to_pq( x ); }, ref_linear_to_pq, 1e-30, 1e-4 ); },
+			400.F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "srgb_to_linear (reference)",
+			[]() {
+				float v[4] = { 0.02F, 0.04045F, 0.2F, 0.9F };
+				float cval[4];
+				for ( int i = 0; i != 4; ++i )
+					cval[i] = float( ref_srgb_to_linear( v[i] ) );
+				return match( srgb_to_linear( fvec4( v ) ), cval );
+			}, 1e-6F );
+	};
+}
+
+// the sort_network overloads by register count
+template <typename VT> static void run_network( VT (&v)[1] ) { v[0] = PAL_NAMESPACE::sort_network( v[0] ); }
+template <typename VT> static void run_network( VT (&v)[2] ) { PAL_NAMESPACE::sort_network( v[0], v[1] ); }
+template <typename VT> static void run_network( VT (&v)[4] ) { PAL_NAMESPACE::sort_network( v[0], v[1], v[2], v[3] ); }
+
+// sorts 64 trials of R registers with sort_network, ascending,
+// descending then random values with many duplicates, and compares
+// every output against std::sort, the worst 4 against their
+// reference
+template <typename VT, int R>
+static match
+network_check( uint32_t seed )
+{
+	typedef typename VT::value_type T;
+	const size_t N = size_t( R * VT::value_count );
+	const size_t trials = 64;
+	std::vector<T> got( trials * N ), ref( trials * N );
+	for ( size_t t = 0; t != trials; ++t )
+	{
+		T *g = got.data() + t * N;
+		T *r = ref.data() + t * N;
+		for ( size_t i = 0; i != N; ++i )
+		{
+			seed = seed * 1664525U + 1013904223U;
+			int x = t == 0 ? int( i ) : ( t == 1 ? int( N - i ) : int( seed >> 27 ) - 16 );
+			g[i] = r[i] = T( x );
+		}
+		VT v[R];
+		for ( int k = 0; k != R; ++k )
+			v[k] = PAL_NAMESPACE::detail::load_vec<VT>( g + size_t( k ) * size_t( VT::value_count ) );
+		run_network( v );
+		for ( int k = 0; k != R; ++k )
+			PAL_NAMESPACE::store( g + size_t( k ) * size_t( VT::value_count ), v[k] );
+		std::sort( r, r + N );
+	}
+	return worst4( got.data(), ref.data(), got.size() );
+}
+
+static void
+add_sort_tests( unit_test &test )
+{
+	using namespace PAL_NAMESPACE;
+	test["sort"] = [&]() {
+		TEST_CODE_VAL_EQ(test, "sort_network (1 register)",
+						 []() { return match( sort_network( fvec4( 3.F, -1.F, 2.F, -5.F ) ), {-5.F,-1.F,2.F,3.F} ); } );
+		TEST_CODE_VAL_EQ(test, "sort_network (fvec4, 1 register)", []() { return network_check<fvec4, 1>( 1 ); } );
+		TEST_CODE_VAL_EQ(test, "sort_network (fvec4, 2 registers)", []() { return network_check<fvec4, 2>( 2 ); } );
+		TEST_CODE_VAL_EQ(test, "sort_network (fvec4, 4 registers)", []() { return network_check<fvec4, 4>( 3 ); } );
+#ifdef PAL_HAS_FVEC8
+		TEST_CODE_VAL_EQ(test, "sort_network (fvec8, 1 register)", []() { return network_check<fvec8, 1>( 4 ); } );
+		TEST_CODE_VAL_EQ(test, "sort_network (fvec8, 2 registers)", []() { return network_check<fvec8, 2>( 5 ); } );
+		TEST_CODE_VAL_EQ(test, "sort_network (fvec8, 4 registers)", []() { return network_check<fvec8, 4>( 6 ); } );
+#endif
+		TEST_CODE_VAL_EQ(test, "sort (float buffer)",
+						 []() {
+							 std::vector<float> v( 1000 );
+							 for ( size_t i = 0; i != v.size(); ++i )
+								 v[i] = float( ( i * 7919 ) % 1009 ) - 500.F + ( i % 3 == 0 ? 0.F : 0.25F );
+							 std::vector<float> r = v;
+							 std::sort( r.begin(), r.end() );
+							 sort( v.data(), v.size() );
+							 return match_val<int>( v == r ? 1 : 0, 1 );
+						 } );
+	};
+}
+
+static void
+add_reduce_tests( unit_test &test )
+{
+	using namespace PAL_NAMESPACE;
+	test["reduce"] = [&]() {
+		TEST_CODE_VAL_EQ(test, "argmin / argmax (float, first index)",
+						 []() {
+							 std::vector<float> v( 1003 );
+							 for ( size_t i = 0; i != v.size(); ++i )
+								 v[i] = float( ( i * 7919 ) % 101 ) - 50.F;
+							 int cval[4] = { int( argmin( v.data(), v.size() ) ),
+											 int( argmax( v.data(), v.size() ) ),
+											 int( argmin( v.data(), 3 ) ),
+											 int( argmin( v.data(), 0 ) ) };
+							 int tval[4] = { int( std::min_element( v.begin(), v.end() ) - v.begin() ),
+											 int( std::max_element( v.begin(), v.end() ) - v.begin() ),
+											 int( std::min_element( v.begin(), v.begin() + 3 ) - v.begin() ),
+											 0 };
+							 return match_val<int>( std::equal( cval, cval + 4, tval ) ? 1 : 0, 1 );
+						 } );
+		TEST_CODE_VAL_EQ(test, "max_with_index (double)",
+						 []() {
+							 std::vector<double> v( 517, 1.0 );
+							 v[300] = 2.5;
+							 v[411] = 2.5;
+							 value_index<double> r = max_with_index( v.data(), v.size() );
+							 return match_val<int>( r.value == 2.5 ? int( r.index ) : -1, 300 );
+						 } );
+		TEST_CODE_VAL_EQ(test, "min_with_index (threads)",
+						 []() {
+							 // the extremes (each twice) are past the first
+							 // chunk, so the chunk offsets must be added
+							 std::vector<float> v( size_t(1) << 20 );
+							 for ( size_t i = 0; i != v.size(); ++i )
+								 v[i] = float( ( ( i * 2654435761U ) >> 20 ) & 0xFFFF );
+							 v[1047575] = v[1048570] = -3.F;
+							 v[600001] = v[900000] = 1e6F;
+							 value_index<float> a = min_with_index( v.data(), v.size(), 4 );
+							 value_index<float> b = max_with_index( v.data(), v.size(), 4 );
+							 return intmatch( lvec4( int( a.index ), int( a.value ), int( b.index ), int( b.value ) ),
+											  {1047575,-3,600001,1000000} );
+						 } );
+	};
+}
+
+static void
+add_search_tests( unit_test &test )
+{
+	using namespace PAL_NAMESPACE;
+	test["search"] = [&]() {
+		TEST_CODE_VAL_EQ(test, "mask which",
+						 []() { return match_val<int>( ( fvec4( 1.F, 5.F, 1.F, 5.F ) > fvec4( 2.F ) ).which(), 0xA ); } );
+		TEST_CODE_VAL_EQ(test, "find_first_nonfinite",
+						 []() {
+							 std::vector<float> v( 1001, 1.F );
+							 v[777] = std::numeric_limits<float>::infinity();
+							 v[1000] = std::numeric_limits<float>::quiet_NaN();
+							 int cval[4] = { int( find_first_nonfinite( v.data(), v.size() ) ),
+											 int( find_first_nan( v.data(), v.size() ) ),
+											 int( find_first_nonfinite( v.data(), 777 ) ),
+											 int( find_first_nan( v.data(), 3 ) ) };
+							 return match( fvec4( float( cval[0] ), float( cval[1] ), float( cval[2] ), float( cval[3] ) ),
+										   { 777.F, 1000.F, 777.F, 3.F } );
+						 } );
+		TEST_CODE_VAL_EQ(test, "count_if / any_of / all_of",
+						 []() {
+							 std::vector<float> v( 203 );
+							 for ( size_t i = 0; i != v.size(); ++i )
+								 v[i] = float( i % 7 );
+							 auto big = []( search_vec<float> x ) { return x > search_vec<float>( 4.5F ); };
+							 auto pos = []( search_vec<float> x ) { return x >= search_vec<float>( 0.F ); };
+							 int cval[4] = { int( count_if( v.data(), v.size(), big ) ),
+											 any_of( v.data(), 5, big ) ? 1 : 0,
+											 all_of( v.data(), v.size(), pos ) ? 1 : 0,
+											 int( find_first_if( v.data(), v.size(), big ) ) };
+							 return match( fvec4( float( cval[0] ), float( cval[1] ), float( cval[2] ), float( cval[3] ) ),
+										   { 58.F, 0.F, 1.F, 5.F } );
+						 } );
+	};
+}
+
+static void
+add_compact_tests( unit_test &test )
+{
+	using namespace PAL_NAMESPACE;
+	test["compact"] = [&]() {
+		TEST_CODE_VAL_EQ(test, "compress",
+						 []() {
+							 int count;
+							 fvec4 v( 1.F, 2.F, 3.F, 4.F );
+							 fvec4 r = compress( v, v > fvec4( 1.5F ), count );
+							 return match( fvec4( r[0], r[1], r[2], float( count ) ), { 2.F, 3.F, 4.F, 3.F } );
+						 } );
+#ifdef PAL_HAS_FVEC8
+		TEST_CODE_VAL_EQ(test, "compress (8 wide, every mask)",
+						 []() {
+							 // returns the first mask any of the 8 wide
+							 // compresses gets wrong, -1 for none
+							 PAL_ALIGN_256 float fv[8], fo[8], fs[8];
+							 PAL_ALIGN_256 int32_t iv[8], io[8], is[8];
+							 for ( int i = 0; i != 8; ++i )
+							 {
+								 fv[i] = float( i + 1 );
+								 iv[i] = -( i + 1 );
+							 }
+							 fvec8 v = load8f( fv );
+							 lvec8 w = load256( iv );
+							 for ( int bits = 0; bits != 256; ++bits )
+							 {
+								 float sel[8], ref[8];
+								 int n = 0;
+								 for ( int i = 0; i != 8; ++i )
+								 {
+									 sel[i] = float( ( bits >> i ) & 1 );
+									 if ( sel[i] != 0.F )
+										 ref[n++] = fv[i];
+								 }
+								 fvec8 sv( sel );
+								 int fc, ic;
+								 store( fo, compress( v, sv > fvec8( 0.5F ), fc ) );
+								 store( io, compress( w, lvec8( sv.convert_to_int() ) > lvec8::zero(), ic ) );
+								 int fsc = compress_store( fs, v, sv > fvec8( 0.5F ) );
+								 int isc = compress_store( is, w, lvec8( sv.convert_to_int() ) > lvec8::zero() );
+								 bool ok = fc == n && ic == n && fsc == n && isc == n;
+								 for ( int i = 0; ok && i != n; ++i )
+									 ok = fo[i] == ref[i] && fs[i] == ref[i] && io[i] == -int32_t( ref[i] ) && is[i] == -int32_t( ref[i] );
+								 if ( ! ok )
+									 return match_val<int>( bits, -1 );
+							 }
+							 return match_val<int>( -1, -1 );
+						 } );
+#endif
+		TEST_CODE_VAL_EQ(test, "copy_if / partition",
+						 []() {
+							 std::vector<float> v( 203 ), o( 203 );
+							 for ( size_t i = 0; i != v.size(); ++i )
+								 v[i] = float( ( i * 37 ) % 11 ) - 5.F;
+							 std::vector<float> r;
+							 std::copy_if( v.begin(), v.end(), std::back_inserter( r ), []( float x ) { return x > 0.F; } );
+							 auto pos = []( search_vec<float> x ) { return x > search_vec<float>::zero(); };
+							 size_t c = copy_if( o.data(), v.data(), v.size(), pos );
+							 bool ok = c == r.size() && std::equal( r.begin(), r.end(), o.begin() );
+							 std::vector<float> p = v;
+							 std::stable_partition( p.begin(), p.end(), []( float x ) { return x > 0.F; } );
+							 ok = ok && partition( v.data(), v.size(), pos ) == c && v == p;
+							 return match_val<int>( ok ? 1 : 0, 1 );
+						 } );
+	};
+}
+
+// the test signal filtered in one call (y), and in odd sized blocks
+// both plain (ys) and decimated by 2 (yd), which carry the history
+// across the calls
+static void
+fir_blocks( std::vector<float> &y, std::vector<float> &ys, std::vector<float> &yd,
+			size_t &o, size_t &od, bool &sym )
+{
+	using namespace PAL_NAMESPACE;
+	float h[9] = { 0.1F, -0.2F, 0.3F, 0.5F, 1.F, 0.5F, 0.3F, -0.2F, 0.1F };
+	std::vector<float> x( 1000 );
+	y.resize( 1000 );
+	ys.resize( 1000 );
+	yd.resize( 500 );
+	for ( size_t i = 0; i != x.size(); ++i )
+		x[i] = float( ( i * 37 ) % 17 ) - 8.F;
+	fir( y.data(), x.data(), x.size(), h, 9 );
+	fir_filter fs( h, 9 ), fd( h, 9, 2 );
+	o = od = 0;
+	for ( size_t b = 0; b < x.size(); b += 77 )
+	{
+		size_t c = std::min( x.size() - b, size_t(77) );
+		o += fs.process( ys.data() + o, x.data() + b, c );
+		od += fd.process( yd.data() + od, x.data() + b, c );
+	}
+	sym = fs.symmetric();
+}
+
+static void
+add_fir_tests( unit_test &test )
+{
+	using namespace PAL_NAMESPACE;
+	test["fir"] = [&]() {
+		TEST_CODE_VAL_EQ(test, "fir (impulse response)",
+						 []() {
+							 float h[5] = { 0.5F, -1.F, 2.F, 0.25F, 3.F };
+							 std::vector<float> x( 100, 0.F ), y( 100 ), r( 100, 0.F );
+							 x[40] = 1.F;
+							 std::copy( h, h + 5, r.begin() + 40 );
+							 fir( y.data(), x.data(), x.size(), h, 5 );
+							 return worst4( y.data(), r.data(), r.size() );
+						 } );
+		TEST_CODE_VAL_EQ(test, "fir_filter (block counts, symmetric)",
+						 []() {
+							 std::vector<float> y, ys, yd;
+							 size_t o, od;
+							 bool sym;
+							 fir_blocks( y, ys, yd, o, od, sym );
+							 return intmatch( lvec4( int( o ), int( od ), int( sym ), 0 ), { 1000, 500, 1, 0 } );
+						 } );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "fir_filter (blocks)",
+			[]() {
+				std::vector<float> y, ys, yd;
+				size_t o, od;
+				bool sym;
+				fir_blocks( y, ys, yd, o, od, sym );
+				return worst4( ys.data(), y.data(), y.size() );
+			}, 1e-4F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "fir_filter (blocks, decimated)",
+			[]() {
+				std::vector<float> y, ys, yd, y2( 500 );
+				size_t o, od;
+				bool sym;
+				fir_blocks( y, ys, yd, o, od, sym );
+				for ( size_t i = 0; i != y2.size(); ++i )
+					y2[i] = y[i * 2];
+				return worst4( yd.data(), y2.data(), y2.size() );
+			}, 1e-4F );
+	};
+}
+
+static void
+add_blur_tests( unit_test &test )
+{
+	using namespace PAL_NAMESPACE;
+	test["blur"] = [&]() {
+		TEST_CODE_VAL_EQ_PREC(
+			test, "separable_filter (strided, edges)",
+			[]() {
+				// wider than a column tile
+				const size_t w = 531, h = 13, stride = 540;
+				float hk[5] = { 0.1F, 0.2F, 0.4F, 0.2F, 0.1F };
+				float vk[4] = { -1.F, 0.5F, 2.F, 0.25F };
+				std::vector<float> in( stride * h ), out( w * h ), ref( w * h );
+				for ( size_t i = 0; i != in.size(); ++i )
+					in[i] = float( ( i * 53 ) % 23 ) - 11.F;
+				separable_filter( out.data(), w, in.data(), stride, w, h, hk, 5, vk, 4, 2 );
+				for ( size_t y = 0; y != h; ++y )
+					for ( size_t x = 0; x != w; ++x )
+					{
+						float a = 0.F;
+						for ( int j = 0; j != 4; ++j )
+							for ( int i = 0; i != 5; ++i )
+							{
+								int sx = std::min( std::max( int( x ) + i - 2, 0 ), int( w ) - 1 );
+								int sy = std::min( std::max( int( y ) + j - 2, 0 ), int( h ) - 1 );
+								a += hk[i] * vk[j] * in[size_t( sy ) * stride + size_t( sx )];
+							}
+						ref[y * w + x] = a;
+					}
+				return worst4( out.data(), ref.data(), ref.size() );
+			}, 1e-4F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "box_blur",
+			[]() {
+				const size_t w = 53, h = 41, r = 6;
+				std::vector<float> in( w * h ), a( w * h ), b( w * h ), k( 2 * r + 1, 1.F / float( 2 * r + 1 ) );
+				for ( size_t i = 0; i != in.size(); ++i )
+					in[i] = float( ( i * 37 ) % 17 ) - 8.F;
+				box_blur( a.data(), w, in.data(), w, w, h, r );
+				separable_filter( b.data(), w, in.data(), w, w, h, k.data(), k.size(), k.data(), k.size() );
+				return worst4( a.data(), b.data(), b.size() );
+			}, 1e-4F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "gaussian_blur (constant)",
+			[]() {
+				// a constant image stays constant, with the kernel
+				// and the 3 box passes
+				const size_t w = 53, h = 41;
+				std::vector<float> in( w * h, 3.F ), a( w * h ), b( w * h );
+				gaussian_blur( a.data(), w, in.data(), w, w, h, 2.F );
+				gaussian_blur( b.data(), w, in.data(), w, w, h, 8.F );
+				return match( fvec4( a[w * h / 2], a[0], b[w * h / 2], b[0] ), { 3.F, 3.F, 3.F, 3.F } );
+			}, 1e-5F );
+		// tall enough for 3 bands of threads, starting at rows 0, 64
+		// and 128
+		TEST_CODE_VAL_EQ(test, "separable_filter (threads)",
+						 []() {
+							 const size_t w = 97, h = 200;
+							 float k[7] = { 0.05F, 0.1F, 0.2F, 0.3F, 0.2F, 0.1F, 0.05F };
+							 std::vector<float> in( w * h ), a( w * h ), b( w * h );
+							 for ( size_t i = 0; i != in.size(); ++i )
+								 in[i] = float( ( i * 53 ) % 23 ) - 11.F;
+							 separable_filter( a.data(), w, in.data(), w, w, h, k, 7, k, 7, 1 );
+							 separable_filter( b.data(), w, in.data(), w, w, h, k, 7, k, 7, 3 );
+							 return worst4( b.data(), a.data(), a.size() );
+						 } );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "box_blur (threads)",
+			[]() {
+				// each band restarts its running sums, so this is
+				// only close to the single thread result
+				const size_t w = 97, h = 200, r = 9;
+				std::vector<float> in( w * h ), a( w * h ), b( w * h );
+				for ( size_t i = 0; i != in.size(); ++i )
+					in[i] = float( ( i * 37 ) % 17 ) - 8.F;
+				box_blur( a.data(), w, in.data(), w, w, h, r, 1 );
+				box_blur( b.data(), w, in.data(), w, w, h, r, 3 );
+				return worst4( b.data(), a.data(), a.size() );
+			}, 1e-5F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "box_blur (threads, reference)",
+			[]() {
+				const size_t w = 97, h = 200, r = 9;
+				std::vector<float> in( w * h ), a( w * h ), b( w * h ), k( 2 * r + 1, 1.F / float( 2 * r + 1 ) );
+				for ( size_t i = 0; i != in.size(); ++i )
+					in[i] = float( ( i * 37 ) % 17 ) - 8.F;
+				box_blur( b.data(), w, in.data(), w, w, h, r, 3 );
+				separable_filter( a.data(), w, in.data(), w, w, h, k.data(), k.size(), k.data(), k.size() );
+				return worst4( b.data(), a.data(), a.size() );
+			}, 1e-4F );
+	};
+}
+
+static void
+add_resample_tests( unit_test &test )
+{
+	using namespace PAL_NAMESPACE;
+	test["resample"] = [&]() {
+		TEST_CODE_VAL_EQ(test, "resample (linear ramp)",
+						 []() {
+							 // a 2x linear upsample of a ramp is a ramp of half the
+							 // slope (away from the edges)
+							 std::vector<float> in( 50 ), up( 100 );
+							 for ( size_t i = 0; i != in.size(); ++i )
+								 in[i] = float( i );
+							 resample( up.data(), up.size(), in.data(), in.size(), resample_filter::linear );
+							 return match( fvec4( up[20], up[21], up[61], up[62] ), { 9.75F, 10.25F, 30.25F, 30.75F } );
+						 } );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "resample (constant)",
+			[]() {
+				std::vector<float> c( 50, 2.F ), dn( 17 ), ref( 17, 2.F );
+				resample( dn.data(), dn.size(), c.data(), c.size(), resample_filter::lanczos3 );
+				return worst4( dn.data(), ref.data(), ref.size() );
+			}, 1e-5F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "resize (rows then columns)",
+			[]() {
+				const size_t iw = 67, ih = 23, ow = 29, oh = 41, stride = 70;
+				std::vector<float> in( stride * ih ), out( ow * oh ), rows( ow * ih ), col( ih ), ocol( oh ), ref( ow * oh );
+				for ( size_t i = 0; i != in.size(); ++i )
+					in[i] = float( ( i * 53 ) % 23 ) - 11.F;
+				resize( out.data(), ow, ow, oh, in.data(), stride, iw, ih, resample_filter::cubic, 2 );
+				for ( size_t y = 0; y != ih; ++y )
+					resample( rows.data() + y * ow, ow, in.data() + y * stride, iw, resample_filter::cubic );
+				for ( size_t x = 0; x != ow; ++x )
+				{
+					for ( size_t y = 0; y != ih; ++y )
+						col[y] = rows[y * ow + x];
+					resample( ocol.data(), oh, col.data(), ih, resample_filter::cubic );
+					for ( size_t y = 0; y != oh; ++y )
+						ref[y * ow + x] = ocol[y];
+				}
+				return worst4( out.data(), ref.data(), ref.size() );
+			}, 1e-4F );
+		TEST_CODE_VAL_EQ(test, "resampler (output counts)",
+						 []() {
+							 // the outputs whose taps have all arrived, in
+							 // one call or in blocks, then those 64 zeros
+							 // of flush release
+							 std::vector<float> in( 5000, 1.F ), z( 64, 0.F ), a( 6000 ), b( 6000 );
+							 resampler ra( 48000.0 / 44100.0 ), rb( 48000.0 / 44100.0 );
+							 size_t na = ra.process( a.data(), in.data(), in.size() ), nb = 0;
+							 for ( size_t i = 0; i < in.size(); i += 333 )
+								 nb += rb.process( b.data() + nb, in.data() + i, std::min( size_t(333), in.size() - i ) );
+							 size_t nz = ra.process( a.data() + na, z.data(), z.size() );
+							 return intmatch( lvec4( int( na ), int( nb ), int( nz ), int( na + nz ) ),
+											  { 5438, 5438, 70, 5508 } );
+						 } );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "resampler (stream in blocks)",
+			[]() {
+				std::vector<float> in( 5000 ), a( 6000 ), b( 6000 );
+				for ( size_t i = 0; i != in.size(); ++i )
+					in[i] = std::sin( 0.05F * float( i ) );
+				resampler ra( 48000.0 / 44100.0 ), rb( 48000.0 / 44100.0 );
+				size_t na = ra.process( a.data(), in.data(), in.size() ), nb = 0;
+				for ( size_t i = 0; i < in.size(); i += 333 )
+					nb += rb.process( b.data() + nb, in.data() + i, std::min( size_t(333), in.size() - i ) );
+				return worst4( b.data(), a.data(), std::min( na, nb ) );
+			}, 1e-6F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "resampler (sample times)",
+			[]() {
+				// output k is the input at time k * 44100 / 48000
+				std::vector<float> in( 5000 ), a( 6000 );
+				for ( size_t i = 0; i != in.size(); ++i )
+					in[i] = std::sin( 0.05F * float( i ) );
+				resampler ra( 48000.0 / 44100.0 );
+				ra.process( a.data(), in.data(), in.size() );
+				float cval[4];
+				const size_t k[4] = { 1000, 1001, 2500, 4321 };
+				for ( int i = 0; i != 4; ++i )
+					cval[i] = float( std::sin( 0.05 * double( k[i] ) * 44100.0 / 48000.0 ) );
+				return match( fvec4( a[k[0]], a[k[1]], a[k[2]], a[k[3]] ), cval );
+			}, 1e-3F );
+	};
+}
+
+// a test signal of n complex values, and its DFT by the definition in
+// double, with the real parts then the imaginary parts in one buffer
+static void
+fft_signal( std::vector<float> &re, std::vector<float> &im, std::vector<float> &ref, size_t n )
+{
+	re.resize( n );
+	im.resize( n );
+	ref.resize( 2 * n );
+	for ( size_t i = 0; i != n; ++i )
+	{
+		re[i] = float( ( i * 37 ) % 17 ) - 8.F;
+		im[i] = float( ( i * 11 ) % 13 ) - 6.F;
+	}
+	for ( size_t k = 0; k != n; ++k )
+	{
+		double sr = 0.0, si = 0.0;
+		for ( size_t i = 0; i != n; ++i )
+		{
+			double a = -2.0 * 3.14159265358979323846 * double( ( i * k ) % n ) / double( n );
+			sr += re[i] * std::cos( a ) - im[i] * std::sin( a );
+			si += re[i] * std::sin( a ) + im[i] * std::cos( a );
+		}
+		ref[k] = float( sr );
+		ref[n + k] = float( si );
+	}
+}
+
+// transforms the signal of fft_signal with plan p, returning the real
+// then the imaginary parts
+static std::vector<float>
+fft_forward( PAL_NAMESPACE::fft_plan<float> &p, const std::vector<float> &re, const std::vector<float> &im )
+{
+	const size_t n = re.size();
+	std::vector<float> r = re, i = im, out( 2 * n );
+	p.forward( r.data(), i.data() );
+	std::copy( r.begin(), r.end(), out.begin() );
+	std::copy( i.begin(), i.end(), out.begin() + std::ptrdiff_t( n ) );
+	return out;
+}
+
+static void
+add_fft_tests( unit_test &test )
+{
+	using namespace PAL_NAMESPACE;
+	test["fft"] = [&]() {
+		TEST_CODE_VAL_EQ(test, "fft_plan (sizes)",
+						 []() {
+							 return intmatch( lvec4( int( fft_plan<float>( 128 ).size() ), int( fft_plan<float>( 12 ).size() ),
+													 int( fft_plan<float>( 0 ).size() ), int( fft_plan<double>( 1 ).size() ) ),
+											  { 128, 0, 0, 1 } );
+						 } );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "fft_plan (naive DFT)",
+			[]() {
+				// 128 is an odd power of two, ending with a radix-2 pass
+				std::vector<float> re, im, ref;
+				fft_signal( re, im, ref, 128 );
+				fft_plan<float> p( 128 );
+				std::vector<float> out = fft_forward( p, re, im );
+				return worst4( out.data(), ref.data(), ref.size() );
+			}, 1e-3F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "fft_plan (round trip)",
+			[]() {
+				std::vector<float> re, im, ref;
+				fft_signal( re, im, ref, 128 );
+				std::vector<float> r = re, i = im;
+				fft_plan<float> p( 128 );
+				p.forward( r.data(), i.data() );
+				p.inverse( r.data(), i.data() );
+				for ( size_t k = 0; k != r.size(); ++k )
+					r[k] /= 128.F;
+				return worst4( r.data(), re.data(), re.size() );
+			}, 1e-5F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "fft_plan (four step, naive DFT)",
+			[]() {
+				// past a lowered blocked size, as a 32 x 32 matrix
+				std::vector<float> re, im, ref;
+				fft_signal( re, im, ref, 1024 );
+				fft_plan<float> p( 1024, 256 );
+				std::vector<float> out = fft_forward( p, re, im );
+				return worst4( out.data(), ref.data(), ref.size() );
+			}, 2e-3F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "fft_plan (four step, odd power)",
+			[]() {
+				// 32 x 64, so the rows have a plan of their own
+				std::vector<float> re, im, ref;
+				fft_signal( re, im, ref, 2048 );
+				fft_plan<float> p( 2048, 1024 );
+				std::vector<float> out = fft_forward( p, re, im );
+				return worst4( out.data(), ref.data(), ref.size() );
+			}, 2e-3F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "real_fft_plan (complex transform)",
+			[]() {
+				const size_t n = 256;
+				std::vector<double> x( n ), cr( n ), ci( n, 0.0 ), r( n / 2 + 1 ), i( n / 2 + 1 ), got, ref;
+				for ( size_t k = 0; k != n; ++k )
+					cr[k] = x[k] = std::sin( 0.3 * double( k ) ) + double( k % 5 );
+				fft_plan<double>( n ).forward( cr.data(), ci.data() );
+				real_fft_plan<double> p( n );
+				p.forward( r.data(), i.data(), x.data() );
+				got.insert( got.end(), r.begin(), r.end() );
+				got.insert( got.end(), i.begin(), i.end() );
+				ref.insert( ref.end(), cr.begin(), cr.begin() + std::ptrdiff_t( n / 2 + 1 ) );
+				ref.insert( ref.end(), ci.begin(), ci.begin() + std::ptrdiff_t( n / 2 + 1 ) );
+				return worst2( got.data(), ref.data(), ref.size() );
+			}, 1e-10F );
+		TEST_CODE_VAL_EQ(test, "real_fft_plan (real DC and Nyquist)",
+						 []() {
+							 const size_t n = 256;
+							 std::vector<double> x( n ), r( n / 2 + 1 ), i( n / 2 + 1 );
+							 for ( size_t k = 0; k != n; ++k )
+								 x[k] = std::sin( 0.3 * double( k ) ) + double( k % 5 );
+							 real_fft_plan<double>( n ).forward( r.data(), i.data(), x.data() );
+							 return dmatch( dvec2( i[0], i[n / 2] ), { 0.0, 0.0 } );
+						 } );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "real_fft_plan (round trip)",
+			[]() {
+				const size_t n = 256;
+				std::vector<double> x( n ), r( n / 2 + 1 ), i( n / 2 + 1 ), y( n );
+				for ( size_t k = 0; k != n; ++k )
+					x[k] = std::sin( 0.3 * double( k ) ) + double( k % 5 );
+				real_fft_plan<double> p( n );
+				p.forward( r.data(), i.data(), x.data() );
+				p.inverse( y.data(), r.data(), i.data() );
+				for ( size_t k = 0; k != n; ++k )
+					y[k] /= double( n );
+				return worst2( y.data(), x.data(), x.size() );
+			}, 1e-12F );
+	};
+}
+
+// 8 complex values (2 vectors of 4, 1 of 8), their products with the
+// conjugates of those 3 further on, and their split and interleaved
+// layouts
+static const float kCplxRe[11] = { 1.F, -0.5F, 2.F, 0.F, 0.25F, -3.F, 1.5F, -1.F, 0.5F, 2.F, -2.5F };
+static const float kCplxIm[11] = { 2.F, 1.5F, -1.F, -3.F, 0.75F, 0.5F, -2.F, -0.25F, 1.F, -1.5F, 0.F };
+
+// out[0, n) is the real parts and out[n, 2 n) the imaginary parts of
+// op applied to the values i, i + 3 in double
+template <typename F>
+static void
+cplx_ref( float *out, int n, F op )
+{
+	for ( int i = 0; i != n; ++i )
+	{
+		std::complex<double> r = op( std::complex<double>( kCplxRe[i], kCplxIm[i] ),
+									 std::complex<double>( kCplxRe[i + 3], kCplxIm[i + 3] ) );
+		out[i] = float( r.real() );
+		out[n + i] = float( r.imag() );
+	}
+}
+
+static void
+add_complex_tests( unit_test &test )
+{
+	using namespace PAL_NAMESPACE;
+	test["complex"] = [&]() {
+		TEST_CODE_VAL_EQ_PREC(
+			test, "cfvec4 fma",
+			[]() {
+				cfvec4 a( load4f( kCplxRe ), load4f( kCplxIm ) ), b( load4f( kCplxRe + 3 ), load4f( kCplxIm + 3 ) );
+				cfvec4 m = fma( a, b, conj( a ) );
+				float got[8], ref[8];
+				store( got, m.re );
+				store( got + 4, m.im );
+				cplx_ref( ref, 4, []( std::complex<double> x, std::complex<double> y ) { return x * y + std::conj( x ); } );
+				return worst4( got, ref, 8 );
+			}, 1e-6F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "cfvec4 exp, polar",
+			[]() {
+				cfvec4 a( load4f( kCplxRe ), load4f( kCplxIm ) );
+				cfvec4 e = exp( a ), p = polar( abs( a ), arg( a ) );
+				float got[16], ref[16];
+				store( got, e.re );
+				store( got + 4, e.im );
+				store( got + 8, p.re );
+				store( got + 12, p.im );
+				cplx_ref( ref, 4, []( std::complex<double> x, std::complex<double> ) { return std::exp( x ); } );
+				cplx_ref( ref + 8, 4, []( std::complex<double> x, std::complex<double> ) { return x; } );
+				return worst4( got, ref, 16 );
+			}, 4e-6F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "cfvec4 abs, arg",
+			[]() {
+				cfvec4 a( load4f( kCplxRe ), load4f( kCplxIm ) );
+				float got[8], ref[8];
+				store( got, abs( a ) );
+				store( got + 4, arg( a ) );
+				cplx_ref( ref, 4, []( std::complex<double> x, std::complex<double> ) {
+						return std::complex<double>( std::abs( x ), std::arg( x ) );
+					} );
+				return worst4( got, ref, 8 );
+			}, 1e-6F );
+		TEST_CODE_VAL_EQ(test, "icfvec4 multiply (re)",
+						 []() {
+							 // z0^2, z1^2 then z2 conj( z2 ), z3 conj( z3 )
+							 float buf[8];
+							 interleave2( buf, kCplxRe, kCplxIm, 4 );
+							 icfvec4 x0( load4f( buf ) ), x1( load4f( buf + 4 ) );
+							 cfvec4 p = to_split( x0 * x0, x1 * conj( x1 ) );
+							 return match( p.re, { -3.F, -2.F, 5.F, 9.F } );
+						 } );
+		TEST_CODE_VAL_EQ(test, "icfvec4 multiply (im)",
+						 []() {
+							 float buf[8];
+							 interleave2( buf, kCplxRe, kCplxIm, 4 );
+							 icfvec4 x0( load4f( buf ) ), x1( load4f( buf + 4 ) );
+							 cfvec4 p = to_split( x0 * x0, x1 * conj( x1 ) );
+							 return match( p.im, { 4.F, -1.5F, 0.F, 0.F } );
+						 } );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "icfvec4 fma, exp",
+			[]() {
+				float ab[8], bb[8];
+				interleave2( ab, kCplxRe, kCplxIm, 4 );
+				interleave2( bb, kCplxRe + 3, kCplxIm + 3, 4 );
+				icfvec4 a0( load4f( ab ) ), a1( load4f( ab + 4 ) ), b0( load4f( bb ) ), b1( load4f( bb + 4 ) );
+				cfvec4 m = to_split( fma( a0, b0, conj( a0 ) ), fma( a1, b1, conj( a1 ) ) );
+				cfvec4 e = to_split( exp( a0 ), exp( a1 ) );
+				float got[16], ref[16];
+				store( got, m.re );
+				store( got + 4, m.im );
+				store( got + 8, e.re );
+				store( got + 12, e.im );
+				cplx_ref( ref, 4, []( std::complex<double> x, std::complex<double> y ) { return x * y + std::conj( x ); } );
+				cplx_ref( ref + 8, 4, []( std::complex<double> x, std::complex<double> ) { return std::exp( x ); } );
+				return worst4( got, ref, 16 );
+			}, 4e-6F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "icfvec4 abs, arg, polar_interleaved",
+			[]() {
+				float ab[4];
+				interleave2( ab, kCplxRe, kCplxIm, 2 );
+				icfvec4 a( load4f( ab ) );
+				icfvec4 p = polar_interleaved( abs( a ), arg( a ) );
+				float got[12], ref[12];
+				store( got, abs( a ) );
+				store( got + 4, arg( a ) );
+				store( got + 8, p.v );
+				for ( int i = 0; i != 2; ++i )
+				{
+					std::complex<double> x( kCplxRe[i], kCplxIm[i] );
+					ref[2 * i] = ref[2 * i + 1] = float( std::abs( x ) );
+					ref[4 + 2 * i] = ref[4 + 2 * i + 1] = float( std::arg( x ) );
+				}
+				std::copy( ab, ab + 4, ref + 8 );
+				return worst4( got, ref, 12 );
+			}, 1e-6F );
+		TEST_CODE_VAL_EQ(test, "to_split, to_interleaved (4 wide)",
+						 []() {
+							 // the second half of the interleaved values
+							 // back from the split layout
+							 icfvec4 x0, x1;
+							 to_interleaved( cfvec4( load4f( kCplxRe ), load4f( kCplxIm ) ), x0, x1 );
+							 return match( x1.v, { kCplxRe[2], kCplxIm[2], kCplxRe[3], kCplxIm[3] } );
+						 } );
+		TEST_CODE_VAL_EQ(test, "interleave2, deinterleave2 (buffers)",
+						 []() {
+							 // long enough for the 8 wide, 4 wide and
+							 // scalar loops
+							 const size_t n = 37;
+							 std::vector<float> a( n ), b( n ), buf( 2 * n ), a2( n ), b2( n ), ref( 2 * n ), got( 2 * n );
+							 for ( size_t i = 0; i != n; ++i )
+							 {
+								 a[i] = float( i );
+								 b[i] = -float( i ) - 0.5F;
+								 ref[2 * i] = a[i];
+								 ref[2 * i + 1] = b[i];
+							 }
+							 interleave2( buf.data(), a.data(), b.data(), n );
+							 deinterleave2( a2.data(), b2.data(), buf.data(), n );
+							 // the interleaved buffer, then the round trip
+							 std::vector<float> all = buf, back = ref;
+							 std::copy( a2.begin(), a2.end(), got.begin() );
+							 std::copy( b2.begin(), b2.end(), got.begin() + std::ptrdiff_t( n ) );
+							 std::copy( a.begin(), a.end(), back.begin() );
+							 std::copy( b.begin(), b.end(), back.begin() + std::ptrdiff_t( n ) );
+							 all.insert( all.end(), got.begin(), got.end() );
+							 ref.insert( ref.end(), back.begin(), back.end() );
+							 return worst4( all.data(), ref.data(), ref.size() );
+						 } );
+#ifdef PAL_HAS_FVEC8
+		TEST_CODE_VAL_EQ_PREC(
+			test, "cfvec8 fma, polar",
+			[]() {
+				cfvec8 a( load8f( kCplxRe ), load8f( kCplxIm ) ), b( fvec8( load8f_split( kCplxRe + 3, kCplxRe + 7 ) ),
+																  fvec8( load8f_split( kCplxIm + 3, kCplxIm + 7 ) ) );
+				cfvec8 m = fma( a, b, conj( a ) ), p = polar( abs( a ), arg( a ) );
+				float got[32], ref[32];
+				store( got, m.re );
+				store( got + 8, m.im );
+				store( got + 16, p.re );
+				store( got + 24, p.im );
+				cplx_ref( ref, 8, []( std::complex<double> x, std::complex<double> y ) { return x * y + std::conj( x ); } );
+				cplx_ref( ref + 16, 8, []( std::complex<double> x, std::complex<double> ) { return x; } );
+				return worst4( got, ref, 32 );
+			}, 4e-6F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "icfvec8 fma, exp",
+			[]() {
+				float ab[16], bb[16];
+				interleave2( ab, kCplxRe, kCplxIm, 8 );
+				interleave2( bb, kCplxRe + 3, kCplxIm + 3, 8 );
+				icfvec8 a0( load8f( ab ) ), a1( load8f( ab + 8 ) ), b0( load8f( bb ) ), b1( load8f( bb + 8 ) );
+				cfvec8 m = to_split( fma( a0, b0, conj( a0 ) ), fma( a1, b1, conj( a1 ) ) );
+				cfvec8 e = to_split( exp( a0 ), exp( a1 ) );
+				float got[32], ref[32];
+				store( got, m.re );
+				store( got + 8, m.im );
+				store( got + 16, e.re );
+				store( got + 24, e.im );
+				cplx_ref( ref, 8, []( std::complex<double> x, std::complex<double> y ) { return x * y + std::conj( x ); } );
+				cplx_ref( ref + 16, 8, []( std::complex<double> x, std::complex<double> ) { return std::exp( x ); } );
+				return worst4( got, ref, 32 );
+			}, 4e-6F );
+		TEST_CODE_VAL_EQ(test, "icfvec8 multiply, to_split",
+						 []() {
+							 // z^2 for the first 4 values, z conj( z ) for
+							 // the last 4, all exact
+							 float buf[16];
+							 interleave2( buf, kCplxRe, kCplxIm, 8 );
+							 icfvec8 x0( load8f( buf ) ), x1( load8f( buf + 8 ) );
+							 cfvec8 p = to_split( x0 * x0, x1 * conj( x1 ) );
+							 float got[16], ref[16];
+							 store( got, p.re );
+							 store( got + 8, p.im );
+							 for ( int i = 0; i != 8; ++i )
+							 {
+								 std::complex<float> z( kCplxRe[i], kCplxIm[i] );
+								 std::complex<float> r = z * ( i < 4 ? z : std::conj( z ) );
+								 ref[i] = r.real();
+								 ref[8 + i] = r.imag();
+							 }
+							 return worst4( got, ref, 16 );
+						 } );
+		TEST_CODE_VAL_EQ(test, "to_split, to_interleaved (8 wide)",
+						 []() {
+							 // split, then back to the interleaved buffer
+							 float buf[16], out[16];
+							 interleave2( buf, kCplxRe, kCplxIm, 8 );
+							 cfvec8 z = to_split( icfvec8( load8f( buf ) ), icfvec8( load8f( buf + 8 ) ) );
+							 icfvec8 x0, x1;
+							 to_interleaved( z, x0, x1 );
+							 store( out, x0.v );
+							 store( out + 8, x1.v );
+							 std::vector<float> got( out, out + 16 ), ref( buf, buf + 16 );
+							 float zr[8], zi[8];
+							 store( zr, z.re );
+							 store( zi, z.im );
+							 got.insert( got.end(), zr, zr + 8 );
+							 got.insert( got.end(), zi, zi + 8 );
+							 ref.insert( ref.end(), kCplxRe, kCplxRe + 8 );
+							 ref.insert( ref.end(), kCplxIm, kCplxIm + 8 );
+							 return worst4( got.data(), ref.data(), ref.size() );
+						 } );
+#endif
+	};
+}
+
+// the ratios of f to ref at n points across [lo, hi], the 2 furthest
+// from 1 against 1
+template <typename F, typename R>
+static dmatch
+ratio_sweep( F f, R ref, double lo, double hi, int n = 2000 )
+{
+	std::vector<double> got( static_cast<size_t>( n ) ), one( got.size(), 1.0 );
+	for ( int i = 0; i < n; i += 2 )
+	{
+		double x0 = lo + ( hi - lo ) * double( i ) / double( n - 1 );
+		double x1 = lo + ( hi - lo ) * double( i + 1 ) / double( n - 1 );
+		PAL_NAMESPACE::dvec2 r = f( PAL_NAMESPACE::dvec2( x0, x1 ) );
+		got[size_t( i )] = r[0] / ref( x0 );
+		got[size_t( i + 1 )] = r[1] / ref( x1 );
+	}
+	return worst2( got.data(), one.data(), got.size() );
+}
+
+static void
+add_special_tests( unit_test &test )
+{
+	using namespace PAL_NAMESPACE;
+	test["special"] = [&]() {
+		TEST_CODE_VAL_EQ_PREC(
+			test, "erff",
+			[]() {
+				float v[4] = { 0.25F, -0.75F, 2.5F, -4.F };
+				float cval[4];
+				for ( int i = 0; i != 4; ++i )
+					cval[i] = float( std::erf( double( v[i] ) ) );
+				return match( erff( fvec4( v ) ), cval );
+			}, 2e-7F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "erfcf (tail, scaled)",
+			[]() {
+				float v[4] = { 0.25F, 1.5F, 5.F, 9.5F };
+				float r[4], cval[4] = { 1.F, 1.F, 1.F, 1.F };
+				fvec4 e = erfcf( fvec4( v ) );
+				for ( int i = 0; i != 4; ++i )
+					r[i] = float( e[i] / std::erfc( double( v[i] ) ) );
+				return match( fvec4( r ), cval );
+			}, 1e-6F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "tgammaf",
+			[]() {
+				float v[4] = { 0.5F, 5.F, -1.5F, -0.25F };
+				float cval[4];
+				for ( int i = 0; i != 4; ++i )
+					cval[i] = float( std::tgamma( double( v[i] ) ) );
+				return match( tgammaf( fvec4( v ) ), cval );
+			}, 1e-5F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "lgammaf",
+			[]() {
+				float v[4] = { 0.999F, 2.25F, -2.5F, 10.5F };
+				float cval[4];
+				for ( int i = 0; i != 4; ++i )
+					cval[i] = float( std::lgamma( double( v[i] ) ) );
+				return match( lgammaf( fvec4( v ) ), cval );
+			}, 4e-6F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "normcdfinvf",
+			[]() {
+				return match( normcdfinvf( fvec4( 0.975F, 0.5F, 0.025F, 1e-10F ) ),
+							  { 1.959963985F, 0.F, -1.959963985F, -6.361340902F } );
+			}, 2e-6F );
+		TEST_CODE_VAL_EQ(test, "tgammaf (poles, infinities)",
+						 []() { return match( tgammaf( fvec4( -0.F, -2.F, 0.F, -INFINITY ) ), { -INFINITY, NAN, INFINITY, NAN } ); } );
+		TEST_CODE_VAL_EQ(test, "lgammaf (poles, zeros)",
+						 []() { return match( lgammaf( fvec4( -INFINITY, -3.F, 1.F, 2.F ) ), { INFINITY, INFINITY, 0.F, 0.F } ); } );
+		TEST_CODE_VAL_EQ(test, "normcdfinvf (ends, out of range)",
+						 []() { return match( normcdfinvf( fvec4( 0.F, 1.F, -0.5F, 1.5F ) ), { -INFINITY, INFINITY, NAN, NAN } ); } );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "dvec2 erf (sweep)",
+			[]() { return ratio_sweep( []( dvec2 x ) { return erf( x ); }, []( double x ) { return std::erf( x ); }, -6.0, 6.0 ); },
+			1e-15F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "dvec2 erfc (sweep)",
+			[]() { return ratio_sweep( []( dvec2 x ) { return erfc( x ); }, []( double x ) { return std::erfc( x ); }, -6.0, 26.0 ); },
+			2e-15F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "dvec2 tgamma (sweep)",
+			[]() { return ratio_sweep( []( dvec2 x ) { return tgamma( x ); }, []( double x ) { return std::tgamma( x ); }, -29.9, 30.1 ); },
+			3e-15F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "dvec2 tgamma (sweep, large)",
+			[]() { return ratio_sweep( []( dvec2 x ) { return tgamma( x ); }, []( double x ) { return std::tgamma( x ); }, 30.0, 171.5 ); },
+			6e-15F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "dvec2 lgamma (sweep)",
+			[]() {
+				// the relative error grows near the roots at 1 and 2
+				return ratio_sweep( []( dvec2 x ) { return lgamma( x ); }, []( double x ) { return std::lgamma( x ); }, 2.5, 1e5 );
+			}, 3e-15F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "dvec2 normcdfinv (sweep)",
+			[]() {
+				// the inverse of 0.5 erfc( x / sqrt 2 ) is -x, out to
+				// p of 1e-300
+				return ratio_sweep( []( dvec2 x ) { return -normcdfinv( dvec2( 0.5 ) * erfc( x * dvec2( M_SQRT1_2 ) ) ); },
+									[]( double x ) { return x; }, 0.05, 37.0 );
+			}, 2e-14F );
+		TEST_CODE_VAL_EQ(test, "dvec2 (exact values)",
+						 []() { return dmatch( dvec2( normcdfinv( dvec2( 0.5 ) )[0], tgamma( dvec2( 4.0 ) )[1] ), { 0.0, 6.0 } ); } );
+	};
+}
+
+// the ratios of f to the double precision reference at the n (a
+// multiple of 4) values in v, the worst 4 matched against 1
+template <typename F, typename R>
+static match
+float_ratios( F f, R ref, const float *v, size_t n )
+{
+	std::vector<float> got( n ), one( n, 1.F );
+	for ( size_t i = 0; i < n; i += 4 )
+	{
+		PAL_NAMESPACE::fvec4 r = f( PAL_NAMESPACE::fvec4( v[i], v[i + 1], v[i + 2], v[i + 3] ) );
+		for ( size_t k = 0; k != 4; ++k )
+			got[i + k] = float( double( r[int( k )] ) / ref( double( v[i + k] ) ) );
+	}
+	return worst4( got.data(), one.data(), n );
+}
+
+static void
+add_hyperbolic_tests( unit_test &test )
+{
+	using namespace PAL_NAMESPACE;
+	test["hyperbolic"] = [&]() {
+		TEST_CODE_VAL_EQ_PREC(
+			test, "expm1f (small x)",
+			[]() {
+				// expf( x ) - 1 has no bits left here
+				float v[4] = { 1e-7F, -3e-6F, 2.5e-4F, -0.125F };
+				return float_ratios( []( fvec4 x ) { return expm1f( x ); }, []( double x ) { return std::expm1( x ); }, v, 4 );
+			}, 2.5e-7F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "log1pf (small x)",
+			[]() {
+				// logf( 1 + x ) has no bits left here
+				float v[4] = { 1e-7F, -3e-6F, 2.5e-4F, -0.125F };
+				return float_ratios( []( fvec4 x ) { return log1pf( x ); }, []( double x ) { return std::log1p( x ); }, v, 4 );
+			}, 2.5e-7F );
+		TEST_CODE_VAL_EQ(test, "expm1f, log1pf (limits)",
+						 []() {
+							 return match( fvec4( expm1f( fvec4( -100.F ) )[0], expm1f( fvec4( -0.F ) )[0],
+												  log1pf( fvec4( -1.F ) )[0], log1pf( fvec4( -2.F ) )[0] ),
+										   { -1.F, -0.F, -INFINITY, NAN } );
+						 } );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "expm1f",
+			[]() {
+				float v[4] = { 0.5F, -2.F, 10.F, 0.3F };
+				float cval[4];
+				for ( int i = 0; i != 4; ++i )
+					cval[i] = float( std::expm1( double( v[i] ) ) / std::exp( double( v[i] ) ) );
+				fvec4 e = expm1f( fvec4( v ) ) / expf( fvec4( v ) );
+				return match( e, cval );
+			}, 4e-7F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "sinhf",
+			[]() {
+				float v[8] = { 1e-4F, -0.75F, 2.F, -5.F, 0.3F, -20.F, 60.F, -88.F };
+				return float_ratios( []( fvec4 x ) { return sinhf( x ); }, []( double x ) { return std::sinh( x ); }, v, 8 );
+			}, 3e-7F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "coshf",
+			[]() {
+				float v[8] = { 1e-4F, -0.75F, 2.F, -5.F, 0.3F, -20.F, 60.F, -88.F };
+				return float_ratios( []( fvec4 x ) { return coshf( x ); }, []( double x ) { return std::cosh( x ); }, v, 8 );
+			}, 3e-7F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "tanhf",
+			[]() {
+				float v[8] = { 1e-4F, -0.01F, 0.3F, -0.75F, 2.F, -5.F, 7.5F, -9.F };
+				return float_ratios( []( fvec4 x ) { return tanhf( x ); }, []( double x ) { return std::tanh( x ); }, v, 8 );
+			}, 2e-7F );
+		TEST_CODE_VAL_EQ(test, "sinhf, coshf (near overflow)",
+						 []() {
+							 // e^89 overflows, sinh and cosh do not
+							 return match( fvec4( sinhf( fvec4( -89.F ) )[0], coshf( fvec4( 89.F ) )[0],
+												  sinhf( fvec4( 89.5F ) )[0], sinhf( fvec4( -0.F ) )[0] ),
+										   { float( std::sinh( -89.0 ) ), float( std::cosh( 89.0 ) ), INFINITY, -0.F } );
+						 } );
+		TEST_CODE_VAL_EQ(test, "tanhf (large x)",
+						 []() {
+							 return match( tanhf( fvec4( -30.F, INFINITY, 8.F, -0.F ) ),
+										   { -1.F, 1.F, float( std::tanh( 8.0 ) ), -0.F } );
+						 } );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "dvec2 expm1 (sweep)",
+			[]() { return ratio_sweep( []( dvec2 x ) { return expm1( x ); }, []( double x ) { return std::expm1( x ); }, -40.0, 700.0 ); },
+			2e-15F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "dvec2 expm1, log1p (sweep, small x)",
+			[]() {
+				return ratio_sweep( []( dvec2 x ) { return expm1( x ) * log1p( x ); },
+									[]( double x ) { return std::expm1( x ) * std::log1p( x ); }, -1e-3, 1e-3 );
+			}, 2e-15F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "dvec2 log1p (sweep)",
+			[]() { return ratio_sweep( []( dvec2 x ) { return log1p( x ); }, []( double x ) { return std::log1p( x ); }, -0.999, 1e5 ); },
+			2e-15F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "dvec2 sinh (sweep)",
+			[]() { return ratio_sweep( []( dvec2 x ) { return sinh( x ); }, []( double x ) { return std::sinh( x ); }, -709.0, 709.0 ); },
+			3e-15F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "dvec2 cosh (sweep)",
+			[]() { return ratio_sweep( []( dvec2 x ) { return cosh( x ); }, []( double x ) { return std::cosh( x ); }, -709.0, 709.0 ); },
+			3e-15F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "dvec2 tanh (sweep)",
+			[]() { return ratio_sweep( []( dvec2 x ) { return tanh( x ); }, []( double x ) { return std::tanh( x ); }, -20.0, 20.0 ); },
+			2e-15F );
+		TEST_CODE_VAL_EQ_PREC(
+			test, "dvec2 sinh, tanh (sweep, small x)",
+			[]() {
+				return ratio_sweep( []( dvec2 x ) { return sinh( x ) * tanh( x ); },
+									[]( double x ) { return std::sinh( x ) * std::tanh( x ); }, -1e-3, 1e-3 );
+			}, 2e-15F );
+		TEST_CODE_VAL_EQ(test, "dvec2 (limits)",
+						 []() {
+							 return dmatch( dvec2( sinh( dvec2( 710.0 ) )[0], expm1( dvec2( -50.0 ) )[1] ),
+											{ 1.1169973830808557e308, -1.0 } );
+						 } );
+		TEST_CODE_VAL_EQ(test, "dvec2 tanh (limits)",
+						 []() { return dmatch( tanh( dvec2( -40.0, -0.0 ) ), { -1.0, -0.0 } ); } );
+	};
+}
+
+// sweeps [lo, hi) (as exponents when logscale is set) and returns
+// the worst relative error against the double precision reference
+template <typename VT, typename F, typename R>
+static double
+max_rel_error( F f, R ref, float lo, float hi, bool logscale = false )
+{
+	const int N = 20000;
+	const int W = VT::value_count;
+	double worst = 0.0;
+	for ( int i = 0; i < N; i += W )
+	{
+		float v[W];
+		for ( int j = 0; j != W; ++j )
+		{
+			v[j] = lo + ( hi - lo ) * float( i + j ) / float( N );
+			if ( logscale )
+				v[j] = std::exp2( v[j] );
+		}
+		VT r = f( VT( v ) );
+		for ( int j = 0; j != W; ++j )
+		{
+			double e = ref( double( v[j] ) );
+			double err = std::fabs( ( double( r[j] ) - e ) / e );
+			if ( ! ( err <= worst ) )
+				worst = err;
+		}
+	}
+	return worst;
+}
+
+static void
+check_precision( unit_test &test, const std::string &tag, int bits, double err )
+{
+	std::stringstream msg;
+	msg << "max rel err " << err << " (~" << std::setprecision( 3 ) << -std::log2( err )
+		<< " bits), need " << bits;
+	if ( err <= std::ldexp( 1.0, -bits ) )
+		test.success( tag, msg.str() );
+	else
+		test.failure( tag, msg.str() );
+}
+
+#define TEST_PRECISION_TIER_VEC(test, VT, tag, func, ref, bits, lo, hi, logscale) \
+	check_precision( test, #func "<" #bits ">" tag, bits, \
+					 max_rel_error<VT>( []( VT x ) { return func( x, precision<bits>() ); }, \
+										ref, lo, hi, logscale ) )
+
+#define TEST_PRECISION_TIER(test, func, ref, bits, lo, hi, logscale) \
+	TEST_PRECISION_TIER_VEC(test, fvec4, "", func, ref, bits, lo, hi, logscale)
+
+#define TEST_PRECISION(test, func, ref, lo, hi, logscale) \
+	TEST_PRECISION_TIER(test, func, ref, 12, lo, hi, logscale); \
+	TEST_PRECISION_TIER(test, func, ref, 18, lo, hi, logscale); \
+	TEST_PRECISION_TIER(test, func, ref, 22, lo, hi, logscale)
+
+#define TEST_PRECISION8(test, func, ref, lo, hi, logscale) \
+	TEST_PRECISION_TIER_VEC(test, fvec8, " fvec8", func, ref, 12, lo, hi, logscale); \
+	TEST_PRECISION_TIER_VEC(test, fvec8, " fvec8", func, ref, 18, lo, hi, logscale); \
+	TEST_PRECISION_TIER_VEC(test, fvec8, " fvec8", func, ref, 22, lo, hi, logscale)
+
+// test the fvec4 (and fvec8 when available) precision tiers meet the
+// requested number of bits
+static void
+add_precision_tests( unit_test &test )
+{
+	using namespace PAL_NAMESPACE;
+	test["precision"] = [&]() {
+		TEST_PRECISION( test, log2f, []( double x ) { return std::log2( x ); }, -100.F, 100.F, true );
+		TEST_PRECISION( test, logf, []( double x ) { return std::log( x ); }, -100.F, 100.F, true );
+		TEST_PRECISION( test, log10f, []( double x ) { return std::log10( x ); }, -100.F, 100.F, true );
+		TEST_PRECISION( test, expf, []( double x ) { return std::exp( x ); }, -87.F, 88.F, false );
+		TEST_PRECISION( test, exp2f, []( double x ) { return std::exp2( x ); }, -126.F, 127.F, false );
+		TEST_PRECISION( test, exp10f, []( double x ) { return std::pow( 10.0, x ); }, -37.F, 38.F, false );
+		TEST_PRECISION( test, cbrtf, []( double x ) { return std::cbrt( x ); }, -1000.F, 1000.F, false );
+		TEST_PRECISION( test, sinf, []( double x ) { return std::sin( x ); }, -100.F, 100.F, false );
+		TEST_PRECISION( test, cosf, []( double x ) { return std::cos( x ); }, -100.F, 100.F, false );
+		TEST_PRECISION_TIER( test, recip, []( double x ) { return 1.0 / x; }, 11, -60.F, 60.F, true );
+		TEST_PRECISION_TIER( test, recip, []( double x ) { return 1.0 / x; }, 21, -60.F, 60.F, true );
+		TEST_PRECISION_TIER( test, rsqrtf, []( double x ) { return 1.0 / std::sqrt( x ); }, 11, -60.F, 60.F, true );
+		TEST_PRECISION_TIER( test, rsqrtf, []( double x ) { return 1.0 / std::sqrt( x ); }, 21, -60.F, 60.F, true );
+		TEST_PRECISION_TIER( test, sqrtf, []( double x ) { return std::sqrt( x ); }, 11, -60.F, 60.F, true );
+		TEST_PRECISION_TIER( test, sqrtf, []( double x ) { return std::sqrt( x ); }, 21, -60.F, 60.F, true );
+		TEST_CODE_VAL_EQ(test, "full tier only (tag accepted)",
+						 []() {
+							 // the worst 4 of the tagged results against the untagged
+							 fvec4 x( -0.75F, 0.3F, 2.5F, 0.125F ), p( 0.01F, 0.3F, 0.6F, 0.95F ), y( 1.5F );
+							 precision<12> lo;
+							 fvec4 tagged[] = { atanf( x, lo ), atan2f( x, y, lo ), erff( x, lo ), erfcf( x, lo ),
+												tgammaf( x, lo ), lgammaf( x, lo ), normcdfinvf( p, lo ), expm1f( x, lo ),
+												log1pf( x, lo ), sinhf( x, lo ), coshf( x, lo ), tanhf( x, lo ) };
+							 fvec4 full[] = { atanf( x ), atan2f( x, y ), erff( x ), erfcf( x ),
+											  tgammaf( x ), lgammaf( x ), normcdfinvf( p ), expm1f( x ),
+											  log1pf( x ), sinhf( x ), coshf( x ), tanhf( x ) };
+							 float got[48], ref[48];
+							 for ( int f = 0; f != 12; ++f )
+							 {
+								 for ( int i = 0; i != 4; ++i )
+								 {
+									 got[f * 4 + i] = tagged[f][i];
+									 ref[f * 4 + i] = full[f][i];
+								 }
+							 }
+							 return worst4( got, ref, 48 );
+						 } );
+#ifdef PAL_HAS_FVEC8
+		TEST_PRECISION8( test, log2f, []( double x ) { return std::log2( x ); }, -100.F, 100.F, true );
+		TEST_PRECISION8( test, logf, []( double x ) { return std::log( x ); }, -100.F, 100.F, true );
+		TEST_PRECISION8( test, log10f, []( double x ) { return std::log10( x ); }, -100.F, 100.F, true );
+		TEST_PRECISION8( test, expf, []( double x ) { return std::exp( x ); }, -87.F, 88.F, false );
+		TEST_PRECISION8( test, exp2f, []( double x ) { return std::exp2( x ); }, -126.F, 127.F, false );
+		TEST_PRECISION8( test, exp10f, []( double x ) { return std::pow( 10.0, x ); }, -37.F, 38.F, false );
+		TEST_PRECISION8( test, cbrtf, []( double x ) { return std::cbrt( x ); }, -1000.F, 1000.F, false );
+		TEST_PRECISION8( test, sinf, []( double x ) { return std::sin( x ); }, -100.F, 100.F, false );
+		TEST_PRECISION8( test, cosf, []( double x ) { return std::cos( x ); }, -100.F, 100.F, false );
+		TEST_PRECISION_TIER_VEC( test, fvec8, " fvec8", recip, []( double x ) { return 1.0 / x; }, 11, -60.F, 60.F, true );
+		TEST_PRECISION_TIER_VEC( test, fvec8, " fvec8", recip, []( double x ) { return 1.0 / x; }, 21, -60.F, 60.F, true );
+		TEST_PRECISION_TIER_VEC( test, fvec8, " fvec8", rsqrtf, []( double x ) { return 1.0 / std::sqrt( x ); }, 11, -60.F, 60.F, true );
+		TEST_PRECISION_TIER_VEC( test, fvec8, " fvec8", rsqrtf, []( double x ) { return 1.0 / std::sqrt( x ); }, 21, -60.F, 60.F, true );
+		TEST_PRECISION_TIER_VEC( test, fvec8, " fvec8", sqrtf, []( double x ) { return std::sqrt( x ); }, 11, -60.F, 60.F, true );
+		TEST_PRECISION_TIER_VEC( test, fvec8, " fvec8", sqrtf, []( double x ) { return std::sqrt( x ); }, 21, -60.F, 60.F, true );
+#endif
 	};
 }
 
@@ -1326,7 +3198,20 @@ int main( int argc, char *argv[] )
 	add_load_store_tests( test );
 	add_math_tests( test );
 	add_exp_tests( test );
-	//add_trig_tests( test );
+	add_trig_tests( test );
+	add_transfer_tests( test );
+	add_sort_tests( test );
+	add_reduce_tests( test );
+	add_search_tests( test );
+	add_compact_tests( test );
+	add_fir_tests( test );
+	add_blur_tests( test );
+	add_resample_tests( test );
+	add_fft_tests( test );
+	add_complex_tests( test );
+	add_special_tests( test );
+	add_hyperbolic_tests( test );
+	add_precision_tests( test );
 
 	bool q = false;
 	while ( argc > 1 )
@@ -10,9 +10,137 @@
 #include <pal.h>
 #include <cfloat>
 #include <cmath>
+#include <cstring>
+#include <vector>
+#include <algorithm>
 
 typedef match_test<PAL_NAMESPACE::lvec4> match;
 
+// fills v with the extremes of T, then a spread of values from an lcg
+template <typename T>
+static void fill_narrow( T *v, int n, uint32_t seed )
+{
+	typedef std::numeric_limits<T> lim;
+	const T edge[] = { lim::min(), lim::max(), T( 0 ), T( 1 ), T( -1 ), T( lim::max() / 2 ), T( lim::min() / 2 ) };
+	for ( int i = 0; i != n; ++i )
+	{
+		seed = seed * 1664525U + 1013904223U;
+		v[i] = i < 7 ? edge[( i + int( seed >> 29 ) ) % 7] : T( seed >> 8 );
+	}
+}
+
+template <typename R>
+static R clamp_to( int64_t v )
+{
+	typedef std::numeric_limits<R> lim;
+	return R( std::min<int64_t>( std::max<int64_t>( v, int64_t( lim::min() ) ), int64_t( lim::max() ) ) );
+}
+
+template <typename VT>
+static typename std::enable_if<sizeof(VT) == 16, VT>::type
+load_any( const typename VT::value_type *v )
+{
+	return VT( _mm_loadu_si128( reinterpret_cast<const __m128i *>( v ) ) );
+}
+
+#ifdef PAL_ENABLE_AVX
+template <typename VT>
+static typename std::enable_if<sizeof(VT) == 32, VT>::type
+load_any( const typename VT::value_type *v )
+{
+	return VT( _mm256_loadu_si256( reinterpret_cast<const __m256i *>( v ) ) );
+}
+#endif
+
+// checks a saturating op of narrow integer vectors against the
+// scalar ref computed in 64 bits and clamped to the type
+template <typename VT>
+static match_test<VT> narrow_op_check( VT (*op)( VT, VT ), int64_t (*ref)( int64_t, int64_t ), uint32_t seed )
+{
+	typedef typename VT::value_type T;
+	const int N = VT::value_count;
+	T a[N], b[N];
+	std::array<T, N> cval;
+	fill_narrow( a, N, seed );
+	fill_narrow( b, N, seed * 7 + 3 );
+	for ( int i = 0; i != N; ++i )
+		cval[i] = clamp_to<T>( ref( a[i], b[i] ) );
+	return match_test<VT>( op( load_any<VT>( a ), load_any<VT>( b ) ), cval );
+}
+
+static int64_t ref_add( int64_t a, int64_t b ) { return a + b; }
+static int64_t ref_sub( int64_t a, int64_t b ) { return a - b; }
+static int64_t ref_avg( int64_t a, int64_t b ) { return ( a + b + 1 ) >> 1; }
+
+// checks a pack of a then b against clamping each value to RT. op
+// is a lambda, the pack functions are always inline so their address
+// can not be taken
+template <typename RT, typename VT, typename F>
+static match_test<RT> pack_check( F op, uint32_t seed )
+{
+	typedef typename VT::value_type T;
+	const int N = VT::value_count;
+	T a[N], b[N];
+	std::array<typename RT::value_type, N * 2> cval;
+	fill_narrow( a, N, seed );
+	fill_narrow( b, N, seed * 7 + 3 );
+	for ( int i = 0; i != N; ++i )
+	{
+		cval[i] = clamp_to<typename RT::value_type>( a[i] );
+		cval[N + i] = clamp_to<typename RT::value_type>( b[i] );
+	}
+	return match_test<RT>( op( load_any<VT>( a ), load_any<VT>( b ) ), cval );
+}
+
+// checks widen_lo (hi = false) or widen_hi against the values of a
+template <typename VT>
+static match_test<decltype( PAL_NAMESPACE::widen_lo( VT() ) )> widen_check( bool hi, uint32_t seed )
+{
+	typedef decltype( PAL_NAMESPACE::widen_lo( VT() ) ) WT;
+	typedef typename VT::value_type T;
+	const int N = VT::value_count;
+	T a[N];
+	std::array<typename WT::value_type, N / 2> cval;
+	fill_narrow( a, N, seed );
+	for ( int i = 0; i != N / 2; ++i )
+		cval[i] = a[hi ? N / 2 + i : i];
+	VT v = load_any<VT>( a );
+	return match_test<WT>( hi ? PAL_NAMESPACE::widen_hi( v ) : PAL_NAMESPACE::widen_lo( v ), cval );
+}
+
+#define TEST_NARROW_OPS(test, VT) \
+	TEST_CODE_VAL_EQ(test, "add_sat " #VT, []() { return narrow_op_check<VT>( add_sat, ref_add, 1 ); } ); \
+	TEST_CODE_VAL_EQ(test, "sub_sat " #VT, []() { return narrow_op_check<VT>( sub_sat, ref_sub, 2 ); } ); \
+	TEST_CODE_VAL_EQ(test, "avg " #VT, []() { return narrow_op_check<VT>( avg, ref_avg, 3 ); } )
+
+#define TEST_WIDEN(test, VT) \
+	TEST_CODE_VAL_EQ(test, "widen_lo " #VT, []() { return widen_check<VT>( false, 4 ); } ); \
+	TEST_CODE_VAL_EQ(test, "widen_hi " #VT, []() { return widen_check<VT>( true, 5 ); } )
+
+#ifdef PAL_ENABLE_AVX
+// divides the value_count values in tval by d with the 256-bit
+// divisor, matching against the scalar divide
+template <typename VT, typename T>
+static match_test<VT> divide256( const T *tval, T d )
+{
+	using namespace PAL_NAMESPACE;
+	std::array<T, VT::value_count> cval;
+	for ( int i = 0; i != VT::value_count; ++i )
+		cval[i] = T( tval[i] / d );
+	return match_test<VT>( load_any<VT>( tval ) / divisor<T>( d ), cval );
+}
+
+template <int32_t b>
+static match_test<PAL_NAMESPACE::lvec8> divide256_const( const int32_t *tval )
+{
+	using namespace PAL_NAMESPACE;
+	std::array<int32_t, 8> cval;
+	for ( int i = 0; i != 8; ++i )
+		cval[i] = tval[i] / b;
+	return match_test<lvec8>( divide_by_const<b>( load_any<lvec8>( tval ) ), cval );
+}
+#endif
+
 static void
 add_class_tests( unit_test &test )
 {
@@ -173,6 +301,64 @@ add_op_tests( unit_test &test )
 								 cval[i] = (tval[i] / 3);
 							 return match( divide_by_const<3>( tmp ), cval );
 						 } );
+		TEST_CODE_VAL_EQ(test, "binary / (unsigned)",
+						 []() {
+							 uint32_t tval[4] = {0xFFFFFFFF,0x80000000,6,12345678};
+							 uint32_t cval[4];
+							 ulvec4 tmp( tval );
+							 for ( int i = 0; i < 4; ++i )
+								 cval[i] = (tval[i] / 7);
+							 divisor<uint32_t> d( 7 );
+							 return match_test<ulvec4>( tmp / d, cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "binary / (16-bit)",
+						 []() {
+							 int16_t tval[8] = {32767,-32768,-30,18,1000,-1000,5,-5};
+							 int16_t cval[8];
+							 svec8 tmp( tval );
+							 for ( int i = 0; i < 8; ++i )
+								 cval[i] = int16_t(tval[i] / -10);
+							 divisor<int16_t> d( -10 );
+							 return match_test<svec8>( tmp / d, cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "binary / (64-bit)",
+						 []() {
+							 int64_t tval[2] = {-9000000000000000000LL,123456789012345LL};
+							 int64_t cval[2];
+							 llvec2 tmp( tval );
+							 for ( int i = 0; i < 2; ++i )
+								 cval[i] = (tval[i] / 1000003);
+							 divisor<int64_t> d( 1000003 );
+							 return match_test<llvec2>( tmp / d, cval );
+						 } );
+#ifdef PAL_ENABLE_AVX
+		{
+			const int32_t iv[8] = { INT32_MIN, INT32_MAX, -1, 0, 1, -30, 127, -1000000007 };
+			// INT32_MIN / -1 overflows, leave it out of those
+			const int32_t iv1[8] = { INT32_MIN + 1, INT32_MAX, -1, 0, 1, -30, 127, -1000000007 };
+			const uint32_t uv[8] = { 0xFFFFFFFF, 0x80000000, 0, 1, 6, 7, 12345678, 0x7FFFFFFF };
+			const int16_t sv[16] = { -32768, 32767, -1, 0, 1, -30, 18, 1000, -1000, 5, -5, 9, -9, 10, -10, 12345 };
+			const int64_t lv[4] = { INT64_MIN, INT64_MAX, -9000000000000000000LL, 123456789012345LL };
+			TEST_CODE_VAL_EQ(test, "binary / lvec8 (7)", [&]() { return divide256<lvec8>( iv, 7 ); } );
+			TEST_CODE_VAL_EQ(test, "binary / lvec8 (-7)", [&]() { return divide256<lvec8>( iv, -7 ); } );
+			TEST_CODE_VAL_EQ(test, "binary / lvec8 (16)", [&]() { return divide256<lvec8>( iv, 16 ); } );
+			TEST_CODE_VAL_EQ(test, "binary / lvec8 (INT32_MIN)", [&]() { return divide256<lvec8>( iv, INT32_MIN ); } );
+			TEST_CODE_VAL_EQ(test, "binary / lvec8 (-1)", [&]() { return divide256<lvec8>( iv1, -1 ); } );
+			TEST_CODE_VAL_EQ(test, "binary / ulvec8 (7)", [&]() { return divide256<ulvec8>( uv, 7U ); } );
+			TEST_CODE_VAL_EQ(test, "binary / ulvec8 (0x80000001)", [&]() { return divide256<ulvec8>( uv, 0x80000001U ); } );
+			TEST_CODE_VAL_EQ(test, "binary / svec16 (-10)", [&]() { return divide256<svec16>( sv, int16_t( -10 ) ); } );
+			TEST_CODE_VAL_EQ(test, "binary / llvec4 (1000003)", [&]() { return divide256<llvec4>( lv, int64_t( 1000003 ) ); } );
+			TEST_CODE_VAL_EQ(test, "binary / llvec4 (-3)", [&]() { return divide256<llvec4>( lv, int64_t( -3 ) ); } );
+			TEST_CODE_VAL_EQ(test, "divide_by_const lvec8 (7)", [&]() { return divide256_const<7>( iv ); } );
+			TEST_CODE_VAL_EQ(test, "divide_by_const lvec8 (-7)", [&]() { return divide256_const<-7>( iv ); } );
+			TEST_CODE_VAL_EQ(test, "divide_by_const lvec8 (8)", [&]() { return divide256_const<8>( iv ); } );
+			TEST_CODE_VAL_EQ(test, "divide_by_const lvec8 (-8)", [&]() { return divide256_const<-8>( iv ); } );
+			TEST_CODE_VAL_EQ(test, "divide_by_const lvec8 (2)", [&]() { return divide256_const<2>( iv ); } );
+			TEST_CODE_VAL_EQ(test, "divide_by_const lvec8 (1)", [&]() { return divide256_const<1>( iv ); } );
+			TEST_CODE_VAL_EQ(test, "divide_by_const lvec8 (-1)", [&]() { return divide256_const<-1>( iv1 ); } );
+			TEST_CODE_VAL_EQ(test, "divide_by_const lvec8 (INT32_MIN)", [&]() { return divide256_const<INT32_MIN>( iv ); } );
+		}
+#endif
 	};
 
 	test["bitwise_op_tests"] = [&]() {
@@ -335,12 +521,890 @@ add_op_tests( unit_test &test )
 							 return match_val<bool>( m.none(), false );
 						 } );
 	};
+	test["int64_op_tests"] = [&]() {
+		using namespace PAL_NAMESPACE;
+		TEST_CODE_VAL_EQ(test, "operator*",
+						 []() {
+							 int64_t tval[2] = {-3000000000LL,0x123456789LL};
+							 int64_t tval2[2] = {7000000001LL,-0x1000000001LL};
+							 int64_t cval[2];
+							 for ( int i = 0; i < 2; ++i )
+								 cval[i] = int64_t( uint64_t(tval[i]) * uint64_t(tval2[i]) );
+							 return match_test<llvec2>( llvec2( tval ) * llvec2( tval2 ), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "operator>>",
+						 []() {
+							 int64_t tval[2] = {-3000000000LL,0x123456789LL};
+							 int64_t cval[2] = {tval[0] >> 35,tval[1] >> 35};
+							 return match_test<llvec2>( llvec2( tval ) >> 35, cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "operator<",
+						 []() {
+							 int64_t tval[2] = {-3000000000LL,0x100000001LL};
+							 int64_t tval2[2] = {5,0x100000002LL};
+							 int64_t cval[2] = {-1,-1};
+							 return match_test<llvec2>( llvec2( ( llvec2( tval ) < llvec2( tval2 ) ).as_int() ), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "operator< (unsigned)",
+						 []() {
+							 uint64_t tval[2] = {0xFFFFFFFF00000000ULL,0x100000001ULL};
+							 uint64_t tval2[2] = {5,0x100000002ULL};
+							 uint64_t cval[2] = {0,~uint64_t(0)};
+							 return match_test<ullvec2>( ullvec2( ( ullvec2( tval ) < ullvec2( tval2 ) ).as_int() ), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "min / max",
+						 []() {
+							 int64_t tval[2] = {-3000000000LL,0x100000001LL};
+							 int64_t tval2[2] = {5,0x100000002LL};
+							 int64_t cval[2] = {-3000000000LL + 5,0x100000001LL + 0x100000002LL};
+							 llvec2 a( tval ), b( tval2 );
+							 return match_test<llvec2>( min( a, b ) + max( a, b ), cval );
+						 } );
+#ifdef PAL_ENABLE_AVX
+		// the same for the 256-bit llvec4 / ullvec4, which fall back to
+		// pairs of 128-bit operations without AVX2
+		const int64_t la[4] = { -3000000000LL, 0x123456789LL, INT64_MIN, -1 };
+		const int64_t lb[4] = { 7000000001LL, -0x1000000001LL, 5, -1 };
+		const uint64_t ua[4] = { 0xFFFFFFFF00000000ULL, 0x100000001ULL, 0x8000000000000000ULL, 0 };
+		const uint64_t ub[4] = { 5, 0x100000002ULL, 0x7FFFFFFFFFFFFFFFULL, 0 };
+		TEST_CODE_VAL_EQ(test, "llvec4 operator+",
+						 [&]() {
+							 int64_t cval[4];
+							 for ( int i = 0; i < 4; ++i )
+								 cval[i] = int64_t( uint64_t(la[i]) + uint64_t(lb[i]) );
+							 return match_test<llvec4>( load_any<llvec4>( la ) + load_any<llvec4>( lb ), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "llvec4 operator-",
+						 [&]() {
+							 int64_t cval[4];
+							 for ( int i = 0; i < 4; ++i )
+								 cval[i] = int64_t( uint64_t(la[i]) - uint64_t(lb[i]) );
+							 return match_test<llvec4>( load_any<llvec4>( la ) - load_any<llvec4>( lb ), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "llvec4 operator*",
+						 [&]() {
+							 int64_t cval[4];
+							 for ( int i = 0; i < 4; ++i )
+								 cval[i] = int64_t( uint64_t(la[i]) * uint64_t(lb[i]) );
+							 return match_test<llvec4>( load_any<llvec4>( la ) * load_any<llvec4>( lb ), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "ullvec4 operator*",
+						 [&]() {
+							 uint64_t cval[4];
+							 for ( int i = 0; i < 4; ++i )
+								 cval[i] = ua[i] * ub[i];
+							 return match_test<ullvec4>( load_any<ullvec4>( ua ) * load_any<ullvec4>( ub ), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "llvec4 operator>>",
+						 [&]() {
+							 int64_t cval[4];
+							 for ( int i = 0; i < 4; ++i )
+								 cval[i] = la[i] >> 35;
+							 return match_test<llvec4>( load_any<llvec4>( la ) >> 35, cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "llvec4 lsr",
+						 [&]() {
+							 int64_t cval[4];
+							 for ( int i = 0; i < 4; ++i )
+								 cval[i] = int64_t( uint64_t(la[i]) >> 35 );
+							 return match_test<llvec4>( lsr( load_any<llvec4>( la ), 35 ), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "ullvec4 operator>>",
+						 [&]() {
+							 uint64_t cval[4];
+							 for ( int i = 0; i < 4; ++i )
+								 cval[i] = ua[i] >> 35;
+							 return match_test<ullvec4>( load_any<ullvec4>( ua ) >> 35, cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "llvec4 operator<<",
+						 [&]() {
+							 int64_t cval[4];
+							 for ( int i = 0; i < 4; ++i )
+								 cval[i] = int64_t( uint64_t(la[i]) << 7 );
+							 return match_test<llvec4>( load_any<llvec4>( la ) << 7, cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "llvec4 operator<",
+						 [&]() {
+							 int64_t cval[4];
+							 for ( int i = 0; i < 4; ++i )
+								 cval[i] = la[i] < lb[i] ? -1 : 0;
+							 return match_test<llvec4>( llvec4( ( load_any<llvec4>( la ) < load_any<llvec4>( lb ) ).as_int() ), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "llvec4 operator>=",
+						 [&]() {
+							 int64_t cval[4];
+							 for ( int i = 0; i < 4; ++i )
+								 cval[i] = la[i] >= lb[i] ? -1 : 0;
+							 return match_test<llvec4>( llvec4( ( load_any<llvec4>( la ) >= load_any<llvec4>( lb ) ).as_int() ), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "llvec4 operator==",
+						 [&]() {
+							 int64_t cval[4];
+							 for ( int i = 0; i < 4; ++i )
+								 cval[i] = la[i] == lb[i] ? -1 : 0;
+							 return match_test<llvec4>( llvec4( ( load_any<llvec4>( la ) == load_any<llvec4>( lb ) ).as_int() ), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "ullvec4 operator<",
+						 [&]() {
+							 uint64_t cval[4];
+							 for ( int i = 0; i < 4; ++i )
+								 cval[i] = ua[i] < ub[i] ? ~uint64_t(0) : 0;
+							 return match_test<ullvec4>( ullvec4( ( load_any<ullvec4>( ua ) < load_any<ullvec4>( ub ) ).as_int() ), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "ullvec4 operator>",
+						 [&]() {
+							 uint64_t cval[4];
+							 for ( int i = 0; i < 4; ++i )
+								 cval[i] = ua[i] > ub[i] ? ~uint64_t(0) : 0;
+							 return match_test<ullvec4>( ullvec4( ( load_any<ullvec4>( ua ) > load_any<ullvec4>( ub ) ).as_int() ), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "llvec4 min / max",
+						 [&]() {
+							 int64_t cval[4];
+							 for ( int i = 0; i < 4; ++i )
+								 cval[i] = int64_t( uint64_t( std::min( la[i], lb[i] ) ) - uint64_t( std::max( la[i], lb[i] ) ) );
+							 llvec4 a = load_any<llvec4>( la ), b = load_any<llvec4>( lb );
+							 return match_test<llvec4>( min( a, b ) - max( a, b ), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "ullvec4 min / max",
+						 [&]() {
+							 uint64_t cval[4];
+							 for ( int i = 0; i < 4; ++i )
+								 cval[i] = std::min( ua[i], ub[i] ) - std::max( ua[i], ub[i] );
+							 ullvec4 a = load_any<ullvec4>( ua ), b = load_any<ullvec4>( ub );
+							 return match_test<ullvec4>( min( a, b ) - max( a, b ), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "llvec4 abs, negate",
+						 [&]() {
+							 // abs of the most negative value is itself, as in C
+							 int64_t cval[4] = { -3000000000LL, -0x123456789LL, INT64_MIN, -1 };
+							 return match_test<llvec4>( -abs( load_any<llvec4>( la ) ), cval );
+						 } );
+#endif
+	};
+	test["narrow_int_tests"] = [&]() {
+		using namespace PAL_NAMESPACE;
+		TEST_CODE_VAL_EQ(test, "add_sat / sub_sat (unsigned)",
+						 []() {
+							 uint16_t tval[8] = {0,1,2,3,65000,65535,100,200};
+							 uint16_t tval2[8] = {5,5,5,5,1000,1,50,300};
+							 // (a +| b) -| b is a unless the add saturated
+							 uint16_t cval[8] = {0,1,2,3,64535,65534,100,200};
+							 usvec8 a( tval ), b( tval2 );
+							 return match_test<usvec8>( sub_sat( add_sat( a, b ), b ), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "add_sat (signed)",
+						 []() {
+							 int16_t tval[8] = {-32000,32000,1,-1,0,100,-100,7};
+							 int16_t tval2[8] = {-1000,1000,2,-2,0,100,-100,-7};
+							 int16_t cval[8] = {-32768,32767,3,-3,0,200,-200,0};
+							 return match_test<svec8>( add_sat( svec8( tval ), svec8( tval2 ) ), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "avg",
+						 []() {
+							 int16_t tval[8] = {-32768,32767,1,-1,0,3,-3,7};
+							 int16_t tval2[8] = {-32768,32767,2,-2,0,4,-4,-8};
+							 int16_t cval[8] = {-32768,32767,2,-1,0,4,-3,0};
+							 return match_test<svec8>( avg( svec8( tval ), svec8( tval2 ) ), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "pack_usat",
+						 []() {
+							 int tval[4] = {-5,0,65535,70000};
+							 int tval2[4] = {32768,-70000,1,40000};
+							 uint16_t cval[8] = {0,0,65535,65535,32768,0,1,40000};
+							 return match_test<usvec8>( pack_usat( lvec4( tval ), lvec4( tval2 ) ), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "widen_lo / widen_hi",
+						 []() {
+							 int16_t tval[8] = {-32768,32767,1,-1,0,3,-3,7};
+							 int cval[4] = {-32768 + 0,32767 + 3,1 - 3,-1 + 7};
+							 return match_test<lvec4>( lvec4( widen_lo( svec8( tval ) ) ) + lvec4( widen_hi( svec8( tval ) ) ), cval );
+						 } );
+		// every type against the scalar reference, extremes included
+		TEST_NARROW_OPS( test, cvec16 );
+		TEST_NARROW_OPS( test, ucvec16 );
+		TEST_NARROW_OPS( test, svec8 );
+		TEST_NARROW_OPS( test, usvec8 );
+		TEST_CODE_VAL_EQ(test, "pack_sat svec8", []() { return pack_check<cvec16, svec8>( []( svec8 a, svec8 b ) { return pack_sat( a, b ); }, 6 ); } );
+		TEST_CODE_VAL_EQ(test, "pack_sat usvec8", []() { return pack_check<ucvec16, usvec8>( []( usvec8 a, usvec8 b ) { return pack_sat( a, b ); }, 7 ); } );
+		TEST_CODE_VAL_EQ(test, "pack_sat lvec4", []() { return pack_check<svec8, lvec4>( []( lvec4 a, lvec4 b ) { return pack_sat( a, b ); }, 8 ); } );
+		TEST_CODE_VAL_EQ(test, "pack_sat ulvec4", []() { return pack_check<usvec8, ulvec4>( []( ulvec4 a, ulvec4 b ) { return pack_sat( a, b ); }, 9 ); } );
+		TEST_CODE_VAL_EQ(test, "pack_usat svec8", []() { return pack_check<ucvec16, svec8>( []( svec8 a, svec8 b ) { return pack_usat( a, b ); }, 10 ); } );
+		TEST_CODE_VAL_EQ(test, "pack_usat lvec4", []() { return pack_check<usvec8, lvec4>( []( lvec4 a, lvec4 b ) { return pack_usat( a, b ); }, 11 ); } );
+		TEST_WIDEN( test, cvec16 );
+		TEST_WIDEN( test, ucvec16 );
+		TEST_WIDEN( test, svec8 );
+		TEST_WIDEN( test, usvec8 );
+		TEST_WIDEN( test, lvec4 );
+		TEST_WIDEN( test, ulvec4 );
+#ifdef PAL_ENABLE_AVX
+		TEST_NARROW_OPS( test, cvec32 );
+		TEST_NARROW_OPS( test, ucvec32 );
+		TEST_NARROW_OPS( test, svec16 );
+		TEST_NARROW_OPS( test, usvec16 );
+		TEST_CODE_VAL_EQ(test, "pack_sat svec16", []() { return pack_check<cvec32, svec16>( []( svec16 a, svec16 b ) { return pack_sat( a, b ); }, 12 ); } );
+		TEST_CODE_VAL_EQ(test, "pack_sat usvec16", []() { return pack_check<ucvec32, usvec16>( []( usvec16 a, usvec16 b ) { return pack_sat( a, b ); }, 13 ); } );
+		TEST_CODE_VAL_EQ(test, "pack_sat lvec8", []() { return pack_check<svec16, lvec8>( []( lvec8 a, lvec8 b ) { return pack_sat( a, b ); }, 14 ); } );
+		TEST_CODE_VAL_EQ(test, "pack_sat ulvec8", []() { return pack_check<usvec16, ulvec8>( []( ulvec8 a, ulvec8 b ) { return pack_sat( a, b ); }, 15 ); } );
+		TEST_CODE_VAL_EQ(test, "pack_usat svec16", []() { return pack_check<ucvec32, svec16>( []( svec16 a, svec16 b ) { return pack_usat( a, b ); }, 16 ); } );
+		TEST_CODE_VAL_EQ(test, "pack_usat lvec8", []() { return pack_check<usvec16, lvec8>( []( lvec8 a, lvec8 b ) { return pack_usat( a, b ); }, 17 ); } );
+		TEST_WIDEN( test, cvec32 );
+		TEST_WIDEN( test, ucvec32 );
+		TEST_WIDEN( test, svec16 );
+		TEST_WIDEN( test, usvec16 );
+		TEST_WIDEN( test, lvec8 );
+		TEST_WIDEN( test, ulvec8 );
+#endif
+	};
+
+}
 
+// converts n values at image position x, y in one call, then one
+// value at a time so only the scalar path runs, and returns the first
+// difference
+template <typename T>
+static match_val<int> unorm_split_check( const float *in, size_t n, PAL_NAMESPACE::dither d, int x, int y )
+{
+	std::vector<T> all( n ), one( n );
+	PAL_NAMESPACE::convert_to_unorm( all.data(), in, n, d, x, y );
+	for ( size_t i = 0; i != n; ++i )
+		PAL_NAMESPACE::convert_to_unorm( one.data() + i, in + i, 1, d, x + int( i ), y );
+	for ( size_t i = 0; i != n; ++i )
+	{
+		if ( all[i] != one[i] )
+			return match_val<int>( all[i], one[i] );
+	}
+	return match_val<int>( 0, 0 );
 }
 
 static void
 add_load_store_tests( unit_test &test )
 {
+	test["convert_tests"] = [&]() {
+		using namespace PAL_NAMESPACE;
+		TEST_CODE_VAL_EQ(test, "convert (int32 -> uint8)",
+						 []() {
+							 int32_t in[37];
+							 uint8_t out[37];
+							 for ( int i = 0; i < 37; ++i )
+								 in[i] = ( i - 10 ) * 11;
+							 convert( out, in, 37 );
+							 for ( int i = 0; i < 37; ++i )
+							 {
+								 if ( out[i] != std::min( std::max( in[i], 0 ), 255 ) )
+									 return match_val<int>( out[i], std::min( std::max( in[i], 0 ), 255 ) );
+							 }
+							 return match_val<int>( 0, 0 );
+						 } );
+		TEST_CODE_VAL_EQ(test, "convert (uint8 -> uint16)",
+						 []() {
+							 uint8_t in[37];
+							 uint16_t out[37];
+							 for ( int i = 0; i < 37; ++i )
+								 in[i] = uint8_t( 255 - i * 7 );
+							 convert( out, in, 37 );
+							 for ( int i = 0; i < 37; ++i )
+							 {
+								 if ( out[i] != in[i] )
+									 return match_val<int>( out[i], in[i] );
+							 }
+							 return match_val<int>( 0, 0 );
+						 } );
+		TEST_CODE_VAL_EQ(test, "convert_to_unorm round trip",
+						 []() {
+							 uint8_t in[256], out[256];
+							 float tmp[256];
+							 for ( int i = 0; i < 256; ++i )
+								 in[i] = uint8_t( i );
+							 convert_from_unorm( tmp, in, 256 );
+							 convert_to_unorm( out, tmp, 256 );
+							 for ( int i = 0; i < 256; ++i )
+							 {
+								 if ( out[i] != in[i] )
+									 return match_val<int>( out[i], in[i] );
+							 }
+							 return match_val<int>( 0, 0 );
+						 } );
+		TEST_CODE_VAL_EQ(test, "convert_to_unorm (ordered dither)",
+						 []() {
+							 // the mean over a full dither tile is the
+							 // unquantized value
+							 float in[8];
+							 uint8_t out[8];
+							 int sum = 0;
+							 for ( int i = 0; i < 8; ++i )
+								 in[i] = 100.25F / 255.F;
+							 for ( int y = 0; y < 8; ++y )
+							 {
+								 convert_to_unorm( out, in, 8, dither::ordered, 0, y );
+								 for ( int i = 0; i < 8; ++i )
+									 sum += out[i];
+							 }
+							 return match_val<int>( sum, 6416 );
+						 } );
+		{
+			// long enough for the 32 (AVX2), 16 and scalar loops
+			std::vector<float> ramp( 77 );
+			for ( size_t i = 0; i != ramp.size(); ++i )
+				ramp[i] = float( i ) / 76.F;
+			const float *r = ramp.data();
+			const size_t n = ramp.size();
+			TEST_CODE_VAL_EQ(test, "convert_to_unorm8 (ordered dither, vector vs scalar)",
+							 [=]() { return unorm_split_check<uint8_t>( r, n, dither::ordered, 3, 5 ); } );
+			TEST_CODE_VAL_EQ(test, "convert_to_unorm8 (noise dither, vector vs scalar)",
+							 [=]() { return unorm_split_check<uint8_t>( r, n, dither::noise, 1021, 77 ); } );
+			TEST_CODE_VAL_EQ(test, "convert_to_unorm16 (ordered dither, vector vs scalar)",
+							 [=]() { return unorm_split_check<uint16_t>( r, n, dither::ordered, 6, 2 ); } );
+			TEST_CODE_VAL_EQ(test, "convert_to_unorm16 (noise dither, vector vs scalar)",
+							 [=]() { return unorm_split_check<uint16_t>( r, n, dither::noise, 4000, 3001 ); } );
+		}
+		TEST_CODE_VAL_EQ(test, "convert_to_unorm (noise dither mean)",
+						 []() {
+							 // the noise is uniform, so a long run averages
+							 // to the unquantized value
+							 std::vector<float> in( 4096, 100.25F / 255.F );
+							 std::vector<uint8_t> out( 4096 );
+							 convert_to_unorm( out.data(), in.data(), 4096, dither::noise, 0, 9 );
+							 int sum = 0;
+							 for ( uint8_t v: out )
+								 sum += v;
+							 // 100.25 * 4096 = 401 * 1024, within half a step
+							 return match_val<int>( ( sum + 512 ) / 1024, 401 );
+						 } );
+		TEST_CODE_VAL_EQ(test, "convert_to_unorm8 (out of range)",
+						 []() {
+							 // NaN goes to the top of the range, as with
+							 // clamp, repeated so every path sees each
+							 const float v[8] = { NAN, -INFINITY, INFINITY, -0.5F, 1.5F, -0.F, 1.F, 0.5F };
+							 const int cv[8] = { 255, 0, 255, 0, 255, 0, 255, 128 };
+							 float in[40];
+							 uint8_t out[40];
+							 for ( int i = 0; i < 40; ++i )
+								 in[i] = v[i & 7];
+							 convert_to_unorm( out, in, 40 );
+							 for ( int i = 0; i < 40; ++i )
+							 {
+								 if ( out[i] != cv[i & 7] )
+									 return match_val<int>( out[i], cv[i & 7] );
+							 }
+							 return match_val<int>( 0, 0 );
+						 } );
+		TEST_CODE_VAL_EQ(test, "convert_to_unorm16 (out of range)",
+						 []() {
+							 const float v[8] = { NAN, -INFINITY, INFINITY, -0.5F, 1.5F, -0.F, 1.F, 0.5F };
+							 const int cv[8] = { 65535, 0, 65535, 0, 65535, 0, 65535, 32768 };
+							 float in[40];
+							 uint16_t out[40];
+							 for ( int i = 0; i < 40; ++i )
+								 in[i] = v[i & 7];
+							 convert_to_unorm( out, in, 40 );
+							 for ( int i = 0; i < 40; ++i )
+							 {
+								 if ( out[i] != cv[i & 7] )
+									 return match_val<int>( out[i], cv[i & 7] );
+							 }
+							 return match_val<int>( 0, 0 );
+						 } );
+		TEST_CODE_VAL_EQ(test, "convert_to_unorm16 round trip",
+						 []() {
+							 uint16_t in[1000], out[1000];
+							 float tmp[1000];
+							 for ( int i = 0; i < 1000; ++i )
+								 in[i] = uint16_t( i * 65 + 17 );
+							 convert_from_unorm( tmp, in, 1000 );
+							 convert_to_unorm( out, tmp, 1000 );
+							 for ( int i = 0; i < 1000; ++i )
+							 {
+								 if ( out[i] != in[i] )
+									 return match_val<int>( out[i], in[i] );
+							 }
+							 return match_val<int>( 0, 0 );
+						 } );
+	};
+}
+
+// the 4 values of got from the first one whose bits differ from ref
+// (the last 4 if they all match) against ref, so a whole buffer is
+// compared exactly and a failure shows where it starts
+template <typename VT>
+static match_test<VT>
+first_diff4( const typename VT::value_type *got, const typename VT::value_type *ref, size_t n )
+{
+	typedef typename VT::value_type T;
+	size_t i = 0;
+	while ( i != n && std::memcmp( got + i, ref + i, sizeof( T ) ) == 0 )
+		++i;
+	i = std::min( i, n - 4 );
+	T g[4], r[4];
+	for ( size_t k = 0; k != 4; ++k )
+	{
+		g[k] = got[i + k];
+		r[k] = ref[i + k];
+	}
+	return match_test<VT>( VT( g ), r );
+}
+
+// one xoshiro256+ step of the scalar reference, returning the output
+static uint64_t xoshiro_ref_next( uint64_t (&s)[4] )
+{
+	uint64_t r = s[0] + s[3];
+	uint64_t t = s[1] << 17;
+	s[2] ^= s[0]; s[3] ^= s[1]; s[1] ^= s[2]; s[0] ^= s[3]; s[2] ^= t;
+	s[3] = ( s[3] << 45 ) | ( s[3] >> 19 );
+	return r;
+}
+
+static void
+add_random_tests( unit_test &test )
+{
+	test["random_tests"] = [&]() {
+		using namespace PAL_NAMESPACE;
+		TEST_CODE_VAL_EQ(test, "philox4x32 (known answer)",
+						 []() {
+							 // Random123 kat_vectors, philox4x32_10
+							 uint32_t cval[4] = {0xd16cfe09,0x94fdcceb,0x5001e420,0x24126ea1};
+							 philox4x32<fvec4> g( 0x299f31d0a4093822ULL, 0x0370734413198a2eULL, 0x85a308d3243f6a88ULL );
+							 ulvec4 r[4];
+							 g.next( r );
+							 uint32_t tval[4] = { r[0][0], r[1][0], r[2][0], r[3][0] };
+							 return match_test<ulvec4>( ulvec4( tval ), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "philox4x32 (counter carry)",
+						 []() {
+							 // lane 1 wraps the low counter word, so must
+							 // match a generator started there
+							 philox4x32<fvec4> a( 5, 0, 0xFFFFFFFFULL ), b( 5, 0, 0x100000000ULL );
+							 ulvec4 ra[4], rb[4];
+							 a.next( ra );
+							 b.next( rb );
+							 uint32_t cval[4] = { rb[0][0], rb[1][0], rb[2][0], rb[3][0] };
+							 uint32_t tval[4] = { ra[0][1], ra[1][1], ra[2][1], ra[3][1] };
+							 return match_test<ulvec4>( ulvec4( tval ), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "xoshiro256plus",
+						 []() {
+							 uint64_t st[4][2] = { {1,5}, {2,6}, {3,7}, {4,8} };
+							 uint64_t ref[2][4] = { {1,2,3,4}, {5,6,7,8} };
+							 xoshiro256plus<fvec4> g( st );
+							 ullvec2 v;
+							 uint64_t cval[2];
+							 for ( int k = 0; k < 100; ++k )
+							 {
+								 v = g.next_u64();
+								 for ( int l = 0; l < 2; ++l )
+									 cval[l] = xoshiro_ref_next( ref[l] );
+							 }
+							 return match_test<ullvec2>( v, cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "fill_random",
+						 []() {
+							 // the first block is counter 0 in order
+							 uint32_t out[37];
+							 fill_random( out, 37, 0 );
+							 uint32_t cval[4] = {0x6627e8d5,0xe169c58d,0xbc57ac4c,0x9b00dbd8};
+							 return match_test<ulvec4>( ulvec4( out[0], out[1], out[2], out[3] ), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "fill_uniform range",
+						 []() {
+							 float out[1000];
+							 int bad = 0;
+							 fill_uniform( out, 1000, 17, 3 );
+							 for ( int i = 0; i < 1000; ++i )
+								 bad += ( out[i] < 0.F || out[i] >= 1.F ) ? 1 : 0;
+							 return match_val<int>( bad, 0 );
+						 } );
+		TEST_CODE_VAL_EQ(test, "xoshiro256plus::jump",
+						 []() {
+							 uint64_t st[4][2] = { {1,5}, {2,6}, {3,7}, {4,8} };
+							 uint64_t ref[2][4] = { {1,2,3,4}, {5,6,7,8} };
+							 static const uint64_t kJump[4] = {
+								 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+								 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+							 for ( int l = 0; l < 2; ++l )
+							 {
+								 uint64_t t[4] = { 0, 0, 0, 0 };
+								 for ( int i = 0; i != 4; ++i )
+									 for ( int b = 0; b != 64; ++b )
+									 {
+										 if ( kJump[i] & ( uint64_t(1) << b ) )
+											 for ( int k = 0; k != 4; ++k )
+												 t[k] ^= ref[l][k];
+										 xoshiro_ref_next( ref[l] );
+									 }
+								 std::copy( t, t + 4, ref[l] );
+							 }
+							 xoshiro256plus<fvec4> g( st );
+							 g.jump();
+							 g.next_u64();
+							 uint64_t cval[2];
+							 xoshiro_ref_next( ref[0] );
+							 xoshiro_ref_next( ref[1] );
+							 cval[0] = xoshiro_ref_next( ref[0] );
+							 cval[1] = xoshiro_ref_next( ref[1] );
+							 return match_test<ullvec2>( g.next_u64(), cval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "xoshiro256plus::uniform",
+						 []() {
+							 // the upper 24 bits of each 32-bit half, the
+							 // low half in the even lane
+							 uint64_t st[4][2] = { {1,5}, {2,6}, {3,7}, {4,8} };
+							 uint64_t ref[2][4] = { {1,2,3,4}, {5,6,7,8} };
+							 xoshiro256plus<fvec4> g( st );
+							 fvec4 u;
+							 float cval[4];
+							 for ( int k = 0; k < 10; ++k )
+							 {
+								 u = g.uniform();
+								 for ( int l = 0; l < 2; ++l )
+								 {
+									 uint64_t r = xoshiro_ref_next( ref[l] );
+									 cval[2 * l] = float( uint32_t( r ) >> 8 ) / 16777216.F;
+									 cval[2 * l + 1] = float( uint32_t( r >> 32 ) >> 8 ) / 16777216.F;
+								 }
+							 }
+							 return match_test<fvec4>( u, cval );
+						 } );
+		TEST_CODE_VAL_EQ_PREC(test, "xoshiro256plus::normal",
+							  []() {
+								  // Box-Muller of two uniform draws against
+								  // double precision
+								  uint64_t st[4][2] = { {1,5}, {2,6}, {3,7}, {4,8} };
+								  xoshiro256plus<fvec4> g( st ), u( st );
+								  fvec4 z0, z1;
+								  float cval[4];
+								  for ( int k = 0; k < 10; ++k )
+								  {
+									  g.normal( z0, z1 );
+									  fvec4 u1 = u.uniform();
+									  fvec4 u2 = u.uniform();
+									  for ( int i = 0; i != 4; ++i )
+									  {
+										  double r = std::sqrt( -2.0 * std::log( 1.0 - double( u1[i] ) ) );
+										  double a = 2.0 * M_PI * double( u2[i] );
+										  cval[i] = float( r * ( i % 2 == 0 ? std::cos( a ) : std::sin( a ) ) );
+									  }
+								  }
+								  // the cosine half in the even lanes, the sine
+								  // half in the odd ones
+								  return match_test<fvec4>( fvec4( z0[0], z1[1], z0[2], z1[3] ), cval );
+							  }, 1e-5F );
+		TEST_CODE_VAL_EQ(test, "fill_random (blocks, tail)",
+						 []() {
+							 // value k is word k % 4 of counter k / 4, 37
+							 // leaves a partial block at either fill width
+							 uint32_t out[37], ref[48];
+							 fill_random( out, 37, 11, 2 );
+							 philox4x32<fvec4> g( 11, 2 );
+							 for ( int b = 0; b != 48; b += 16 )
+							 {
+								 ulvec4 r[4];
+								 g.next( r );
+								 for ( int i = 0; i != 4; ++i )
+									 for ( int j = 0; j != 4; ++j )
+										 ref[b + 4 * i + j] = r[j][i];
+							 }
+							 return first_diff4<ulvec4>( out, ref, 37 );
+						 } );
+		TEST_CODE_VAL_EQ(test, "fill_normal (blocks, tail)",
+						 []() {
+							 float out[37], ref[48];
+							 fill_normal( out, 37, 11, 2 );
+							 philox4x32<fvec4> g( 11, 2 );
+							 for ( int b = 0; b != 48; b += 16 )
+							 {
+								 fvec4 z[4];
+								 g.normal( z );
+								 for ( int i = 0; i != 4; ++i )
+									 for ( int j = 0; j != 4; ++j )
+										 ref[b + 4 * i + j] = z[j][i];
+							 }
+							 return first_diff4<fvec4>( out, ref, 37 );
+						 } );
+		TEST_CODE_VAL_EQ_PREC(test, "fill_normal (moments)",
+							  []() {
+								  // mean, variance and the fraction within one
+								  // standard deviation
+								  std::vector<float> v( 1 << 16 );
+								  fill_normal( v.data(), v.size(), 23 );
+								  double sum = 0.0, sum2 = 0.0, within = 0.0;
+								  for ( float x: v )
+								  {
+									  sum += x;
+									  sum2 += double( x ) * x;
+									  within += std::fabs( x ) < 1.F ? 1.0 : 0.0;
+								  }
+								  double n = double( v.size() );
+								  double mean = sum / n;
+								  float cval[4] = { 0.F, 1.F, 0.6826895F, 0.F };
+								  return match_test<fvec4>( fvec4( float( mean ), float( sum2 / n - mean * mean ), float( within / n ), 0.F ), cval );
+							  }, 0.02F );
+#ifdef PAL_HAS_FVEC8
+		TEST_CODE_VAL_EQ(test, "random_block_store (fvec8 lane order)",
+						 []() {
+							 // lane i of v[j] is word j of counter i, which
+							 // goes to 4 * i + j
+							 float in[4][8], out[32], ref[32];
+							 for ( int j = 0; j != 4; ++j )
+								 for ( int i = 0; i != 8; ++i )
+									 in[j][i] = float( 4 * i + j );
+							 for ( int k = 0; k != 32; ++k )
+								 ref[k] = float( k );
+							 fvec8 v[4] = { load8f( in[0] ), load8f( in[1] ), load8f( in[2] ), load8f( in[3] ) };
+							 detail::random_block_store( out, v );
+							 return first_diff4<fvec4>( out, ref, 32 );
+						 } );
+		TEST_CODE_VAL_EQ(test, "philox4x32 (fvec8 matches fvec4)",
+						 []() {
+							 philox4x32<fvec8> a( 3, 9 );
+							 philox4x32<fvec4> b( 3, 9 );
+							 ulvec8 ra[4];
+							 ulvec4 rb[4], rc[4];
+							 a.next( ra );
+							 b.next( rb );
+							 b.next( rc );
+							 uint32_t got[32], ref[32];
+							 for ( int j = 0; j != 4; ++j )
+								 for ( int i = 0; i != 4; ++i )
+								 {
+									 got[8 * j + i] = ra[j][i];
+									 got[8 * j + 4 + i] = ra[j][4 + i];
+									 ref[8 * j + i] = rb[j][i];
+									 ref[8 * j + 4 + i] = rc[j][i];
+								 }
+							 return first_diff4<ulvec4>( got, ref, 32 );
+						 } );
+#endif
+	};
+}
+
+// the sort_network overloads by register count
+template <typename VT> static void run_network( VT (&v)[1] ) { v[0] = PAL_NAMESPACE::sort_network( v[0] ); }
+template <typename VT> static void run_network( VT (&v)[2] ) { PAL_NAMESPACE::sort_network( v[0], v[1] ); }
+template <typename VT> static void run_network( VT (&v)[4] ) { PAL_NAMESPACE::sort_network( v[0], v[1], v[2], v[3] ); }
+
+// sorts 64 trials of R registers with sort_network, ascending,
+// descending then random values with many duplicates, and compares
+// every output against std::sort, the first 4 which differ against
+// their reference
+template <typename VT, int R>
+static match
+network_check( uint32_t seed )
+{
+	typedef typename VT::value_type T;
+	const size_t N = size_t( R * VT::value_count );
+	const size_t trials = 64;
+	std::vector<T> got( trials * N ), ref( trials * N );
+	for ( size_t t = 0; t != trials; ++t )
+	{
+		T *g = got.data() + t * N;
+		T *r = ref.data() + t * N;
+		for ( size_t i = 0; i != N; ++i )
+		{
+			seed = seed * 1664525U + 1013904223U;
+			int x = t == 0 ? int( i ) : ( t == 1 ? int( N - i ) : int( seed >> 27 ) - 16 );
+			g[i] = r[i] = T( x );
+		}
+		VT v[R];
+		for ( int k = 0; k != R; ++k )
+			v[k] = PAL_NAMESPACE::detail::load_vec<VT>( g + size_t( k ) * size_t( VT::value_count ) );
+		run_network( v );
+		for ( int k = 0; k != R; ++k )
+			PAL_NAMESPACE::store( g + size_t( k ) * size_t( VT::value_count ), v[k] );
+		std::sort( r, r + N );
+	}
+	return first_diff4<PAL_NAMESPACE::lvec4>( got.data(), ref.data(), got.size() );
+}
+
+static void
+add_sort_tests( unit_test &test )
+{
+	test["sort_tests"] = [&]() {
+		using namespace PAL_NAMESPACE;
+		TEST_CODE_VAL_EQ(test, "sort_network (lvec4, 1 register)", []() { return network_check<lvec4, 1>( 1 ); } );
+		TEST_CODE_VAL_EQ(test, "sort_network (lvec4, 2 registers)", []() { return network_check<lvec4, 2>( 2 ); } );
+		TEST_CODE_VAL_EQ(test, "sort_network (lvec4, 4 registers)", []() { return network_check<lvec4, 4>( 3 ); } );
+#ifdef PAL_ENABLE_AVX
+		TEST_CODE_VAL_EQ(test, "sort_network (lvec8, 1 register)", []() { return network_check<lvec8, 1>( 4 ); } );
+		TEST_CODE_VAL_EQ(test, "sort_network (lvec8, 2 registers)", []() { return network_check<lvec8, 2>( 5 ); } );
+		TEST_CODE_VAL_EQ(test, "sort_network (lvec8, 4 registers)", []() { return network_check<lvec8, 4>( 6 ); } );
+#endif
+		TEST_CODE_VAL_EQ(test, "sort (int32 buffer)",
+						 []() {
+							 // includes long runs of equal values
+							 std::vector<int32_t> v( 5000 );
+							 for ( size_t i = 0; i != v.size(); ++i )
+								 v[i] = ( i & 1 ) ? int32_t( i * 2654435761U ) : int32_t( i % 5 );
+							 std::vector<int32_t> r = v;
+							 std::sort( r.begin(), r.end() );
+							 sort( v.data(), v.size() );
+							 return match_val<int>( v == r ? 1 : 0, 1 );
+						 } );
+	};
+}
+
+static void
+add_reduce_tests( unit_test &test )
+{
+	test["reduce_tests"] = [&]() {
+		using namespace PAL_NAMESPACE;
+		TEST_CODE_VAL_EQ(test, "mask which",
+						 []() {
+							 lvec4 a( 1, 2, 3, 4 );
+							 mask128<int16_t> m16( _mm_setr_epi16( 0, -1, 0, 0, 0, 0, 0, -1 ) );
+							 int32_t cval[4] = { ( a > lvec4( 2 ) ).which(), m16.which(),
+												 ( a > lvec4( 2 ) ).active_mask( 3 ), ( a > lvec4( 9 ) ).which() };
+							 int32_t tval[4] = { 0xC, 0x82, 0x8, 0 };
+							 return match_test<lvec4>( lvec4( cval ), tval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "find_first_if (int32)",
+						 []() {
+							 std::vector<int32_t> v( 333, 3 );
+							 v[130] = -4;
+							 v[200] = -1;
+							 auto neg = []( search_vec<int32_t> x ) { return x < search_vec<int32_t>::zero(); };
+							 int32_t cval[4] = { int32_t( find_first_if( v.data(), v.size(), neg ) ),
+												 int32_t( count_if( v.data(), v.size(), neg ) ),
+												 int32_t( find_first_if( v.data(), 130, neg ) ),
+												 none_of( v.data(), 130, neg ) ? 1 : 0 };
+							 int32_t tval[4] = { 130, 2, 130, 1 };
+							 return match_test<lvec4>( lvec4( cval ), tval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "argmin / argmax (int32)",
+						 []() {
+							 std::vector<int32_t> v( 777 );
+							 for ( size_t i = 0; i != v.size(); ++i )
+								 v[i] = int32_t( ( i * 7919 ) % 211 ) - 100;
+							 int32_t cval[4] = { int32_t( argmin( v.data(), v.size() ) ),
+												 int32_t( argmax( v.data(), v.size() ) ),
+												 min_with_index( v.data(), v.size() ).value,
+												 max_with_index( v.data(), v.size() ).value };
+							 int32_t tval[4] = { int32_t( std::min_element( v.begin(), v.end() ) - v.begin() ),
+												 int32_t( std::max_element( v.begin(), v.end() ) - v.begin() ),
+												 -100, 110 };
+							 return match_test<lvec4>( lvec4( cval ), tval );
+						 } );
+	};
+}
+
+static void
+add_compact_tests( unit_test &test )
+{
+	test["compact_tests"] = [&]() {
+		using namespace PAL_NAMESPACE;
+		TEST_CODE_VAL_EQ(test, "compress_store",
+						 []() {
+							 int32_t out[4];
+							 lvec4 v( 5, -6, 7, -8 );
+							 int count = compress_store( out, v, v < lvec4::zero() );
+							 int32_t cval[4] = { out[0], out[1], count, 0 };
+							 int32_t tval[4] = { -6, -8, 2, 0 };
+							 return match_test<lvec4>( lvec4( cval ), tval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "partition_copy (int32)",
+						 []() {
+							 std::vector<int32_t> v( 301 ), t( 301 ), f( 301 );
+							 for ( size_t i = 0; i != v.size(); ++i )
+								 v[i] = int32_t( ( i * 7919 ) % 13 ) - 6;
+							 std::vector<int32_t> rt, rf;
+							 for ( int32_t x: v )
+								 ( x < 0 ? rt : rf ).push_back( x );
+							 size_t c = partition_copy( t.data(), f.data(), v.data(), v.size(),
+														 []( search_vec<int32_t> x ) { return x < search_vec<int32_t>::zero(); } );
+							 bool ok = c == rt.size() && std::equal( rt.begin(), rt.end(), t.begin() ) &&
+								 std::equal( rf.begin(), rf.end(), f.begin() );
+							 return match_val<int>( ok ? 1 : 0, 1 );
+						 } );
+	};
+}
+
+static void
+add_histogram_tests( unit_test &test )
+{
+	test["histogram_tests"] = [&]() {
+		using namespace PAL_NAMESPACE;
+		TEST_CODE_VAL_EQ(test, "histogram (uint8)",
+						 []() {
+							 std::vector<uint8_t> v( 1001 );
+							 for ( size_t i = 0; i != v.size(); ++i )
+								 v[i] = uint8_t( ( i / 16 ) * 3 );
+							 uint32_t bins[256];
+							 histogram( bins, v.data(), v.size() );
+							 uint32_t cval[4] = { bins[0], bins[3], bins[186], bins[1] };
+							 uint32_t tval[4] = { 16, 16, 9, 0 };
+							 return match_test<ulvec4>( ulvec4( cval ), tval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "histogram (uint16, clamped)",
+						 []() {
+							 uint16_t v[11] = { 0, 1, 1, 1023, 1024, 65535, 5, 5, 5, 5, 1 };
+							 uint32_t bins[1024];
+							 histogram( bins, 1024, v, 11 );
+							 uint32_t cval[4] = { bins[0], bins[1], bins[5], bins[1023] };
+							 uint32_t tval[4] = { 1, 3, 4, 3 };
+							 return match_test<ulvec4>( ulvec4( cval ), tval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "histogram (uint16, more bins than values)",
+						 []() {
+							 uint16_t v[6] = { 0, 1, 65535, 65535, 40000, 1 };
+							 std::vector<uint32_t> bins( 70000, uint32_t(7) );
+							 histogram( bins.data(), bins.size(), v, 6 );
+							 uint32_t cval[4] = { bins[1], bins[40000], bins[65535], bins[69999] };
+							 uint32_t tval[4] = { 2, 1, 2, 0 };
+							 return match_test<ulvec4>( ulvec4( cval ), tval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "histogram (no bins)",
+						 []() {
+							 // nothing is written, the sentinel stays
+							 uint16_t v16[5] = { 0, 1, 2, 3, 65535 };
+							 float vf[5] = { 0.F, 0.5F, 1.F, NAN, -1.F };
+							 uint32_t bins[4] = { 9, 9, 9, 9 };
+							 histogram( bins, 0, v16, 5 );
+							 histogram( bins + 1, 0, vf, 5, 0.F, 1.F );
+							 histogram2d( bins + 2, 0, 4, vf, vf, 5, 0.F, 1.F, 0.F, 1.F );
+							 histogram2d( bins + 3, 4, 0, vf, vf, 5, 0.F, 1.F, 0.F, 1.F );
+							 uint32_t tval[4] = { 9, 9, 9, 9 };
+							 return match_test<ulvec4>( ulvec4( bins ), tval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "histogram (too many float bins)",
+						 []() {
+							 // the int32 bin indices cannot address 2^31
+							 // bins, nx * ny may also overflow size_t
+							 float vf[5] = { 0.F, 0.5F, 1.F, NAN, -1.F };
+							 uint32_t bins[4] = { 9, 9, 9, 9 };
+							 histogram( bins, size_t(1) << 31, vf, 5, 0.F, 1.F );
+							 histogram2d( bins + 1, size_t(1) << 16, size_t(1) << 15, vf, vf, 5, 0.F, 1.F, 0.F, 1.F );
+							 histogram2d( bins + 2, std::numeric_limits<size_t>::max() / 2, 4, vf, vf, 5, 0.F, 1.F, 0.F, 1.F );
+							 uint32_t tval[4] = { 9, 9, 9, 9 };
+							 return match_test<ulvec4>( ulvec4( bins ), tval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "histogram (float)",
+						 []() {
+							 float v[9] = { -1.F, 0.F, 0.1F, 0.35F, 0.5F, 0.99F, 1.F, 7.F, NAN };
+							 uint32_t bins[4];
+							 histogram( bins, 4, v, 9, 0.F, 1.F );
+							 uint32_t tval[4] = { 4, 1, 1, 3 };
+							 return match_test<ulvec4>( ulvec4( bins ), tval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "histogram2d",
+						 []() {
+							 float x[5] = { 0.1F, 0.9F, 0.9F, 0.6F, 0.2F };
+							 float y[5] = { 0.1F, 0.1F, 0.8F, 0.7F, 0.6F };
+							 uint32_t bins[4];
+							 histogram2d( bins, 2, 2, x, y, 5, 0.F, 1.F, 0.F, 1.F );
+							 uint32_t tval[4] = { 1, 1, 1, 2 };
+							 return match_test<ulvec4>( ulvec4( bins ), tval );
+						 } );
+		TEST_CODE_VAL_EQ(test, "histogram (threads)",
+						 []() {
+							 // the threaded chunks must add up to the same
+							 std::vector<uint8_t> v( 1 << 20 );
+							 for ( size_t i = 0; i != v.size(); ++i )
+								 v[i] = uint8_t( ( i * 2654435761U ) >> 24 );
+							 uint32_t a[256], b[256];
+							 histogram( a, v.data(), v.size(), 1 );
+							 histogram( b, v.data(), v.size(), 4 );
+							 return match_val<int>( std::equal( a, a + 256, b ) ? 1 : 0, 1 );
+						 } );
+	};
 }
 
 int main( int argc, char *argv[] )
@@ -350,6 +1414,11 @@ int main( int argc, char *argv[] )
 	add_class_tests( test );
 	add_op_tests( test );
 	add_load_store_tests( test );
+	add_random_tests( test );
+	add_sort_tests( test );
+	add_reduce_tests( test );
+	add_compact_tests( test );
+	add_histogram_tests( test );
 
 	bool q = false;
 	while ( argc > 1 )
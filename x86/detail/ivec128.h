@@ -63,6 +63,10 @@ template <> struct ivec128_traits<1>
 
 	static PAL_INLINE __m128i subu( __m128i a, __m128i b ) { return _mm_sub_epi8( a, b ); }
 	static PAL_INLINE __m128i subs( __m128i a, __m128i b ) { return _mm_subs_epi8( a, b ); }
+	/// @brief unsigned saturating add / subtract, rounding average
+	static PAL_INLINE __m128i addus( __m128i a, __m128i b ) { return _mm_adds_epu8( a, b ); }
+	static PAL_INLINE __m128i subus( __m128i a, __m128i b ) { return _mm_subs_epu8( a, b ); }
+	static PAL_INLINE __m128i avgu( __m128i a, __m128i b ) { return _mm_avg_epu8( a, b ); }
 
 	static PAL_INLINE __m128i mul( __m128i a, __m128i b )
 	{
@@ -164,10 +168,24 @@ template <> struct ivec128_traits<2>
 
 	static PAL_INLINE __m128i subu( __m128i a, __m128i b ) { return _mm_sub_epi16( a, b ); }
 	static PAL_INLINE __m128i subs( __m128i a, __m128i b ) { return _mm_subs_epi16( a, b ); }
+	/// @brief unsigned saturating add / subtract, rounding average
+	static PAL_INLINE __m128i addus( __m128i a, __m128i b ) { return _mm_adds_epu16( a, b ); }
+	static PAL_INLINE __m128i subus( __m128i a, __m128i b ) { return _mm_subs_epu16( a, b ); }
+	static PAL_INLINE __m128i avgu( __m128i a, __m128i b ) { return _mm_avg_epu16( a, b ); }
 
 	static PAL_INLINE __m128i mul( __m128i a, __m128i b )
 	{ return _mm_mullo_epi16( a, b ); }
 
+	/// @brief high half of the 16x16 multiply
+	static PAL_INLINE __m128i mulhi_s( __m128i a, __m128i b ) { return _mm_mulhi_epi16( a, b ); }
+	static PAL_INLINE __m128i mulhi_u( __m128i a, __m128i b ) { return _mm_mulhi_epu16( a, b ); }
+
+	/// @brief shifts by the count in the low 64 bits of c
+	static PAL_INLINE __m128i srl( __m128i a, __m128i c ) { return _mm_srl_epi16( a, c ); }
+	static PAL_INLINE __m128i sra( __m128i a, __m128i c ) { return _mm_sra_epi16( a, c ); }
+	/// @brief all ones where a is negative
+	static PAL_INLINE __m128i sign( __m128i a ) { return _mm_srai_epi16( a, 15 ); }
+
 	static PAL_INLINE itype access( __m128i a, int idx )
 	{
 #ifdef PAL_HAS_DIRECT_VEC_ACCESS
@@ -253,6 +271,37 @@ template <> struct ivec128_traits<4>
 								   _mm_unpackhi_epi32( a02, a13 ) );
 #endif
 	}
+
+	/// @brief high half of the 32x32 multiply
+	static PAL_INLINE __m128i mulhi_u( __m128i a, __m128i b )
+	{
+		__m128i a02 = _mm_srli_epi64( _mm_mul_epu32( a, b ), 32 );
+		__m128i a13 = _mm_mul_epu32( _mm_srli_epi64( a, 32 ),
+									 _mm_srli_epi64( b, 32 ) );
+#if PAL_ENABLE_SSE4_1
+		return _mm_blend_epi16( a02, a13, 0xCC );
+#else
+		return _mm_or_si128( a02, _mm_and_si128( a13, _mm_set_epi32( -1, 0, -1, 0 ) ) );
+#endif
+	}
+	static PAL_INLINE __m128i mulhi_s( __m128i a, __m128i b )
+	{
+#if PAL_ENABLE_SSE4_1
+		__m128i a02 = _mm_srli_epi64( _mm_mul_epi32( a, b ), 32 );
+		__m128i a13 = _mm_mul_epi32( _mm_srli_epi64( a, 32 ),
+									 _mm_srli_epi64( b, 32 ) );
+		return _mm_blend_epi16( a02, a13, 0xCC );
+#else
+		// hacker's delight, unsigned to signed mul (page 132)
+		__m128i lows = _mm_add_epi32( _mm_and_si128( b, sign( a ) ),
+									  _mm_and_si128( a, sign( b ) ) );
+		return _mm_sub_epi32( mulhi_u( a, b ), lows );
+#endif
+	}
+
+	static PAL_INLINE __m128i srl( __m128i a, __m128i c ) { return _mm_srl_epi32( a, c ); }
+	static PAL_INLINE __m128i sra( __m128i a, __m128i c ) { return _mm_sra_epi32( a, c ); }
+	static PAL_INLINE __m128i sign( __m128i a ) { return _mm_srai_epi32( a, 31 ); }
 	
 	static PAL_INLINE itype access( __m128i a, int idx )
 	{
@@ -308,7 +357,7 @@ template <> struct ivec128_traits<8>
 		return _mm_set_epi64x( itype(a[1]), itype(a[0]) );
 	}
 	template <typename U>
-	static PAL_INLINE __m128i init( const std::array<U,4> &a )
+	static PAL_INLINE __m128i init( const std::array<U,2> &a )
 	{
 		return _mm_set_epi64x( itype(a[1]), itype(a[0]) );
 	}
@@ -323,9 +372,80 @@ template <> struct ivec128_traits<8>
 
 	static PAL_INLINE __m128i mul( __m128i a, __m128i b )
 	{
-		// TODO: in AVX512 there is a mullo_epi64...
-		return _mm_set_epi64x( access( a, 1 ) * access( b, 1 ),
-							   access( a, 0 ) * access( b, 0 ) );
+#if defined(PAL_ENABLE_AVX_512DQ) && defined(PAL_ENABLE_AVX_512VL)
+		return _mm_mullo_epi64( a, b );
+#else
+		// the low 64 bits of the product are lo*lo + ((lo*hi + hi*lo) << 32),
+		// the hi*hi term is entirely shifted out
+		__m128i cross = _mm_add_epi64( _mm_mul_epu32( a, _mm_srli_epi64( b, 32 ) ),
+									   _mm_mul_epu32( _mm_srli_epi64( a, 32 ), b ) );
+		return _mm_add_epi64( _mm_mul_epu32( a, b ), _mm_slli_epi64( cross, 32 ) );
+#endif
+	}
+
+	/// @brief high half of the 64x64 multiply, there is no 64-bit
+	/// multiply (even with AVX512DQ, that is only the low half), so
+	/// this is built from the 4 32x32->64 partial products
+	static PAL_INLINE __m128i mulhi_u( __m128i a, __m128i b )
+	{
+		__m128i ah = _mm_srli_epi64( a, 32 );
+		__m128i bh = _mm_srli_epi64( b, 32 );
+		__m128i t = _mm_add_epi64( _mm_mul_epu32( ah, b ),
+								   _mm_srli_epi64( _mm_mul_epu32( a, b ), 32 ) );
+		__m128i w = _mm_add_epi64( _mm_and_si128( t, _mm_set1_epi64x( 0xFFFFFFFF ) ),
+								   _mm_mul_epu32( a, bh ) );
+		return _mm_add_epi64( _mm_add_epi64( _mm_mul_epu32( ah, bh ), _mm_srli_epi64( t, 32 ) ),
+							  _mm_srli_epi64( w, 32 ) );
+	}
+	static PAL_INLINE __m128i mulhi_s( __m128i a, __m128i b )
+	{
+		__m128i lows = _mm_add_epi64( _mm_and_si128( b, sign( a ) ),
+									  _mm_and_si128( a, sign( b ) ) );
+		return _mm_sub_epi64( mulhi_u( a, b ), lows );
+	}
+
+	static PAL_INLINE __m128i srl( __m128i a, __m128i c ) { return _mm_srl_epi64( a, c ); }
+	static PAL_INLINE __m128i sra( __m128i a, __m128i c )
+	{
+#ifdef PAL_ENABLE_AVX_512VL
+		return _mm_sra_epi64( a, c );
+#else
+		// no 64-bit arithmetic shift prior to AVX512
+		__m128i s = sign( a );
+		return _mm_xor_si128( _mm_srl_epi64( _mm_xor_si128( a, s ), c ), s );
+#endif
+	}
+	static PAL_INLINE __m128i sign( __m128i a )
+	{
+#ifdef PAL_ENABLE_AVX_512VL
+		return _mm_srai_epi64( a, 63 );
+#else
+		return _mm_shuffle_epi32( _mm_srai_epi32( a, 31 ), _MM_SHUFFLE( 3, 3, 1, 1 ) );
+#endif
+	}
+
+	static PAL_INLINE __m128i cmpeq( __m128i a, __m128i b )
+	{
+#ifdef PAL_ENABLE_SSE4_1
+		return _mm_cmpeq_epi64( a, b );
+#else
+		__m128i r = _mm_cmpeq_epi32( a, b );
+		return _mm_and_si128( r, _mm_shuffle_epi32( r, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+#endif
+	}
+	/// @brief signed a > b
+	static PAL_INLINE __m128i cmpgt( __m128i a, __m128i b )
+	{
+#ifdef PAL_ENABLE_SSE4_2
+		return _mm_cmpgt_epi64( a, b );
+#else
+		// the high words decide, unless they are equal, in which case
+		// the borrow of b - a into the high word is the unsigned
+		// compare of the low words
+		__m128i r = _mm_or_si128( _mm_cmpgt_epi32( a, b ),
+								  _mm_and_si128( _mm_cmpeq_epi32( a, b ), _mm_sub_epi64( b, a ) ) );
+		return _mm_shuffle_epi32( r, _MM_SHUFFLE( 3, 3, 1, 1 ) );
+#endif
 	}
 
 	static PAL_INLINE itype access( __m128i a, int idx )
@@ -33,6 +33,28 @@ namespace PAL_NAMESPACE
 namespace detail
 {
 
+// AVX1 only has 256-bit float operations, so integer operations are
+// done on the two 128-bit halves
+#define PAL_AVX_INT_SPLIT_BINOP( op128, a, b )							\
+	_mm256_insertf128_si256(											\
+		_mm256_castsi128_si256( op128( _mm256_castsi256_si128( a ),		\
+									   _mm256_castsi256_si128( b ) ) ),	\
+		op128( _mm256_extractf128_si256( a, 1 ),						\
+			   _mm256_extractf128_si256( b, 1 ) ), 1 )
+// same, but c (i.e. a shift count) is passed as is to both halves
+#define PAL_AVX_INT_SPLIT_SHIFTOP( op128, a, c )							\
+	_mm256_insertf128_si256(											\
+		_mm256_castsi128_si256( op128( _mm256_castsi256_si128( a ), c ) ), \
+		op128( _mm256_extractf128_si256( a, 1 ), c ), 1 )
+
+#ifdef PAL_ENABLE_AVX2
+# define PAL_AVX_INT_BINOP( op256, op128, a, b ) op256( a, b )
+# define PAL_AVX_INT_SHIFTOP( op256, op128, a, c ) op256( a, c )
+#else
+# define PAL_AVX_INT_BINOP( op256, op128, a, b ) PAL_AVX_INT_SPLIT_BINOP( op128, a, b )
+# define PAL_AVX_INT_SHIFTOP( op256, op128, a, c ) PAL_AVX_INT_SPLIT_SHIFTOP( op128, a, c )
+#endif
+
 template <size_t T> struct ivec256_traits {};
 
 template <> struct ivec256_traits<1>
@@ -53,10 +75,13 @@ template <> struct ivec256_traits<1>
 			a31, a30, a29, a28, a27, a26, a25, a24, a23, a22, a21, a20, a19, a18, a17, a16,
 			a15, a14, a13, a12, a11, a10, a9, a8, a7, a6, a5, a4, a3, a2, a1, a0 );
 	}
-	static PAL_INLINE __m256i addu( __m256i a, __m256i b ) { return _mm256_add_epi8( a, b ); }
-	static PAL_INLINE __m256i adds( __m256i a, __m256i b ) { return _mm256_adds_epi8( a, b ); }
-	static PAL_INLINE __m256i subu( __m256i a, __m256i b ) { return _mm256_sub_epi8( a, b ); }
-	static PAL_INLINE __m256i subs( __m256i a, __m256i b ) { return _mm256_subs_epi8( a, b ); }
+	static PAL_INLINE __m256i addu( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_add_epi8, _mm_add_epi8, a, b ); }
+	static PAL_INLINE __m256i adds( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_adds_epi8, _mm_adds_epi8, a, b ); }
+	static PAL_INLINE __m256i subu( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_sub_epi8, _mm_sub_epi8, a, b ); }
+	static PAL_INLINE __m256i subs( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_subs_epi8, _mm_subs_epi8, a, b ); }
+	static PAL_INLINE __m256i addus( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_adds_epu8, _mm_adds_epu8, a, b ); }
+	static PAL_INLINE __m256i subus( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_subs_epu8, _mm_subs_epu8, a, b ); }
+	static PAL_INLINE __m256i avgu( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_avg_epu8, _mm_avg_epu8, a, b ); }
 	static PAL_INLINE itype access( __m256i a, int idx )
 	{
 #ifdef PAL_HAS_DIRECT_VEC_ACCESS
@@ -89,10 +114,19 @@ template <> struct ivec256_traits<2>
 	{
 		return _mm256_set_epi16( a15, a14, a13, a12, a11, a10, a9, a8, a7, a6, a5, a4, a3, a2, a1, a0 );
 	}
-	static PAL_INLINE __m256i addu( __m256i a, __m256i b ) { return _mm256_add_epi16( a, b ); }
-	static PAL_INLINE __m256i adds( __m256i a, __m256i b ) { return _mm256_adds_epi16( a, b ); }
-	static PAL_INLINE __m256i subu( __m256i a, __m256i b ) { return _mm256_sub_epi16( a, b ); }
-	static PAL_INLINE __m256i subs( __m256i a, __m256i b ) { return _mm256_subs_epi16( a, b ); }
+	static PAL_INLINE __m256i addu( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_add_epi16, _mm_add_epi16, a, b ); }
+	static PAL_INLINE __m256i adds( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_adds_epi16, _mm_adds_epi16, a, b ); }
+	static PAL_INLINE __m256i subu( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_sub_epi16, _mm_sub_epi16, a, b ); }
+	static PAL_INLINE __m256i subs( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_subs_epi16, _mm_subs_epi16, a, b ); }
+	static PAL_INLINE __m256i addus( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_adds_epu16, _mm_adds_epu16, a, b ); }
+	static PAL_INLINE __m256i subus( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_subs_epu16, _mm_subs_epu16, a, b ); }
+	static PAL_INLINE __m256i avgu( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_avg_epu16, _mm_avg_epu16, a, b ); }
+	static PAL_INLINE __m256i mul( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_mullo_epi16, _mm_mullo_epi16, a, b ); }
+	static PAL_INLINE __m256i mulhi_s( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_mulhi_epi16, _mm_mulhi_epi16, a, b ); }
+	static PAL_INLINE __m256i mulhi_u( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_mulhi_epu16, _mm_mulhi_epu16, a, b ); }
+	static PAL_INLINE __m256i srl( __m256i a, __m128i c ) { return PAL_AVX_INT_SHIFTOP( _mm256_srl_epi16, _mm_srl_epi16, a, c ); }
+	static PAL_INLINE __m256i sra( __m256i a, __m128i c ) { return PAL_AVX_INT_SHIFTOP( _mm256_sra_epi16, _mm_sra_epi16, a, c ); }
+	static PAL_INLINE __m256i sign( __m256i a ) { return PAL_AVX_INT_SHIFTOP( _mm256_srai_epi16, _mm_srai_epi16, a, 15 ); }
 	static PAL_INLINE itype access( __m256i a, int idx )
 	{
 #ifdef PAL_HAS_DIRECT_VEC_ACCESS
@@ -123,12 +157,36 @@ template <> struct ivec256_traits<4>
 	{
 		return _mm256_set_epi32( a7, a6, a5, a4, a3, a2, a1, a0 );
 	}
-	static PAL_INLINE __m256i addu( __m256i a, __m256i b ) { return _mm256_add_epi32( a, b ); }
+	static PAL_INLINE __m256i addu( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_add_epi32, _mm_add_epi32, a, b ); }
 	// huh, gcc doesn't seem to provide a signed 32-bit add
-	static PAL_INLINE __m256i adds( __m256i a, __m256i b ) { return _mm256_add_epi32( a, b ); }
-	static PAL_INLINE __m256i subu( __m256i a, __m256i b ) { return _mm256_sub_epi32( a, b ); }
+	static PAL_INLINE __m256i adds( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_add_epi32, _mm_add_epi32, a, b ); }
+	static PAL_INLINE __m256i subu( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_sub_epi32, _mm_sub_epi32, a, b ); }
 	// huh, gcc doesn't seem to provide a signed 32-bit subtract
-	static PAL_INLINE __m256i subs( __m256i a, __m256i b ) { return _mm256_sub_epi32( a, b ); }
+	static PAL_INLINE __m256i subs( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_sub_epi32, _mm_sub_epi32, a, b ); }
+	static PAL_INLINE __m256i mul( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_mullo_epi32, _mm_mullo_epi32, a, b ); }
+	static PAL_INLINE __m256i mulhi_u( __m256i a, __m256i b )
+	{
+#ifdef PAL_ENABLE_AVX2
+		__m256i a02 = _mm256_srli_epi64( _mm256_mul_epu32( a, b ), 32 );
+		__m256i a13 = _mm256_mul_epu32( _mm256_srli_epi64( a, 32 ), _mm256_srli_epi64( b, 32 ) );
+		return _mm256_blend_epi32( a02, a13, 0xAA );
+#else
+		return PAL_AVX_INT_SPLIT_BINOP( ivec128_traits<4>::mulhi_u, a, b );
+#endif
+	}
+	static PAL_INLINE __m256i mulhi_s( __m256i a, __m256i b )
+	{
+#ifdef PAL_ENABLE_AVX2
+		__m256i a02 = _mm256_srli_epi64( _mm256_mul_epi32( a, b ), 32 );
+		__m256i a13 = _mm256_mul_epi32( _mm256_srli_epi64( a, 32 ), _mm256_srli_epi64( b, 32 ) );
+		return _mm256_blend_epi32( a02, a13, 0xAA );
+#else
+		return PAL_AVX_INT_SPLIT_BINOP( ivec128_traits<4>::mulhi_s, a, b );
+#endif
+	}
+	static PAL_INLINE __m256i srl( __m256i a, __m128i c ) { return PAL_AVX_INT_SHIFTOP( _mm256_srl_epi32, _mm_srl_epi32, a, c ); }
+	static PAL_INLINE __m256i sra( __m256i a, __m128i c ) { return PAL_AVX_INT_SHIFTOP( _mm256_sra_epi32, _mm_sra_epi32, a, c ); }
+	static PAL_INLINE __m256i sign( __m256i a ) { return PAL_AVX_INT_SHIFTOP( _mm256_srai_epi32, _mm_srai_epi32, a, 31 ); }
 	static PAL_INLINE itype access( __m256i a, int idx )
 	{
 #ifdef PAL_HAS_DIRECT_VEC_ACCESS
@@ -158,12 +216,77 @@ template <> struct ivec256_traits<8>
 	{
 		return _mm256_set_epi64x( a3, a2, a1, a0 );
 	}
-	static PAL_INLINE __m256i addu( __m256i a, __m256i b ) { return _mm256_add_epi64( a, b ); }
+	static PAL_INLINE __m256i addu( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_add_epi64, _mm_add_epi64, a, b ); }
 	// huh, gcc doesn't seem to provide a signed 64-bit add
-	static PAL_INLINE __m256i adds( __m256i a, __m256i b ) { return _mm256_add_epi64( a, b ); }
-	static PAL_INLINE __m256i subu( __m256i a, __m256i b ) { return _mm256_sub_epi64( a, b ); }
+	static PAL_INLINE __m256i adds( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_add_epi64, _mm_add_epi64, a, b ); }
+	static PAL_INLINE __m256i subu( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_sub_epi64, _mm_sub_epi64, a, b ); }
 	// huh, gcc doesn't seem to provide a signed 64-bit subtract
-	static PAL_INLINE __m256i subs( __m256i a, __m256i b ) { return _mm256_sub_epi64( a, b ); }
+	static PAL_INLINE __m256i subs( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_sub_epi64, _mm_sub_epi64, a, b ); }
+	static PAL_INLINE __m256i mul( __m256i a, __m256i b )
+	{
+#if defined(PAL_ENABLE_AVX_512DQ) && defined(PAL_ENABLE_AVX_512VL)
+		return _mm256_mullo_epi64( a, b );
+#elif defined(PAL_ENABLE_AVX2)
+		__m256i cross = _mm256_add_epi64( _mm256_mul_epu32( a, _mm256_srli_epi64( b, 32 ) ),
+										  _mm256_mul_epu32( _mm256_srli_epi64( a, 32 ), b ) );
+		return _mm256_add_epi64( _mm256_mul_epu32( a, b ), _mm256_slli_epi64( cross, 32 ) );
+#else
+		return PAL_AVX_INT_SPLIT_BINOP( ivec128_traits<8>::mul, a, b );
+#endif
+	}
+	/// @brief see ivec128_traits<8>::mulhi_u
+	static PAL_INLINE __m256i mulhi_u( __m256i a, __m256i b )
+	{
+#ifdef PAL_ENABLE_AVX2
+		__m256i ah = _mm256_srli_epi64( a, 32 );
+		__m256i bh = _mm256_srli_epi64( b, 32 );
+		__m256i t = _mm256_add_epi64( _mm256_mul_epu32( ah, b ),
+									  _mm256_srli_epi64( _mm256_mul_epu32( a, b ), 32 ) );
+		__m256i w = _mm256_add_epi64( _mm256_and_si256( t, _mm256_set1_epi64x( 0xFFFFFFFF ) ),
+									  _mm256_mul_epu32( a, bh ) );
+		return _mm256_add_epi64( _mm256_add_epi64( _mm256_mul_epu32( ah, bh ), _mm256_srli_epi64( t, 32 ) ),
+								 _mm256_srli_epi64( w, 32 ) );
+#else
+		return PAL_AVX_INT_SPLIT_BINOP( ivec128_traits<8>::mulhi_u, a, b );
+#endif
+	}
+	static PAL_INLINE __m256i mulhi_s( __m256i a, __m256i b )
+	{
+#ifdef PAL_ENABLE_AVX2
+		__m256i lows = _mm256_add_epi64( _mm256_and_si256( b, sign( a ) ),
+										 _mm256_and_si256( a, sign( b ) ) );
+		return _mm256_sub_epi64( mulhi_u( a, b ), lows );
+#else
+		return PAL_AVX_INT_SPLIT_BINOP( ivec128_traits<8>::mulhi_s, a, b );
+#endif
+	}
+	static PAL_INLINE __m256i srl( __m256i a, __m128i c ) { return PAL_AVX_INT_SHIFTOP( _mm256_srl_epi64, _mm_srl_epi64, a, c ); }
+	static PAL_INLINE __m256i sra( __m256i a, __m128i c )
+	{
+#ifdef PAL_ENABLE_AVX_512VL
+		return _mm256_sra_epi64( a, c );
+#elif defined(PAL_ENABLE_AVX2)
+		__m256i s = sign( a );
+		return _mm256_xor_si256( _mm256_srl_epi64( _mm256_xor_si256( a, s ), c ), s );
+#else
+		return PAL_AVX_INT_SPLIT_SHIFTOP( ivec128_traits<8>::sra, a, c );
+#endif
+	}
+	static PAL_INLINE __m256i sign( __m256i a )
+	{
+#ifdef PAL_ENABLE_AVX_512VL
+		return _mm256_srai_epi64( a, 63 );
+#elif defined(PAL_ENABLE_AVX2)
+		return _mm256_shuffle_epi32( _mm256_srai_epi32( a, 31 ), _MM_SHUFFLE( 3, 3, 1, 1 ) );
+#else
+		return _mm256_insertf128_si256(
+			_mm256_castsi128_si256( ivec128_traits<8>::sign( _mm256_castsi256_si128( a ) ) ),
+			ivec128_traits<8>::sign( _mm256_extractf128_si256( a, 1 ) ), 1 );
+#endif
+	}
+	static PAL_INLINE __m256i cmpeq( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_cmpeq_epi64, _mm_cmpeq_epi64, a, b ); }
+	/// @brief signed a > b
+	static PAL_INLINE __m256i cmpgt( __m256i a, __m256i b ) { return PAL_AVX_INT_BINOP( _mm256_cmpgt_epi64, ivec128_traits<8>::cmpgt, a, b ); }
 	static PAL_INLINE itype access( __m256i a, int idx )
 	{
 #ifdef PAL_HAS_DIRECT_VEC_ACCESS
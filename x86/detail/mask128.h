@@ -70,23 +70,24 @@ template <typename VT> struct mask128_bitops
 #endif
 	}
 
+	static const int full_mask = ( 1 << ( 16 / sizeof(value_type) ) ) - 1;
+
+	/// one bit per element, element 0 in the low bit
 	static PAL_INLINE int which( vec_type m )
 	{
 		// technically, only tests high bit, but meh
-		return _mm_movemask_epi8( m ) != 0;
+		if ( sizeof(value_type) == 1 )
+			return _mm_movemask_epi8( m );
+		if ( sizeof(value_type) == 2 )
+			return _mm_movemask_epi8( _mm_packs_epi16( m, _mm_setzero_si128() ) );
+		if ( sizeof(value_type) == 4 )
+			return _mm_movemask_ps( _mm_castsi128_ps( m ) );
+		return _mm_movemask_pd( _mm_castsi128_pd( m ) );
 	}
 
 	static PAL_INLINE int active_mask( const int i )
 	{
-		if ( sizeof(value_type) == 1 )
-			return 1 << i;
-		if ( sizeof(value_type) == 2 )
-			return 1 << (i*2);
-		if ( sizeof(value_type) == 4 )
-			return 1 << (i*4);
-		if ( sizeof(value_type) == 8 )
-			return 1 << (i*8);
-		return 0x8000;
+		return 1 << i;
 	}
 
 	static PAL_INLINE bool any( vec_type m )
@@ -103,7 +104,7 @@ template <typename VT> struct mask128_bitops
 #ifdef PAL_ENABLE_SSE4_1
 		return _mm_test_all_ones( m ) == 1;
 #else
-		return which( m ) == 0xFFFF;
+		return which( m ) == full_mask;
 #endif
 	}
 
@@ -437,6 +438,47 @@ template <typename T> struct mask128_traits<4,T>
 	}
 };
 
+template <typename T> struct mask128_traits<8,T>
+{
+	static_assert( std::is_integral<T>::value, "Expecting integer type" );
+	using vec_type = __m128i;
+	using bitmask_type = T;
+
+	static const int value_count = 2;
+
+	template <typename V>
+	static PAL_INLINE vec_type splat( V v ) { return _mm_set1_epi64x( static_cast<long long>( v ) ); }
+
+	static PAL_INLINE vec_type init( bool a0, bool a1 )
+	{
+		return _mm_set_epi64x( a1?-1:0, a0?-1:0 );
+	}
+
+	static PAL_INLINE bool access_bool( vec_type v, int i )
+	{
+		return ( ( access_value( v, i ) >> (sizeof(bitmask_type)*8 - 1) ) & 1 ) != 0;
+	}
+
+	static PAL_INLINE bitmask_type access_value( vec_type v, int i )
+	{
+#ifdef PAL_HAS_DIRECT_VEC_ACCESS
+		return static_cast<bitmask_type>( ((__v2di)v)[i] );
+#elif defined(PAL_HAS_UNION_VEC_ACCESS)
+		union 
+		{
+			__m128i vec;
+			bitmask_type vals[value_count];
+		} x;
+		x.vec = v;
+		return x.vals[i];
+#else
+		PAL_ALIGN_128 bitmask_type vals[value_count];
+		_mm_store_si128( reinterpret_cast<__m128i *>( vals ), v );
+		return vals[i];
+#endif
+	}
+};
+
 template <> struct mask128_traits<4,float>
 {
 	using vec_type = __m128;
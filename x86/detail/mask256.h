@@ -34,13 +34,21 @@ template <typename VT> struct mask256_bitops
 		// there is an _mm256_undefined_ps function but not all
 		// compilers have that, so emulate it here
 #ifdef PAL_ENABLE_AVX2
-		__m256i tmp = tmp;
+# if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
+		__m256i tmp = _mm256_setzero_si256();
+# else
+		__m256i tmp = _mm256_undefined_si256();
+# endif
 		return _mm256_cmpeq_epi8( tmp, tmp );
 #else
 		return _mm256_set1_epi8( -1 );
 #endif
 	}
 
+	static PAL_INLINE vec_type from_other( __m256 v ) { return _mm256_castps_si256( v ); }
+	static PAL_INLINE vec_type from_other( __m256d v ) { return _mm256_castpd_si256( v ); }
+	static PAL_INLINE vec_type from_other( __m256i v ) { return v; }
+
 	static PAL_INLINE __m256 as_float( vec_type v ) { return _mm256_castsi256_ps( v ); }
 	static PAL_INLINE __m256d as_double( vec_type v ) { return _mm256_castsi256_pd( v ); }
 	static PAL_INLINE __m256i as_int( vec_type v ) { return v; }
@@ -56,11 +64,17 @@ template <typename VT> struct mask256_bitops
 
 #else
 
-	static PAL_INLINE vec_type apply_and( vec_type a, vec_type b ) { return _mm256_castps_si256( _mm256_or_ps( as_float(a), as_float(b) ) ); }
+	static PAL_INLINE vec_type apply_and( vec_type a, vec_type b ) { return _mm256_castps_si256( _mm256_and_ps( as_float(a), as_float(b) ) ); }
 	static PAL_INLINE vec_type apply_andnot( vec_type a, vec_type b ) { return _mm256_castps_si256( _mm256_andnot_ps( as_float(a), as_float(b) ) ); }
 	static PAL_INLINE vec_type apply_or( vec_type a, vec_type b ) { return _mm256_castps_si256( _mm256_or_ps( as_float(a), as_float(b) ) ); }
 	static PAL_INLINE vec_type apply_xor( vec_type a, vec_type b ) { return _mm256_castps_si256( _mm256_xor_ps( as_float(a), as_float(b) ) ); }
-	static PAL_INLINE vec_type apply_eq( vec_type a, vec_type b ) { return _mm256_castps_si256( _mm256_cmp_ps( as_float(m), as_float(m), _CMP_EQ_OQ ) ); }
+	// no 256-bit integer compare in AVX1, so compare the halves
+	static PAL_INLINE vec_type apply_eq( vec_type a, vec_type b )
+	{
+		return _mm256_insertf128_si256(
+			_mm256_castsi128_si256( _mm_cmpeq_epi8( _mm256_castsi256_si128( a ), _mm256_castsi256_si128( b ) ) ),
+			_mm_cmpeq_epi8( _mm256_extractf128_si256( a, 1 ), _mm256_extractf128_si256( b, 1 ) ), 1 );
+	}
 	// if m returns b else a
 	static PAL_INLINE vec_type blend( vec_type m, vec_type a, vec_type b )
 	{ return _mm256_castps_si256( _mm256_blendv_ps( as_float( a ), as_float( b ), as_float( m ) ) ); }
@@ -70,6 +84,24 @@ template <typename VT> struct mask256_bitops
 		return apply_or( apply_andnot( m, a ), apply_and( m, b ) );
 	}
 
+	/// one bit per element, element 0 in the low bit
+	static PAL_INLINE int which( vec_type m )
+	{
+		if ( sizeof(value_type) == 4 )
+			return _mm256_movemask_ps( _mm256_castsi256_ps( m ) );
+		if ( sizeof(value_type) == 8 )
+			return _mm256_movemask_pd( _mm256_castsi256_pd( m ) );
+		__m128i lo = _mm256_castsi256_si128( m ), hi = _mm256_extractf128_si256( m, 1 );
+		if ( sizeof(value_type) == 2 )
+			return _mm_movemask_epi8( _mm_packs_epi16( lo, hi ) );
+		return _mm_movemask_epi8( lo ) | int( unsigned( _mm_movemask_epi8( hi ) ) << 16 );
+	}
+
+	static PAL_INLINE int active_mask( const int i )
+	{
+		return 1 << i;
+	}
+
 	static PAL_INLINE bool any( vec_type m )
 	{
 		return _mm256_testz_si256( m, m ) == 0;
@@ -77,7 +109,7 @@ template <typename VT> struct mask256_bitops
 
 	static PAL_INLINE bool all( vec_type m )
 	{
-		return _mm256_testc_si256( m, apply_eq( m, m ) );
+		return _mm256_testc_si256( m, yes() ) != 0;
 	}
 
 	static PAL_INLINE bool none( vec_type m )
@@ -91,6 +123,10 @@ template <> struct mask256_bitops<double>
 	typedef double value_type;
 	typedef __m256d vec_type;
 
+	static PAL_INLINE vec_type from_other( __m256 v ) { return _mm256_castps_pd( v ); }
+	static PAL_INLINE vec_type from_other( __m256d v ) { return v; }
+	static PAL_INLINE vec_type from_other( __m256i v ) { return _mm256_castsi256_pd( v ); }
+
 	static PAL_INLINE __m256 as_float( vec_type v ) { return _mm256_castpd_ps( v ); }
 	static PAL_INLINE __m256d as_double( vec_type v ) { return v; }
 	static PAL_INLINE __m256i as_int( vec_type v ) { return _mm256_castpd_si256( v ); }
@@ -103,14 +139,18 @@ template <> struct mask256_bitops<double>
 		// there is an _mm256_undefined_ps function but not all
 		// compilers have that, so emulate it here
 #ifdef PAL_ENABLE_AVX2
-		__m256i tmp = tmp;
+# if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
+		__m256i tmp = _mm256_setzero_si256();
+# else
+		__m256i tmp = _mm256_undefined_si256();
+# endif
 		return _mm256_castsi256_pd( _mm256_cmpeq_epi8( tmp, tmp ) );
 #else
 		return _mm256_castsi256_pd( _mm256_set1_epi8( -1 ) );
 #endif
 	}
 
-	static PAL_INLINE vec_type apply_and( vec_type a, vec_type b ) { return _mm256_or_pd( a, b ); }
+	static PAL_INLINE vec_type apply_and( vec_type a, vec_type b ) { return _mm256_and_pd( a, b ); }
 	static PAL_INLINE vec_type apply_andnot( vec_type a, vec_type b ) { return _mm256_andnot_pd( a, b ); }
 	static PAL_INLINE vec_type apply_or( vec_type a, vec_type b ) { return _mm256_or_pd( a, b ); }
 	static PAL_INLINE vec_type apply_xor( vec_type a, vec_type b ) { return _mm256_xor_pd( a, b ); }
@@ -125,6 +165,16 @@ template <> struct mask256_bitops<double>
 		return _mm256_blendv_pd( a, b, m );
 	}
 
+	static PAL_INLINE int which( vec_type m )
+	{
+		return _mm256_movemask_pd( m );
+	}
+
+	static PAL_INLINE int active_mask( const int i )
+	{
+		return 1 << i;
+	}
+
 	static PAL_INLINE bool any( vec_type m )
 	{
 		return _mm256_testz_pd( m, m ) == 0;
@@ -132,7 +182,9 @@ template <> struct mask256_bitops<double>
 
 	static PAL_INLINE bool all( vec_type m )
 	{
-		return _mm256_testc_pd( m, apply_eq( m, m ) );
+		// comparing with itself would produce NaN != NaN, so
+		// compare against all bits set instead
+		return _mm256_testc_pd( m, yes() ) != 0;
 	}
 
 	static PAL_INLINE bool none( vec_type m )
@@ -146,6 +198,10 @@ template <> struct mask256_bitops<float>
 	typedef float value_type;
 	typedef __m256 vec_type;
 
+	static PAL_INLINE vec_type from_other( __m256 v ) { return v; }
+	static PAL_INLINE vec_type from_other( __m256d v ) { return _mm256_castpd_ps( v ); }
+	static PAL_INLINE vec_type from_other( __m256i v ) { return _mm256_castsi256_ps( v ); }
+
 	static PAL_INLINE __m256 as_float( vec_type v ) { return v; }
 	static PAL_INLINE __m256d as_double( vec_type v ) { return _mm256_castps_pd( v ); }
 	static PAL_INLINE __m256i as_int( vec_type v ) { return _mm256_castps_si256( v ); }
@@ -158,14 +214,18 @@ template <> struct mask256_bitops<float>
 		// there is an _mm256_undefined_ps function but not all
 		// compilers have that, so emulate it here
 #ifdef PAL_ENABLE_AVX2
-		__m256i tmp = tmp;
+# if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
+		__m256i tmp = _mm256_setzero_si256();
+# else
+		__m256i tmp = _mm256_undefined_si256();
+# endif
 		return _mm256_castsi256_ps( _mm256_cmpeq_epi8( tmp, tmp ) );
 #else
 		return _mm256_castsi256_ps( _mm256_set1_epi8( -1 ) );
 #endif
 	}
 
-	static PAL_INLINE vec_type apply_and( vec_type a, vec_type b ) { return _mm256_or_ps( a, b ); }
+	static PAL_INLINE vec_type apply_and( vec_type a, vec_type b ) { return _mm256_and_ps( a, b ); }
 	static PAL_INLINE vec_type apply_andnot( vec_type a, vec_type b ) { return _mm256_andnot_ps( a, b ); }
 	static PAL_INLINE vec_type apply_or( vec_type a, vec_type b ) { return _mm256_or_ps( a, b ); }
 	static PAL_INLINE vec_type apply_xor( vec_type a, vec_type b ) { return _mm256_xor_ps( a, b ); }
@@ -181,6 +241,16 @@ template <> struct mask256_bitops<float>
 	static PAL_INLINE vec_type blend( vec_type m, vec_type a, vec_type b )
 	{ return _mm256_blendv_ps( a, b, m ); }
 
+	static PAL_INLINE int which( vec_type m )
+	{
+		return _mm256_movemask_ps( m );
+	}
+
+	static PAL_INLINE int active_mask( const int i )
+	{
+		return 1 << i;
+	}
+
 	static PAL_INLINE bool any( vec_type m )
 	{
 		return _mm256_testz_ps( m, m ) == 0;
@@ -188,7 +258,9 @@ template <> struct mask256_bitops<float>
 
 	static PAL_INLINE bool all( vec_type m )
 	{
-		return _mm256_testc_ps( m, apply_eq( m, m ) );
+		// comparing with itself would produce NaN != NaN, so
+		// compare against all bits set instead
+		return _mm256_testc_ps( m, yes() ) != 0;
 	}
 
 	static PAL_INLINE bool none( vec_type m )
@@ -345,6 +417,47 @@ template <typename T> struct mask256_traits<4,T>
 	}
 };
 
+template <typename T> struct mask256_traits<8,T>
+{
+	static_assert( std::is_integral<T>::value, "Expecting integer type" );
+	typedef __m256i vec_type;
+	typedef T bitmask_type;
+	static const int value_count = 4;
+
+	template <typename V>
+	static PAL_INLINE vec_type splat( V v )
+	{ return _mm256_set1_epi64x( static_cast<long long>( v ) ); }
+
+	static PAL_INLINE vec_type init( bool b0, bool b1, bool b2, bool b3 )
+	{
+		return _mm256_set_epi64x( b3?-1:0, b2?-1:0, b1?-1:0, b0?-1:0 );
+	}
+
+	static PAL_INLINE bool access_bool( vec_type v, int i )
+	{
+		return ( ( access_value( v, i ) >> (sizeof(bitmask_type)*8 - 1) ) & 1 ) != 0;
+	}
+
+	static PAL_INLINE bitmask_type access_value( vec_type v, int i )
+	{
+#ifdef PAL_HAS_DIRECT_VEC_ACCESS
+		return static_cast<bitmask_type>( ((__v4di)v)[i] );
+#elif defined(PAL_HAS_UNION_VEC_ACCESS)
+		union 
+		{
+			__m256i vec;
+			bitmask_type vals[value_count];
+		} x;
+		x.vec = v;
+		return x.vals[i];
+#else
+		PAL_ALIGN_256 bitmask_type vals[value_count];
+		_mm256_store_si256( reinterpret_cast<__m256i *>( vals ), v );
+		return vals[i];
+#endif
+	}
+};
+
 template <> struct mask256_traits<4,float>
 {
 	typedef __m256 vec_type;
@@ -41,6 +41,9 @@ public:
 	/// @}
 
 	explicit PAL_INLINE dvec2( value_type v ) : _vec( _mm_set1_pd( v ) ) {}
+	explicit PAL_INLINE dvec2( bitmask_type v )
+		: _vec( _mm_castsi128_pd( _mm_set1_epi64x( static_cast<long long>(v) ) ) )
+	{}
 	PAL_INLINE dvec2( value_type v0, value_type v1 ) : _vec( _mm_set_pd( v1, v0 ) ) {}
 	PAL_INLINE dvec2( __m128d v ) : _vec( v ) {}
 
@@ -123,6 +126,12 @@ private:
 	__m128d _vec;
 };
 
+inline std::ostream &operator<<( std::ostream &os, dvec2 v )
+{
+	os << "{ " << v[0] << ", " << v[1] << " }";
+	return os;
+}
+
 // see all the operators defined in sse_dvec_operators.h
 
 /// @brief declare a specialization of vector_limits for dvec2
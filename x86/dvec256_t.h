@@ -41,6 +41,9 @@ public:
 	/// @}
 
 	explicit PAL_INLINE dvec4( value_type v ) : _vec( _mm256_set1_pd( v ) ) {}
+	explicit PAL_INLINE dvec4( bitmask_type v )
+		: _vec( _mm256_castsi256_pd( _mm256_set1_epi64x( static_cast<long long>(v) ) ) )
+	{}
 	PAL_INLINE dvec4( value_type v0, value_type v1, value_type v2, value_type v3 ) : _vec( _mm256_set_pd( v3, v2, v1, v0 ) ) {}
 	explicit PAL_INLINE dvec4( __m256d v ) : _vec( v ) {}
 	PAL_INLINE dvec4( mask_type v ) : _vec( v ) {}
@@ -123,6 +126,12 @@ private:
 	__m256d _vec;
 };
 
+inline std::ostream &operator<<( std::ostream &os, dvec4 v )
+{
+	os << "{ " << v[0] << ", " << v[1] << ", " << v[2] << ", " << v[3] << " }";
+	return os;
+}
+
 // see all the operators defined in sse_dvec_operators.h
 
 /// @brief declare a specialization of vector_limits for dvec4
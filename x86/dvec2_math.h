@@ -0,0 +1,57 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use <pal/x86/dvec2_math.h> directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_X86_SSE_DVEC2_MATH_H_
+# define _PAL_X86_SSE_DVEC2_MATH_H_ 1
+
+namespace PAL_NAMESPACE
+{
+
+/// @brief return the max of the 2 numbers. if one is NaN, return the other?
+PAL_INLINE dvec2 max( dvec2 a, dvec2 b ) { return dvec2( _mm_max_pd( a, b ) ); }
+/// @brief return the min of the 2 numbers. if one is NaN, return the other?
+PAL_INLINE dvec2 min( dvec2 a, dvec2 b ) { return dvec2( _mm_min_pd( a, b ) ); }
+
+/// @brief clears the sign bit of all values
+PAL_INLINE dvec2 fabs( dvec2 v )
+{
+	return v & int_constants<dvec2>::nonsign_bitmask();
+}
+
+/// @brief create a mask for any values that are NaN
+PAL_INLINE dvec2::mask_type isnan( dvec2 v )
+{
+	return dvec2::mask_type( _mm_cmpunord_pd( v, v ) );
+}
+
+/// @brief create a mask for any values that are NOT NaN or inf
+PAL_INLINE dvec2::mask_type isfinite( dvec2 v )
+{
+	return dvec2::mask_type( _mm_cmpord_pd( v, _mm_mul_pd( _mm_setzero_pd(), v ) ) );
+}
+
+/// @brief create a mask for any values that infinite
+PAL_INLINE dvec2::mask_type isinf( dvec2 v )
+{
+	return dvec2::mask_type( _mm_and_pd(
+								 _mm_cmpord_pd( v, v ),
+								 _mm_cmpunord_pd( v, _mm_mul_pd( _mm_setzero_pd(), v ) ) ) );
+}
+
+/// @brief computes the sqrt of all values
+PAL_INLINE dvec2 sqrt( dvec2 a )
+{
+	return dvec2( _mm_sqrt_pd( a ) );
+}
+
+} // namespace pal
+
+#endif // _PAL_X86_SSE_DVEC2_MATH_H_
@@ -127,6 +127,38 @@ PAL_INLINE dvec2::mask_type operator>=( dvec2 a, dvec2 b )
 	return dvec2::mask_type( _mm_cmpge_pd( a, b ) );
 }
 
+////////////////////////////////////////
+
+/// @brief apply a * b + c
+PAL_INLINE dvec2 fma( dvec2 a, dvec2 b, dvec2 c )
+{
+#ifdef PAL_ENABLE_FMA_EXT
+	return dvec2( _mm_fmadd_pd( a, b, c ) );
+#else
+	return dvec2( _mm_add_pd( _mm_mul_pd( a, b ), c ) );
+#endif
+}
+
+/// @brief apply a * b - c
+PAL_INLINE dvec2 fms( dvec2 a, dvec2 b, dvec2 c )
+{
+#ifdef PAL_ENABLE_FMA_EXT
+	return dvec2( _mm_fmsub_pd( a, b, c ) );
+#else
+	return dvec2( _mm_sub_pd( _mm_mul_pd( a, b ), c ) );
+#endif
+}
+
+/// @brief apply -( a * b ) + c
+PAL_INLINE dvec2 nmadd( dvec2 a, dvec2 b, dvec2 c )
+{
+#ifdef PAL_ENABLE_FMA_EXT
+	return dvec2( _mm_fnmadd_pd( a, b, c ) );
+#else
+	return dvec2( _mm_sub_pd( c, _mm_mul_pd( a, b ) ) );
+#endif
+}
+
 } // namespace pal
 
 #endif // _PAL_X86_DVEC2_OPERATORS_H_
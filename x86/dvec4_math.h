@@ -0,0 +1,61 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use <pal/x86/dvec4_math.h> directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_X86_SSE_DVEC4_MATH_H_
+# define _PAL_X86_SSE_DVEC4_MATH_H_ 1
+
+# ifdef PAL_HAS_DVEC4
+
+namespace PAL_NAMESPACE
+{
+
+/// @brief return the max of the 2 numbers. if one is NaN, return the other?
+PAL_INLINE dvec4 max( dvec4 a, dvec4 b ) { return dvec4( _mm256_max_pd( a, b ) ); }
+/// @brief return the min of the 2 numbers. if one is NaN, return the other?
+PAL_INLINE dvec4 min( dvec4 a, dvec4 b ) { return dvec4( _mm256_min_pd( a, b ) ); }
+
+/// @brief clears the sign bit of all values
+PAL_INLINE dvec4 fabs( dvec4 v )
+{
+	return v & int_constants<dvec4>::nonsign_bitmask();
+}
+
+/// @brief create a mask for any values that are NaN
+PAL_INLINE dvec4::mask_type isnan( dvec4 v )
+{
+	return dvec4::mask_type( _mm256_cmp_pd( v, v, _CMP_UNORD_Q ) );
+}
+
+/// @brief create a mask for any values that are NOT NaN or inf
+PAL_INLINE dvec4::mask_type isfinite( dvec4 v )
+{
+	return dvec4::mask_type( _mm256_cmp_pd( v, _mm256_mul_pd( _mm256_setzero_pd(), v ), _CMP_ORD_Q ) );
+}
+
+/// @brief create a mask for any values that infinite
+PAL_INLINE dvec4::mask_type isinf( dvec4 v )
+{
+	return dvec4::mask_type( _mm256_and_pd(
+								 _mm256_cmp_pd( v, v, _CMP_ORD_Q ),
+								 _mm256_cmp_pd( v, _mm256_mul_pd( _mm256_setzero_pd(), v ), _CMP_UNORD_Q ) ) );
+}
+
+/// @brief computes the sqrt of all values
+PAL_INLINE dvec4 sqrt( dvec4 a )
+{
+	return dvec4( _mm256_sqrt_pd( a ) );
+}
+
+} // namespace pal
+
+# endif // PAL_HAS_DVEC4
+
+#endif // _PAL_X86_SSE_DVEC4_MATH_H_
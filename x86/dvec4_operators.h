@@ -129,6 +129,38 @@ PAL_INLINE dvec4::mask_type operator>=( dvec4 a, dvec4 b )
 	return dvec4::mask_type( _mm256_cmp_pd( a, b, _CMP_GE_OQ ) );
 }
 
+////////////////////////////////////////
+
+/// @brief apply a * b + c
+PAL_INLINE dvec4 fma( dvec4 a, dvec4 b, dvec4 c )
+{
+#ifdef PAL_ENABLE_FMA_EXT
+	return dvec4( _mm256_fmadd_pd( a, b, c ) );
+#else
+	return dvec4( _mm256_add_pd( _mm256_mul_pd( a, b ), c ) );
+#endif
+}
+
+/// @brief apply a * b - c
+PAL_INLINE dvec4 fms( dvec4 a, dvec4 b, dvec4 c )
+{
+#ifdef PAL_ENABLE_FMA_EXT
+	return dvec4( _mm256_fmsub_pd( a, b, c ) );
+#else
+	return dvec4( _mm256_sub_pd( _mm256_mul_pd( a, b ), c ) );
+#endif
+}
+
+/// @brief apply -( a * b ) + c
+PAL_INLINE dvec4 nmadd( dvec4 a, dvec4 b, dvec4 c )
+{
+#ifdef PAL_ENABLE_FMA_EXT
+	return dvec4( _mm256_fnmadd_pd( a, b, c ) );
+#else
+	return dvec4( _mm256_sub_pd( c, _mm256_mul_pd( a, b ) ) );
+#endif
+}
+
 } // namespace pal
 
 #endif // AVX
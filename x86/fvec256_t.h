@@ -83,8 +83,25 @@ public:
 	/// @brief enable transparent calls to intrinsic functions
 	PAL_INLINE operator __m256( void ) const { return _vec; }
 	PAL_INLINE int_vec_type as_int( void ) const { return int_vec_type( _mm256_castps_si256( _vec ) ); }
+	PAL_INLINE __m256 as_float( void ) const { return _vec; }
+	PAL_INLINE __m256d as_double( void ) const { return _mm256_castps_pd( _vec ); }
 
 	PAL_INLINE fvec8 &operator=( float v ) { _vec = _mm256_set1_ps( v ); return *this; }
+	PAL_INLINE fvec8 &operator=( __m256 x ) { _vec = x; return *this; }
+
+	template <int i>
+	void set( value_type v )
+	{
+		static_assert( i >= 0 && i < 8, "invalid index for fvec8" );
+		_vec = _mm256_blend_ps( _vec, _mm256_set1_ps( v ), 1 << i );
+	}
+
+	template <int i>
+	value_type get() const
+	{
+		static_assert( i >= 0 && i < 8, "invalid index for fvec8" );
+		return (*this)[i];
+	}
 
 	PAL_INLINE float operator[]( int i ) const
 	{
@@ -147,6 +164,9 @@ public:
 		return *this;
 	}
 
+	PAL_INLINE int_vec_type convert_to_int( void ) const { return int_vec_type( _mm256_cvtps_epi32( _vec ) ); }
+	PAL_INLINE int_vec_type convert_to_int_trunc( void ) const { return int_vec_type( _mm256_cvttps_epi32( _vec ) ); }
+
 	static PAL_INLINE fvec8 zero( void ) { return fvec8( _mm256_setzero_ps() ); }
 	static PAL_INLINE fvec8 splat( float v ) { return fvec8( _mm256_set1_ps( v ) ); }
 
@@ -155,6 +175,13 @@ private:
 	__m256 _vec;
 };
 
+inline std::ostream &operator<<( std::ostream &os, fvec8 v )
+{
+	os << "{ " << v[0] << ", " << v[1] << ", " << v[2] << ", " << v[3]
+	   << ", " << v[4] << ", " << v[5] << ", " << v[6] << ", " << v[7] << " }";
+	return os;
+}
+
 // see all the operators defined in sse_fvec_operators.h
 
 /// @brief declare a specialization of vector_limits for fvec8
@@ -164,12 +164,10 @@ PAL_INLINE fvec4 fast_recip( fvec4 v )
 	// or 2-3 instructions and a constant
 	//     e * ( 2 - v * e )
 	//       1     1   1
-	// let's assume that the version with no constant
-	// is actually best since it saves a register?
-	// and on machines with FMA, it goes down to 3 instr
-	return nmadd( v, e * e, e + e );
-//	static const fvec4 two( 2.F );
-//	return nmadd( e, v, two ) * e;
+	// the version with no constant saves a register, but e * e
+	// overflows for small v (and underflows for large v), so take
+	// the extra constant
+	return nmadd( e, v, float_constants<fvec4>::two() ) * e;
 }
 
 /// @brief computes reciprocal 1/v for each value
@@ -104,9 +104,9 @@ PAL_INLINE fvec8 faster_recip( fvec8 v )
 PAL_INLINE fvec8 fast_recip( fvec8 v )
 {
 	fvec8 e = fvec8( _mm256_rcp_ps( v ) );
-	// see the logic path in recip for fvec4 
+	// see the logic path in recip for fvec4
 	// one round of newton-raphson refinement
-	return nmadd( v, e * e, e + e );
+	return nmadd( e, v, float_constants<fvec8>::two() ) * e;
 }
 
 /// @brief return the reciprocal (1 / v) of each value
@@ -164,18 +164,7 @@ PAL_INLINE fvec8::mask_type isinf( fvec8 v )
 /// match the C library
 PAL_INLINE lvec8 signbit( fvec8 v )
 {
-#ifdef PAL_ENABLE_AVX2
-	return lvec8( _mm256_srli_epi32( _mm256_castps_si256( v ), 31 ) );
-#else
-	return lvec8( _mm256_and_epi32(
-					  _mm256_cmp_ps(
-						  _mm256_and_ps(
-							  v,
-							  _mm256_set1_epi32( int(0x80000000) ) ),
-						  _mm256_set1_epi32( int(0x80000000) ),
-						  _CMP_EQ_OQ ),
-					  _mm256_set1_epi32( 1 ) ) );
-#endif
+	return lsr( v.as_int(), 31 );
 }
 
 /// @brief should be the same as a single float fabsf
@@ -183,11 +172,9 @@ PAL_INLINE lvec8 signbit( fvec8 v )
 /// NaN behavior? NaNs have a sign, but...
 PAL_INLINE fvec8 fabsf( fvec8 v )
 {
-#ifdef PAL_ENABLE_AVX2
-	return fvec8( _mm256_castsi256_ps( _mm256_abs_epi32( v.as_int() ) ) );
-#else
-	return fvec8( _mm256_and_ps( v, lvec8_constants::nonsign_bitmask().as_float() ) );
-#endif
+	// NB: an integer abs of the bits is not the same as clearing
+	// the sign bit
+	return fvec8( _mm256_and_ps( v, int_constants<lvec8>::nonsign_bitmask().as_float() ) );
 }
 
 PAL_INLINE fvec8 sqrtf( fvec8 a )
@@ -106,16 +106,40 @@ PAL_INLINE fvec8 operator&( fvec8 a, fvec8 b )
 {
 	return fvec8( _mm256_and_ps( a, b ) );
 }
+PAL_INLINE fvec8 operator&( fvec8::mask_type a, fvec8 b )
+{
+	return fvec8( _mm256_and_ps( a, b ) );
+}
+PAL_INLINE fvec8 operator&( fvec8 a, fvec8::mask_type b )
+{
+	return fvec8( _mm256_and_ps( a, b ) );
+}
 
 PAL_INLINE fvec8 operator|( fvec8 a, fvec8 b )
 {
 	return fvec8( _mm256_or_ps( a, b ) );
 }
+PAL_INLINE fvec8 operator|( fvec8::mask_type a, fvec8 b )
+{
+	return fvec8( _mm256_or_ps( a, b ) );
+}
+PAL_INLINE fvec8 operator|( fvec8 a, fvec8::mask_type b )
+{
+	return fvec8( _mm256_or_ps( a, b ) );
+}
 
 PAL_INLINE fvec8 operator^( fvec8 a, fvec8 b )
 {
 	return fvec8( _mm256_xor_ps( a, b ) );
 }
+PAL_INLINE fvec8 operator^( fvec8::mask_type a, fvec8 b )
+{
+	return fvec8( _mm256_xor_ps( a, b ) );
+}
+PAL_INLINE fvec8 operator^( fvec8 a, fvec8::mask_type b )
+{
+	return fvec8( _mm256_xor_ps( a, b ) );
+}
 
 ////////////////////////////////////////
 // Comparison operators
@@ -20,6 +20,8 @@
 namespace PAL_NAMESPACE
 {
 
+# define PAL_HAS_IVEC128 1
+
 /// @brief base integer templated class
 ///
 /// This is the basic implementation of all the integer vector
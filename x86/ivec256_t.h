@@ -22,6 +22,8 @@
 namespace PAL_NAMESPACE
 {
 
+# define PAL_HAS_IVEC256 1
+
 /// @brief base integer templated class
 ///
 /// This is the basic implementation of all the integer vector
@@ -65,6 +67,9 @@ public:
 	}
 
 	PAL_INLINE ivec256( __m256i x ) : _vec( x ) {}
+
+	template <typename O>
+	PAL_INLINE ivec256( const ivec256<O> &o ) : _vec( static_cast<__m256i>( o ) ) {}
 	template <typename I>
 	PAL_INLINE ivec256 &operator=( I x )
 	{
@@ -82,7 +87,7 @@ public:
 	PAL_INLINE __m256 as_float( void ) const { return _mm256_castsi256_ps( _vec ); }
 	PAL_INLINE __m256d as_double( void ) const { return _mm256_castsi256_pd( _vec ); }
 
-	PAL_INLINE float operator[]( int i ) const
+	PAL_INLINE value_type operator[]( int i ) const
 	{
 		return manip_traits::access( _vec, i );
 	}
@@ -95,6 +100,10 @@ public:
 			_vec = manip_traits::addu( _vec, a );
 		return *this;
 	}
+	PAL_INLINE ivec256 &operator+=( value_type a )
+	{
+		return ( *this += ivec256( a ) );
+	}
 	PAL_INLINE ivec256 &operator-=( ivec256 a )
 	{
 		if ( std::is_signed<value_type>::value )
@@ -103,6 +112,20 @@ public:
 			_vec = manip_traits::subu( _vec, a );
 		return *this;
 	}
+	PAL_INLINE ivec256 &operator-=( value_type a )
+	{
+		return ( *this -= ivec256( a ) );
+	}
+	PAL_INLINE ivec256 &operator*=( ivec256 a )
+	{
+		_vec = manip_traits::mul( _vec, a );
+		return *this;
+	}
+	PAL_INLINE ivec256 &operator*=( value_type a )
+	{
+		_vec = manip_traits::mul( _vec, ivec256( a ) );
+		return *this;
+	}
 
 	/// @brief factory to create a zero-initialized value
 	static PAL_INLINE ivec256 zero( void ) { return ivec256( _mm256_setzero_si256() ); }
@@ -116,6 +139,20 @@ private:
 	__m256i _vec;
 };
 
+template <typename T>
+std::ostream &operator<<( std::ostream &os, ivec256<T> v )
+{
+	os << "{ ";
+	for ( int i = 0; i < ivec256<T>::value_count; ++i )
+	{
+		if ( i > 0 )
+			os << ", ";
+		os << v[i];
+	}
+	os << " }";
+	return os;
+}
+
 typedef ivec256<int8_t> cvec32;
 typedef ivec256<uint8_t> ucvec32;
 typedef ivec256<int16_t> svec16;
@@ -39,6 +39,19 @@ PAL_INLINE lvec4 min( lvec4 a, lvec4 b )
 #endif
 }
 
+/// @brief return the absolute value of each number
+///
+/// NB: like the C library, abs of the most negative number is itself
+PAL_INLINE lvec4 abs( lvec4 a )
+{
+#ifdef PAL_ENABLE_SSSE3
+	return lvec4( _mm_abs_epi32( a ) );
+#else
+	lvec4 s = a >> 31;
+	return ( a ^ s ) - s;
+#endif
+}
+
 } // namespace pal
 
 #endif // _PAL_X86_LVEC4_MATH_H_
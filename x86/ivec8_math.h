@@ -0,0 +1,50 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use <pal/x86/ivec8_math.h> directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_X86_LVEC8_MATH_H_
+# define _PAL_X86_LVEC8_MATH_H_ 1
+
+#ifdef PAL_ENABLE_AVX
+
+namespace PAL_NAMESPACE
+{
+
+/// @brief return the max of the 2 numbers
+PAL_INLINE lvec8 max( lvec8 a, lvec8 b )
+{
+	return lvec8( PAL_AVX_INT_BINOP( _mm256_max_epi32, _mm_max_epi32, a, b ) );
+}
+
+/// @brief return the min of the 2 numbers
+PAL_INLINE lvec8 min( lvec8 a, lvec8 b )
+{
+	return lvec8( PAL_AVX_INT_BINOP( _mm256_min_epi32, _mm_min_epi32, a, b ) );
+}
+
+/// @brief return the absolute value of each number
+///
+/// NB: like the C library, abs of the most negative number is itself
+PAL_INLINE lvec8 abs( lvec8 a )
+{
+#ifdef PAL_ENABLE_AVX2
+	return lvec8( _mm256_abs_epi32( a ) );
+#else
+	return lvec8( _mm256_insertf128_si256(
+					  _mm256_castsi128_si256( _mm_abs_epi32( _mm256_castsi256_si128( a ) ) ),
+					  _mm_abs_epi32( _mm256_extractf128_si256( a, 1 ) ), 1 ) );
+#endif
+}
+
+} // namespace pal
+
+#endif // PAL_ENABLE_AVX
+
+#endif // _PAL_X86_LVEC8_MATH_H_
@@ -23,11 +23,8 @@ namespace PAL_NAMESPACE
 PAL_INLINE lvec8 operator+( lvec8 a ) { return a; }
 PAL_INLINE lvec8 operator-( lvec8 a )
 {
-#ifdef PAL_ENABLE_AVX2
-	return lvec8( _mm256_xor_si256( a, int_constants<lvec8>::sign_bitmask() ) );
-#else
-	return lvec8( _mm256_castps_si256( _mm256_xor_ps( a.as_float(), int_constants<lvec8>::sign_bitmask().as_float() ) ) );
-#endif
+	// two's complement, flipping the sign bit is not a negate
+	return lvec8( PAL_AVX_INT_BINOP( _mm256_sub_epi32, _mm_sub_epi32, lvec8::zero(), a ) );
 }
 PAL_INLINE lvec8 operator~( lvec8 a )
 {
@@ -68,13 +65,111 @@ PAL_INLINE lvec8 &operator--( lvec8 &a )
 	return a;
 }
 
+PAL_INLINE lvec8 operator+( lvec8 a, lvec8 b )
+{
+	a += b; return a;
+}
+PAL_INLINE lvec8 operator+( lvec8 a, int32_t b )
+{
+	a += b; return a;
+}
+PAL_INLINE lvec8 operator+( int32_t a, lvec8 b )
+{
+	b += a; return b;
+}
+
+PAL_INLINE lvec8 operator-( lvec8 a, lvec8 b )
+{
+	a -= b; return a;
+}
+PAL_INLINE lvec8 operator-( lvec8 a, int32_t b )
+{
+	a -= b; return a;
+}
+PAL_INLINE lvec8 operator-( int32_t a, lvec8 b )
+{
+	lvec8 r( a );
+	r -= b; return r;
+}
+
+PAL_INLINE lvec8 operator*( lvec8 a, lvec8 b )
+{
+	a *= b; return a;
+}
+PAL_INLINE lvec8 operator*( lvec8 a, int32_t b )
+{
+	a *= b; return a;
+}
+PAL_INLINE lvec8 operator*( int32_t a, lvec8 b )
+{
+	lvec8 r( a );
+	r *= b; return r;
+}
+
 ////////////////////////////////////////
 // Binary operators
 
 #ifdef PAL_ENABLE_AVX2
+# define PAL_LVEC8_BITOP( op, a, b ) lvec8( _mm256_##op##_si256( a, b ) )
+#else
+# define PAL_LVEC8_BITOP( op, a, b ) lvec8( _mm256_castps_si256( _mm256_##op##_ps( _mm256_castsi256_ps( a ), _mm256_castsi256_ps( b ) ) ) )
+#endif
+
+PAL_INLINE lvec8 operator&( lvec8 a, lvec8 b )
+{
+	return PAL_LVEC8_BITOP( and, a, b );
+}
+PAL_INLINE lvec8 operator&( lvec8::mask_type a, lvec8 b )
+{
+	return PAL_LVEC8_BITOP( and, a, b );
+}
+PAL_INLINE lvec8 operator&( lvec8 a, lvec8::mask_type b )
+{
+	return PAL_LVEC8_BITOP( and, a, b );
+}
+
+PAL_INLINE lvec8 operator|( lvec8 a, lvec8 b )
+{
+	return PAL_LVEC8_BITOP( or, a, b );
+}
+PAL_INLINE lvec8 operator|( lvec8::mask_type a, lvec8 b )
+{
+	return PAL_LVEC8_BITOP( or, a, b );
+}
+PAL_INLINE lvec8 operator|( lvec8 a, lvec8::mask_type b )
+{
+	return PAL_LVEC8_BITOP( or, a, b );
+}
+
+PAL_INLINE lvec8 operator^( lvec8 a, lvec8 b )
+{
+	return PAL_LVEC8_BITOP( xor, a, b );
+}
+PAL_INLINE lvec8 operator^( lvec8::mask_type a, lvec8 b )
+{
+	return PAL_LVEC8_BITOP( xor, a, b );
+}
+PAL_INLINE lvec8 operator^( lvec8 a, lvec8::mask_type b )
+{
+	return PAL_LVEC8_BITOP( xor, a, b );
+}
+
+#undef PAL_LVEC8_BITOP
+
+////////////////////////////////////////
+
+#ifdef PAL_ENABLE_AVX2
+# define PAL_LVEC8_SHIFTOP( op, a, amt ) lvec8( _mm256_##op##_epi32( a, amt ) )
+#else
+# define PAL_LVEC8_SHIFTOP( op, a, amt )								\
+	lvec8( _mm256_insertf128_si256(										\
+			   _mm256_castsi128_si256( _mm_##op##_epi32( _mm256_castsi256_si128( a ), amt ) ), \
+			   _mm_##op##_epi32( _mm256_extractf128_si256( a, 1 ), amt ), 1 ) )
+#endif
+
 PAL_INLINE lvec8 operator<<( lvec8 a, int32_t amt )
 {
-	return lvec8( _mm256_sll_epi32( a, _mm_cvtsi32_si128( amt ) ) );
+	return PAL_LVEC8_SHIFTOP( sll, a, _mm_cvtsi32_si128( amt ) );
 }
 PAL_INLINE lvec8 &operator<<=( lvec8 &a, int32_t amt )
 {
@@ -84,7 +179,7 @@ PAL_INLINE lvec8 &operator<<=( lvec8 &a, int32_t amt )
 
 PAL_INLINE lvec8 operator>>( lvec8 a, int32_t amt )
 {
-	return lvec8( _mm256_sra_epi32( a, _mm_cvtsi32_si128( amt ) ) );
+	return PAL_LVEC8_SHIFTOP( sra, a, _mm_cvtsi32_si128( amt ) );
 }
 PAL_INLINE lvec8 &operator>>=( lvec8 &a, int32_t amt )
 {
@@ -94,37 +189,38 @@ PAL_INLINE lvec8 &operator>>=( lvec8 &a, int32_t amt )
 
 PAL_INLINE lvec8 lsr( lvec8 a, int s )
 {
-	return _mm256_srli_epi32( a, s );
+	return PAL_LVEC8_SHIFTOP( srl, a, _mm_cvtsi32_si128( s ) );
 }
 
+#undef PAL_LVEC8_SHIFTOP
+
 ////////////////////////////////////////
 // Comparison operators
 
 PAL_INLINE lvec8::mask_type operator==( lvec8 a, lvec8 b )
 {
-	return lvec8::mask_type( _mm256_cmpeq_epi32( a, b ) );
+	return lvec8::mask_type( PAL_AVX_INT_BINOP( _mm256_cmpeq_epi32, _mm_cmpeq_epi32, a, b ) );
 }
 PAL_INLINE lvec8::mask_type operator<( lvec8 a, lvec8 b )
 {
-	return lvec8::mask_type( _mm256_cmpgt_epi32( b, a ) );
+	return lvec8::mask_type( PAL_AVX_INT_BINOP( _mm256_cmpgt_epi32, _mm_cmpgt_epi32, b, a ) );
 }
 PAL_INLINE lvec8::mask_type operator>( lvec8 a, lvec8 b )
 {
-	return lvec8::mask_type( _mm256_cmpgt_epi32( a, b ) );
+	return lvec8::mask_type( PAL_AVX_INT_BINOP( _mm256_cmpgt_epi32, _mm_cmpgt_epi32, a, b ) );
 }
 PAL_INLINE lvec8::mask_type operator<=( lvec8 a, lvec8 b )
 {
-	return a < b || a == b;
+	return ! ( a > b );
 }
 PAL_INLINE lvec8::mask_type operator!=( lvec8 a, lvec8 b )
 {
-	return a < b || a > b;
+	return ! ( a == b );
 }
 PAL_INLINE lvec8::mask_type operator>=( lvec8 a, lvec8 b )
 {
-	return ( a > b || a == b );
+	return ! ( a < b );
 }
-#endif // PAL_ENABLE_AVX2
 
 } // namespace pal
 
@@ -0,0 +1,345 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use <pal/x86/ivec_divide.h> directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_X86_IVEC_DIVIDE_H_
+# define _PAL_X86_IVEC_DIVIDE_H_ 1
+
+// divide is ... annoying, there is no integer divide instruction, so
+// this is the multiply by a magic number approach (granlund /
+// montgomery, see also hacker's delight, chapter 10)
+
+namespace PAL_NAMESPACE
+{
+
+namespace detail
+{
+
+// ceil(log2(d)) - 1 == (bitscan(d-1)+1)-1
+constexpr inline int32_t bit_scan( const uint32_t d )
+{
+	return (d >= 16) ? 4 + bit_scan( d >> 4 ) :
+		( ( d < 2 ) ? 0 : ( ( d < 4 ) ? 1 : ( d < 8 ) ? 2 : 3 ) );
+}
+constexpr inline int32_t compute_int_shift( const uint32_t d )
+{
+	return bit_scan( d - 1 );
+}
+
+PAL_INLINE constexpr int32_t compute_const_int_mul( int32_t sh, const uint32_t d )
+{
+	return int32_t(1 + (uint64_t(1) << (32+sh)) / uint32_t(d) - (int64_t(1) << 32));
+}
+
+PAL_INLINE constexpr int32_t compute_int_shift_abs( int32_t d )
+{
+	return ( ( d > 1 ) ? bit_scan( d - 1 ) : ( uint32_t(d) == 0x80000000 ) ? 30 : 0 );
+}
+
+PAL_INLINE constexpr int32_t compute_int_shift( int32_t d )
+{
+	return d < 0 ? compute_int_shift_abs( -d ) : compute_int_shift_abs( d );
+}
+
+PAL_INLINE constexpr int32_t compute_int_mul_abs( int32_t d )
+{
+	return ( ( d > 1 ) ? int32_t( ( ( int64_t(1) << ( 32 + compute_int_shift( d ) ) ) / d - ( ( int64_t(1) << 32 ) - 1 ) ) ) : int32_t( uint32_t(d) == 0x80000000 ? 0x80000001 : 1 ) );
+}
+
+PAL_INLINE constexpr int32_t compute_int_mul( int32_t d )
+{
+	return ( d < 0 ) ? compute_int_mul_abs( -d ) : compute_int_mul_abs( d );
+}
+
+/// @brief number of significant bits in v
+template <typename U>
+inline int div_bit_length( U v )
+{
+	int r = 0;
+	for ( ; v != 0; v = U( v >> 1 ) )
+		++r;
+	return r;
+}
+
+/// @brief floor( hi * 2^W / d ) modulo 2^W, where W is the bit
+/// width of U and hi < d
+///
+/// simple shift / subtract long division, as there isn't always a
+/// type twice as wide as U
+template <typename U>
+inline U div_wide( U hi, U d )
+{
+	const int W = int( sizeof(U) * 8 );
+	U r = hi, q = 0;
+	for ( int i = 0; i != W; ++i )
+	{
+		bool carry = ( r >> ( W - 1 ) ) != 0;
+		r = U( r << 1 );
+		q = U( q << 1 );
+		if ( carry || r >= d )
+		{
+			r = U( r - d );
+			q = U( q | 1 );
+		}
+	}
+	return q;
+}
+
+PAL_INLINE __m128i div_xor( __m128i a, __m128i b ) { return _mm_xor_si128( a, b ); }
+#ifdef PAL_ENABLE_AVX
+PAL_INLINE __m256i div_xor( __m256i a, __m256i b )
+{
+# ifdef PAL_ENABLE_AVX2
+	return _mm256_xor_si256( a, b );
+# else
+	return _mm256_castps_si256( _mm256_xor_ps( _mm256_castsi256_ps( a ), _mm256_castsi256_ps( b ) ) );
+# endif
+}
+#endif
+
+} // namespace detail
+
+////////////////////////////////////////
+
+/// @brief precomputed divisor for dividing integer vectors by a
+/// runtime invariant value
+///
+/// Construction does the (scalar) work of finding the magic multiplier
+/// and shifts, so construct it once outside the loop; the divide is
+/// then a high multiply, a few adds and shifts. Works for 16, 32 and
+/// 64-bit element types, with ivec128 or ivec256 of the same element
+/// type. Results truncate towards zero, the same as the scalar divide.
+/// The 64-bit high multiply is emulated with 32-bit multiplies, so is
+/// noticeably slower than the narrower types.
+template <typename T>
+class divisor
+{
+	static_assert( std::is_integral<T>::value && sizeof(T) >= 2 && sizeof(T) <= 8,
+				   "divisor is only implemented for 16, 32 and 64-bit integers" );
+	using utype = typename std::make_unsigned<T>::type;
+	using traits128 = detail::ivec128_traits<sizeof(T)>;
+	using itype = typename traits128::itype;
+#ifdef PAL_ENABLE_AVX
+	using traits256 = detail::ivec256_traits<sizeof(T)>;
+	using reg_type = __m256i;
+#else
+	using reg_type = __m128i;
+#endif
+	static const int bits = int( sizeof(T) * 8 );
+
+public:
+	using value_type = T;
+
+	/// @brief d must not be 0
+	PAL_INLINE divisor( T d )
+	{
+		init( d, std::is_signed<T>() );
+	}
+
+	/// @brief directly provide the (signed) magic number values, the
+	/// shift, the multiplier, and the sign (0 or -1) of the divisor,
+	/// see divide_by_const
+	template <typename U = T, typename = typename std::enable_if<std::is_signed<U>::value>::type>
+	PAL_INLINE divisor( int shift, T mul, T sign )
+		: _mul( splat( mul ) ), _sign( splat( sign ) ),
+		  _preshift( _mm_setzero_si128() ), _shift( _mm_cvtsi32_si128( shift ) )
+	{}
+
+	PAL_INLINE __m128i operator()( __m128i a ) const
+	{
+		return apply<traits128>( a, get128( _mul ), get128( _sign ), std::is_signed<T>() );
+	}
+
+#ifdef PAL_ENABLE_AVX
+	PAL_INLINE __m256i operator()( __m256i a ) const
+	{
+		return apply<traits256>( a, _mul, _sign, std::is_signed<T>() );
+	}
+#endif
+
+private:
+	static PAL_INLINE reg_type splat( T v )
+	{
+#ifdef PAL_ENABLE_AVX
+		return traits256::splat( static_cast<itype>( v ) );
+#else
+		return traits128::splat( static_cast<itype>( v ) );
+#endif
+	}
+	static PAL_INLINE __m128i get128( reg_type v )
+	{
+#ifdef PAL_ENABLE_AVX
+		return _mm256_castsi256_si128( v );
+#else
+		return v;
+#endif
+	}
+
+	// signed: q = sra( mulhi( n, m ) + n, s ) - sign( n ), then negated
+	// if the divisor is negative
+	inline void init( T d, std::true_type )
+	{
+		utype ad = d < 0 ? utype( utype(0) - utype( d ) ) : utype( d );
+		int sh = 0;
+		utype m = 1;
+		if ( ad > 1 )
+		{
+			sh = detail::div_bit_length( utype( ad - 1 ) ) - 1;
+			m = utype( detail::div_wide( utype( utype(1) << sh ), ad ) + 1 );
+		}
+		_mul = splat( static_cast<T>( m ) );
+		_sign = splat( d < 0 ? T(-1) : T(0) );
+		_preshift = _mm_setzero_si128();
+		_shift = _mm_cvtsi32_si128( sh );
+	}
+
+	// unsigned: t = mulhi( n, m ), q = ( t + ( ( n - t ) >> s1 ) ) >> s2
+	inline void init( T d, std::false_type )
+	{
+		const int l = detail::div_bit_length( utype( d - 1 ) );
+		const utype p2 = l == bits ? utype(0) : utype( utype(1) << l );
+		_mul = splat( static_cast<T>( detail::div_wide( utype( p2 - d ), utype( d ) ) + 1 ) );
+		_sign = splat( T(0) );
+		_preshift = _mm_cvtsi32_si128( l > 0 ? 1 : 0 );
+		_shift = _mm_cvtsi32_si128( l > 0 ? l - 1 : 0 );
+	}
+
+	template <typename Traits, typename V>
+	PAL_INLINE V apply( V n, V m, V sign, std::true_type ) const
+	{
+		V q = Traits::sra( Traits::addu( Traits::mulhi_s( n, m ), n ), _shift );
+		q = Traits::subu( q, Traits::sign( n ) );
+		return Traits::subu( detail::div_xor( q, sign ), sign );
+	}
+
+	template <typename Traits, typename V>
+	PAL_INLINE V apply( V n, V m, V, std::false_type ) const
+	{
+		V t = Traits::mulhi_u( n, m );
+		return Traits::srl( Traits::addu( t, Traits::srl( Traits::subu( n, t ), _preshift ) ), _shift );
+	}
+
+	reg_type _mul;
+	reg_type _sign;
+	__m128i _preshift;
+	__m128i _shift;
+};
+
+/// @brief the original (signed 32-bit) name
+using int_divisor = divisor<int32_t>;
+
+template <typename T>
+PAL_INLINE ivec128<T> operator/( ivec128<T> a, const divisor<T> &d )
+{
+	return ivec128<T>( d( __m128i( a ) ) );
+}
+
+template <typename T>
+PAL_INLINE ivec128<T> &operator/=( ivec128<T> &a, const divisor<T> &d )
+{
+	a = a / d;
+	return a;
+}
+
+// keep the implicit conversion of the divisor working for lvec4
+PAL_INLINE lvec4 operator/( lvec4 a, const int_divisor &b )
+{
+	return lvec4( b( __m128i( a ) ) );
+}
+
+#ifdef PAL_ENABLE_AVX
+template <typename T>
+PAL_INLINE ivec256<T> operator/( ivec256<T> a, const divisor<T> &d )
+{
+	return ivec256<T>( d( __m256i( a ) ) );
+}
+
+template <typename T>
+PAL_INLINE ivec256<T> &operator/=( ivec256<T> &a, const divisor<T> &d )
+{
+	a = a / d;
+	return a;
+}
+
+PAL_INLINE lvec8 operator/( lvec8 a, const int_divisor &b )
+{
+	return lvec8( b( __m256i( a ) ) );
+}
+#endif
+
+////////////////////////////////////////
+
+template <int32_t b>
+static PAL_INLINE lvec4 divide_by_const( lvec4 a )
+{
+	// who would do this?
+	if ( b == 1 )
+		return a;
+	if ( b == -1 )
+		return -a;
+	// overflow...
+	if ( uint32_t(b) == 0x80000000 )
+		return lvec4( a == lvec4( b ) ) & lvec4( 1 );
+
+	// abs
+	constexpr uint32_t ub = b > 0 ? uint32_t(b) : uint32_t(0) - uint32_t(b);
+	if ( ( ub & ( ub - 1 ) ) == 0 )
+	{
+		// b is a power of 2
+		constexpr int p2 = detail::compute_int_shift( ub + 1 );
+		// need the sign
+		lvec4 s = ( p2 > 1 ) ? lvec4( _mm_srai_epi32( a, p2 - 1 ) ) : a;
+
+		lvec4 ret = _mm_srai_epi32( _mm_add_epi32( a, _mm_srli_epi32( s, 32 - p2 ) ),
+									p2 );
+		if ( b > 0 )
+			return ret;
+		return lvec4::zero() - ret;
+	}
+	constexpr int32_t shift = detail::compute_int_shift( ub );
+	constexpr int32_t mult = detail::compute_const_int_mul( shift, ub );
+	const int_divisor d( shift, mult, b < 0 ? -1 : 0 );
+	return lvec4( d( __m128i( a ) ) );
+}
+
+#ifdef PAL_ENABLE_AVX
+/// @brief divides by a compile time constant
+template <int32_t b>
+static PAL_INLINE lvec8 divide_by_const( lvec8 a )
+{
+	if ( b == 1 )
+		return a;
+	if ( b == -1 )
+		return -a;
+	if ( uint32_t(b) == 0x80000000 )
+		return ( a == lvec8( b ) ) & lvec8( 1 );
+
+	constexpr uint32_t ub = b > 0 ? uint32_t(b) : uint32_t(0) - uint32_t(b);
+	if ( ( ub & ( ub - 1 ) ) == 0 )
+	{
+		// b is a power of 2, round towards zero by adding ub - 1 to
+		// negative values prior to the shift
+		constexpr int p2 = detail::compute_int_shift( ub + 1 );
+		lvec8 s = ( p2 > 1 ) ? ( a >> ( p2 - 1 ) ) : a;
+		lvec8 ret = ( a + lsr( s, 32 - p2 ) ) >> p2;
+		if ( b > 0 )
+			return ret;
+		return -ret;
+	}
+	constexpr int32_t shift = detail::compute_int_shift( ub );
+	constexpr int32_t mult = detail::compute_const_int_mul( shift, ub );
+	const int_divisor d( shift, mult, b < 0 ? -1 : 0 );
+	return lvec8( d( __m256i( a ) ) );
+}
+#endif
+
+} // namespace pal
+
+#endif // _PAL_X86_IVEC_DIVIDE_H_
@@ -0,0 +1,407 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use <pal/x86/ivec_pack.h> directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_X86_IVEC_PACK_H_
+# define _PAL_X86_IVEC_PACK_H_ 1
+
+// operations specific to the narrow (8 and 16-bit) integer types:
+// saturating arithmetic, rounding average, saturating packs to the
+// next narrower type and widening to the next wider type. These allow
+// 8-bit image processing to stay in the integer units.
+
+namespace PAL_NAMESPACE
+{
+
+namespace detail
+{
+
+template <typename T>
+using narrow128_t = typename std::enable_if<sizeof(T) <= 2, ivec128<T>>::type;
+
+template <typename T> struct widen_type {};
+template <> struct widen_type<int8_t> { typedef int16_t type; };
+template <> struct widen_type<uint8_t> { typedef uint16_t type; };
+template <> struct widen_type<int16_t> { typedef int32_t type; };
+template <> struct widen_type<uint16_t> { typedef uint32_t type; };
+template <> struct widen_type<int32_t> { typedef int64_t type; };
+template <> struct widen_type<uint32_t> { typedef uint64_t type; };
+
+/// @brief xor with this to map a signed value into the unsigned range
+/// (and back)
+template <typename T>
+PAL_INLINE __m128i sign_bias128( void )
+{
+	return ivec128_traits<sizeof(T)>::splat( std::numeric_limits<typename std::make_signed<T>::type>::min() );
+}
+
+////////////////////////////////////////
+// the 128-bit packs, each takes 2 vectors and produces one vector
+// of the narrower type with a's values first
+
+PAL_INLINE __m128i pack_s16_s8( __m128i a, __m128i b ) { return _mm_packs_epi16( a, b ); }
+PAL_INLINE __m128i pack_s16_u8( __m128i a, __m128i b ) { return _mm_packus_epi16( a, b ); }
+PAL_INLINE __m128i pack_u16_u8( __m128i a, __m128i b )
+{
+	// unsigned min with 255, then values are in range for the signed
+	// to unsigned pack
+#ifdef PAL_ENABLE_SSE4_1
+	const __m128i lim = _mm_set1_epi16( 0xFF );
+	return _mm_packus_epi16( _mm_min_epu16( a, lim ), _mm_min_epu16( b, lim ) );
+#else
+	const __m128i lim = _mm_set1_epi16( 0xFF );
+	a = _mm_sub_epi16( a, _mm_subs_epu16( a, lim ) );
+	b = _mm_sub_epi16( b, _mm_subs_epu16( b, lim ) );
+	return _mm_packus_epi16( a, b );
+#endif
+}
+PAL_INLINE __m128i pack_s32_s16( __m128i a, __m128i b ) { return _mm_packs_epi32( a, b ); }
+
+#ifndef PAL_ENABLE_SSE4_1
+/// @brief SSE2 has no unsigned 32-bit pack, so values already in
+/// [0, 65535] are sign extended from 16 bits so the signed pack
+/// leaves the bits alone
+PAL_INLINE __m128i pack_u16_in_range( __m128i a, __m128i b )
+{
+	a = _mm_srai_epi32( _mm_slli_epi32( a, 16 ), 16 );
+	b = _mm_srai_epi32( _mm_slli_epi32( b, 16 ), 16 );
+	return _mm_packs_epi32( a, b );
+}
+#endif
+
+PAL_INLINE __m128i pack_s32_u16( __m128i a, __m128i b )
+{
+#ifdef PAL_ENABLE_SSE4_1
+	return _mm_packus_epi32( a, b );
+#else
+	const __m128i lim = _mm_set1_epi32( 0xFFFF );
+	// zero the negatives, then saturate anything above the limit
+	a = _mm_andnot_si128( _mm_srai_epi32( a, 31 ), a );
+	b = _mm_andnot_si128( _mm_srai_epi32( b, 31 ), b );
+	a = _mm_or_si128( a, _mm_cmpgt_epi32( a, lim ) );
+	b = _mm_or_si128( b, _mm_cmpgt_epi32( b, lim ) );
+	return pack_u16_in_range( a, b );
+#endif
+}
+PAL_INLINE __m128i pack_u32_u16( __m128i a, __m128i b )
+{
+#ifdef PAL_ENABLE_SSE4_1
+	const __m128i lim = _mm_set1_epi32( 0xFFFF );
+	return _mm_packus_epi32( _mm_min_epu32( a, lim ), _mm_min_epu32( b, lim ) );
+#else
+	// anything with bits in the upper half saturates
+	const __m128i zero = _mm_setzero_si128();
+	a = _mm_or_si128( a, _mm_cmpgt_epi32( _mm_srli_epi32( a, 16 ), zero ) );
+	b = _mm_or_si128( b, _mm_cmpgt_epi32( _mm_srli_epi32( b, 16 ), zero ) );
+	return pack_u16_in_range( a, b );
+#endif
+}
+
+////////////////////////////////////////
+// widening, lo takes the first half of the elements, hi the second
+
+template <typename T> struct widen_traits {};
+
+template <> struct widen_traits<uint8_t>
+{
+	static PAL_INLINE __m128i lo( __m128i a ) { return _mm_unpacklo_epi8( a, _mm_setzero_si128() ); }
+	static PAL_INLINE __m128i hi( __m128i a ) { return _mm_unpackhi_epi8( a, _mm_setzero_si128() ); }
+#ifdef PAL_ENABLE_AVX2
+	static PAL_INLINE __m256i cvt( __m128i a ) { return _mm256_cvtepu8_epi16( a ); }
+#endif
+};
+
+template <> struct widen_traits<int8_t>
+{
+	static PAL_INLINE __m128i lo( __m128i a )
+	{
+#ifdef PAL_ENABLE_SSE4_1
+		return _mm_cvtepi8_epi16( a );
+#else
+		return _mm_srai_epi16( _mm_unpacklo_epi8( a, a ), 8 );
+#endif
+	}
+	static PAL_INLINE __m128i hi( __m128i a )
+	{
+#ifdef PAL_ENABLE_SSE4_1
+		return _mm_cvtepi8_epi16( _mm_unpackhi_epi64( a, a ) );
+#else
+		return _mm_srai_epi16( _mm_unpackhi_epi8( a, a ), 8 );
+#endif
+	}
+#ifdef PAL_ENABLE_AVX2
+	static PAL_INLINE __m256i cvt( __m128i a ) { return _mm256_cvtepi8_epi16( a ); }
+#endif
+};
+
+template <> struct widen_traits<uint16_t>
+{
+	static PAL_INLINE __m128i lo( __m128i a ) { return _mm_unpacklo_epi16( a, _mm_setzero_si128() ); }
+	static PAL_INLINE __m128i hi( __m128i a ) { return _mm_unpackhi_epi16( a, _mm_setzero_si128() ); }
+#ifdef PAL_ENABLE_AVX2
+	static PAL_INLINE __m256i cvt( __m128i a ) { return _mm256_cvtepu16_epi32( a ); }
+#endif
+};
+
+template <> struct widen_traits<int16_t>
+{
+	static PAL_INLINE __m128i lo( __m128i a )
+	{
+#ifdef PAL_ENABLE_SSE4_1
+		return _mm_cvtepi16_epi32( a );
+#else
+		return _mm_srai_epi32( _mm_unpacklo_epi16( a, a ), 16 );
+#endif
+	}
+	static PAL_INLINE __m128i hi( __m128i a )
+	{
+#ifdef PAL_ENABLE_SSE4_1
+		return _mm_cvtepi16_epi32( _mm_unpackhi_epi64( a, a ) );
+#else
+		return _mm_srai_epi32( _mm_unpackhi_epi16( a, a ), 16 );
+#endif
+	}
+#ifdef PAL_ENABLE_AVX2
+	static PAL_INLINE __m256i cvt( __m128i a ) { return _mm256_cvtepi16_epi32( a ); }
+#endif
+};
+
+template <> struct widen_traits<uint32_t>
+{
+	static PAL_INLINE __m128i lo( __m128i a ) { return _mm_unpacklo_epi32( a, _mm_setzero_si128() ); }
+	static PAL_INLINE __m128i hi( __m128i a ) { return _mm_unpackhi_epi32( a, _mm_setzero_si128() ); }
+#ifdef PAL_ENABLE_AVX2
+	static PAL_INLINE __m256i cvt( __m128i a ) { return _mm256_cvtepu32_epi64( a ); }
+#endif
+};
+
+template <> struct widen_traits<int32_t>
+{
+	static PAL_INLINE __m128i lo( __m128i a ) { return _mm_unpacklo_epi32( a, _mm_srai_epi32( a, 31 ) ); }
+	static PAL_INLINE __m128i hi( __m128i a ) { return _mm_unpackhi_epi32( a, _mm_srai_epi32( a, 31 ) ); }
+#ifdef PAL_ENABLE_AVX2
+	static PAL_INLINE __m256i cvt( __m128i a ) { return _mm256_cvtepi32_epi64( a ); }
+#endif
+};
+
+#ifdef PAL_ENABLE_AVX
+template <typename T>
+using narrow256_t = typename std::enable_if<sizeof(T) <= 2, ivec256<T>>::type;
+
+template <typename T>
+PAL_INLINE __m256i sign_bias256( void )
+{
+	return ivec256_traits<sizeof(T)>::splat( std::numeric_limits<typename std::make_signed<T>::type>::min() );
+}
+
+PAL_INLINE __m256i combine128( __m128i lo, __m128i hi )
+{
+	return _mm256_insertf128_si256( _mm256_castsi128_si256( lo ), hi, 1 );
+}
+
+/// @brief the AVX1 256-bit pack: the 128-bit pack of the halves of
+/// each input keeps the elements in order
+template <__m128i (*packop)( __m128i, __m128i )>
+PAL_INLINE __m256i pack256_split( __m256i a, __m256i b )
+{
+	return combine128( packop( _mm256_castsi256_si128( a ), _mm256_extractf128_si256( a, 1 ) ),
+					   packop( _mm256_castsi256_si128( b ), _mm256_extractf128_si256( b, 1 ) ) );
+}
+
+# ifdef PAL_ENABLE_AVX2
+/// @brief the AVX2 packs operate per 128-bit lane, so the result is
+/// a0 b0 a1 b1, fix that up to a0 a1 b0 b1
+PAL_INLINE __m256i pack256_fixup( __m256i r )
+{
+	return _mm256_permute4x64_epi64( r, _MM_SHUFFLE( 3, 1, 2, 0 ) );
+}
+
+PAL_INLINE __m256i pack256_s16_s8( __m256i a, __m256i b ) { return pack256_fixup( _mm256_packs_epi16( a, b ) ); }
+PAL_INLINE __m256i pack256_s16_u8( __m256i a, __m256i b ) { return pack256_fixup( _mm256_packus_epi16( a, b ) ); }
+PAL_INLINE __m256i pack256_u16_u8( __m256i a, __m256i b )
+{
+	const __m256i lim = _mm256_set1_epi16( 0xFF );
+	return pack256_fixup( _mm256_packus_epi16( _mm256_min_epu16( a, lim ), _mm256_min_epu16( b, lim ) ) );
+}
+PAL_INLINE __m256i pack256_s32_s16( __m256i a, __m256i b ) { return pack256_fixup( _mm256_packs_epi32( a, b ) ); }
+PAL_INLINE __m256i pack256_s32_u16( __m256i a, __m256i b ) { return pack256_fixup( _mm256_packus_epi32( a, b ) ); }
+PAL_INLINE __m256i pack256_u32_u16( __m256i a, __m256i b )
+{
+	const __m256i lim = _mm256_set1_epi32( 0xFFFF );
+	return pack256_fixup( _mm256_packus_epi32( _mm256_min_epu32( a, lim ), _mm256_min_epu32( b, lim ) ) );
+}
+# else
+PAL_INLINE __m256i pack256_s16_s8( __m256i a, __m256i b ) { return pack256_split<pack_s16_s8>( a, b ); }
+PAL_INLINE __m256i pack256_s16_u8( __m256i a, __m256i b ) { return pack256_split<pack_s16_u8>( a, b ); }
+PAL_INLINE __m256i pack256_u16_u8( __m256i a, __m256i b ) { return pack256_split<pack_u16_u8>( a, b ); }
+PAL_INLINE __m256i pack256_s32_s16( __m256i a, __m256i b ) { return pack256_split<pack_s32_s16>( a, b ); }
+PAL_INLINE __m256i pack256_s32_u16( __m256i a, __m256i b ) { return pack256_split<pack_s32_u16>( a, b ); }
+PAL_INLINE __m256i pack256_u32_u16( __m256i a, __m256i b ) { return pack256_split<pack_u32_u16>( a, b ); }
+# endif
+
+template <typename T>
+PAL_INLINE __m256i widen256_lo( __m256i a )
+{
+# ifdef PAL_ENABLE_AVX2
+	return widen_traits<T>::cvt( _mm256_castsi256_si128( a ) );
+# else
+	__m128i l = _mm256_castsi256_si128( a );
+	return combine128( widen_traits<T>::lo( l ), widen_traits<T>::hi( l ) );
+# endif
+}
+
+template <typename T>
+PAL_INLINE __m256i widen256_hi( __m256i a )
+{
+# ifdef PAL_ENABLE_AVX2
+	return widen_traits<T>::cvt( _mm256_extracti128_si256( a, 1 ) );
+# else
+	__m128i h = _mm256_extractf128_si256( a, 1 );
+	return combine128( widen_traits<T>::lo( h ), widen_traits<T>::hi( h ) );
+# endif
+}
+#endif // PAL_ENABLE_AVX
+
+} // namespace detail
+
+////////////////////////////////////////
+// Saturating arithmetic
+
+/// @brief add, clamping to the range of the type (paddsb / paddusb
+/// and friends)
+template <typename T>
+PAL_INLINE detail::narrow128_t<T> add_sat( ivec128<T> a, ivec128<T> b )
+{
+	typedef detail::ivec128_traits<sizeof(T)> traits;
+	if ( std::is_signed<T>::value )
+		return ivec128<T>( traits::adds( a, b ) );
+	return ivec128<T>( traits::addus( a, b ) );
+}
+
+/// @brief subtract, clamping to the range of the type
+template <typename T>
+PAL_INLINE detail::narrow128_t<T> sub_sat( ivec128<T> a, ivec128<T> b )
+{
+	typedef detail::ivec128_traits<sizeof(T)> traits;
+	if ( std::is_signed<T>::value )
+		return ivec128<T>( traits::subs( a, b ) );
+	return ivec128<T>( traits::subus( a, b ) );
+}
+
+/// @brief rounding average (a + b + 1) >> 1, without overflow
+template <typename T>
+PAL_INLINE detail::narrow128_t<T> avg( ivec128<T> a, ivec128<T> b )
+{
+	typedef detail::ivec128_traits<sizeof(T)> traits;
+	if ( std::is_signed<T>::value )
+	{
+		// bias into the unsigned range and back
+		__m128i bias = detail::sign_bias128<T>();
+		return ivec128<T>( _mm_xor_si128( traits::avgu( _mm_xor_si128( a, bias ),
+														_mm_xor_si128( b, bias ) ), bias ) );
+	}
+	return ivec128<T>( traits::avgu( a, b ) );
+}
+
+////////////////////////////////////////
+// Packs
+
+/// @brief packs a then b to the narrower type, saturating to the
+/// range of the narrower type
+PAL_INLINE cvec16 pack_sat( svec8 a, svec8 b ) { return cvec16( detail::pack_s16_s8( a, b ) ); }
+PAL_INLINE ucvec16 pack_sat( usvec8 a, usvec8 b ) { return ucvec16( detail::pack_u16_u8( a, b ) ); }
+PAL_INLINE svec8 pack_sat( lvec4 a, lvec4 b ) { return svec8( detail::pack_s32_s16( a, b ) ); }
+PAL_INLINE usvec8 pack_sat( ulvec4 a, ulvec4 b ) { return usvec8( detail::pack_u32_u16( a, b ) ); }
+
+/// @brief packs signed a then b to the narrower unsigned type,
+/// negative values become 0 (packuswb / packusdw)
+PAL_INLINE ucvec16 pack_usat( svec8 a, svec8 b ) { return ucvec16( detail::pack_s16_u8( a, b ) ); }
+PAL_INLINE usvec8 pack_usat( lvec4 a, lvec4 b ) { return usvec8( detail::pack_s32_u16( a, b ) ); }
+
+////////////////////////////////////////
+// Widening
+
+/// @brief sign or zero extends the first half of the elements to the
+/// next wider type
+template <typename T>
+PAL_INLINE ivec128<typename detail::widen_type<T>::type> widen_lo( ivec128<T> a )
+{
+	return ivec128<typename detail::widen_type<T>::type>( detail::widen_traits<T>::lo( a ) );
+}
+
+/// @brief sign or zero extends the second half of the elements to
+/// the next wider type
+template <typename T>
+PAL_INLINE ivec128<typename detail::widen_type<T>::type> widen_hi( ivec128<T> a )
+{
+	return ivec128<typename detail::widen_type<T>::type>( detail::widen_traits<T>::hi( a ) );
+}
+
+#ifdef PAL_ENABLE_AVX
+
+////////////////////////////////////////
+
+template <typename T>
+PAL_INLINE detail::narrow256_t<T> add_sat( ivec256<T> a, ivec256<T> b )
+{
+	typedef detail::ivec256_traits<sizeof(T)> traits;
+	if ( std::is_signed<T>::value )
+		return ivec256<T>( traits::adds( a, b ) );
+	return ivec256<T>( traits::addus( a, b ) );
+}
+
+template <typename T>
+PAL_INLINE detail::narrow256_t<T> sub_sat( ivec256<T> a, ivec256<T> b )
+{
+	typedef detail::ivec256_traits<sizeof(T)> traits;
+	if ( std::is_signed<T>::value )
+		return ivec256<T>( traits::subs( a, b ) );
+	return ivec256<T>( traits::subus( a, b ) );
+}
+
+template <typename T>
+PAL_INLINE detail::narrow256_t<T> avg( ivec256<T> a, ivec256<T> b )
+{
+	typedef detail::ivec256_traits<sizeof(T)> traits;
+	typedef detail::mask256_bitops<T> bitops;
+	if ( std::is_signed<T>::value )
+	{
+		__m256i bias = detail::sign_bias256<T>();
+		return ivec256<T>( bitops::apply_xor( traits::avgu( bitops::apply_xor( a, bias ),
+															bitops::apply_xor( b, bias ) ), bias ) );
+	}
+	return ivec256<T>( traits::avgu( a, b ) );
+}
+
+PAL_INLINE cvec32 pack_sat( svec16 a, svec16 b ) { return cvec32( detail::pack256_s16_s8( a, b ) ); }
+PAL_INLINE ucvec32 pack_sat( usvec16 a, usvec16 b ) { return ucvec32( detail::pack256_u16_u8( a, b ) ); }
+PAL_INLINE svec16 pack_sat( lvec8 a, lvec8 b ) { return svec16( detail::pack256_s32_s16( a, b ) ); }
+PAL_INLINE usvec16 pack_sat( ulvec8 a, ulvec8 b ) { return usvec16( detail::pack256_u32_u16( a, b ) ); }
+
+PAL_INLINE ucvec32 pack_usat( svec16 a, svec16 b ) { return ucvec32( detail::pack256_s16_u8( a, b ) ); }
+PAL_INLINE usvec16 pack_usat( lvec8 a, lvec8 b ) { return usvec16( detail::pack256_s32_u16( a, b ) ); }
+
+template <typename T>
+PAL_INLINE ivec256<typename detail::widen_type<T>::type> widen_lo( ivec256<T> a )
+{
+	return ivec256<typename detail::widen_type<T>::type>( detail::widen256_lo<T>( a ) );
+}
+
+template <typename T>
+PAL_INLINE ivec256<typename detail::widen_type<T>::type> widen_hi( ivec256<T> a )
+{
+	return ivec256<typename detail::widen_type<T>::type>( detail::widen256_hi<T>( a ) );
+}
+
+#endif // PAL_ENABLE_AVX
+
+} // namespace pal
+
+#endif // _PAL_X86_IVEC_PACK_H_
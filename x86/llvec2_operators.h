@@ -0,0 +1,276 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use <pal/x86/llvec2_operators.h> directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_X86_LLVEC2_OPERATORS_H_
+# define _PAL_X86_LLVEC2_OPERATORS_H_ 1
+
+// operators for the 64-bit integer types (llvec2 and ullvec2). SSE
+// is missing a lot of the 64-bit operations (multiply, arithmetic
+// shift right, min / max, and signed compare prior to SSE4.2), see
+// ivec128_traits<8> for the emulation sequences, which use the
+// native instructions when AVX512DQ / AVX512VL are enabled
+
+namespace PAL_NAMESPACE
+{
+
+namespace detail
+{
+
+template <typename T>
+using llvec2_t = typename std::enable_if<sizeof(T) == 8, ivec128<T>>::type;
+template <typename T>
+using llmask2_t = typename std::enable_if<sizeof(T) == 8, mask128<T>>::type;
+
+PAL_INLINE __m128i llvec2_cmpgt( __m128i a, __m128i b, std::true_type )
+{
+	return ivec128_traits<8>::cmpgt( a, b );
+}
+
+PAL_INLINE __m128i llvec2_cmpgt( __m128i a, __m128i b, std::false_type )
+{
+	// flip the sign bit to turn unsigned into signed compare
+	const __m128i bias = _mm_set1_epi64x( static_cast<long long>( 0x8000000000000000ULL ) );
+	return ivec128_traits<8>::cmpgt( _mm_xor_si128( a, bias ), _mm_xor_si128( b, bias ) );
+}
+
+} // namespace detail
+
+////////////////////////////////////////
+// Unary operators
+
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator+( ivec128<T> a ) { return a; }
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator-( ivec128<T> a )
+{
+	return ivec128<T>( _mm_sub_epi64( _mm_setzero_si128(), a ) );
+}
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator~( ivec128<T> a )
+{
+	return ivec128<T>( _mm_xor_si128( a, _mm_set1_epi32( -1 ) ) );
+}
+
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator+( ivec128<T> a, ivec128<T> b )
+{
+	a += b; return a;
+}
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator+( ivec128<T> a, typename ivec128<T>::value_type b )
+{
+	a += b; return a;
+}
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator+( typename ivec128<T>::value_type a, ivec128<T> b )
+{
+	b += a; return b;
+}
+
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator-( ivec128<T> a, ivec128<T> b )
+{
+	a -= b; return a;
+}
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator-( ivec128<T> a, typename ivec128<T>::value_type b )
+{
+	a -= b; return a;
+}
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator-( typename ivec128<T>::value_type a, ivec128<T> b )
+{
+	ivec128<T> r( a );
+	r -= b; return r;
+}
+
+/// @brief low 64 bits of the product (the same for signed and
+/// unsigned)
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator*( ivec128<T> a, ivec128<T> b )
+{
+	a *= b; return a;
+}
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator*( ivec128<T> a, typename ivec128<T>::value_type b )
+{
+	a *= b; return a;
+}
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator*( typename ivec128<T>::value_type a, ivec128<T> b )
+{
+	b *= a; return b;
+}
+
+////////////////////////////////////////
+// Binary operators
+
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator&( ivec128<T> a, ivec128<T> b )
+{
+	return ivec128<T>( _mm_and_si128( a, b ) );
+}
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator&( mask128<T> a, ivec128<T> b )
+{
+	return ivec128<T>( _mm_and_si128( a, b ) );
+}
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator&( ivec128<T> a, mask128<T> b )
+{
+	return ivec128<T>( _mm_and_si128( a, b ) );
+}
+
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator|( ivec128<T> a, ivec128<T> b )
+{
+	return ivec128<T>( _mm_or_si128( a, b ) );
+}
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator|( mask128<T> a, ivec128<T> b )
+{
+	return ivec128<T>( _mm_or_si128( a, b ) );
+}
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator|( ivec128<T> a, mask128<T> b )
+{
+	return ivec128<T>( _mm_or_si128( a, b ) );
+}
+
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator^( ivec128<T> a, ivec128<T> b )
+{
+	return ivec128<T>( _mm_xor_si128( a, b ) );
+}
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator^( mask128<T> a, ivec128<T> b )
+{
+	return ivec128<T>( _mm_xor_si128( a, b ) );
+}
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator^( ivec128<T> a, mask128<T> b )
+{
+	return ivec128<T>( _mm_xor_si128( a, b ) );
+}
+
+////////////////////////////////////////
+
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator<<( ivec128<T> a, int amt )
+{
+	return ivec128<T>( _mm_sll_epi64( a, _mm_cvtsi32_si128( amt ) ) );
+}
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> &operator<<=( ivec128<T> &a, int amt )
+{
+	a = a << amt;
+	return a;
+}
+
+/// @brief arithmetic shift for llvec2, logical for ullvec2
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> operator>>( ivec128<T> a, int amt )
+{
+	if ( std::is_signed<T>::value )
+		return ivec128<T>( detail::ivec128_traits<8>::sra( a, _mm_cvtsi32_si128( amt ) ) );
+	return ivec128<T>( _mm_srl_epi64( a, _mm_cvtsi32_si128( amt ) ) );
+}
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> &operator>>=( ivec128<T> &a, int amt )
+{
+	a = a >> amt;
+	return a;
+}
+
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> lsr( ivec128<T> a, int s )
+{
+	return ivec128<T>( _mm_srl_epi64( a, _mm_cvtsi32_si128( s ) ) );
+}
+
+////////////////////////////////////////
+// Comparison operators
+
+template <typename T>
+PAL_INLINE detail::llmask2_t<T> operator==( ivec128<T> a, ivec128<T> b )
+{
+	return mask128<T>( detail::ivec128_traits<8>::cmpeq( a, b ) );
+}
+template <typename T>
+PAL_INLINE detail::llmask2_t<T> operator!=( ivec128<T> a, ivec128<T> b )
+{
+	return ~( a == b );
+}
+template <typename T>
+PAL_INLINE detail::llmask2_t<T> operator>( ivec128<T> a, ivec128<T> b )
+{
+	return mask128<T>( detail::llvec2_cmpgt( a, b, std::is_signed<T>() ) );
+}
+template <typename T>
+PAL_INLINE detail::llmask2_t<T> operator<( ivec128<T> a, ivec128<T> b )
+{
+	return b > a;
+}
+template <typename T>
+PAL_INLINE detail::llmask2_t<T> operator<=( ivec128<T> a, ivec128<T> b )
+{
+	return ~( a > b );
+}
+template <typename T>
+PAL_INLINE detail::llmask2_t<T> operator>=( ivec128<T> a, ivec128<T> b )
+{
+	return ~( b > a );
+}
+
+////////////////////////////////////////
+
+/// @brief return the max of the 2 numbers
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> max( ivec128<T> a, ivec128<T> b )
+{
+#ifdef PAL_ENABLE_AVX_512VL
+	if ( std::is_signed<T>::value )
+		return ivec128<T>( _mm_max_epi64( a, b ) );
+	return ivec128<T>( _mm_max_epu64( a, b ) );
+#else
+	return ivec128<T>( ( a > b ).blend( b, a ) );
+#endif
+}
+
+/// @brief return the min of the 2 numbers
+template <typename T>
+PAL_INLINE detail::llvec2_t<T> min( ivec128<T> a, ivec128<T> b )
+{
+#ifdef PAL_ENABLE_AVX_512VL
+	if ( std::is_signed<T>::value )
+		return ivec128<T>( _mm_min_epi64( a, b ) );
+	return ivec128<T>( _mm_min_epu64( a, b ) );
+#else
+	return ivec128<T>( ( a > b ).blend( a, b ) );
+#endif
+}
+
+/// @brief return the absolute value of each number
+///
+/// NB: like the C library, abs of the most negative number is itself
+PAL_INLINE llvec2 abs( llvec2 a )
+{
+#ifdef PAL_ENABLE_AVX_512VL
+	return llvec2( _mm_abs_epi64( a ) );
+#else
+	__m128i s = detail::ivec128_traits<8>::sign( a );
+	return llvec2( _mm_sub_epi64( _mm_xor_si128( a, s ), s ) );
+#endif
+}
+
+} // namespace pal
+
+#endif // _PAL_X86_LLVEC2_OPERATORS_H_
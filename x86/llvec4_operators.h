@@ -0,0 +1,277 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use <pal/x86/llvec4_operators.h> directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_X86_LLVEC4_OPERATORS_H_
+# define _PAL_X86_LLVEC4_OPERATORS_H_ 1
+
+#ifdef PAL_ENABLE_AVX
+
+// operators for llvec4 and ullvec4, @sa llvec2_operators.h
+
+namespace PAL_NAMESPACE
+{
+
+namespace detail
+{
+
+template <typename T>
+using llvec4_t = typename std::enable_if<sizeof(T) == 8, ivec256<T>>::type;
+template <typename T>
+using llmask4_t = typename std::enable_if<sizeof(T) == 8, mask256<T>>::type;
+
+PAL_INLINE __m256i llvec4_bitop_and( __m256i a, __m256i b ) { return mask256_bitops<int64_t>::apply_and( a, b ); }
+PAL_INLINE __m256i llvec4_bitop_or( __m256i a, __m256i b ) { return mask256_bitops<int64_t>::apply_or( a, b ); }
+PAL_INLINE __m256i llvec4_bitop_xor( __m256i a, __m256i b ) { return mask256_bitops<int64_t>::apply_xor( a, b ); }
+
+PAL_INLINE __m256i llvec4_cmpgt( __m256i a, __m256i b, std::true_type )
+{
+	return ivec256_traits<8>::cmpgt( a, b );
+}
+
+PAL_INLINE __m256i llvec4_cmpgt( __m256i a, __m256i b, std::false_type )
+{
+	const __m256i bias = _mm256_set1_epi64x( static_cast<long long>( 0x8000000000000000ULL ) );
+	return ivec256_traits<8>::cmpgt( llvec4_bitop_xor( a, bias ), llvec4_bitop_xor( b, bias ) );
+}
+
+} // namespace detail
+
+////////////////////////////////////////
+// Unary operators
+
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator+( ivec256<T> a ) { return a; }
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator-( ivec256<T> a )
+{
+	return ivec256<T>( detail::ivec256_traits<8>::subu( _mm256_setzero_si256(), a ) );
+}
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator~( ivec256<T> a )
+{
+	return ivec256<T>( detail::llvec4_bitop_xor( a, _mm256_set1_epi32( -1 ) ) );
+}
+
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator+( ivec256<T> a, ivec256<T> b )
+{
+	a += b; return a;
+}
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator+( ivec256<T> a, typename ivec256<T>::value_type b )
+{
+	a += b; return a;
+}
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator+( typename ivec256<T>::value_type a, ivec256<T> b )
+{
+	b += a; return b;
+}
+
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator-( ivec256<T> a, ivec256<T> b )
+{
+	a -= b; return a;
+}
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator-( ivec256<T> a, typename ivec256<T>::value_type b )
+{
+	a -= b; return a;
+}
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator-( typename ivec256<T>::value_type a, ivec256<T> b )
+{
+	ivec256<T> r( a );
+	r -= b; return r;
+}
+
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator*( ivec256<T> a, ivec256<T> b )
+{
+	a *= b; return a;
+}
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator*( ivec256<T> a, typename ivec256<T>::value_type b )
+{
+	a *= b; return a;
+}
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator*( typename ivec256<T>::value_type a, ivec256<T> b )
+{
+	b *= a; return b;
+}
+
+////////////////////////////////////////
+// Binary operators
+
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator&( ivec256<T> a, ivec256<T> b )
+{
+	return ivec256<T>( detail::llvec4_bitop_and( a, b ) );
+}
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator&( mask256<T> a, ivec256<T> b )
+{
+	return ivec256<T>( detail::llvec4_bitop_and( a, b ) );
+}
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator&( ivec256<T> a, mask256<T> b )
+{
+	return ivec256<T>( detail::llvec4_bitop_and( a, b ) );
+}
+
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator|( ivec256<T> a, ivec256<T> b )
+{
+	return ivec256<T>( detail::llvec4_bitop_or( a, b ) );
+}
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator|( mask256<T> a, ivec256<T> b )
+{
+	return ivec256<T>( detail::llvec4_bitop_or( a, b ) );
+}
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator|( ivec256<T> a, mask256<T> b )
+{
+	return ivec256<T>( detail::llvec4_bitop_or( a, b ) );
+}
+
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator^( ivec256<T> a, ivec256<T> b )
+{
+	return ivec256<T>( detail::llvec4_bitop_xor( a, b ) );
+}
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator^( mask256<T> a, ivec256<T> b )
+{
+	return ivec256<T>( detail::llvec4_bitop_xor( a, b ) );
+}
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator^( ivec256<T> a, mask256<T> b )
+{
+	return ivec256<T>( detail::llvec4_bitop_xor( a, b ) );
+}
+
+////////////////////////////////////////
+
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator<<( ivec256<T> a, int amt )
+{
+	return ivec256<T>( PAL_AVX_INT_SHIFTOP( _mm256_sll_epi64, _mm_sll_epi64, a, _mm_cvtsi32_si128( amt ) ) );
+}
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> &operator<<=( ivec256<T> &a, int amt )
+{
+	a = a << amt;
+	return a;
+}
+
+/// @brief arithmetic shift for llvec4, logical for ullvec4
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> operator>>( ivec256<T> a, int amt )
+{
+	if ( std::is_signed<T>::value )
+		return ivec256<T>( detail::ivec256_traits<8>::sra( a, _mm_cvtsi32_si128( amt ) ) );
+	return ivec256<T>( detail::ivec256_traits<8>::srl( a, _mm_cvtsi32_si128( amt ) ) );
+}
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> &operator>>=( ivec256<T> &a, int amt )
+{
+	a = a >> amt;
+	return a;
+}
+
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> lsr( ivec256<T> a, int s )
+{
+	return ivec256<T>( detail::ivec256_traits<8>::srl( a, _mm_cvtsi32_si128( s ) ) );
+}
+
+////////////////////////////////////////
+// Comparison operators
+
+template <typename T>
+PAL_INLINE detail::llmask4_t<T> operator==( ivec256<T> a, ivec256<T> b )
+{
+	return mask256<T>( detail::ivec256_traits<8>::cmpeq( a, b ) );
+}
+template <typename T>
+PAL_INLINE detail::llmask4_t<T> operator!=( ivec256<T> a, ivec256<T> b )
+{
+	return ~( a == b );
+}
+template <typename T>
+PAL_INLINE detail::llmask4_t<T> operator>( ivec256<T> a, ivec256<T> b )
+{
+	return mask256<T>( detail::llvec4_cmpgt( a, b, std::is_signed<T>() ) );
+}
+template <typename T>
+PAL_INLINE detail::llmask4_t<T> operator<( ivec256<T> a, ivec256<T> b )
+{
+	return b > a;
+}
+template <typename T>
+PAL_INLINE detail::llmask4_t<T> operator<=( ivec256<T> a, ivec256<T> b )
+{
+	return ~( a > b );
+}
+template <typename T>
+PAL_INLINE detail::llmask4_t<T> operator>=( ivec256<T> a, ivec256<T> b )
+{
+	return ~( b > a );
+}
+
+////////////////////////////////////////
+
+/// @brief return the max of the 2 numbers
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> max( ivec256<T> a, ivec256<T> b )
+{
+#ifdef PAL_ENABLE_AVX_512VL
+	if ( std::is_signed<T>::value )
+		return ivec256<T>( _mm256_max_epi64( a, b ) );
+	return ivec256<T>( _mm256_max_epu64( a, b ) );
+#else
+	return ivec256<T>( ( a > b ).blend( b, a ) );
+#endif
+}
+
+/// @brief return the min of the 2 numbers
+template <typename T>
+PAL_INLINE detail::llvec4_t<T> min( ivec256<T> a, ivec256<T> b )
+{
+#ifdef PAL_ENABLE_AVX_512VL
+	if ( std::is_signed<T>::value )
+		return ivec256<T>( _mm256_min_epi64( a, b ) );
+	return ivec256<T>( _mm256_min_epu64( a, b ) );
+#else
+	return ivec256<T>( ( a > b ).blend( a, b ) );
+#endif
+}
+
+/// @brief return the absolute value of each number
+///
+/// NB: like the C library, abs of the most negative number is itself
+PAL_INLINE llvec4 abs( llvec4 a )
+{
+#ifdef PAL_ENABLE_AVX_512VL
+	return llvec4( _mm256_abs_epi64( a ) );
+#else
+	__m256i s = detail::ivec256_traits<8>::sign( a );
+	return llvec4( detail::ivec256_traits<8>::subu( detail::llvec4_bitop_xor( a, s ), s ) );
+#endif
+}
+
+} // namespace pal
+
+#endif // PAL_ENABLE_AVX
+
+#endif // _PAL_X86_LLVEC4_OPERATORS_H_
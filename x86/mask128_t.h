@@ -161,10 +161,11 @@ public:
 	/// @defgroup test functions
 	/// @{
 
-	/// @brief returns a mask indicating what elements are set @sa active_mask
+	/// @brief returns a mask indicating what elements are set, one bit
+	/// per element with element 0 in the low bit @sa active_mask
 	PAL_INLINE int which( void ) const
 	{
-		return manip_traits::any( _vec );
+		return manip_traits::which( _vec );
 	}
 
 	/// @brief returns a mask for a specific element index
@@ -73,6 +73,9 @@ public:
 	/// User is expected to make sure it has the correct mask values (all bytes 0xFF as appropriate)
 	explicit PAL_INLINE mask256( vec_type v ) : _vec( v ) {}
 
+	template <typename U>
+	PAL_INLINE mask256( mask256<U> v ) : _vec( manip_traits::from_other( v ) ) {}
+
 	PAL_INLINE __m256 as_float( void ) const { return manip_traits::as_float( _vec ); }
 	PAL_INLINE __m256d as_double( void ) const { return manip_traits::as_double( _vec ); }
 	PAL_INLINE __m256i as_int( void ) const { return manip_traits::as_int( _vec ); }
@@ -159,6 +162,19 @@ public:
 	/// @defgroup test functions
 	/// @{
 
+	/// @brief returns a mask indicating what elements are set, one bit
+	/// per element with element 0 in the low bit @sa active_mask
+	PAL_INLINE int which( void ) const
+	{
+		return manip_traits::which( _vec );
+	}
+
+	/// @brief returns a mask for a specific element index
+	PAL_INLINE int active_mask( const int i ) const
+	{
+		return manip_traits::active_mask( i );
+	}
+
 	/// @brief returns true if any bits are set
 	PAL_INLINE bool any( void ) const
 	{
@@ -0,0 +1,302 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use <pal/x86/simd_complex.h> directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_X86_SIMD_COMPLEX_H_
+# define _PAL_X86_SIMD_COMPLEX_H_ 1
+
+// complex values of float vectors, in two layouts.
+//
+// cvec (cfvec4, cfvec8) is the split layout: one vector of the real
+// parts and one of the imaginary parts, so a multiply is 4 multiplies
+// (2 of them fused) with no shuffles. This is the fast layout for
+// long runs of arithmetic, see deinterleave2 / interleave2 in
+// buffer_layout.h to convert whole buffers to and from it.
+//
+// cvec_interleaved (icfvec4, icfvec8) holds the values as stored in
+// memory, re im re im, so half as many values to a vector. The
+// multiply duplicates the real and imaginary parts of one side and
+// swaps the other, finishing with addsub (fmaddsub when fma is
+// available) to get the alternating signs.
+//
+// abs is computed as sqrt( re^2 + im^2 ) so overflows for magnitudes
+// past about 1e19.
+
+namespace PAL_NAMESPACE
+{
+
+/// @brief value_count complex values in split layout
+template <typename VT>
+struct cvec
+{
+	typedef VT vec_type;
+	static const int value_count = VT::value_count;
+
+	cvec( void ) = default;
+	cvec( VT r, VT i ) : re( r ), im( i ) {}
+	explicit cvec( VT r ) : re( r ), im( VT::zero() ) {}
+
+	VT re;
+	VT im;
+};
+
+typedef cvec<fvec4> cfvec4;
+#ifdef PAL_HAS_FVEC8
+typedef cvec<fvec8> cfvec8;
+#endif
+
+template <typename VT>
+PAL_INLINE cvec<VT> operator+( cvec<VT> a, cvec<VT> b ) { return cvec<VT>( a.re + b.re, a.im + b.im ); }
+template <typename VT>
+PAL_INLINE cvec<VT> operator-( cvec<VT> a, cvec<VT> b ) { return cvec<VT>( a.re - b.re, a.im - b.im ); }
+template <typename VT>
+PAL_INLINE cvec<VT> operator-( cvec<VT> a ) { return cvec<VT>( -a.re, -a.im ); }
+
+template <typename VT>
+PAL_INLINE cvec<VT> operator*( cvec<VT> a, cvec<VT> b )
+{
+	return cvec<VT>( fms( a.re, b.re, a.im * b.im ), fma( a.re, b.im, a.im * b.re ) );
+}
+
+/// @brief scale by real values
+template <typename VT>
+PAL_INLINE cvec<VT> operator*( cvec<VT> a, VT s ) { return cvec<VT>( a.re * s, a.im * s ); }
+template <typename VT>
+PAL_INLINE cvec<VT> operator*( VT s, cvec<VT> a ) { return cvec<VT>( a.re * s, a.im * s ); }
+
+/// @brief a * b + c
+template <typename VT>
+PAL_INLINE cvec<VT> fma( cvec<VT> a, cvec<VT> b, cvec<VT> c )
+{
+	return cvec<VT>( fma( a.re, b.re, nmadd( a.im, b.im, c.re ) ),
+					 fma( a.re, b.im, fma( a.im, b.re, c.im ) ) );
+}
+
+template <typename VT>
+PAL_INLINE cvec<VT> conj( cvec<VT> a ) { return cvec<VT>( a.re, -a.im ); }
+
+/// @brief the squared magnitude, re^2 + im^2
+template <typename VT>
+PAL_INLINE VT norm( cvec<VT> a ) { return fma( a.re, a.re, a.im * a.im ); }
+
+/// @brief the magnitude
+template <typename VT>
+PAL_INLINE VT abs( cvec<VT> a ) { return sqrtf( norm( a ) ); }
+
+/// @brief the phase angle in [-pi, pi]
+template <typename VT>
+PAL_INLINE VT arg( cvec<VT> a ) { return atan2f( a.im, a.re ); }
+
+/// @brief e^a = e^re ( cos( im ) + i sin( im ) )
+template <typename VT>
+PAL_INLINE cvec<VT> exp( cvec<VT> a )
+{
+	VT s, c;
+	sincosf( a.im, &s, &c );
+	VT e = expf( a.re );
+	return cvec<VT>( e * c, e * s );
+}
+
+/// @brief the complex value with magnitude r and phase angle theta
+template <typename VT>
+PAL_INLINE cvec<VT> polar( VT r, VT theta )
+{
+	VT s, c;
+	sincosf( theta, &s, &c );
+	return cvec<VT>( r * c, r * s );
+}
+
+////////////////////////////////////////
+
+namespace detail
+{
+
+/// @brief { a0 - b0, a1 + b1, ... }
+PAL_INLINE fvec4 complex_addsub( fvec4 a, fvec4 b )
+{
+#ifdef PAL_ENABLE_SSE3
+	return fvec4( _mm_addsub_ps( a, b ) );
+#else
+	return a + ( b ^ fvec4( -0.F, 0.F, -0.F, 0.F ) );
+#endif
+}
+
+/// @brief { a0 b0 - c0, a1 b1 + c1, ... }
+PAL_INLINE fvec4 complex_fmaddsub( fvec4 a, fvec4 b, fvec4 c )
+{
+#ifdef PAL_ENABLE_FMA_EXT
+	return fvec4( _mm_fmaddsub_ps( a, b, c ) );
+#else
+	return complex_addsub( a * b, c );
+#endif
+}
+
+PAL_INLINE fvec4 complex_dup_re( fvec4 v ) { return permute<0, 0, 2, 2>( v ); }
+PAL_INLINE fvec4 complex_dup_im( fvec4 v ) { return permute<1, 1, 3, 3>( v ); }
+PAL_INLINE fvec4 complex_swap( fvec4 v ) { return permute<1, 0, 3, 2>( v ); }
+PAL_INLINE fvec4 complex_conj( fvec4 v ) { return v ^ fvec4( 0.F, -0.F, 0.F, -0.F ); }
+/// @brief the real parts from re, the imaginary parts from im
+PAL_INLINE fvec4 complex_blend( fvec4 re, fvec4 im ) { return blend<0, 1, 0, 1>( re, im ); }
+
+#ifdef PAL_HAS_FVEC8
+PAL_INLINE fvec8 complex_addsub( fvec8 a, fvec8 b ) { return fvec8( _mm256_addsub_ps( a, b ) ); }
+
+PAL_INLINE fvec8 complex_fmaddsub( fvec8 a, fvec8 b, fvec8 c )
+{
+#ifdef PAL_ENABLE_FMA_EXT
+	return fvec8( _mm256_fmaddsub_ps( a, b, c ) );
+#else
+	return complex_addsub( a * b, c );
+#endif
+}
+
+PAL_INLINE fvec8 complex_dup_re( fvec8 v ) { return fvec8( _mm256_moveldup_ps( v ) ); }
+PAL_INLINE fvec8 complex_dup_im( fvec8 v ) { return fvec8( _mm256_movehdup_ps( v ) ); }
+PAL_INLINE fvec8 complex_swap( fvec8 v ) { return fvec8( _mm256_permute_ps( v, _MM_SHUFFLE( 2, 3, 0, 1 ) ) ); }
+PAL_INLINE fvec8 complex_conj( fvec8 v )
+{
+	return v ^ fvec8( 0.F, -0.F, 0.F, -0.F, 0.F, -0.F, 0.F, -0.F );
+}
+PAL_INLINE fvec8 complex_blend( fvec8 re, fvec8 im ) { return fvec8( _mm256_blend_ps( re, im, 0xAA ) ); }
+#endif
+
+} // namespace detail
+
+/// @brief value_count complex values stored interleaved, re im re im
+template <typename VT>
+struct cvec_interleaved
+{
+	typedef VT vec_type;
+	static const int value_count = VT::value_count / 2;
+
+	cvec_interleaved( void ) = default;
+	explicit cvec_interleaved( VT x ) : v( x ) {}
+
+	VT v;
+};
+
+typedef cvec_interleaved<fvec4> icfvec4;
+#ifdef PAL_HAS_FVEC8
+typedef cvec_interleaved<fvec8> icfvec8;
+#endif
+
+template <typename VT>
+PAL_INLINE cvec_interleaved<VT> operator+( cvec_interleaved<VT> a, cvec_interleaved<VT> b )
+{
+	return cvec_interleaved<VT>( a.v + b.v );
+}
+template <typename VT>
+PAL_INLINE cvec_interleaved<VT> operator-( cvec_interleaved<VT> a, cvec_interleaved<VT> b )
+{
+	return cvec_interleaved<VT>( a.v - b.v );
+}
+template <typename VT>
+PAL_INLINE cvec_interleaved<VT> operator-( cvec_interleaved<VT> a ) { return cvec_interleaved<VT>( -a.v ); }
+
+template <typename VT>
+PAL_INLINE cvec_interleaved<VT> operator*( cvec_interleaved<VT> a, cvec_interleaved<VT> b )
+{
+	// { ar br - ai bi, ai br + ar bi }
+	VT t = detail::complex_swap( a.v ) * detail::complex_dup_im( b.v );
+	return cvec_interleaved<VT>( detail::complex_fmaddsub( a.v, detail::complex_dup_re( b.v ), t ) );
+}
+
+/// @brief a * b + c
+template <typename VT>
+PAL_INLINE cvec_interleaved<VT> fma( cvec_interleaved<VT> a, cvec_interleaved<VT> b, cvec_interleaved<VT> c )
+{
+	VT t = detail::complex_swap( a.v ) * detail::complex_dup_im( b.v );
+	return cvec_interleaved<VT>( fma( a.v, detail::complex_dup_re( b.v ), detail::complex_addsub( c.v, t ) ) );
+}
+
+template <typename VT>
+PAL_INLINE cvec_interleaved<VT> conj( cvec_interleaved<VT> a )
+{
+	return cvec_interleaved<VT>( detail::complex_conj( a.v ) );
+}
+
+/// @brief the squared magnitudes, each in both the real and imaginary
+/// positions
+template <typename VT>
+PAL_INLINE VT norm( cvec_interleaved<VT> a )
+{
+	VT t = a.v * a.v;
+	return t + detail::complex_swap( t );
+}
+
+/// @brief the magnitudes, as for norm
+template <typename VT>
+PAL_INLINE VT abs( cvec_interleaved<VT> a ) { return sqrtf( norm( a ) ); }
+
+/// @brief the phase angles, as for norm
+template <typename VT>
+PAL_INLINE VT arg( cvec_interleaved<VT> a )
+{
+	return atan2f( detail::complex_dup_im( a.v ), detail::complex_dup_re( a.v ) );
+}
+
+template <typename VT>
+PAL_INLINE cvec_interleaved<VT> exp( cvec_interleaved<VT> a )
+{
+	VT s, c;
+	sincosf( detail::complex_dup_im( a.v ), &s, &c );
+	return cvec_interleaved<VT>( expf( detail::complex_dup_re( a.v ) ) * detail::complex_blend( c, s ) );
+}
+
+/// @brief the complex values with magnitudes r and phase angles theta,
+/// each in both the real and imaginary positions as abs and arg return
+/// them, so polar_interleaved( abs( a ), arg( a ) ) is a
+template <typename VT>
+PAL_INLINE cvec_interleaved<VT> polar_interleaved( VT r, VT theta )
+{
+	VT s, c;
+	sincosf( theta, &s, &c );
+	return cvec_interleaved<VT>( r * detail::complex_blend( c, s ) );
+}
+
+////////////////////////////////////////
+
+/// @brief the 4 values of x0 then x1 in split layout
+PAL_INLINE cfvec4 to_split( icfvec4 x0, icfvec4 x1 )
+{
+	cfvec4 r;
+	deinterleave2( x0.v, x1.v, r.re, r.im );
+	return r;
+}
+
+/// @brief inverse of to_split
+PAL_INLINE void to_interleaved( cfvec4 z, icfvec4 &x0, icfvec4 &x1 )
+{
+	interleave2( z.re, z.im, x0.v, x1.v );
+}
+
+#ifdef PAL_HAS_FVEC8
+PAL_INLINE cfvec8 to_split( icfvec8 x0, icfvec8 x1 )
+{
+	// deinterleave2 works in the 128-bit lanes, so first gather the
+	// values 0, 1, 4, 5 and 2, 3, 6, 7
+	cfvec8 r;
+	deinterleave2( fvec8( _mm256_permute2f128_ps( x0.v, x1.v, 0x20 ) ),
+				   fvec8( _mm256_permute2f128_ps( x0.v, x1.v, 0x31 ) ), r.re, r.im );
+	return r;
+}
+
+PAL_INLINE void to_interleaved( cfvec8 z, icfvec8 &x0, icfvec8 &x1 )
+{
+	fvec8 a, b;
+	interleave2( z.re, z.im, a, b );
+	x0.v = fvec8( _mm256_permute2f128_ps( a, b, 0x20 ) );
+	x1.v = fvec8( _mm256_permute2f128_ps( a, b, 0x31 ) );
+}
+#endif
+
+} // namespace pal
+
+#endif // _PAL_X86_SIMD_COMPLEX_H_
@@ -0,0 +1,329 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use <pal/x86/simd_compress.h> directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_X86_SIMD_COMPRESS_H_
+# define _PAL_X86_SIMD_COMPRESS_H_ 1
+
+// left packing (compress) of the lanes selected by a mask for fvec4,
+// lvec4, fvec8 and lvec8. The selected lanes are moved to the front
+// in order with a shuffle from a lookup table indexed by the mask
+// bits (pshufb, or vpermd for 8 wide with AVX2), or vcompressps /
+// vpcompressd with AVX-512VL. AVX without AVX2 compresses the 128-bit
+// halves of 8 wide registers with pshufb. Without SSSE3 the lanes are
+// moved one at a time.
+
+namespace PAL_NAMESPACE
+{
+
+namespace detail
+{
+
+/// @brief index of the lowest set bit, b must not be 0
+PAL_INLINE int first_set_bit( int b )
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	unsigned long r;
+	_BitScanForward( &r, static_cast<unsigned long>( b ) );
+	return int( r );
+#else
+	return __builtin_ctz( static_cast<unsigned int>( b ) );
+#endif
+}
+
+/// @brief number of set bits
+PAL_INLINE int count_set_bits( int b )
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	return int( __popcnt( static_cast<unsigned int>( b ) ) );
+#else
+	return __builtin_popcount( static_cast<unsigned int>( b ) );
+#endif
+}
+
+/// @brief lookup tables for the partition shuffles, indexed by the
+/// bit mask of the lanes going right. Compressing is a partition
+/// with the mask inverted.
+template <int N> struct partition_table {};
+
+template <> struct partition_table<4>
+{
+	uint8_t shuf[16][16];
+	uint8_t left[16];
+
+	partition_table( void )
+	{
+		for ( int m = 0; m != 16; ++m )
+		{
+			int o = 0;
+			for ( int pass = 0; pass != 2; ++pass )
+			{
+				for ( int i = 0; i != 4; ++i )
+				{
+					if ( ( ( m >> i ) & 1 ) != pass )
+						continue;
+					for ( int b = 0; b != 4; ++b )
+						shuf[m][o * 4 + b] = uint8_t( i * 4 + b );
+					++o;
+				}
+				if ( pass == 0 )
+					left[m] = uint8_t( o );
+			}
+		}
+	}
+
+	static const partition_table &get( void )
+	{
+		static const partition_table t;
+		return t;
+	}
+};
+
+template <> struct partition_table<8>
+{
+	// lane indices packed in nibbles
+	uint32_t perm[256];
+	uint8_t left[256];
+
+	partition_table( void )
+	{
+		for ( int m = 0; m != 256; ++m )
+		{
+			uint32_t p = 0;
+			int o = 0;
+			for ( int pass = 0; pass != 2; ++pass )
+			{
+				for ( int i = 0; i != 8; ++i )
+				{
+					if ( ( ( m >> i ) & 1 ) != pass )
+						continue;
+					p |= uint32_t( i ) << ( o * 4 );
+					++o;
+				}
+				if ( pass == 0 )
+					left[m] = uint8_t( o );
+			}
+			perm[m] = p;
+		}
+	}
+
+	static const partition_table &get( void )
+	{
+		static const partition_table t;
+		return t;
+	}
+};
+
+#ifdef PAL_ENABLE_SSSE3
+PAL_INLINE fvec4 partition_shuffle4( fvec4 v, __m128i s )
+{
+	return fvec4( _mm_castsi128_ps( _mm_shuffle_epi8( _mm_castps_si128( v ), s ) ) );
+}
+PAL_INLINE lvec4 partition_shuffle4( lvec4 v, __m128i s ) { return lvec4( _mm_shuffle_epi8( v, s ) ); }
+
+/// @brief moves the lanes with a clear bit in m first, returning how
+/// many there are
+template <typename VT>
+PAL_INLINE typename std::enable_if<VT::value_count == 4, VT>::type
+partition_shuffle( const partition_table<4> &t, VT v, int m, int &left )
+{
+	left = t.left[m];
+	__m128i s = _mm_loadu_si128( reinterpret_cast<const __m128i *>( t.shuf[m] ) );
+	return partition_shuffle4( v, s );
+}
+
+# ifdef PAL_ENABLE_AVX2
+template <typename VT>
+PAL_INLINE typename std::enable_if<VT::value_count == 8, VT>::type
+partition_shuffle( const partition_table<8> &t, VT v, int m, int &left )
+{
+	left = t.left[m];
+	__m256i idx = _mm256_srlv_epi32( _mm256_set1_epi32( int( t.perm[m] ) ),
+									 _mm256_setr_epi32( 0, 4, 8, 12, 16, 20, 24, 28 ) );
+	return permute( v, lvec8( _mm256_and_si256( idx, _mm256_set1_epi32( 7 ) ) ) );
+}
+# endif
+#endif
+
+/// @brief lane at a time compress of vals, returning the count
+template <typename T, int N>
+PAL_INLINE int compress_lanes( T (&vals)[N], int bits )
+{
+	int c = 0;
+	for ( int b = bits; b != 0; b &= b - 1 )
+		vals[c++] = vals[first_set_bit( b )];
+	return c;
+}
+
+#if defined(PAL_ENABLE_SSSE3) && !defined(PAL_ENABLE_AVX2)
+// no lane crossing variable permute, so 8 wide registers compress
+// their halves with the 4 wide table, storing the high half after the
+// low one. out needs room for 8 values
+# ifdef PAL_HAS_FVEC8
+PAL_INLINE int compress_halves( float *out, fvec8 v, int bits )
+{
+	int lo, hi;
+	const partition_table<4> &t = partition_table<4>::get();
+	store( out, partition_shuffle( t, fvec4( _mm256_castps256_ps128( v ) ), ( bits & 0xF ) ^ 0xF, lo ) );
+	store( out + lo, partition_shuffle( t, fvec4( _mm256_extractf128_ps( v, 1 ) ), ( bits >> 4 ) ^ 0xF, hi ) );
+	return lo + hi;
+}
+# endif
+# ifdef PAL_HAS_IVEC256
+PAL_INLINE int compress_halves( int32_t *out, lvec8 v, int bits )
+{
+	int lo, hi;
+	const partition_table<4> &t = partition_table<4>::get();
+	store( out, partition_shuffle( t, lvec4( _mm256_castsi256_si128( v ) ), ( bits & 0xF ) ^ 0xF, lo ) );
+	store( out + lo, partition_shuffle( t, lvec4( _mm256_extractf128_si256( v, 1 ) ), ( bits >> 4 ) ^ 0xF, hi ) );
+	return lo + hi;
+}
+# endif
+#endif
+
+} // namespace detail
+
+////////////////////////////////////////
+
+/// @brief moves the lanes of v with their mask set to the front, in
+/// order, setting count to how many there are. The lanes after those
+/// are unspecified.
+PAL_INLINE fvec4 compress( fvec4 v, fvec4::mask_type m, int &count )
+{
+	int bits = m.which();
+#if defined(PAL_ENABLE_AVX_512VL)
+	count = detail::count_set_bits( bits );
+	return fvec4( _mm_maskz_compress_ps( __mmask8( bits ), v ) );
+#elif defined(PAL_ENABLE_SSSE3)
+	return detail::partition_shuffle( detail::partition_table<4>::get(), v, bits ^ 0xF, count );
+#else
+	PAL_ALIGN_128 float vals[4];
+	store( vals, v );
+	count = detail::compress_lanes( vals, bits );
+	return load4f( vals );
+#endif
+}
+
+/// @sa compress( fvec4, fvec4::mask_type, int & )
+PAL_INLINE lvec4 compress( lvec4 v, lvec4::mask_type m, int &count )
+{
+	int bits = m.which();
+#if defined(PAL_ENABLE_AVX_512VL)
+	count = detail::count_set_bits( bits );
+	return lvec4( _mm_maskz_compress_epi32( __mmask8( bits ), v ) );
+#elif defined(PAL_ENABLE_SSSE3)
+	return detail::partition_shuffle( detail::partition_table<4>::get(), v, bits ^ 0xF, count );
+#else
+	PAL_ALIGN_128 int32_t vals[4];
+	store( vals, v );
+	count = detail::compress_lanes( vals, bits );
+	return load( vals );
+#endif
+}
+
+#ifdef PAL_HAS_FVEC8
+/// @sa compress( fvec4, fvec4::mask_type, int & )
+PAL_INLINE fvec8 compress( fvec8 v, fvec8::mask_type m, int &count )
+{
+	int bits = m.which();
+# if defined(PAL_ENABLE_AVX_512VL)
+	count = detail::count_set_bits( bits );
+	return fvec8( _mm256_maskz_compress_ps( __mmask8( bits ), v ) );
+# elif defined(PAL_ENABLE_AVX2)
+	return detail::partition_shuffle( detail::partition_table<8>::get(), v, bits ^ 0xFF, count );
+# elif defined(PAL_ENABLE_SSSE3)
+	PAL_ALIGN_256 float vals[8];
+	count = detail::compress_halves( vals, v, bits );
+	return load8f( vals );
+# else
+	PAL_ALIGN_256 float vals[8];
+	store( vals, v );
+	count = detail::compress_lanes( vals, bits );
+	return load8f( vals );
+# endif
+}
+#endif
+
+#ifdef PAL_HAS_IVEC256
+/// @sa compress( fvec4, fvec4::mask_type, int & )
+PAL_INLINE lvec8 compress( lvec8 v, lvec8::mask_type m, int &count )
+{
+	int bits = m.which();
+# if defined(PAL_ENABLE_AVX_512VL)
+	count = detail::count_set_bits( bits );
+	return lvec8( _mm256_maskz_compress_epi32( __mmask8( bits ), v ) );
+# elif defined(PAL_ENABLE_AVX2)
+	return detail::partition_shuffle( detail::partition_table<8>::get(), v, bits ^ 0xFF, count );
+# elif defined(PAL_ENABLE_SSSE3)
+	PAL_ALIGN_256 int32_t vals[8];
+	count = detail::compress_halves( vals, v, bits );
+	return load256( vals );
+# else
+	PAL_ALIGN_256 int32_t vals[8];
+	store( vals, v );
+	count = detail::compress_lanes( vals, bits );
+	return load256( vals );
+# endif
+}
+#endif
+
+////////////////////////////////////////
+
+/// @brief stores the lanes of v with their mask set to out, in order,
+/// returning how many there are. A whole register may be written, so
+/// out needs room for value_count values, the values past the
+/// returned count are unspecified.
+PAL_INLINE int compress_store( float *out, fvec4 v, fvec4::mask_type m )
+{
+	int count;
+	store( out, compress( v, m, count ) );
+	return count;
+}
+
+/// @sa compress_store( float *, fvec4, fvec4::mask_type )
+PAL_INLINE int compress_store( int32_t *out, lvec4 v, lvec4::mask_type m )
+{
+	int count;
+	store( out, compress( v, m, count ) );
+	return count;
+}
+
+#ifdef PAL_HAS_FVEC8
+/// @sa compress_store( float *, fvec4, fvec4::mask_type )
+PAL_INLINE int compress_store( float *out, fvec8 v, fvec8::mask_type m )
+{
+# if !defined(PAL_ENABLE_AVX2) && defined(PAL_ENABLE_SSSE3)
+	// straight to out, skipping the reload through the stack
+	return detail::compress_halves( out, v, m.which() );
+# else
+	int count;
+	store( out, compress( v, m, count ) );
+	return count;
+# endif
+}
+#endif
+
+#ifdef PAL_HAS_IVEC256
+/// @sa compress_store( float *, fvec4, fvec4::mask_type )
+PAL_INLINE int compress_store( int32_t *out, lvec8 v, lvec8::mask_type m )
+{
+# if !defined(PAL_ENABLE_AVX2) && defined(PAL_ENABLE_SSSE3)
+	return detail::compress_halves( out, v, m.which() );
+# else
+	int count;
+	store( out, compress( v, m, count ) );
+	return count;
+# endif
+}
+#endif
+
+} // namespace pal
+
+#endif // _PAL_X86_SIMD_COMPRESS_H_
@@ -0,0 +1,210 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use <pal/x86/simd_hyperbolic.h> directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_X86_SIMD_HYPERBOLIC_H_
+# define _PAL_X86_SIMD_HYPERBOLIC_H_ 1
+
+// hyperbolic functions, sinhf / coshf / tanhf for the float vectors
+// and sinh / cosh / tanh for the double vectors, built on expm1 so
+// there is no cancellation for small x (as the fdlibm versions).
+//
+// e^|x| overflows just before sinh and cosh do, so past that they
+// are computed as ( e^(|x|/2) / 2 ) e^(|x|/2). Measured against the
+// C library (long double), the larger of the sse2 and fma builds:
+//
+//   sinhf          2.44 ulp        sinh           2.5 ulp
+//   coshf          2.44 ulp        cosh           2 ulp
+//   tanhf          2.3 ulp         tanh           2.5 ulp
+//
+// The float figures are over every float. sinhf and coshf are worst
+// at -89.4, in the split past the expf overflow, and tanhf near 0.55.
+
+namespace PAL_NAMESPACE
+{
+
+namespace detail
+{
+
+template <typename T> struct hyperbolic_constants;
+
+template <> struct hyperbolic_constants<float>
+{
+	/// expf returns inf past this
+	static PAL_INLINE float exp_max( void ) { return 8.8721679688e+01F; }
+	/// tanh rounds to 1 past this
+	static PAL_INLINE float tanh_max( void ) { return 10.F; }
+};
+
+template <> struct hyperbolic_constants<double>
+{
+	static PAL_INLINE double exp_max( void ) { return 7.09782712893383973096e+02; }
+	static PAL_INLINE double tanh_max( void ) { return 22.0; }
+};
+
+template <typename VT>
+PAL_INLINE PAL_ENABLE_FLOAT(VT) special_expm1( VT x ) { return expm1f( x ); }
+template <typename VT>
+PAL_INLINE PAL_ENABLE_DOUBLE(VT) special_expm1( VT x ) { return expm1( x ); }
+
+/// @brief ( e^(|x|/2) / 2 ) e^(|x|/2) with the sign of s, for where
+/// e^|x| overflows
+template <typename VT>
+PAL_INLINE VT
+exp_half_squared( VT ax, VT s )
+{
+	VT w = special_exp( float_constants<VT>::one_half() * ax );
+	return ( s * w ) * w;
+}
+
+template <typename VT>
+inline VT
+sinh_impl( VT x )
+{
+	typedef hyperbolic_constants<typename VT::value_type> hconst;
+	const VT one = float_constants<VT>::one();
+	const VT emax( hconst::exp_max() );
+
+	VT ax = fabs( x );
+	VT h = copysign( float_constants<VT>::one_half(), x );
+	// 2 sinh( x ) = t + t / ( t + 1 ), t = e^|x| - 1
+	VT t = special_expm1( min( ax, emax ) );
+	VT r = h * ( t + t / ( t + one ) );
+	typename VT::mask_type big = ax > emax;
+	if ( big.any() )
+		r = ifthen( big, exp_half_squared( ax, h ), r );
+	return ifthen( isnan( x ), x, r );
+}
+
+template <typename VT>
+inline VT
+cosh_impl( VT x )
+{
+	typedef hyperbolic_constants<typename VT::value_type> hconst;
+	const VT half = float_constants<VT>::one_half();
+	const VT emax( hconst::exp_max() );
+
+	// no cancellation, cosh( x ) >= 1
+	VT ax = fabs( x );
+	VT e = special_exp( min( ax, emax ) );
+	VT r = fma( half, e, half / e );
+	typename VT::mask_type big = ax > emax;
+	if ( big.any() )
+		r = ifthen( big, exp_half_squared( ax, half ), r );
+	return ifthen( isnan( x ), x, r );
+}
+
+template <typename VT>
+inline VT
+tanh_impl( VT x )
+{
+	typedef hyperbolic_constants<typename VT::value_type> hconst;
+	const VT one = float_constants<VT>::one();
+	const VT two = float_constants<VT>::two();
+
+	// with t = e^(-2|x|) - 1 below 1 and t = e^(2|x|) - 1 above,
+	// tanh( |x| ) = -t / ( t + 2 ) and 1 - 2 / ( t + 2 )
+	VT ax = min( fabs( x ), VT( hconst::tanh_max() ) );
+	typename VT::mask_type small = ax < one;
+	VT t = special_expm1( ifthen( small, -two * ax, two * ax ) );
+	VT r = ifthen( small, -t / ( t + two ), one - two / ( t + two ) );
+	return ifthen( isnan( x ), x, copysign( r, x ) );
+}
+
+} // namespace detail
+
+////////////////////////////////////////
+
+/// @brief the hyperbolic sine
+template <typename VT>
+inline PAL_ENABLE_FLOAT(VT)
+sinhf( VT x )
+{
+	return detail::sinh_impl( x );
+}
+
+/// @brief the hyperbolic cosine
+template <typename VT>
+inline PAL_ENABLE_FLOAT(VT)
+coshf( VT x )
+{
+	return detail::cosh_impl( x );
+}
+
+/// @brief the hyperbolic tangent
+template <typename VT>
+inline PAL_ENABLE_FLOAT(VT)
+tanhf( VT x )
+{
+	return detail::tanh_impl( x );
+}
+
+/// @brief sinhf with a requested precision, there is only the full
+/// tier
+///
+/// @sa precision
+template <typename VT, int bits>
+inline PAL_ENABLE_FLOAT(VT)
+sinhf( VT x, precision<bits> )
+{
+	return sinhf( x );
+}
+
+/// @brief coshf with a requested precision, there is only the full
+/// tier
+///
+/// @sa precision
+template <typename VT, int bits>
+inline PAL_ENABLE_FLOAT(VT)
+coshf( VT x, precision<bits> )
+{
+	return coshf( x );
+}
+
+/// @brief tanhf with a requested precision, there is only the full
+/// tier
+///
+/// @sa precision
+template <typename VT, int bits>
+inline PAL_ENABLE_FLOAT(VT)
+tanhf( VT x, precision<bits> )
+{
+	return tanhf( x );
+}
+
+////////////////////////////////////////
+
+/// @brief double version of sinhf
+template <typename VT>
+inline PAL_ENABLE_DOUBLE(VT)
+sinh( VT x )
+{
+	return detail::sinh_impl( x );
+}
+
+/// @brief double version of coshf
+template <typename VT>
+inline PAL_ENABLE_DOUBLE(VT)
+cosh( VT x )
+{
+	return detail::cosh_impl( x );
+}
+
+/// @brief double version of tanhf
+template <typename VT>
+inline PAL_ENABLE_DOUBLE(VT)
+tanh( VT x )
+{
+	return detail::tanh_impl( x );
+}
+
+} // namespace pal
+
+#endif // _PAL_X86_SIMD_HYPERBOLIC_H_
@@ -63,16 +63,25 @@ PAL_INLINE void prefetch_readwrite( const void *buffer )
 template <typename itype>
 PAL_INLINE ivec128<itype> load( const itype *in )
 {
-	return ivec128<itype>( _mm_castps_epi32( _mm_loadu_ps( in ) ) );
+	return ivec128<itype>( _mm_loadu_si128( reinterpret_cast<const __m128i *>( in ) ) );
 }
 
 /// @brief load from a known aligned address
 template <typename itype>
 PAL_INLINE ivec128<itype> load_aligned( const itype *in )
 {
-	return ivec128<itype>( _mm_castps_epi32( _mm_load_ps( in ) ) );
+	return ivec128<itype>( _mm_load_si128( reinterpret_cast<const __m128i *>( in ) ) );
 }
 
+#ifdef PAL_ENABLE_AVX
+/// @brief load a 256-bit integer vector from any address
+template <typename itype>
+PAL_INLINE ivec256<itype> load256( const itype *in )
+{
+	return ivec256<itype>( _mm256_loadu_si256( reinterpret_cast<const __m256i *>( in ) ) );
+}
+#endif
+
 ////////////////////////////////////////
 
 /// @brief load a single value
@@ -124,8 +133,46 @@ PAL_INLINE fvec8 load8f_aligned( const float *in )
 {
 	return fvec8( _mm256_load_ps( in ) );
 }
+
+/// @brief load 4 values from each of two addresses into the low and
+/// high 128-bit lanes
+///
+/// Useful for processing interleaved data with the in-lane shuffles
+/// by treating each lane as an independent fvec4.
+PAL_INLINE fvec8 load8f_split( const float *lo, const float *hi )
+{
+	return fvec8( _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( lo ) ), _mm_loadu_ps( hi ), 1 ) );
+}
 #endif // PAL_HAS_FVEC8
 
+#ifdef PAL_HAS_DVEC2
+/// @brief load 2 doubles from any address
+PAL_INLINE dvec2 load2d( const double *in )
+{
+	return dvec2( _mm_loadu_pd( in ) );
+}
+
+/// @brief load 2 doubles from a known aligned address
+PAL_INLINE dvec2 load2d_aligned( const double *in )
+{
+	return dvec2( _mm_load_pd( in ) );
+}
+#endif
+
+#ifdef PAL_HAS_DVEC4
+/// @brief load 4 doubles from any address
+PAL_INLINE dvec4 load4d( const double *in )
+{
+	return dvec4( _mm256_loadu_pd( in ) );
+}
+
+/// @brief load 4 doubles from a known aligned address
+PAL_INLINE dvec4 load4d_aligned( const double *in )
+{
+	return dvec4( _mm256_load_pd( in ) );
+}
+#endif
+
 ////////////////////////////////////////
 ////////////////////////////////////////
 
@@ -188,6 +235,14 @@ PAL_INLINE void store_aligned( itype *out, ivec128<itype> v )
 	store_aligned( reinterpret_cast<float *>( out ), v.as_float() );
 }
 
+#ifdef PAL_ENABLE_AVX
+template <typename itype>
+PAL_INLINE void store( itype *out, ivec256<itype> v )
+{
+	_mm256_storeu_si256( reinterpret_cast<__m256i *>( out ), v );
+}
+#endif
+
 #ifdef PAL_HAS_FVEC8
 PAL_INLINE void store( float *out, fvec8 v )
 {
@@ -203,6 +258,39 @@ PAL_INLINE void stream_aligned( float *out, fvec8 v )
 {
 	_mm256_stream_ps( out, v );
 }
+
+/// @brief store the low and high 128-bit lanes to separate addresses
+///
+/// @sa load8f_split
+PAL_INLINE void store_split( float *lo, float *hi, fvec8 v )
+{
+	_mm_storeu_ps( lo, _mm256_castps256_ps128( v ) );
+	_mm_storeu_ps( hi, _mm256_extractf128_ps( v, 1 ) );
+}
+#endif
+
+#ifdef PAL_HAS_DVEC2
+PAL_INLINE void store( double *out, dvec2 v )
+{
+	_mm_storeu_pd( out, v );
+}
+
+PAL_INLINE void store_aligned( double *out, dvec2 v )
+{
+	_mm_store_pd( out, v );
+}
+#endif
+
+#ifdef PAL_HAS_DVEC4
+PAL_INLINE void store( double *out, dvec4 v )
+{
+	_mm256_storeu_pd( out, v );
+}
+
+PAL_INLINE void store_aligned( double *out, dvec4 v )
+{
+	_mm256_store_pd( out, v );
+}
 #endif
 
 #ifdef PAL_HAS_FVEC16
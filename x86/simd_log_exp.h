@@ -330,11 +330,8 @@ fast_log2f( VT d )
 	m -= float_constants<fvec>::one();
 
 	// Chebyshev polynomial to approximate log2
-	fvec y = fma( m, fvec( -0.0258411662F ), fvec( 0.1217970128F ) );
-	y = fma( m, y, fvec( -0.2779042655F ) );
-	y = fma( m, y, fvec( 0.4575485901F ) );
-	y = fma( m, y, fvec( -0.7181451002F ) );
-	y = fma( m, y, fvec( 1.4425449290F ) );
+	fvec y = polyval( m, 1.4425449290F, -0.7181451002F, 0.4575485901F,
+					  -0.2779042655F, 0.1217970128F, -0.0258411662F );
 
 	y = fma( m, y, e );
 
@@ -368,6 +365,160 @@ fast_log10f( VT f )
 
 ////////////////////////////////////////
 
+namespace detail
+{
+
+/// @brief reduces d to 2^k * (1 + f), returning f in [sqrt(2)/2-1, sqrt(2)-1]
+///
+/// same reduction as log2f, but leaves the polynomial to the caller
+template <typename VT>
+PAL_INLINE VT
+log_reduce( VT d, VT &fk )
+{
+	typedef VT fvec;
+	typedef typename fvec::int_vec_type ivec;
+	typedef float_extract_constants<fvec> econst;
+	typedef vector_limits<fvec> limits;
+
+	ivec id = d.as_int();
+	id += ivec( 0x3F800000 - 0x3f3504f3 );
+	ivec k = lsr( id & econst::exponent_mask(), limits::mantissa_bits ) - econst::bias();
+	id = ( id & econst::mantissa_mask() ) + ivec( 0x3f3504f3 );
+	fk = fvec::convert_int( k );
+	return id.as_float() - float_constants<fvec>::one();
+}
+
+/// @brief minimax polynomial for log(1+f)/f, ~14.3 bits relative
+template <typename VT>
+PAL_INLINE VT
+log_kernel( VT f, tier_low )
+{
+	return polyval( f, 9.999661814e-01F, -4.994506475e-01F, 3.363888424e-01F,
+					-2.709459943e-01F, 1.765805420e-01F );
+}
+
+/// @brief minimax polynomial for log(1+f)/f, ~19.8 bits relative
+template <typename VT>
+PAL_INLINE VT
+log_kernel( VT f, tier_medium )
+{
+	return polyval( f, 1.000000975e+00F, -5.000111289e-01F, 3.331450893e-01F,
+					-2.490974415e-01F, 2.049632891e-01F, -1.866785487e-01F,
+					1.189610807e-01F );
+}
+
+/// @brief applies the C library edge cases for the log family
+template <typename VT>
+PAL_INLINE VT
+log_special( VT d, VT ret )
+{
+	typedef VT fvec;
+	ret = ifthen( d < fvec::zero(), fvec( std::numeric_limits<float>::quiet_NaN() ), ret );
+	ret = ifthen( d == fvec::zero(), fvec( - std::numeric_limits<float>::infinity() ), ret );
+	return ifthen( isnan( d ) || isinf( d ), d, ret );
+}
+
+template <typename VT, typename tier>
+PAL_INLINE VT
+log2f_tier( VT d, tier t )
+{
+	VT fk;
+	VT f = log_reduce( d, fk );
+	return log_special( d, fma( f * log_kernel( f, t ), float_constants<VT>::log2_e(), fk ) );
+}
+
+template <typename VT>
+PAL_INLINE VT log2f_tier( VT d, tier_full ) { return log2f( d ); }
+
+template <typename VT, typename tier>
+PAL_INLINE VT
+logf_tier( VT d, tier t )
+{
+	VT fk;
+	VT f = log_reduce( d, fk );
+	return log_special( d, fma( fk, float_constants<VT>::log_2(), f * log_kernel( f, t ) ) );
+}
+
+template <typename VT>
+PAL_INLINE VT logf_tier( VT d, tier_full ) { return logf( d ); }
+
+template <typename VT, typename tier>
+PAL_INLINE VT
+log10f_tier( VT d, tier t )
+{
+	VT fk;
+	VT f = log_reduce( d, fk );
+	VT l = f * log_kernel( f, t );
+	return log_special( d, fma( fk, float_constants<VT>::log_2_10(),
+								l * float_constants<VT>::log10_e() ) );
+}
+
+template <typename VT>
+PAL_INLINE VT log10f_tier( VT d, tier_full ) { return log10f( d ); }
+
+} // namespace detail
+
+/// @brief log2f with a requested precision
+///
+/// @sa precision
+template <typename VT, int bits>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+log2f( VT d, precision<bits> )
+{
+	return detail::log2f_tier( d, typename detail::precision_tier<bits>::type() );
+}
+
+/// @brief logf with a requested precision
+///
+/// @sa precision
+template <typename VT, int bits>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+logf( VT d, precision<bits> )
+{
+	return detail::logf_tier( d, typename detail::precision_tier<bits>::type() );
+}
+
+/// @brief log10f with a requested precision
+///
+/// @sa precision
+template <typename VT, int bits>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+log10f( VT d, precision<bits> )
+{
+	return detail::log10f_tier( d, typename detail::precision_tier<bits>::type() );
+}
+
+
+////////////////////////////////////////
+
+namespace detail
+{
+
+/// @brief computes p * 2^k
+///
+/// splits the scale in two so k in [-252, 254] does not overflow
+/// the exponent of either factor, and the results saturate to 0 / inf
+/// through the multiply instead of needing extra selects
+template <typename VT>
+PAL_INLINE VT
+exp_scale( VT p, typename VT::int_vec_type k )
+{
+	typedef VT fvec;
+	typedef typename fvec::int_vec_type ivec;
+	typedef float_extract_constants<fvec> econst;
+	typedef vector_limits<fvec> limits;
+
+	ivec k1 = k >> 1;
+	ivec k2 = k - k1;
+	fvec s1 = ( ( k1 + econst::bias() ) << limits::mantissa_bits ).as_float();
+	fvec s2 = ( ( k2 + econst::bias() ) << limits::mantissa_bits ).as_float();
+	return ( p * s1 ) * s2;
+}
+
+} // namespace detail
+
+////////////////////////////////////////
+
 template <typename VT>
 inline PAL_ENABLE_FLOAT(VT)
 expf( VT x0 )
@@ -376,8 +527,6 @@ expf( VT x0 )
 	typedef typename VT::int_vec_type ivec;
 	typedef typename ivec::mask_type mvec;
 	typedef float_constants<fvec> fconst;
-	typedef float_extract_constants<fvec> econst;
-	typedef vector_limits<fvec> limits;
 
 	// based on sun microsystems / freebsd implementation
 	const fvec ln2hi( uint32_t(0x3f317200) );
@@ -385,6 +534,8 @@ expf( VT x0 )
 	const fvec invln2( uint32_t(0x3fb8aa3b) );
 	const fvec P1( 1.6666625440e-1f );
 	const fvec P2( -2.7667332906e-3f );
+	const fvec o_threshold( 8.8721679688e+01f );
+	const fvec u_threshold( -1.0397208405e+02f );
 
 	ivec hx = x0.as_int();
 	hx = hx & int_constants<ivec>::nonsign_bitmask();
@@ -396,7 +547,7 @@ expf( VT x0 )
 	fvec signmul = ifthen( do_inverse, - one, one );
 	const fvec half_sign = fconst::one_half() * signmul;
 
-	ivec k_15_ln2 = fma( invln2, x0, half_sign ).convert_to_int();
+	ivec k_15_ln2 = fma( invln2, x0, half_sign ).convert_to_int_trunc();
 	ivec k_not15_ln2 = signmul.convert_to_int();
 	ivec k = ifthen( gt_15_ln2, k_15_ln2, k_not15_ln2 );
 
@@ -413,17 +564,12 @@ expf( VT x0 )
 	fvec c = x - xx * (P1 + xx * P2);
 	fvec y = one + ( x * c / (fconst::two() - c) - lo + hi );
 
-	const ivec testMaxK = ivec( limits::exponent_bias );
-	const ivec testMinK = ivec( -( limits::exponent_bias - 1 ) );
-	ivec n = ( clamp( k, testMinK, testMaxK ) + econst::bias() );
-	ivec sn = n << limits::mantissa_bits;
-	fvec ey = y * sn.as_float();
-
-	ey = ifthen( k > testMaxK, fconst::infinity(), ey );
-	ey = ifthen( k < testMinK, fconst::zero(), ey );
-	y = ifthen( k == ivec::zero(), y, ey );
+	// scale in two steps so the top of the range (k == 128) and
+	// the denormal results don't need special handling
+	y = detail::exp_scale( y, k );
 	y = ifthen( hx <= ivec( 0x39000000 ), one + x0, y );
-	y = ifthen( hx >= ivec( 0x42aeac50 ), ifthen( do_inverse, fconst::zero(), fconst::infinity() ), y );
+	y = ifthen( x0 > o_threshold, fconst::infinity(), y );
+	y = ifthen( x0 < u_threshold, fconst::zero(), y );
 	y = ifthen( isnan( x0 ), x, y );
 	y = ifthen( isinf( x0 ) & (x0 < fconst::zero()), fconst::zero(), y );
 
@@ -442,13 +588,6 @@ exp2f( VT x0 )
 	typedef float_constants<fvec> fconst;
 	typedef int_constants<ivec> iconst;
 
-	const fvec P0( float(1.535336188319500E-004) );
-	const fvec P1( float(1.339887440266574E-003) );
-	const fvec P2( float(9.618437357674640E-003) );
-	const fvec P3( float(5.550332471162809E-002) );
-	const fvec P4( float(2.402264791363012E-001) );
-	const fvec P5( float(6.931472028550421E-001) );
-
 	fvec px = floorf( x0 );
 	ivec i0 = px.convert_to_int();
 	fvec x = x0 - px;
@@ -456,13 +595,14 @@ exp2f( VT x0 )
 	i0 = ifthen( gt05, i0 + iconst::one(), i0 );
 	x = ifthen( gt05, x - fconst::one(), x );
 
-	fvec peval = P0;
-	peval = fma( peval, x, P1 );
-	peval = fma( peval, x, P2 );
-	peval = fma( peval, x, P3 );
-	peval = fma( peval, x, P4 );
-	peval = fma( peval, x, P5 );
-	px = fma( x, peval, fconst::one() );
+	// horner rather than polyval to keep results bit exact with libm
+	px = horner( x, 1.F,
+				 float(6.931472028550421E-001),
+				 float(2.402264791363012E-001),
+				 float(5.550332471162809E-002),
+				 float(9.618437357674640E-003),
+				 float(1.339887440266574E-003),
+				 float(1.535336188319500E-004) );
 	fvec rval = ldexpf( px, i0 );
 	rval = ifthen( x0 == fconst::zero(), fconst::one(), rval );
 	rval = ifthen( x0 > fvec( 127.F ), fconst::infinity(), rval );
@@ -480,13 +620,6 @@ exp10f( VT x0 )
 	typedef typename VT::int_vec_type ivec;
 	typedef float_constants<fvec> fconst;
 
-	const fvec P0( float(2.063216740311022E-001) );
-	const fvec P1( float(5.420251702225484E-001) );
-	const fvec P2( float(1.171292686296281E+000) );
-	const fvec P3( float(2.034649854009453E+000) );
-	const fvec P4( float(2.650948748208892E+000) );
-	const fvec P5( float(2.302585167056758E+000) );
-
 	const fvec LOG210( float(3.32192809488736234787e0) );
 	const fvec LG102A( float(3.00781250000000000000E-1) );
 	const fvec LG102B( float(2.48745663981195213739E-4) );
@@ -497,13 +630,13 @@ exp10f( VT x0 )
 	fvec x = x0 - qx * LG102A;
 	x -= qx * LG102B;
 
-	fvec r = P0;
-	r = fma( r, x, P1 );
-	r = fma( r, x, P2 );
-	r = fma( r, x, P3 );
-	r = fma( r, x, P4 );
-	r = fma( r, x, P5 );
-	r = fma( x, r, fconst::one() );
+	fvec r = horner( x, 1.F,
+					 float(2.302585167056758E+000),
+					 float(2.650948748208892E+000),
+					 float(2.034649854009453E+000),
+					 float(1.171292686296281E+000),
+					 float(5.420251702225484E-001),
+					 float(2.063216740311022E-001) );
 	r = ldexpf( r, n );
 
 	r = ifthen( x0 == fconst::zero(), fconst::one(), r );
@@ -529,29 +662,19 @@ fast_expf( VT x0 )
 	const fvec MAXLOGF( float(88.02969187150841) );
 	const fvec MINLOGF( float(-88.7228391116729996) );
 
-	const fvec P0( float(1.9875691500E-4) );
-	const fvec P1( float(1.3981999507E-3) );
-	const fvec P2( float(8.3334519073E-3) );
-	const fvec P3( float(4.1665795894E-2) );
-	const fvec P4( float(1.6666665459E-1) );
-	const fvec P5( float(5.0000001201E-1) );
-
 	fvec z = floorf( fma( LOG2EF, x0, fconst::one_half() ) );
 	fvec x = nmadd( z, C2, nmadd( z, C1, x0 ) );
 	ivec n = z.convert_to_int();
 	z = x * x;
 
-	fvec r = fma(
-		fma(
-			fma(
-				fma(
-					fma(
-						fma( x, P0, P1 ),
-						x, P2 ),
-					x, P3 ),
-				x, P4 ),
-			x, P5 ),
-		z, x + fconst::one() );
+	fvec r = polyval( x,
+					  float(5.0000001201E-1),
+					  float(1.6666665459E-1),
+					  float(4.1665795894E-2),
+					  float(8.3334519073E-3),
+					  float(1.3981999507E-3),
+					  float(1.9875691500E-4) );
+	r = fma( r, z, x + fconst::one() );
 	r = ldexpf( r, n );
 
 	r = ifthen( x0 == fconst::zero(), fconst::one(), r );
@@ -601,6 +724,381 @@ fast_exp10f( VT v )
 
 ////////////////////////////////////////
 
+namespace detail
+{
+
+/// @brief minimax polynomial for e^r on [-ln2/2, ln2/2], ~12.4 bits relative
+///
+/// fit as 1 + r * P(r) so exact powers of two stay exact
+template <typename VT>
+PAL_INLINE VT
+exp_kernel( VT r, tier_low )
+{
+	return polyval( r, 1.F, 1.000044901e+00F, 5.037513569e-01F, 1.666662305e-01F );
+}
+
+/// @brief minimax polynomial for e^r on [-ln2/2, ln2/2], ~22 bits relative
+template <typename VT>
+PAL_INLINE VT
+exp_kernel( VT r, tier_medium )
+{
+	return polyval( r, 1.F, 9.999999465e-01F, 4.999937694e-01F, 1.666693496e-01F,
+					4.187511121e-02F, 8.333321173e-03F );
+}
+
+template <typename VT, typename tier>
+PAL_INLINE VT
+expf_tier( VT x0, tier t )
+{
+	typedef VT fvec;
+	typedef typename fvec::int_vec_type ivec;
+
+	const fvec ln2hi( uint32_t(0x3f317200) );
+	const fvec ln2lo( uint32_t(0x35bfbe8e) );
+
+	fvec x = clamp( x0, fvec( -104.F ), fvec( 89.F ) );
+	ivec k = ( x * float_constants<fvec>::log2_e() ).convert_to_int();
+	fvec fk = fvec::convert_int( k );
+	fvec r = nmadd( fk, ln2lo, nmadd( fk, ln2hi, x ) );
+	return ifthen( isnan( x0 ), x0, exp_scale( exp_kernel( r, t ), k ) );
+}
+
+template <typename VT>
+PAL_INLINE VT expf_tier( VT x0, tier_full ) { return expf( x0 ); }
+
+template <typename VT, typename tier>
+PAL_INLINE VT
+exp2f_tier( VT x0, tier t )
+{
+	typedef VT fvec;
+	typedef typename fvec::int_vec_type ivec;
+
+	fvec x = clamp( x0, fvec( -151.F ), fvec( 129.F ) );
+	ivec k = x.convert_to_int();
+	fvec r = ( x - fvec::convert_int( k ) ) * float_constants<fvec>::log_2();
+	return ifthen( isnan( x0 ), x0, exp_scale( exp_kernel( r, t ), k ) );
+}
+
+template <typename VT>
+PAL_INLINE VT exp2f_tier( VT x0, tier_full ) { return exp2f( x0 ); }
+
+template <typename VT, typename tier>
+PAL_INLINE VT
+exp10f_tier( VT x0, tier t )
+{
+	typedef VT fvec;
+	typedef typename fvec::int_vec_type ivec;
+
+	const fvec LOG210( float(3.32192809488736234787e0) );
+	const fvec LG102A( float(3.00781250000000000000E-1) );
+	const fvec LG102B( float(2.48745663981195213739E-4) );
+
+	fvec x = clamp( x0, fvec( -46.F ), fvec( 39.F ) );
+	ivec k = ( x * LOG210 ).convert_to_int();
+	fvec fk = fvec::convert_int( k );
+	fvec r = nmadd( fk, LG102B, nmadd( fk, LG102A, x ) ) * float_constants<fvec>::log_10();
+	return ifthen( isnan( x0 ), x0, exp_scale( exp_kernel( r, t ), k ) );
+}
+
+template <typename VT>
+PAL_INLINE VT exp10f_tier( VT x0, tier_full ) { return exp10f( x0 ); }
+
+} // namespace detail
+
+/// @brief expf with a requested precision
+///
+/// @sa precision
+template <typename VT, int bits>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+expf( VT x, precision<bits> )
+{
+	return detail::expf_tier( x, typename detail::precision_tier<bits>::type() );
+}
+
+/// @brief exp2f with a requested precision
+///
+/// @sa precision
+template <typename VT, int bits>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+exp2f( VT x, precision<bits> )
+{
+	return detail::exp2f_tier( x, typename detail::precision_tier<bits>::type() );
+}
+
+/// @brief exp10f with a requested precision
+///
+/// @sa precision
+template <typename VT, int bits>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+exp10f( VT x, precision<bits> )
+{
+	return detail::exp10f_tier( x, typename detail::precision_tier<bits>::type() );
+}
+
+////////////////////////////////////////
+
+namespace detail
+{
+
+/// @brief p * 2^k for the double vectors, split in two as exp_scale
+template <typename VT>
+PAL_INLINE VT
+exp_scale_d( VT p, typename VT::int_vec_type k )
+{
+	typedef typename VT::int_vec_type llvec;
+	llvec k1 = k >> 1;
+	llvec k2 = k - k1;
+	VT s1( ( ( k1 + int64_t(1023) ) << 52 ).as_double() );
+	VT s2( ( ( k2 + int64_t(1023) ) << 52 ).as_double() );
+	return ( p * s1 ) * s2;
+}
+
+} // namespace detail
+
+/// @brief computes e^x for double vectors
+///
+/// Rounds x / ln2 to k with the 1.5 * 2^52 shifter (leaving k in the
+/// low bits of the mantissa, so no 64-bit integer conversion is
+/// needed), reduces with a two part ln2 and evaluates the taylor
+/// series to degree 13, which is below 0.5e-16 on |r| <= ln2 / 2.
+/// Within 1 ulp.
+template <typename VT>
+inline PAL_ENABLE_DOUBLE(VT)
+exp( VT x )
+{
+	typedef VT dvec;
+	typedef typename VT::int_vec_type llvec;
+	typedef float_constants<dvec> fconst;
+
+	const dvec shifter( 6755399441055744.0 );
+	const dvec ln2hi( 6.93147180369123816490e-01 );
+	const dvec ln2lo( 1.90821492927058770002e-10 );
+	const dvec o_threshold( 7.09782712893383973096e+02 );
+	const dvec u_threshold( -7.45133219101941108420e+02 );
+
+	dvec xc = min( max( x, u_threshold ), o_threshold );
+	dvec kd = fma( xc, fconst::log2_e(), shifter );
+	llvec k = kd.as_int() - shifter.as_int();
+	kd -= shifter;
+
+	dvec r = nmadd( kd, ln2lo, nmadd( kd, ln2hi, xc ) );
+	dvec q = horner( r, 1.0 / 2.0, 1.0 / 6.0, 1.0 / 24.0, 1.0 / 120.0,
+					 1.0 / 720.0, 1.0 / 5040.0, 1.0 / 40320.0, 1.0 / 362880.0,
+					 1.0 / 3628800.0, 1.0 / 39916800.0, 1.0 / 479001600.0,
+					 1.0 / 6227020800.0 );
+	dvec y = fconst::one() + fma( r * r, q, r );
+
+	y = detail::exp_scale_d( y, k );
+	y = ifthen( x > o_threshold, fconst::infinity(), y );
+	y = ifthen( x < u_threshold, fconst::zero(), y );
+	return ifthen( isnan( x ), x, y );
+}
+
+/// @brief computes the natural log for double vectors
+///
+/// Same reduction and polynomial as the freebsd / fdlibm log, within 1
+/// ulp. Denormals are scaled up first.
+template <typename VT>
+inline PAL_ENABLE_DOUBLE(VT)
+log( VT d )
+{
+	typedef VT dvec;
+	typedef typename VT::int_vec_type llvec;
+	typedef float_constants<dvec> fconst;
+
+	const dvec ln2hi( 6.93147180369123816490e-01 );
+	const dvec ln2lo( 1.90821492927058770002e-10 );
+	const dvec Lg1( 6.666666666666735130e-01 );
+	const dvec Lg2( 3.999999999940941908e-01 );
+	const dvec Lg3( 2.857142874366239149e-01 );
+	const dvec Lg4( 2.222219843214978396e-01 );
+	const dvec Lg5( 1.818357216161805012e-01 );
+	const dvec Lg6( 1.531383769920937332e-01 );
+	const dvec Lg7( 1.479819860511658591e-01 );
+	// 2^52, the exponent is converted by placing it in the mantissa
+	const dvec two52( 4503599627370496.0 );
+
+	typename VT::mask_type tiny = d < fconst::min();
+	dvec x = ifthen( tiny, d * dvec( 18014398509481984.0 ), d );
+
+	// reduce to [sqrt(2)/2, sqrt(2)]
+	llvec id = x.as_int() + int64_t( 0x3ff0000000000000LL - 0x3fe6a09e667f3bcdLL );
+	llvec ik = lsr( id, 52 );
+	id = ( id & llvec( int64_t( 0x000fffffffffffffLL ) ) ) + int64_t( 0x3fe6a09e667f3bcdLL );
+
+	dvec k( ( ik | llvec( int64_t( 0x4330000000000000LL ) ) ).as_double() );
+	k = k - two52 - ifthen( tiny, dvec( 1023.0 + 54.0 ), dvec( 1023.0 ) );
+
+	dvec f = dvec( id.as_double() ) - fconst::one();
+	dvec s = f / ( fconst::two() + f );
+	dvec z = s * s;
+	dvec w = z * z;
+	dvec t1 = w * fma( w, fma( w, Lg6, Lg4 ), Lg2 );
+	dvec t2 = z * fma( w, fma( w, fma( w, Lg7, Lg5 ), Lg3 ), Lg1 );
+	dvec R = t2 + t1;
+	dvec hfsq = fconst::one_half() * f * f;
+	dvec ret = fma( k, ln2hi, f - ( hfsq - fma( s, hfsq + R, k * ln2lo ) ) );
+
+	ret = ifthen( d < dvec::zero(), fconst::nan(), ret );
+	ret = ifthen( d == dvec::zero(), - fconst::infinity(), ret );
+	return ifthen( isnan( d ) || d == fconst::infinity(), d, ret );
+}
+
+////////////////////////////////////////
+
+/// @brief computes e^x - 1 without the cancellation of expf( x ) - 1
+/// for small x
+///
+/// Reduces as exp does to r in [-ln2 / 2, ln2 / 2], where
+/// r + r^2 Q( r ) holds the precision for small r, then
+/// e^x - 1 = 2^k ( u + 1 ) - 1 with 2^k - 1 exact for the k where
+/// the - 1 matters. Within 2 ulp.
+template <typename VT>
+inline PAL_ENABLE_FLOAT(VT)
+expm1f( VT x )
+{
+	typedef VT fvec;
+	typedef typename VT::int_vec_type ivec;
+	typedef float_constants<fvec> fconst;
+	typedef float_extract_constants<fvec> econst;
+	typedef vector_limits<fvec> limits;
+
+	const fvec shifter( 12582912.F );
+	const fvec ln2hi( uint32_t(0x3f317200) );
+	const fvec ln2lo( uint32_t(0x35bfbe8e) );
+	// the largest x with e^x finite
+	const fvec o_threshold( 8.87228317e+01f );
+	// e^x - 1 rounds to -1 below this
+	const fvec u_threshold( -18.F );
+	const fvec one = fconst::one();
+
+	fvec xc = min( max( x, u_threshold ), o_threshold );
+	fvec kd = fma( xc, fconst::log2_e(), shifter );
+	ivec k = ivec( kd.as_int() ) - ivec( shifter.as_int() );
+	kd -= shifter;
+
+	fvec r = nmadd( kd, ln2lo, nmadd( kd, ln2hi, xc ) );
+	fvec q = horner( r, 5.00000001338565592e-01, 1.66666665323071256e-01,
+					 4.16664654663066389e-02, 8.33336072242546640e-03,
+					 1.39336044037145128e-03, 1.98578022830580263e-04 );
+	fvec u = fma( r * r, q, r );
+
+	fvec t( ( ( k + econst::bias() ) << limits::mantissa_bits ).as_float() );
+	fvec y = fma( t, u, t - one );
+	// 2^128 overflows at the top of the range
+	typename fvec::mask_type top = kd > fvec( 100.F );
+	if ( top.any() )
+		y = ifthen( top, detail::exp_scale( u + one, k ), y );
+
+	y = ifthen( x > o_threshold, fconst::infinity(), y );
+	// x for nan and -0
+	return ifthen( isnan( x ) || x == fvec::zero(), x, y );
+}
+
+/// @brief computes log( 1 + x ) without the loss of precision of
+/// logf( 1 + x ) for small x
+///
+/// 1 + x rounds to u, the rounding error is put back as
+/// log( 1 + x ) = log( u ) + ( x - ( u - 1 ) ) / u, u - 1 being
+/// exact. Within 2 ulp.
+template <typename VT>
+inline PAL_ENABLE_FLOAT(VT)
+log1pf( VT x )
+{
+	typedef VT fvec;
+	typedef float_constants<fvec> fconst;
+
+	const fvec one = fconst::one();
+	fvec u = x + one;
+	fvec l = logf( u );
+	fvec c = ( x - ( u - one ) ) / u;
+	// -1, inf and nan are as for logf, -0 stays -0
+	typename fvec::mask_type ok = u > fvec::zero() && u < fconst::infinity();
+	l = ifthen( ok, l + c, l );
+	l = ifthen( x < - one, fconst::nan(), l );
+	return ifthen( x == fvec::zero(), x, l );
+}
+
+/// @brief expm1f with a requested precision, there is only the full
+/// tier
+///
+/// @sa precision
+template <typename VT, int bits>
+inline PAL_ENABLE_FLOAT(VT)
+expm1f( VT x, precision<bits> )
+{
+	return expm1f( x );
+}
+
+/// @brief log1pf with a requested precision, there is only the full
+/// tier
+///
+/// @sa precision
+template <typename VT, int bits>
+inline PAL_ENABLE_FLOAT(VT)
+log1pf( VT x, precision<bits> )
+{
+	return log1pf( x );
+}
+
+/// @brief double version of expm1f, with the taylor series as for
+/// exp. Within 2 ulp.
+template <typename VT>
+inline PAL_ENABLE_DOUBLE(VT)
+expm1( VT x )
+{
+	typedef VT dvec;
+	typedef typename VT::int_vec_type llvec;
+	typedef float_constants<dvec> fconst;
+
+	const dvec shifter( 6755399441055744.0 );
+	const dvec ln2hi( 6.93147180369123816490e-01 );
+	const dvec ln2lo( 1.90821492927058770002e-10 );
+	const dvec o_threshold( 7.09782712893383973096e+02 );
+	const dvec u_threshold( -40.0 );
+	const dvec one = fconst::one();
+
+	dvec xc = min( max( x, u_threshold ), o_threshold );
+	dvec kd = fma( xc, fconst::log2_e(), shifter );
+	llvec k = kd.as_int() - shifter.as_int();
+	kd -= shifter;
+
+	dvec r = nmadd( kd, ln2lo, nmadd( kd, ln2hi, xc ) );
+	dvec q = horner( r, 1.0 / 2.0, 1.0 / 6.0, 1.0 / 24.0, 1.0 / 120.0,
+					 1.0 / 720.0, 1.0 / 5040.0, 1.0 / 40320.0, 1.0 / 362880.0,
+					 1.0 / 3628800.0, 1.0 / 39916800.0, 1.0 / 479001600.0,
+					 1.0 / 6227020800.0 );
+	dvec u = fma( r * r, q, r );
+
+	dvec t( ( ( k + int64_t(1023) ) << 52 ).as_double() );
+	dvec y = fma( t, u, t - one );
+	typename dvec::mask_type top = kd > dvec( 1000.0 );
+	if ( top.any() )
+		y = ifthen( top, detail::exp_scale_d( u + one, k ), y );
+
+	y = ifthen( x > o_threshold, fconst::infinity(), y );
+	return ifthen( isnan( x ) || x == dvec::zero(), x, y );
+}
+
+/// @brief double version of log1pf
+template <typename VT>
+inline PAL_ENABLE_DOUBLE(VT)
+log1p( VT x )
+{
+	typedef VT dvec;
+	typedef float_constants<dvec> fconst;
+
+	const dvec one = fconst::one();
+	dvec u = x + one;
+	dvec l = log( u );
+	dvec c = ( x - ( u - one ) ) / u;
+	typename dvec::mask_type ok = u > dvec::zero() && u < fconst::infinity();
+	l = ifthen( ok, l + c, l );
+	return ifthen( x == dvec::zero(), x, l );
+}
+
+////////////////////////////////////////
+
 template <typename VT>
 inline PAL_ENABLE_ANY_FLOAT(VT)
 pow( VT v, VT p )
@@ -684,19 +1182,18 @@ pow( VT v, int p )
 	return dorecp ? recip( a ) : a;
 }
 
+namespace detail
+{
+
+/// @brief applies the C library special cases to norm_res, which is
+/// assumed to be exp2( p * log2( |v| ) ) for the regular values
 template <typename VT>
-inline PAL_ENABLE_FLOAT(VT)
-powf( VT v, VT p )
+inline VT
+powf_special( VT v, VT p, VT norm_res )
 {
-//	return pow( v, p );
 	typedef VT fvec;
 	typedef typename VT::mask_type mvec;
 	typedef typename VT::int_vec_type ivec;
-	fvec aval = fabsf( v );
-	// TODO: need to increase precision of log2f estimate * p?
-	// this gives us ~18 bits of mantissa precision, maybe 19
-	// although is sometimes better
-	fvec norm_res = exp2f( p * log2f( aval ) );
 
 	const fvec zero = float_constants<fvec>::zero();
 	const fvec one = float_constants<fvec>::one();
@@ -769,6 +1266,39 @@ powf( VT v, VT p )
 	return res;
 }
 
+} // namespace detail
+
+template <typename VT>
+inline PAL_ENABLE_FLOAT(VT)
+powf( VT v, VT p )
+{
+//	return pow( v, p );
+	// TODO: need to increase precision of log2f estimate * p?
+	// this gives us ~18 bits of mantissa precision, maybe 19
+	// although is sometimes better
+	return detail::powf_special( v, p, exp2f( p * log2f( fabsf( v ) ) ) );
+}
+
+/// @brief powf with a requested precision
+///
+/// The precision applies to the log2 / exp2 kernels, the error of
+/// the result grows with the magnitude of p * log2( v ).
+///
+/// @sa precision
+template <typename VT, int bits>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+powf( VT v, VT p, precision<bits> prec )
+{
+	return detail::powf_special( v, p, exp2f( p * log2f( fabsf( v ), prec ), prec ) );
+}
+
+template <typename VT, int bits>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+powf( VT v, float p, precision<bits> prec )
+{
+	return powf( v, VT(p), prec );
+}
+
 template <typename VT>
 PAL_INLINE PAL_ENABLE_FLOAT(VT)
 powf( VT v, float p )
@@ -825,16 +1355,42 @@ fast_powf( VT v, float p )
 
 ////////////////////////////////////////
 
+namespace detail
+{
+
+/// @brief one newton step for x^3 = xm, enough to reach ~12 bits
+/// from the seed polynomial
 template <typename VT>
-inline PAL_ENABLE_FLOAT(VT)
-cbrtf( VT v )
+PAL_INLINE VT
+cbrt_refine( VT x, VT xm, tier_low )
+{
+	return ( x + x + xm / ( x * x ) ) * VT( float(1.0/3.0) );
+}
+
+/// @brief one round of Halley's method for x^3 = xm
+template <typename VT, typename tier>
+PAL_INLINE VT
+cbrt_refine( VT x, VT xm, tier )
+{
+	VT x3 = x * x * x;
+	return x * fma( xm, float_constants<VT>::two(), x3 ) / fma( float_constants<VT>::two(), x3, xm );
+}
+
+template <typename VT, typename tier>
+inline VT
+cbrtf_tier( VT v, tier t )
 {
 	typedef VT fvec;
 	typedef typename VT::int_vec_type lvec;
 
+	// frexpf does not normalize denormals, so scale those up by
+	// 2^24 and the result back down by 2^8 at the end
+	typename VT::mask_type tiny = fabsf( v ) < float_constants<fvec>::min();
+	fvec av = fabsf( ifthen( tiny, v * fvec( float(16777216.0) ), v ) );
+
 	lvec xe;
 	// reduct to 1.0 to 0.5
-	fvec xm = frexpf( fabsf( v ), xe );
+	fvec xm = frexpf( av, xe );
 
 	// newton raphson equation:
 	// x_1 = (1/3)(2*x1 + v / x^2);
@@ -846,9 +1402,7 @@ cbrtf( VT v )
 	// approximation
 	fvec x = fma( xm, nmadd( xm, fvec(0.191502161678719066F), fvec(0.697570460207922770F) ), fvec(0.492659620528969547F) );
 
-	// one round of Halley's to refine
-	fvec x3 = x * x * x;
-	fvec x_1 = x * fma( xm, float_constants<fvec>::two(), x3 ) / fma( float_constants<fvec>::two(), x3, xm );
+	fvec x_1 = cbrt_refine( x, xm, t );
 
 	// multiply by factor depending on the rounding necessary
 	// to handle remainder of xe / 3
@@ -868,10 +1422,30 @@ cbrtf( VT v )
 									 x_1 * fvec(float(1.5874010519681994748)) ) ) );
 
 	y = ldexpf( copysign( y, v ), nxe );
+	y = ifthen( tiny, y * fvec( float(1.0/256.0) ), y );
 	// handle inf and nan
 	return ifthen( isnormal( v ), y, v );
 }
 
+} // namespace detail
+
+template <typename VT>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+cbrtf( VT v )
+{
+	return detail::cbrtf_tier( v, detail::tier_full() );
+}
+
+/// @brief cbrtf with a requested precision
+///
+/// @sa precision
+template <typename VT, int bits>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+cbrtf( VT v, precision<bits> )
+{
+	return detail::cbrtf_tier( v, typename detail::precision_tier<bits>::type() );
+}
+
 } // namespace pal
 
 
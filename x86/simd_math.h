@@ -14,15 +14,22 @@
 
 #include "fvec4_operators.h"
 #include "ivec4_operators.h"
+#include "llvec2_operators.h"
 #include "dvec2_operators.h"
 
 #include "fvec8_operators.h"
 #include "ivec8_operators.h"
+#include "llvec4_operators.h"
 #include "dvec4_operators.h"
+#include "ivec_divide.h"
+#include "ivec_pack.h"
 
 #include "fvec4_math.h"
 #include "ivec4_math.h"
+#include "ivec8_math.h"
 #include "fvec8_math.h"
+#include "dvec2_math.h"
+#include "dvec4_math.h"
 
 namespace PAL_NAMESPACE
 {
@@ -100,7 +107,7 @@ copysign( vec a, vec b )
 	typedef typename vec::mask_type mvec;
 
 	mvec m( constants::sign_bitmask() );
-	return m.bit_mix( a, b );
+	return vec( m.bit_mix( a, b ) );
 }
 
 /// @brief implements standard c copysign function
@@ -167,6 +174,84 @@ lerp( vec a, vec b, vec t )
 	return fma( b, t, nmadd( a, t, a ) );
 }
 
+////////////////////////////////////////
+
+namespace detail
+{
+
+/// @brief tier selection for the hardware estimate functions
+///
+/// the rcp / rsqrt estimates are only good to ~11.4 bits, and one
+/// newton step gets to ~22, so these do not use the transcendental
+/// tiers from precision_tier.
+template <int bits>
+struct estimate_tier
+	: std::integral_constant<int, ( bits <= 11 ? 0 : ( bits <= 21 ? 1 : 2 ) )>
+{};
+
+template <typename vec>
+PAL_INLINE vec recip_tier( vec v, tier_low ) { return faster_recip( v ); }
+template <typename vec>
+PAL_INLINE vec recip_tier( vec v, tier_medium ) { return fast_recip( v ); }
+template <typename vec>
+PAL_INLINE vec recip_tier( vec v, tier_full ) { return recip( v ); }
+
+template <typename vec>
+PAL_INLINE vec rsqrtf_tier( vec v, tier_low ) { return faster_rsqrtf( v ); }
+template <typename vec>
+PAL_INLINE vec rsqrtf_tier( vec v, tier_medium ) { return fast_rsqrtf( v ); }
+template <typename vec>
+PAL_INLINE vec rsqrtf_tier( vec v, tier_full ) { return rsqrtf( v ); }
+
+template <typename vec, typename tier>
+PAL_INLINE vec
+sqrtf_tier( vec v, tier t )
+{
+	// the estimates treat denormals as zero, so scale those up by
+	// 2^24 and the result back down by 2^12
+	typename vec::mask_type tiny = v < float_constants<vec>::min();
+	vec sv = ifthen( tiny, v * vec( float(16777216.0) ), v );
+	vec r = sv * rsqrtf_tier( sv, t );
+	r = ifthen( tiny, r * vec( float(1.0/4096.0) ), r );
+	// v * 1/sqrt(v) is NaN for 0 and +inf, so put those back
+	return ifthen( v == vec::zero() || v == float_constants<vec>::infinity(), v, r );
+}
+
+template <typename vec>
+PAL_INLINE vec sqrtf_tier( vec v, tier_full ) { return sqrtf( v ); }
+
+} // namespace detail
+
+/// @brief recip with a requested precision
+///
+/// @sa precision
+template <typename vec, int bits>
+PAL_INLINE PAL_ENABLE_FLOAT(vec)
+recip( vec v, precision<bits> )
+{
+	return detail::recip_tier( v, typename detail::estimate_tier<bits>::type() );
+}
+
+/// @brief rsqrtf with a requested precision
+///
+/// @sa precision
+template <typename vec, int bits>
+PAL_INLINE PAL_ENABLE_FLOAT(vec)
+rsqrtf( vec v, precision<bits> )
+{
+	return detail::rsqrtf_tier( v, typename detail::estimate_tier<bits>::type() );
+}
+
+/// @brief sqrtf with a requested precision
+///
+/// @sa precision
+template <typename vec, int bits>
+PAL_INLINE PAL_ENABLE_FLOAT(vec)
+sqrtf( vec v, precision<bits> )
+{
+	return detail::sqrtf_tier( v, typename detail::estimate_tier<bits>::type() );
+}
+
 } // namespace pal
 
 #endif // _PAL_X86_SIMD_MATH_H_
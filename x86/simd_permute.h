@@ -69,14 +69,305 @@ template <> PAL_INLINE fvec4 permute<0,1,0,1>( fvec4 v )
 }
 #endif
 
+/// @brief compile-time blend, taking element i from b where m_i is
+/// non-zero, otherwise from a
+template <int m0, int m1, int m2, int m3>
+PAL_INLINE fvec4 blend( fvec4 a, fvec4 b )
+{
+#ifdef PAL_ENABLE_SSE4_1
+	return fvec4( _mm_blend_ps( a, b, (m0?1:0)|(m1?2:0)|(m2?4:0)|(m3?8:0) ) );
+#else
+	__m128 m = _mm_castsi128_ps( _mm_setr_epi32( m0?-1:0, m1?-1:0, m2?-1:0, m3?-1:0 ) );
+	return fvec4( _mm_or_ps( _mm_and_ps( m, b ), _mm_andnot_ps( m, a ) ) );
+#endif
+}
+
+template <int m0, int m1, int m2, int m3>
+PAL_INLINE lvec4 blend( lvec4 a, lvec4 b )
+{
+#ifdef PAL_ENABLE_SSE4_1
+	return lvec4( _mm_blend_epi16( a, b, (m0?0x03:0)|(m1?0x0C:0)|(m2?0x30:0)|(m3?0xC0:0) ) );
+#else
+	__m128i m = _mm_setr_epi32( m0?-1:0, m1?-1:0, m2?-1:0, m3?-1:0 );
+	return lvec4( _mm_or_si128( _mm_and_si128( m, b ), _mm_andnot_si128( m, a ) ) );
+#endif
+}
+
+template <int m0, int m1>
+PAL_INLINE dvec2 blend( dvec2 a, dvec2 b )
+{
+#ifdef PAL_ENABLE_SSE4_1
+	return dvec2( _mm_blend_pd( a, b, (m0?1:0)|(m1?2:0) ) );
+#else
+	return dvec2( _mm_shuffle_pd( m0 ? b : a, m1 ? b : a, 0x2 ) );
+#endif
+}
+
+/// @brief runtime permute, element i of the result is v[idx[i] & 3]
+PAL_INLINE fvec4 permute( fvec4 v, lvec4 idx )
+{
+#ifdef PAL_ENABLE_AVX
+	return fvec4( _mm_permutevar_ps( v, idx ) );
+#else
+	PAL_ALIGN_128 float vals[4];
+	PAL_ALIGN_128 int32_t ivals[4];
+	_mm_store_ps( vals, v );
+	_mm_store_si128( reinterpret_cast<__m128i *>( ivals ), idx );
+	return fvec4( vals[ivals[0] & 3], vals[ivals[1] & 3], vals[ivals[2] & 3], vals[ivals[3] & 3] );
+#endif
+}
+
 #ifdef PAL_ENABLE_AVX
-//template <int a, int b, int c, int d, int e, int f, int g, int h>
-//PAL_INLINE fvec8 permute( fvec8 v )
-//{
-//	__m128 lo = _mm256_castps256_ps128( v );
-//	__m128 hi = _mm256_extractf128_ps( v, 1 );
-//}
+
+namespace detail
+{
+
+/// @brief classifies an 8 element permute to pick the instruction
+///
+/// AVX instructions mostly operate within each 128-bit lane, so the
+/// cheap cases are the ones where no element crosses lanes (and
+/// ideally both lanes use the same pattern, which is an immediate
+/// instead of a control vector).
+template <int a, int b, int c, int d, int e, int f, int g, int h>
+struct permute8_info
+{
+	static_assert( a >= 0 && a < 8 && b >= 0 && b < 8 && c >= 0 && c < 8 && d >= 0 && d < 8 &&
+				   e >= 0 && e < 8 && f >= 0 && f < 8 && g >= 0 && g < 8 && h >= 0 && h < 8,
+				   "permute indices must be in [0, 8)" );
+	static const bool identity = ( a == 0 && b == 1 && c == 2 && d == 3 &&
+								   e == 4 && f == 5 && g == 6 && h == 7 );
+	/// the in-lane pattern is the same for both lanes
+	static const bool uniform = ( (a&3) == (e&3) && (b&3) == (f&3) &&
+								  (c&3) == (g&3) && (d&3) == (h&3) );
+	static const int imm = _MM_SHUFFLE( d&3, c&3, b&3, a&3 );
+	/// bit i set when element i comes from the other lane
+	static const int cross = ( ( a >= 4 ? 0x01 : 0 ) | ( b >= 4 ? 0x02 : 0 ) |
+							   ( c >= 4 ? 0x04 : 0 ) | ( d >= 4 ? 0x08 : 0 ) |
+							   ( e < 4 ? 0x10 : 0 ) | ( f < 4 ? 0x20 : 0 ) |
+							   ( g < 4 ? 0x40 : 0 ) | ( h < 4 ? 0x80 : 0 ) );
+	/// all elements come from the low (0x00) or high (0x11) lane
+	static const int bcast = ( ( a|b|c|d|e|f|g|h ) < 4 ) ? 0x00 :
+		( ( a&b&c&d&e&f&g&h&4 ) ? 0x11 : -1 );
+};
+
+template <int a, int b, int c, int d, int e, int f, int g, int h>
+PAL_INLINE __m256 permute_in_lane( __m256 v )
+{
+	typedef permute8_info<a, b, c, d, e, f, g, h> info;
+	if ( info::uniform )
+		return _mm256_permute_ps( v, info::imm );
+	return _mm256_permutevar_ps( v, _mm256_setr_epi32( a&3, b&3, c&3, d&3, e&3, f&3, g&3, h&3 ) );
+}
+
+} // namespace detail
+
+/// @brief compile-time permute, element i of the result is v[index_i]
+///
+/// Patterns which stay within the 128-bit lanes use vpermilps, lane
+/// broadcasts use vperm2f128 + vpermilps, and the remaining cross
+/// lane patterns use vpermps under AVX2 or two in-lane permutes and
+/// a blend under AVX.
+template <int a, int b, int c, int d, int e, int f, int g, int h>
+PAL_INLINE fvec8 permute( fvec8 v )
+{
+	typedef detail::permute8_info<a, b, c, d, e, f, g, h> info;
+	if ( info::identity )
+		return v;
+	if ( info::cross == 0 )
+		return fvec8( detail::permute_in_lane<a, b, c, d, e, f, g, h>( v ) );
+	if ( info::uniform && info::cross == 0xFF )
+		return fvec8( _mm256_permute_ps( _mm256_permute2f128_ps( v, v, 0x01 ), info::imm ) );
+	if ( info::uniform && info::bcast >= 0 )
+		return fvec8( _mm256_permute_ps( _mm256_permute2f128_ps( v, v, info::bcast & 0x11 ), info::imm ) );
+#ifdef PAL_ENABLE_AVX2
+	return fvec8( _mm256_permutevar8x32_ps( v, _mm256_setr_epi32( a, b, c, d, e, f, g, h ) ) );
+#else
+	if ( info::bcast >= 0 )
+		return fvec8( detail::permute_in_lane<a, b, c, d, e, f, g, h>(
+						  _mm256_permute2f128_ps( v, v, info::bcast & 0x11 ) ) );
+	__m256 same = detail::permute_in_lane<a, b, c, d, e, f, g, h>( v );
+	__m256 other = detail::permute_in_lane<a, b, c, d, e, f, g, h>( _mm256_permute2f128_ps( v, v, 0x01 ) );
+	return fvec8( _mm256_blend_ps( same, other, info::cross & 0xFF ) );
+#endif
+}
+
+/// @brief compile-time permute, element i of the result is v[index_i]
+///
+/// Uses vpermilpd within lanes, vpermpd under AVX2 otherwise, and
+/// vperm2f128 + vpermilpd + blend under AVX.
+template <int a, int b, int c, int d>
+PAL_INLINE dvec4 permute( dvec4 v )
+{
+	static_assert( a >= 0 && a < 4 && b >= 0 && b < 4 && c >= 0 && c < 4 && d >= 0 && d < 4,
+				   "permute indices must be in [0, 4)" );
+	const int imm = (a&1) | ((b&1)<<1) | ((c&1)<<2) | ((d&1)<<3);
+	const int cross = ( a >= 2 ? 1 : 0 ) | ( b >= 2 ? 2 : 0 ) | ( c < 2 ? 4 : 0 ) | ( d < 2 ? 8 : 0 );
+	if ( a == 0 && b == 1 && c == 2 && d == 3 )
+		return v;
+	if ( cross == 0 )
+		return dvec4( _mm256_permute_pd( v, imm ) );
+	if ( cross == 0xF )
+		return dvec4( _mm256_permute_pd( _mm256_permute2f128_pd( v, v, 0x01 ), imm ) );
+#ifdef PAL_ENABLE_AVX2
+	return dvec4( _mm256_permute4x64_pd( v, _MM_SHUFFLE( d, c, b, a ) ) );
+#else
+	__m256d swapped = _mm256_permute2f128_pd( v, v, 0x01 );
+	return dvec4( _mm256_blend_pd( _mm256_permute_pd( v, imm ),
+								   _mm256_permute_pd( swapped, imm ), cross ) );
+#endif
+}
+
+/// @brief compile-time permute of 32-bit integer elements
+template <int a, int b, int c, int d, int e, int f, int g, int h, typename T>
+PAL_INLINE typename std::enable_if<sizeof(T) == 4, ivec256<T> >::type
+permute( ivec256<T> v )
+{
+#ifdef PAL_ENABLE_AVX2
+	typedef detail::permute8_info<a, b, c, d, e, f, g, h> info;
+	if ( info::identity )
+		return v;
+	if ( info::uniform && info::cross == 0 )
+		return ivec256<T>( _mm256_shuffle_epi32( v, info::imm ) );
+	return ivec256<T>( _mm256_permutevar8x32_epi32( v, _mm256_setr_epi32( a, b, c, d, e, f, g, h ) ) );
+#else
+	return ivec256<T>( _mm256_castps_si256(
+						   permute<a, b, c, d, e, f, g, h>( fvec8( _mm256_castsi256_ps( v ) ) ) ) );
 #endif
+}
+
+/// @brief compile-time permute of 64-bit integer elements
+template <int a, int b, int c, int d, typename T>
+PAL_INLINE typename std::enable_if<sizeof(T) == 8, ivec256<T> >::type
+permute( ivec256<T> v )
+{
+	return ivec256<T>( _mm256_castpd_si256(
+						   permute<a, b, c, d>( dvec4( _mm256_castsi256_pd( v ) ) ) ) );
+}
+
+/// @brief runtime permute, element i of the result is v[idx[i] & 7]
+PAL_INLINE fvec8 permute( fvec8 v, lvec8 idx )
+{
+#ifdef PAL_ENABLE_AVX2
+	return fvec8( _mm256_permutevar8x32_ps( v, idx ) );
+#else
+	// pick from each lane broadcast across both, then select on bit 2
+	__m256 lo = _mm256_permutevar_ps( _mm256_permute2f128_ps( v, v, 0x00 ), idx );
+	__m256 hi = _mm256_permutevar_ps( _mm256_permute2f128_ps( v, v, 0x11 ), idx );
+	__m128i ilo = _mm_slli_epi32( _mm256_castsi256_si128( idx ), 29 );
+	__m128i ihi = _mm_slli_epi32( _mm256_extractf128_si256( idx, 1 ), 29 );
+	__m256 sel = _mm256_castsi256_ps( _mm256_insertf128_si256( _mm256_castsi128_si256( ilo ), ihi, 1 ) );
+	return fvec8( _mm256_blendv_ps( lo, hi, sel ) );
+#endif
+}
+
+/// @brief runtime permute, element i of the result is v[idx[i] & 3]
+PAL_INLINE dvec4 permute( dvec4 v, llvec4 idx )
+{
+	// vpermilpd uses bit 1 of the control, so shift the index up
+#ifdef PAL_ENABLE_AVX2
+	__m256i ctl = _mm256_slli_epi64( idx, 1 );
+	__m256d sel = _mm256_castsi256_pd( _mm256_slli_epi64( idx, 62 ) );
+#else
+	__m128i clo = _mm256_castsi256_si128( idx );
+	__m128i chi = _mm256_extractf128_si256( idx, 1 );
+	__m256i ctl = _mm256_insertf128_si256( _mm256_castsi128_si256( _mm_slli_epi64( clo, 1 ) ),
+										   _mm_slli_epi64( chi, 1 ), 1 );
+	__m256d sel = _mm256_castsi256_pd( _mm256_insertf128_si256(
+										   _mm256_castsi128_si256( _mm_slli_epi64( clo, 62 ) ),
+										   _mm_slli_epi64( chi, 62 ), 1 ) );
+#endif
+	__m256d lo = _mm256_permutevar_pd( _mm256_permute2f128_pd( v, v, 0x00 ), ctl );
+	__m256d hi = _mm256_permutevar_pd( _mm256_permute2f128_pd( v, v, 0x11 ), ctl );
+	return dvec4( _mm256_blendv_pd( lo, hi, sel ) );
+}
+
+/// @brief runtime permute of 32-bit integer elements
+template <typename T>
+PAL_INLINE typename std::enable_if<sizeof(T) == 4, ivec256<T> >::type
+permute( ivec256<T> v, lvec8 idx )
+{
+#ifdef PAL_ENABLE_AVX2
+	return ivec256<T>( _mm256_permutevar8x32_epi32( v, idx ) );
+#else
+	return ivec256<T>( _mm256_castps_si256( permute( fvec8( _mm256_castsi256_ps( v ) ), idx ) ) );
+#endif
+}
+
+/// @brief compile-time blend, taking element i from b where m_i is
+/// non-zero, otherwise from a
+template <int m0, int m1, int m2, int m3, int m4, int m5, int m6, int m7>
+PAL_INLINE fvec8 blend( fvec8 a, fvec8 b )
+{
+	return fvec8( _mm256_blend_ps( a, b, (m0?0x01:0)|(m1?0x02:0)|(m2?0x04:0)|(m3?0x08:0)|
+								   (m4?0x10:0)|(m5?0x20:0)|(m6?0x40:0)|(m7?0x80:0) ) );
+}
+
+template <int m0, int m1, int m2, int m3>
+PAL_INLINE dvec4 blend( dvec4 a, dvec4 b )
+{
+	return dvec4( _mm256_blend_pd( a, b, (m0?1:0)|(m1?2:0)|(m2?4:0)|(m3?8:0) ) );
+}
+
+template <int m0, int m1, int m2, int m3, int m4, int m5, int m6, int m7, typename T>
+PAL_INLINE typename std::enable_if<sizeof(T) == 4, ivec256<T> >::type
+blend( ivec256<T> a, ivec256<T> b )
+{
+	const int m = (m0?0x01:0)|(m1?0x02:0)|(m2?0x04:0)|(m3?0x08:0)|
+		(m4?0x10:0)|(m5?0x20:0)|(m6?0x40:0)|(m7?0x80:0);
+#ifdef PAL_ENABLE_AVX2
+	return ivec256<T>( _mm256_blend_epi32( a, b, m ) );
+#else
+	return ivec256<T>( _mm256_castps_si256( _mm256_blend_ps( _mm256_castsi256_ps( a ),
+															 _mm256_castsi256_ps( b ), m ) ) );
+#endif
+}
+
+template <int m0, int m1, int m2, int m3, typename T>
+PAL_INLINE typename std::enable_if<sizeof(T) == 8, ivec256<T> >::type
+blend( ivec256<T> a, ivec256<T> b )
+{
+	return ivec256<T>( _mm256_castpd_si256( _mm256_blend_pd( _mm256_castsi256_pd( a ), _mm256_castsi256_pd( b ),
+															 (m0?1:0)|(m1?2:0)|(m2?4:0)|(m3?8:0) ) ) );
+}
+
+/// @brief selects 128-bit lanes from a and b (vperm2f128)
+///
+/// The low and high lane of the result are chosen by lo and hi
+/// respectively: 0 is the low lane of a, 1 the high lane of a, 2 the
+/// low lane of b and 3 the high lane of b.
+template <int lo, int hi>
+PAL_INLINE fvec8 permute_lanes( fvec8 a, fvec8 b )
+{
+	static_assert( lo >= 0 && lo < 4 && hi >= 0 && hi < 4, "lane indices must be in [0, 4)" );
+	return fvec8( _mm256_permute2f128_ps( a, b, lo | ( hi << 4 ) ) );
+}
+
+template <int lo, int hi>
+PAL_INLINE dvec4 permute_lanes( dvec4 a, dvec4 b )
+{
+	static_assert( lo >= 0 && lo < 4 && hi >= 0 && hi < 4, "lane indices must be in [0, 4)" );
+	return dvec4( _mm256_permute2f128_pd( a, b, lo | ( hi << 4 ) ) );
+}
+
+template <int lo, int hi, typename T>
+PAL_INLINE ivec256<T> permute_lanes( ivec256<T> a, ivec256<T> b )
+{
+	static_assert( lo >= 0 && lo < 4 && hi >= 0 && hi < 4, "lane indices must be in [0, 4)" );
+#ifdef PAL_ENABLE_AVX2
+	return ivec256<T>( _mm256_permute2x128_si256( a, b, lo | ( hi << 4 ) ) );
+#else
+	return ivec256<T>( _mm256_permute2f128_si256( a, b, lo | ( hi << 4 ) ) );
+#endif
+}
+
+/// @brief swaps the low and high 128-bit lanes
+template <typename VT>
+PAL_INLINE VT swap_lanes( VT v )
+{
+	return permute_lanes<1, 0>( v, v );
+}
+
+#endif // PAL_ENABLE_AVX
 
 } // namespace pal
 
@@ -0,0 +1,249 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use <pal/x86/simd_poly.h> directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_X86_SIMD_POLY_H_
+# define _PAL_X86_SIMD_POLY_H_ 1
+
+namespace PAL_NAMESPACE
+{
+
+/// @brief polynomials of this many coefficients (degree + 1) or more
+/// are evaluated with Estrin's scheme by polyval
+///
+/// Horner's scheme is one fma per coefficient, but each depends on
+/// the previous. Estrin's scheme evaluates pairs of coefficients
+/// independently and combines them with powers x^2, x^4, ... which
+/// costs a few extra multiplies but shortens the dependency chain to
+/// roughly log2 of the degree. When processing buffers, out-of-order
+/// execution overlaps neighboring iterations, so the extra multiplies
+/// only pay off once the chain is fairly long (measured crossover is
+/// around 10 coefficients). Call estrin directly for latency bound
+/// code.
+static const size_t poly_estrin_threshold = 10;
+
+namespace detail
+{
+
+/// @brief scalar type the coefficients are converted to
+template <typename VT, bool isarith = std::is_arithmetic<VT>::value>
+struct poly_scalar { typedef typename VT::value_type type; };
+template <typename VT>
+struct poly_scalar<VT, true> { typedef VT type; };
+
+/// @brief detects whether there is an fma overload for VT
+template <typename VT>
+struct poly_has_fma
+{
+	template <typename U>
+	static auto test( int ) -> decltype( fma( std::declval<U>(), std::declval<U>(), std::declval<U>() ), std::true_type() );
+	template <typename U>
+	static std::false_type test( ... );
+
+	static const bool value = decltype( test<VT>( 0 ) )::value;
+};
+
+template <typename VT>
+PAL_INLINE VT poly_madd( VT a, VT b, VT c, std::true_type ) { return fma( a, b, c ); }
+template <typename VT>
+PAL_INLINE VT poly_madd( VT a, VT b, VT c, std::false_type ) { return a * b + c; }
+
+/// @brief a * b + c, using fma for the types which have it
+template <typename VT>
+PAL_INLINE VT poly_madd( VT a, VT b, VT c )
+{
+	return poly_madd( a, b, c, std::integral_constant<bool, poly_has_fma<VT>::value>() );
+}
+
+constexpr inline size_t poly_lower_pow2( size_t n, size_t p = 1 )
+{
+	return ( p * 2 < n ) ? poly_lower_pow2( n, p * 2 ) : p;
+}
+
+/// @brief x^N for N a power of two by repeated squaring
+template <size_t N>
+struct poly_pow2
+{
+	template <typename VT>
+	static PAL_INLINE VT eval( VT x )
+	{
+		VT h = poly_pow2<N / 2>::eval( x );
+		return h * h;
+	}
+};
+
+template <>
+struct poly_pow2<1>
+{
+	template <typename VT>
+	static PAL_INLINE VT eval( VT x ) { return x; }
+};
+
+/// @brief c[0] + x * ( c[1] + x * ( ... c[N-1] ) )
+template <size_t N>
+struct horner_impl
+{
+	template <typename VT, typename T>
+	static PAL_INLINE VT eval( VT x, const T *c )
+	{
+		return poly_madd( horner_impl<N - 1>::eval( x, c + 1 ), x, VT( c[0] ) );
+	}
+};
+
+template <>
+struct horner_impl<1>
+{
+	template <typename VT, typename T>
+	static PAL_INLINE VT eval( VT, const T *c ) { return VT( c[0] ); }
+};
+
+/// @brief splits the polynomial at the largest power of two H < N:
+/// lo( x ) + x^H * hi( x ), recursively
+template <size_t N>
+struct estrin_impl
+{
+	static const size_t H = poly_lower_pow2( N );
+
+	template <typename VT, typename T>
+	static PAL_INLINE VT eval( VT x, const T *c )
+	{
+		return poly_madd( estrin_impl<N - H>::eval( x, c + H ),
+						  poly_pow2<H>::eval( x ),
+						  estrin_impl<H>::eval( x, c ) );
+	}
+};
+
+template <>
+struct estrin_impl<1>
+{
+	template <typename VT, typename T>
+	static PAL_INLINE VT eval( VT, const T *c ) { return VT( c[0] ); }
+};
+
+template <>
+struct estrin_impl<2>
+{
+	template <typename VT, typename T>
+	static PAL_INLINE VT eval( VT x, const T *c )
+	{
+		return poly_madd( VT( c[1] ), x, VT( c[0] ) );
+	}
+};
+
+template <size_t N>
+struct polyval_impl
+	: std::conditional<( N >= poly_estrin_threshold ), estrin_impl<N>, horner_impl<N> >::type
+{};
+
+} // namespace detail
+
+////////////////////////////////////////
+
+/// @brief evaluates c0 + c1 * x + c2 * x^2 ... using Horner's scheme
+///
+/// The coefficients are given lowest order first, and are converted
+/// to the scalar type of the vector, so plain float literals can be
+/// used. Horner's scheme has the best accuracy and fewest
+/// operations, and should be used where bit-exact results matter.
+template <typename VT, typename... Cs>
+PAL_INLINE VT
+horner( VT x, Cs... cs )
+{
+	typedef typename detail::poly_scalar<VT>::type T;
+	const T c[] = { T( cs )... };
+	return detail::horner_impl<sizeof...(Cs)>::eval( x, c );
+}
+
+/// @brief evaluates c0 + c1 * x + c2 * x^2 ... using Estrin's scheme
+///
+/// @sa horner
+template <typename VT, typename... Cs>
+PAL_INLINE VT
+estrin( VT x, Cs... cs )
+{
+	typedef typename detail::poly_scalar<VT>::type T;
+	const T c[] = { T( cs )... };
+	return detail::estrin_impl<sizeof...(Cs)>::eval( x, c );
+}
+
+/// @brief evaluates c0 + c1 * x + c2 * x^2 ..., choosing Horner or
+/// Estrin based on the degree
+///
+/// @sa poly_estrin_threshold
+template <typename VT, typename... Cs>
+PAL_INLINE VT
+polyval( VT x, Cs... cs )
+{
+	typedef typename detail::poly_scalar<VT>::type T;
+	const T c[] = { T( cs )... };
+	return detail::polyval_impl<sizeof...(Cs)>::eval( x, c );
+}
+
+/// @brief evaluates the polynomial with coefficients (lowest order
+/// first) from an array, which can be constexpr
+template <typename VT, typename T, size_t N>
+PAL_INLINE VT
+polyval( VT x, const T (&c)[N] )
+{
+	return detail::polyval_impl<N>::eval( x, c );
+}
+
+/// @brief evaluates the polynomial with coefficients (lowest order
+/// first) from a std::array, which can be constexpr
+template <typename VT, typename T, size_t N>
+PAL_INLINE VT
+polyval( VT x, const std::array<T, N> &c )
+{
+	return detail::polyval_impl<N>::eval( x, c.data() );
+}
+
+/// @brief evaluates the rational p( x ) / q( x ) with coefficients
+/// (lowest order first) from arrays, as printed by minimax_fit
+template <typename VT, typename T, size_t N, size_t M>
+PAL_INLINE VT
+ratval( VT x, const T (&p)[N], const T (&q)[M] )
+{
+	return polyval( x, p ) / polyval( x, q );
+}
+
+/// @brief evaluates the rational p( x ) / q( x ) with coefficients
+/// from std::arrays, as from minimax_rational_result::p_as / q_as
+template <typename VT, typename T, size_t N, size_t M>
+PAL_INLINE VT
+ratval( VT x, const std::array<T, N> &p, const std::array<T, M> &q )
+{
+	return polyval( x, p ) / polyval( x, q );
+}
+
+/// @brief polynomial with compile-time coefficients
+///
+/// Coeffs is a type with a static constexpr member array c, lowest
+/// order first, so a set of coefficients can be named and reused:
+///
+/// @code
+/// struct my_curve { static constexpr float c[] = { 1.F, 0.5F, 0.25F }; };
+/// constexpr float my_curve::c[]; // needed prior to C++17
+/// y = pal::poly<my_curve>::eval( x );
+/// @endcode
+template <typename Coeffs>
+struct poly
+{
+	static const size_t degree = sizeof(Coeffs::c) / sizeof(Coeffs::c[0]) - 1;
+
+	template <typename VT>
+	static PAL_INLINE VT eval( VT x )
+	{
+		return polyval( x, Coeffs::c );
+	}
+};
+
+} // namespace pal
+
+#endif // _PAL_X86_SIMD_POLY_H_
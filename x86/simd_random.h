@@ -0,0 +1,277 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use <pal/x86/simd_random.h> directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_X86_SIMD_RANDOM_H_
+# define _PAL_X86_SIMD_RANDOM_H_ 1
+
+// vectorized random number generators, each lane is an independent
+// stream. The generators are templated on the float vector type
+// (fvec4 or fvec8) which the uniform / normal values are produced
+// in; the integer results are the matching 32 or 64-bit vectors.
+//
+// xoshiro256plus is the xoshiro256+ generator of Blackman and Vigna,
+// philox4x32 is the counter based Philox4x32-10 of Salmon et al.
+// (Random123), which allows random access and is the easiest way to
+// give threads independent, reproducible streams.
+
+namespace PAL_NAMESPACE
+{
+
+namespace detail
+{
+
+/// @brief the integer vectors matching a float vector
+template <typename VT> struct random_types {};
+
+template <> struct random_types<fvec4>
+{
+	typedef ullvec2 u64_type;
+	typedef ulvec4 u32_type;
+	typedef lvec4 i32_type;
+	typedef ivec128_traits<4> traits32;
+	static const int lanes = 4;
+
+	static PAL_INLINE u64_type load64( const uint64_t *v ) { return load( v ); }
+	static PAL_INLINE i32_type load32( const int32_t *v ) { return load( v ); }
+};
+
+#ifdef PAL_HAS_FVEC8
+template <> struct random_types<fvec8>
+{
+	typedef ullvec4 u64_type;
+	typedef ulvec8 u32_type;
+	typedef lvec8 i32_type;
+	typedef ivec256_traits<4> traits32;
+	static const int lanes = 8;
+
+	static PAL_INLINE u64_type load64( const uint64_t *v ) { return load256( v ); }
+	static PAL_INLINE i32_type load32( const int32_t *v ) { return load256( v ); }
+};
+#endif
+
+/// @brief splitmix64, used to expand seeds into generator state
+PAL_INLINE uint64_t splitmix64( uint64_t &s )
+{
+	uint64_t z = ( s += 0x9E3779B97F4A7C15ULL );
+	z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+	z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL;
+	return z ^ ( z >> 31 );
+}
+
+/// @brief uniform float in [0, 1) from the upper 24 bits of each lane
+template <typename VT>
+PAL_INLINE VT uniform_from_bits( typename random_types<VT>::i32_type bits )
+{
+	return VT::convert_int( lsr( bits, 8 ) ) * VT( 1.F / 16777216.F );
+}
+
+/// @brief Box-Muller transform of two uniforms in [0, 1) to two
+/// independent standard normals
+template <typename VT>
+PAL_INLINE void box_muller( VT u1, VT u2, VT &z0, VT &z1 )
+{
+	// 1 - u1 is in (0, 1], so the log is finite
+	VT r = sqrtf( VT( -2.F ) * logf( float_constants<VT>::one() - u1 ) );
+	VT s, c;
+	sincosf( u2 * float_constants<VT>::two_pi(), &s, &c );
+	z0 = r * c;
+	z1 = r * s;
+}
+
+} // namespace detail
+
+////////////////////////////////////////
+
+/// @brief xoshiro256+ with one stream per 64-bit lane
+///
+/// The upper bits are of high quality, the lowest 3 bits of the 64-bit
+/// results have low linear complexity; the float results only use
+/// the upper 24 bits of each 32-bit half. Lanes are seeded from
+/// splitmix64 of the seed and stream, jump() advances all lanes by
+/// 2^128 for non-overlapping subsequences.
+template <typename VT>
+class xoshiro256plus
+{
+public:
+	typedef detail::random_types<VT> types;
+	typedef typename types::u64_type u64_type;
+	typedef typename types::u32_type u32_type;
+	static const int lanes64 = types::lanes / 2;
+
+	explicit xoshiro256plus( uint64_t seed, uint64_t stream = 0 )
+	{
+		uint64_t st[4][lanes64];
+		for ( int l = 0; l != lanes64; ++l )
+		{
+			uint64_t sm = seed ^ ( ( stream * lanes64 + uint64_t( l ) ) * 0xD1B54A32D192ED03ULL );
+			for ( int i = 0; i != 4; ++i )
+				st[i][l] = detail::splitmix64( sm );
+		}
+		for ( int i = 0; i != 4; ++i )
+			_s[i] = types::load64( st[i] );
+	}
+
+	/// @brief sets the state of all lanes directly (i.e. to match a
+	/// reference), s is [state word][lane]
+	explicit xoshiro256plus( const uint64_t (&s)[4][types::lanes / 2] )
+	{
+		for ( int i = 0; i != 4; ++i )
+			_s[i] = types::load64( s[i] );
+	}
+
+	/// @brief next 64-bit value for each lane
+	PAL_INLINE u64_type next_u64( void )
+	{
+		u64_type r = _s[0] + _s[3];
+		u64_type t = _s[1] << 17;
+		_s[2] = _s[2] ^ _s[0];
+		_s[3] = _s[3] ^ _s[1];
+		_s[1] = _s[1] ^ _s[2];
+		_s[0] = _s[0] ^ _s[3];
+		_s[2] = _s[2] ^ t;
+		_s[3] = ( _s[3] << 45 ) | lsr( _s[3], 19 );
+		return r;
+	}
+
+	/// @brief next 64-bit value for each lane, viewed as 32-bit values
+	PAL_INLINE u32_type next_u32( void ) { return u32_type( next_u64() ); }
+
+	/// @brief uniform floats in [0, 1)
+	PAL_INLINE VT uniform( void )
+	{
+		return detail::uniform_from_bits<VT>( typename types::i32_type( next_u64() ) );
+	}
+
+	/// @brief two vectors of standard normal values
+	PAL_INLINE void normal( VT &z0, VT &z1 )
+	{
+		VT u1 = uniform();
+		detail::box_muller( u1, uniform(), z0, z1 );
+	}
+
+	/// @brief advances every lane by 2^128 steps
+	void jump( void )
+	{
+		static const uint64_t kJump[4] = {
+			0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+			0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+		u64_type t[4] = { u64_type( uint64_t(0) ), u64_type( uint64_t(0) ),
+						  u64_type( uint64_t(0) ), u64_type( uint64_t(0) ) };
+		for ( int i = 0; i != 4; ++i )
+		{
+			for ( int b = 0; b != 64; ++b )
+			{
+				if ( kJump[i] & ( uint64_t(1) << b ) )
+				{
+					for ( int k = 0; k != 4; ++k )
+						t[k] = t[k] ^ _s[k];
+				}
+				next_u64();
+			}
+		}
+		for ( int k = 0; k != 4; ++k )
+			_s[k] = t[k];
+	}
+
+private:
+	u64_type _s[4];
+};
+
+////////////////////////////////////////
+
+/// @brief Philox4x32-10 counter based generator
+///
+/// Each call to next produces one 4 word block for each lane, lane i
+/// using counter (block + i, stream), so the same seed, stream and
+/// block always produce the same values no matter how the work is
+/// split. Word j of the block for lane i is lane i of r[j].
+template <typename VT>
+class philox4x32
+{
+public:
+	typedef detail::random_types<VT> types;
+	typedef typename types::u32_type u32_type;
+	typedef typename types::i32_type i32_type;
+	static const int lanes = types::lanes;
+
+	/// @brief key is the seed, stream selects the upper half of the
+	/// counter, and block the starting lower half
+	explicit philox4x32( uint64_t key, uint64_t stream = 0, uint64_t block = 0 )
+		: _key( key ), _stream( stream ), _block( block )
+	{}
+
+	uint64_t block( void ) const { return _block; }
+	void seek( uint64_t block ) { _block = block; }
+
+	/// @brief generates the next block for each lane, advancing the
+	/// counter by the number of lanes
+	PAL_INLINE void next( u32_type (&r)[4] )
+	{
+		typedef typename types::traits32 traits;
+		static const int32_t kIota[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+		const i32_type bias( int32_t( 0x80000000 ) );
+
+		i32_type lane = types::load32( kIota );
+		i32_type c0 = i32_type( int32_t( _block ) ) + lane;
+		// carry into the upper word where the low word wrapped
+		i32_type carry( ( ( c0 ^ bias ) < ( lane ^ bias ) ).as_int() );
+		i32_type c1 = i32_type( int32_t( _block >> 32 ) ) - carry;
+		i32_type c2 = i32_type( int32_t( _stream ) );
+		i32_type c3 = i32_type( int32_t( _stream >> 32 ) );
+
+		const i32_type m0( int32_t( 0xD2511F53 ) );
+		const i32_type m1( int32_t( 0xCD9E8D57 ) );
+		uint32_t k0 = uint32_t( _key ), k1 = uint32_t( _key >> 32 );
+		for ( int round = 0; round != 10; ++round )
+		{
+			i32_type hi0( traits::mulhi_u( m0, c0 ) );
+			i32_type hi1( traits::mulhi_u( m1, c2 ) );
+			i32_type lo0 = m0 * c0;
+			i32_type lo1 = m1 * c2;
+			c0 = hi1 ^ c1 ^ i32_type( int32_t( k0 ) );
+			c1 = lo1;
+			c2 = hi0 ^ c3 ^ i32_type( int32_t( k1 ) );
+			c3 = lo0;
+			k0 += 0x9E3779B9U;
+			k1 += 0xBB67AE85U;
+		}
+		r[0] = u32_type( c0 ); r[1] = u32_type( c1 );
+		r[2] = u32_type( c2 ); r[3] = u32_type( c3 );
+		_block += uint64_t( lanes );
+	}
+
+	/// @brief 4 vectors of uniform floats in [0, 1)
+	PAL_INLINE void uniform( VT (&u)[4] )
+	{
+		u32_type r[4];
+		next( r );
+		for ( int i = 0; i != 4; ++i )
+			u[i] = detail::uniform_from_bits<VT>( i32_type( r[i] ) );
+	}
+
+	/// @brief 4 vectors of standard normal values
+	PAL_INLINE void normal( VT (&z)[4] )
+	{
+		VT u[4];
+		uniform( u );
+		detail::box_muller( u[0], u[1], z[0], z[1] );
+		detail::box_muller( u[2], u[3], z[2], z[3] );
+	}
+
+private:
+	uint64_t _key;
+	uint64_t _stream;
+	uint64_t _block;
+};
+
+} // namespace pal
+
+#endif // _PAL_X86_SIMD_RANDOM_H_
@@ -0,0 +1,150 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use <pal/x86/simd_sort.h> directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_X86_SIMD_SORT_H_
+# define _PAL_X86_SIMD_SORT_H_ 1
+
+// in-register sorting networks for fvec4 / lvec4 / fvec8 / lvec8,
+// built from min / max and compile-time permutes and blends. A single
+// register is sorted with the optimal 5 comparator network for 4
+// elements (per 128-bit lane), 8 element registers then do a bitonic
+// merge of the two lanes. Multiple registers are combined with
+// bitonic merges, so the sorted result runs through the registers in
+// argument order. Unordered (NaN) values are not supported.
+
+namespace PAL_NAMESPACE
+{
+
+namespace detail
+{
+
+/// @brief the permutes and blends of the networks, 4 element patterns
+/// apply to each 128-bit lane
+template <typename VT> struct sort_traits4
+{
+	static const int lanes = 4;
+	static PAL_INLINE VT swap1( VT v ) { return permute<1, 0, 3, 2>( v ); }
+	static PAL_INLINE VT swap2( VT v ) { return permute<2, 3, 0, 1>( v ); }
+	static PAL_INLINE VT swap_mid( VT v ) { return permute<0, 2, 1, 3>( v ); }
+	static PAL_INLINE VT reverse( VT v ) { return permute<3, 2, 1, 0>( v ); }
+	static PAL_INLINE VT pick1( VT lo, VT hi ) { return blend<0, 1, 0, 1>( lo, hi ); }
+	static PAL_INLINE VT pick2( VT lo, VT hi ) { return blend<0, 0, 1, 1>( lo, hi ); }
+	static PAL_INLINE VT pick_mid( VT lo, VT hi ) { return blend<0, 0, 1, 0>( lo, hi ); }
+	static PAL_INLINE VT merge_lanes( VT v ) { return v; }
+};
+
+template <typename VT> struct sort_traits;
+template <> struct sort_traits<fvec4> : public sort_traits4<fvec4> {};
+template <> struct sort_traits<lvec4> : public sort_traits4<lvec4> {};
+
+/// @brief sorts a bitonic register
+template <typename VT>
+PAL_INLINE VT bitonic_merge4( VT v )
+{
+	typedef sort_traits<VT> st;
+	VT p = st::swap2( v );
+	v = st::pick2( min( v, p ), max( v, p ) );
+	p = st::swap1( v );
+	return st::pick1( min( v, p ), max( v, p ) );
+}
+
+#ifdef PAL_ENABLE_AVX
+template <typename VT> struct sort_traits8
+{
+	static const int lanes = 8;
+	static PAL_INLINE VT swap1( VT v ) { return permute<1, 0, 3, 2, 5, 4, 7, 6>( v ); }
+	static PAL_INLINE VT swap2( VT v ) { return permute<2, 3, 0, 1, 6, 7, 4, 5>( v ); }
+	static PAL_INLINE VT swap_mid( VT v ) { return permute<0, 2, 1, 3, 4, 6, 5, 7>( v ); }
+	static PAL_INLINE VT reverse( VT v ) { return permute<7, 6, 5, 4, 3, 2, 1, 0>( v ); }
+	static PAL_INLINE VT pick1( VT lo, VT hi ) { return blend<0, 1, 0, 1, 0, 1, 0, 1>( lo, hi ); }
+	static PAL_INLINE VT pick2( VT lo, VT hi ) { return blend<0, 0, 1, 1, 0, 0, 1, 1>( lo, hi ); }
+	static PAL_INLINE VT pick_mid( VT lo, VT hi ) { return blend<0, 0, 1, 0, 0, 0, 1, 0>( lo, hi ); }
+	static PAL_INLINE VT bitonic_merge( VT v )
+	{
+		VT p = swap_lanes( v );
+		return bitonic_merge4( blend<0, 0, 0, 0, 1, 1, 1, 1>( min( v, p ), max( v, p ) ) );
+	}
+	/// @brief merges the sorted 128-bit lanes
+	static PAL_INLINE VT merge_lanes( VT v )
+	{
+		// reversing the high lane makes the register bitonic
+		return bitonic_merge( permute<0, 1, 2, 3, 7, 6, 5, 4>( v ) );
+	}
+};
+
+template <> struct sort_traits<fvec8> : public sort_traits8<fvec8> {};
+template <> struct sort_traits<lvec8> : public sort_traits8<lvec8> {};
+
+PAL_INLINE fvec8 bitonic_merge( fvec8 v ) { return sort_traits<fvec8>::bitonic_merge( v ); }
+PAL_INLINE lvec8 bitonic_merge( lvec8 v ) { return sort_traits<lvec8>::bitonic_merge( v ); }
+#endif
+
+PAL_INLINE fvec4 bitonic_merge( fvec4 v ) { return bitonic_merge4( v ); }
+PAL_INLINE lvec4 bitonic_merge( lvec4 v ) { return bitonic_merge4( v ); }
+
+} // namespace detail
+
+////////////////////////////////////////
+
+/// @brief sorts the elements of v ascending
+template <typename VT>
+PAL_INLINE VT sort_network( VT v )
+{
+	typedef detail::sort_traits<VT> st;
+	VT p = st::swap1( v );
+	v = st::pick1( min( v, p ), max( v, p ) );
+	p = st::swap2( v );
+	v = st::pick2( min( v, p ), max( v, p ) );
+	p = st::swap_mid( v );
+	v = st::pick_mid( min( v, p ), max( v, p ) );
+	return st::merge_lanes( v );
+}
+
+/// @brief merges the individually sorted a and b such that a holds
+/// the lowest values and b the highest, both sorted
+template <typename VT>
+PAL_INLINE void merge_sorted( VT &a, VT &b )
+{
+	VT r = detail::sort_traits<VT>::reverse( b );
+	b = detail::bitonic_merge( max( a, r ) );
+	a = detail::bitonic_merge( min( a, r ) );
+}
+
+/// @brief sorts the 2 registers of values as one sequence, a then b
+template <typename VT>
+PAL_INLINE void sort_network( VT &a, VT &b )
+{
+	a = sort_network( a );
+	b = sort_network( b );
+	merge_sorted( a, b );
+}
+
+/// @brief sorts the 4 registers of values as one sequence, a, b, c
+/// then d
+template <typename VT>
+PAL_INLINE void sort_network( VT &a, VT &b, VT &c, VT &d )
+{
+	typedef detail::sort_traits<VT> st;
+	sort_network( a, b );
+	sort_network( c, d );
+	// compare against c, d reversed, each half is then bitonic
+	VT rd = st::reverse( d ), rc = st::reverse( c );
+	VT l0 = min( a, rd ), h0 = max( a, rd );
+	VT l1 = min( b, rc ), h1 = max( b, rc );
+	a = detail::bitonic_merge( min( l0, l1 ) );
+	b = detail::bitonic_merge( max( l0, l1 ) );
+	c = detail::bitonic_merge( min( h0, h1 ) );
+	d = detail::bitonic_merge( max( h0, h1 ) );
+}
+
+} // namespace pal
+
+#endif // _PAL_X86_SIMD_SORT_H_
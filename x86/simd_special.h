@@ -0,0 +1,758 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use <pal/x86/simd_special.h> directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_X86_SIMD_SPECIAL_H_
+# define _PAL_X86_SIMD_SPECIAL_H_ 1
+
+// special functions: erf / erfc, tgamma / lgamma and the inverse of
+// the standard normal CDF, for the float (erff, ...) and double
+// (erf, ...) vectors.
+//
+// The float and double versions share the same reductions, only the
+// kernels differ (minimax fits, see minimax_fit). Measured against the
+// C library (long double), the larger of the sse2 and fma builds:
+//
+//   erff           2.5 ulp         erf            2.5 ulp
+//   erfcf          9 ulp           erfc           7 ulp
+//   tgammaf        see below       tgamma         see below
+//   lgammaf        7 ulp           lgamma         12 ulp
+//   normcdfinvf    7.5 ulp         normcdfinv     5 ulp
+//
+// The float erfc and normcdfinv figures are from every float in the
+// domain (erfcf over [-5, 10]): erfcf is worst at 3.66, 8.9 ulp for
+// sse2 and 6.9 with fma, normcdfinvf at 0.0307, 7.3 ulp.
+// tgamma steps down to [2, 3) one multiply at a time, so the error
+// grows with x: 6.5 ulp below 10 for both, 11 ulp for float up to the
+// overflow, and 11.5 ulp below 30, 24 ulp approaching 171.6 for double.
+// The reflection for x < 0 has about the same error as for -x (double
+// is 11.4 ulp at -25.73, 11.5 at 28.8).
+// lgamma has the error relative to the result except around the
+// negative roots (x < -2), where the reflection subtracts two nearly
+// equal values and the error is absolute (4e-7 / 7e-16).
+// normcdfinvf is a rational fit in the middle and the tails, the
+// double version starts from the approximation by P. Acklam (relative
+// error 1.15e-9) and takes one step of Halley's method using erf /
+// erfc, except for denormal p.
+
+namespace PAL_NAMESPACE
+{
+
+namespace detail
+{
+
+template <typename T> struct special_constants;
+
+template <> struct special_constants<float>
+{
+	/// 1.5 * 2^23, adding it rounds to an integer
+	static PAL_INLINE float round_shifter( void ) { return 12582912.F; }
+	/// values at or past this are all integers
+	static PAL_INLINE float integral( void ) { return 8388608.F; }
+	/// 2^12 + 1, splits a float into two 12 bit halves
+	static PAL_INLINE float split( void ) { return 4097.F; }
+	/// erfc underflows past this
+	static PAL_INLINE float erfc_limit( void ) { return 10.1F; }
+	/// tgamma is inf or 0 past this in magnitude
+	static PAL_INLINE float tgamma_limit( void ) { return 45.F; }
+	/// 2^-64, keeps gamma( 1 - x ) in range for the reflection
+	static PAL_INLINE float tgamma_scale( void ) { return 5.42101086242752217e-20F; }
+	/// lgamma switches to the stirling series from here
+	static PAL_INLINE float stirling( void ) { return 8.F; }
+	/// below this lgamma( x ) is -log( |x| ) to the precision
+	static PAL_INLINE float lgamma_tiny( void ) { return 1e-7F; }
+	/// 2^24 and its log, to bring denormals into range for log
+	static PAL_INLINE float denormal_scale( void ) { return 16777216.F; }
+	static PAL_INLINE float log_denormal_scale( void ) { return 16.6355323334386867F; }
+};
+
+template <> struct special_constants<double>
+{
+	static PAL_INLINE double round_shifter( void ) { return 6755399441055744.0; }
+	static PAL_INLINE double integral( void ) { return 4503599627370496.0; }
+	static PAL_INLINE double split( void ) { return 134217729.0; }
+	static PAL_INLINE double erfc_limit( void ) { return 27.3; }
+	static PAL_INLINE double tgamma_limit( void ) { return 190.0; }
+	static PAL_INLINE double tgamma_scale( void ) { return 8.63616855509444463e-78; }
+	static PAL_INLINE double stirling( void ) { return 10.0; }
+	static PAL_INLINE double lgamma_tiny( void ) { return 1e-17; }
+	static PAL_INLINE double denormal_scale( void ) { return 18014398509481984.0; }
+	static PAL_INLINE double log_denormal_scale( void ) { return 37.4299477502370478; }
+};
+
+// dispatch to the float / double versions of the library functions
+template <typename VT>
+PAL_INLINE PAL_ENABLE_FLOAT(VT) special_exp( VT x ) { return expf( x ); }
+template <typename VT>
+PAL_INLINE PAL_ENABLE_DOUBLE(VT) special_exp( VT x ) { return exp( x ); }
+template <typename VT>
+PAL_INLINE PAL_ENABLE_FLOAT(VT) special_log( VT x ) { return logf( x ); }
+template <typename VT>
+PAL_INLINE PAL_ENABLE_DOUBLE(VT) special_log( VT x ) { return log( x ); }
+template <typename VT>
+PAL_INLINE PAL_ENABLE_FLOAT(VT) special_sqrt( VT x ) { return sqrtf( x ); }
+template <typename VT>
+PAL_INLINE PAL_ENABLE_DOUBLE(VT) special_sqrt( VT x ) { return sqrt( x ); }
+
+/// @brief log that also handles denormal x, which logf does not
+template <typename VT>
+PAL_INLINE VT
+special_log_denormal( VT x )
+{
+	typedef special_constants<typename VT::value_type> sconst;
+	typename VT::mask_type tiny = x < float_constants<VT>::min();
+	VT l = special_log( ifthen( tiny, x * VT( sconst::denormal_scale() ), x ) );
+	return ifthen( tiny, l - VT( sconst::log_denormal_scale() ), l );
+}
+
+/// @brief erf( x ) / x on |x| <= 0.5, t = x^2, 1.4e-9 relative
+template <typename VT>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+erf_kernel( VT t )
+{
+	return horner( t, 1.12837916556734563e+00, -3.76126085728514192e-01,
+				   1.12828228100437147e-01, -2.67571842794861320e-02,
+				   4.71799009138911853e-03 );
+}
+
+/// @brief erf( x ) / x on |x| <= 0.5, t = x^2, 1e-17 relative
+template <typename VT>
+PAL_INLINE PAL_ENABLE_DOUBLE(VT)
+erf_kernel( VT t )
+{
+	return polyval( t, 1.12837916709551256e+00, -3.76126389031834762e-01,
+					1.12837916709254596e-01, -2.68661706328396088e-02,
+					5.22397737063966857e-03, -8.54829741510489496e-04,
+					1.20533135397071762e-04, -1.48452059909567590e-05,
+					1.47185645259539030e-06 );
+}
+
+/// @brief erfc( x ) * e^(x^2) on [0.5, 10.1], 7.5e-10 relative
+template <typename VT>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+erfcx_kernel( VT x )
+{
+	VT p = horner( x, 1.00000993720900322e+00, 1.31400932524152436e+00,
+				   8.18092781190901008e-01, 2.73462265855696995e-01,
+				   4.36891201041420471e-02 );
+	VT q = horner( x, 1.0, 2.44248543346181490e+00, 2.57371120441219992e+00,
+				   1.48853090851710568e+00, 4.84711189209051041e-01,
+				   7.74366649607183127e-02 );
+	return p / q;
+}
+
+/// @brief erfc( x ) * e^(x^2) on [0.5, 27.3], 1e-16 relative
+///
+/// three rational pieces, [0.5, 2), [2, 4.5) and the tail in terms of
+/// 1 / x^2, each only evaluated if a value needs it
+template <typename VT>
+inline PAL_ENABLE_DOUBLE(VT)
+erfcx_kernel( VT x )
+{
+	typename VT::mask_type lo = x < VT( 2.0 );
+	typename VT::mask_type hi = x >= VT( 4.5 );
+	typename VT::mask_type mid = ! ( lo | hi );
+	VT r = VT::zero();
+	if ( lo.any() )
+	{
+		VT p = polyval( x, 1.00000000022050872e+00, 1.53099317642628319e+00,
+						1.16452660200135516e+00, 5.32110555902268412e-01,
+						1.52201949345343618e-01, 2.58151611973436342e-02,
+						2.05397431059411951e-03 );
+		VT q = polyval( x, 1.0, 2.65937234703848357e+00, 3.16530692972686634e+00,
+						2.19665750592303377e+00, 9.66077423068519181e-01,
+						2.71586145996358441e-01, 4.57564690802295462e-02,
+						3.64056671625119380e-03 );
+		r = ifthen( lo, p / q, r );
+	}
+	if ( mid.any() )
+	{
+		VT y = x - VT( 2.0 );
+		VT p = polyval( y, 2.55395676310505748e-01, 2.96279181031922856e-01,
+						1.45275013424570859e-01, 3.74333515900046598e-02,
+						5.06274402190806747e-03, 2.87828367603516159e-04 );
+		VT q = polyval( y, 1.0, 1.57823988529609904e+00, 1.06510298238572276e+00,
+						3.94166609876612339e-01, 8.45510143905024852e-02,
+						9.99380024162051239e-03, 5.10162643088552773e-04 );
+		r = ifthen( mid, p / q, r );
+	}
+	if ( hi.any() )
+	{
+		VT u = float_constants<VT>::one() / ( x * x );
+		VT p = polyval( u, 5.64189583547756279e-01, 1.26809284884048541e+01,
+						9.10262987737174569e+01, 2.41698762938965586e+02,
+						2.01810129429797996e+02, 2.39083468229301523e+01 );
+		VT q = polyval( u, 1.0, 2.29763605323306592e+01, 1.72078094061316079e+02,
+						4.99081679760300972e+02, 5.14699586820389072e+02,
+						1.26810224617724487e+02 );
+		r = ifthen( hi, p / ( x * q ), r );
+	}
+	return r;
+}
+
+/// @brief sin( pi r ) / r on |r| <= 0.5, t = r^2, 5.3e-9 relative
+template <typename VT>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+sinpi_kernel( VT t )
+{
+	return horner( t, 3.14159263689558266e+00, -5.16770968480613746e+00,
+				   2.55006972642173801e+00, -5.98242126847946865e-01,
+				   7.75603877008682607e-02 );
+}
+
+/// @brief sin( pi r ) / r on |r| <= 0.5, t = r^2, 5e-17 relative
+template <typename VT>
+PAL_INLINE PAL_ENABLE_DOUBLE(VT)
+sinpi_kernel( VT t )
+{
+	return polyval( t, 3.14159265358979312e+00, -5.16771278004997114e+00,
+					2.55016403987740414e+00, -5.99264529321196004e-01,
+					8.21458865869874738e-02, -7.37043044428656226e-03,
+					4.66298779496741866e-04, -2.18994419234766861e-05,
+					7.64552524622867052e-07 );
+}
+
+/// @brief tgamma( 2 + y ) on [0, 1], 1.8e-8 relative
+template <typename VT>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+tgamma_kernel( VT y )
+{
+	return horner( y, 9.99999982294513590e-01, 4.22786774513229602e-01,
+				   4.11785744762546313e-01, 8.20396009325491671e-02,
+				   7.23230797975270984e-02, 4.13037030233442785e-03,
+				   5.39758150832359441e-03, 1.53683047800347284e-03 );
+}
+
+/// @brief tgamma( 2 + y ) on [0, 1], 9e-17 relative
+template <typename VT>
+PAL_INLINE PAL_ENABLE_DOUBLE(VT)
+tgamma_kernel( VT y )
+{
+	VT p = polyval( y, 1.0, 2.75059661773445929e-01, 8.70857574228064979e-02,
+					-4.22204817936339908e-03, -2.48650089416093279e-03,
+					-1.66218342700261146e-03, -1.97599021700654609e-04,
+					-4.58173366141496590e-05 );
+	VT q = polyval( y, 1.0, -1.47724673325021677e-01, -2.62298895214237660e-01,
+					8.59358748569187259e-02, 7.00833408006098103e-03,
+					-7.38412783286529657e-03, 1.30954492536802390e-03,
+					-8.04223215177514791e-05 );
+	return p / q;
+}
+
+/// @brief lgamma( 2 + y ) / ( y ( y + 1 ) ) on [-0.5, 0.5], 1.5e-8
+/// relative
+///
+/// factoring out the roots at 1 and 2 keeps the error relative there
+template <typename VT>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+lgamma_kernel( VT y )
+{
+	return horner( y, 4.22784328811676602e-01, -1.00317289038731244e-01,
+				   3.29657991953797858e-02, -1.23848689548189585e-02,
+				   4.98286864467049548e-03, -2.09843878795628897e-03,
+				   1.01383880760545428e-03, -4.56298206267549049e-04 );
+}
+
+/// @brief lgamma( 2 + y ) / ( y ( y + 1 ) ) on [-0.5, 0.5], 2.7e-16
+/// relative
+template <typename VT>
+PAL_INLINE PAL_ENABLE_DOUBLE(VT)
+lgamma_kernel( VT y )
+{
+	VT p = polyval( y, 4.22784335098467134e-01, 5.81024955441525881e-01,
+					2.95437068509541600e-01, 6.78473332139049728e-02,
+					6.79535119464417994e-03, 2.27925219234130494e-04,
+					6.03107574076439899e-07 );
+	VT q = polyval( y, 1.0, 1.61155984399751739e+00, 1.00320510414884878e+00,
+					3.02152356693322133e-01, 4.49284127362799199e-02,
+					2.95889866540282763e-03, 6.05965834967651812e-05 );
+	return p / q;
+}
+
+/// @brief the stirling series correction to lgamma, w = 1 / x for x >= 8
+template <typename VT>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+stirling_kernel( VT w )
+{
+	return w * horner( w * w, 1.0 / 12.0, -1.0 / 360.0, 1.0 / 1260.0 );
+}
+
+/// @brief the stirling series correction to lgamma, w = 1 / x for x >= 10
+template <typename VT>
+PAL_INLINE PAL_ENABLE_DOUBLE(VT)
+stirling_kernel( VT w )
+{
+	return w * horner( w * w, 1.0 / 12.0, -1.0 / 360.0, 1.0 / 1260.0,
+					   -1.0 / 1680.0, 1.0 / 1188.0, -691.0 / 360360.0,
+					   1.0 / 156.0 );
+}
+
+/// @brief e^(-x^2), without the error of rounding x^2 first
+///
+/// splits x in halves (Veltkamp) so the rounding error e of x * x
+/// is computed exactly, and applies it as e^-e ~= 1 - e
+template <typename VT>
+PAL_INLINE VT
+exp_neg_square( VT x )
+{
+	typedef special_constants<typename VT::value_type> sconst;
+	VT c = x * VT( sconst::split() );
+	VT xh = c - ( c - x );
+	VT xl = x - xh;
+	VT p = x * x;
+	VT e = ( ( xh * xh - p ) + float_constants<VT>::two() * xh * xl ) + xl * xl;
+	return special_exp( -p ) * ( float_constants<VT>::one() - e );
+}
+
+/// @brief erfc for x >= 0.5
+template <typename VT>
+PAL_INLINE VT
+erfc_large( VT x )
+{
+	typedef special_constants<typename VT::value_type> sconst;
+	x = min( x, VT( sconst::erfc_limit() ) );
+	return exp_neg_square( x ) * erfcx_kernel( x );
+}
+
+/// @brief sin( pi x ), exact at the integers
+template <typename VT>
+PAL_INLINE VT
+sinpi( VT x )
+{
+	typedef special_constants<typename VT::value_type> sconst;
+	const VT shifter( sconst::round_shifter() );
+	const VT half = float_constants<VT>::one_half();
+
+	// r in [-0.5, 0.5], odd n flips the sign
+	VT n = ( x + shifter ) - shifter;
+	VT r = x - n;
+	VT h = n * half;
+	typename VT::mask_type odd = ( ( h + shifter ) - shifter ) != h;
+	VT s = r * sinpi_kernel( r * r );
+	s = ifthen( odd, -s, s );
+	return ifthen( fabs( x ) >= VT( sconst::integral() ), VT::zero(), s );
+}
+
+template <typename VT>
+inline VT
+erf_impl( VT x )
+{
+	VT ax = fabs( x );
+	VT r = x * erf_kernel( x * x );
+	typename VT::mask_type big = ax >= float_constants<VT>::one_half();
+	if ( big.any() )
+	{
+		VT e = float_constants<VT>::one() - erfc_large( ax );
+		r = ifthen( big, copysign( e, x ), r );
+	}
+	return r;
+}
+
+template <typename VT>
+inline VT
+erfc_impl( VT x )
+{
+	const VT one = float_constants<VT>::one();
+	const VT half = float_constants<VT>::one_half();
+	VT r = one - x * erf_kernel( x * x );
+	typename VT::mask_type big = fabs( x ) >= half;
+	if ( big.any() )
+	{
+		VT e = erfc_large( fabs( x ) );
+		r = ifthen( x >= half, e, r );
+		r = ifthen( x <= -half, float_constants<VT>::two() - e, r );
+	}
+	return r;
+}
+
+template <typename VT>
+inline VT
+tgamma_impl( VT x )
+{
+	typedef VT fvec;
+	typedef typename VT::mask_type mask;
+	typedef typename VT::value_type value_type;
+	typedef special_constants<value_type> sconst;
+	const fvec one = float_constants<fvec>::one();
+	const fvec two = float_constants<fvec>::two();
+	const fvec three = float_constants<fvec>::three();
+
+	// gamma( x ) = -pi / ( x sin( pi x ) gamma( -x ) ), using -x
+	// rather than 1 - x as that is exact
+	mask neg = x < fvec::zero();
+	// also keeps the loops finite for inf
+	fvec z = min( fabs( x ), fvec( sconst::tgamma_limit() ) );
+	// the reflection of large z is tiny (or denormal) where gamma( z )
+	// overflows, so scale gamma( z ) down and the result back after
+	const fvec scale( sconst::tgamma_scale() );
+	mask scaled = neg && z >= fvec( value_type( 20 ) );
+
+	// gamma( z ) = ( z - 1 ) gamma( z - 1 ), gamma( z ) = gamma( z + 1 ) / z
+	fvec p = ifthen( scaled, scale, one ), q = one;
+	mask m = z >= three;
+	while ( m.any() )
+	{
+		z = ifthen( m, z - one, z );
+		p = ifthen( m, p * z, p );
+		m = z >= three;
+	}
+	m = z < two;
+	while ( m.any() )
+	{
+		q = ifthen( m, q * z, q );
+		z = ifthen( m, z + one, z );
+		m = z < two;
+	}
+	fvec t = p * tgamma_kernel( z - two );
+	fvec g = t / q;
+
+	if ( neg.any() )
+	{
+		// sin( pi x ) / q rather than sin( pi x ) gamma( z ), as
+		// gamma( z ) overflows for tiny z
+		fvec s = sinpi( x );
+		fvec r = - float_constants<fvec>::pi() / ( x * ( ( s / q ) * t ) );
+		r = ifthen( scaled, r * scale, r );
+		// the poles at the negative integers
+		r = ifthen( s == fvec::zero(), float_constants<fvec>::nan(), r );
+		g = ifthen( neg, r, g );
+	}
+	// signed infinities at the zeros
+	g = ifthen( x == fvec::zero(), one / x, g );
+	return ifthen( isnan( x ), x, g );
+}
+
+template <typename VT>
+inline VT
+lgamma_impl( VT x )
+{
+	typedef VT fvec;
+	typedef typename VT::mask_type mask;
+	typedef typename VT::value_type value_type;
+	typedef special_constants<value_type> sconst;
+	const fvec one = float_constants<fvec>::one();
+	const fvec two = float_constants<fvec>::two();
+	const fvec lo( value_type( 1.5 ) ), hi( value_type( 2.5 ) );
+	const fvec stirling( sconst::stirling() );
+
+	fvec ax = fabs( x );
+
+	// step into [1.5, 2.5), accumulating the factors to take out
+	fvec z = ax;
+	fvec p = one, q = one, k = fvec::zero();
+	mask m = z >= hi && z < stirling;
+	while ( m.any() )
+	{
+		z = ifthen( m, z - one, z );
+		p = ifthen( m, p * z, p );
+		m = z >= hi && z < stirling;
+	}
+	m = z < lo;
+	while ( m.any() )
+	{
+		q = ifthen( m, q * z, q );
+		z = ifthen( m, z + one, z );
+		k = ifthen( m, k + one, k );
+		m = z < lo;
+	}
+	// z rounds stepping up, so near the root at 1 take y from x
+	// directly, x - 1 is exact there
+	fvec y = ifthen( k == fvec::zero(), z - two, ( ax - one ) + ( k - one ) );
+	// only one of p and q is not 1, and 1 / q would round
+	fvec l = special_log( ifthen( k == fvec::zero(), p, q ) );
+	fvec r = y * ( y + one ) * lgamma_kernel( y ) + ifthen( k == fvec::zero(), l, -l );
+
+	mask big = ax >= stirling;
+	if ( big.any() )
+	{
+		// ( x - 0.5 ) log( x ) - x + log( 2 pi ) / 2 + ...
+		fvec lx = special_log( ax );
+		fvec s = ( ax - float_constants<fvec>::one_half() ) * ( lx - one )
+			+ fvec( value_type( 0.91893853320467274178 - 0.5 ) );
+		s += stirling_kernel( one / ax );
+		r = ifthen( big, s, r );
+	}
+
+	mask neg = x < fvec::zero();
+	if ( neg.any() )
+	{
+		// lgamma( x ) = log( pi / | x sin( pi x ) | ) - lgamma( -x )
+		fvec ref = special_log( float_constants<fvec>::pi() / fabs( x * sinpi( x ) ) ) - r;
+		r = ifthen( neg, ref, r );
+	}
+	// also avoids the overflow of 1 / q for denormal x
+	r = ifthen( ax < fvec( sconst::lgamma_tiny() ), - special_log_denormal( ax ), r );
+	r = ifthen( isinf( x ), float_constants<fvec>::infinity(), r );
+	return ifthen( isnan( x ), x, r );
+}
+
+/// @brief the inverse normal CDF, 3.7e-9 relative
+///
+/// q ( P( s ) / Q( s ) ) with s = 0.180625 - q^2, q = p - 0.5, for
+/// |q| <= 0.425 (as AS241 does, so the coefficients are all positive)
+/// and a rational in t = sqrt( -2 log( p ) ) for the tails
+template <typename VT>
+inline PAL_ENABLE_FLOAT(VT)
+normcdfinv_kernel( VT p )
+{
+	typedef VT fvec;
+	typedef typename VT::mask_type mask;
+	const fvec one = float_constants<fvec>::one();
+	const fvec half = float_constants<fvec>::one_half();
+
+	fvec q = p - half;
+	fvec s = fvec( 0.180625F ) - q * q;
+	fvec a = horner( s, 3.38713286026117277e+00, 6.06948203196823002e+01,
+					 2.73671477229493121e+02, 2.53274682496859896e+02 );
+	fvec b = horner( s, 1.0, 2.09244843395565283e+01, 1.21623948640278044e+02,
+					 1.86934760919528458e+02, 3.12006060753520167e+01 );
+	fvec x = q * a / b;
+
+	// tails, in terms of the smaller of p and 1 - p
+	fvec pt = min( p, one - p );
+	mask tail = pt < fvec( 0.075F );
+	if ( tail.any() )
+	{
+		fvec t = special_sqrt( float_constants<fvec>::two() * - special_log_denormal( pt ) );
+		fvec c = horner( t, 3.00008577033738355e+00, 4.82930428356247710e+00,
+						 -2.90873342378339794e+00, -2.54724234276438377e+00,
+						 -2.58459452979963311e-01 );
+		fvec d = horner( t, 1.0, 4.01449990081560504e+00, 2.55729702307468676e+00,
+						 2.58305169887773967e-01, 1.53837884365412773e-06 );
+		fvec xt = c / d;
+		x = ifthen( tail, ifthen( p > half, -xt, xt ), x );
+	}
+	return x;
+}
+
+/// @brief P. Acklam's approximation to the inverse normal CDF, 1.15e-9
+/// relative, as the start for the refinement in normcdfinv
+template <typename VT>
+inline PAL_ENABLE_DOUBLE(VT)
+normcdfinv_kernel( VT p )
+{
+	typedef VT dvec;
+	typedef typename VT::mask_type mask;
+	const dvec one = float_constants<dvec>::one();
+	const dvec half = float_constants<dvec>::one_half();
+
+	// central region
+	dvec q = p - half;
+	dvec r = q * q;
+	dvec a = horner( r, 2.506628277459239e+00, -3.066479806614716e+01,
+					 1.383577518672690e+02, -2.759285104469687e+02,
+					 2.209460984245205e+02, -3.969683028665376e+01 );
+	dvec b = horner( r, 1.0, -1.328068155288572e+01, 6.680131188771972e+01,
+					 -1.556989798598866e+02, 1.615858368580409e+02,
+					 -5.447609879822406e+01 );
+	dvec x = a * q / b;
+
+	// tails, in terms of the smaller of p and 1 - p
+	dvec pt = min( p, one - p );
+	mask tail = pt < dvec( 0.02425 );
+	if ( tail.any() )
+	{
+		dvec t = sqrt( float_constants<dvec>::two() * - log( pt ) );
+		dvec c = horner( t, 2.938163982698783e+00, 4.374664141464968e+00,
+						 -2.549732539343734e+00, -2.400758277161838e+00,
+						 -3.223964580411365e-01, -7.784894002430293e-03 );
+		dvec d = horner( t, 1.0, 3.754408661907416e+00, 2.445134137142996e+00,
+						 3.224671290700398e-01, 7.784695709041462e-03 );
+		dvec xt = c / d;
+		x = ifthen( tail, ifthen( p > half, -xt, xt ), x );
+	}
+	return x;
+}
+
+template <typename VT>
+PAL_INLINE VT
+normcdfinv_special( VT p, VT x )
+{
+	typedef float_constants<VT> fconst;
+	x = ifthen( p == VT::zero(), - fconst::infinity(), x );
+	x = ifthen( p == fconst::one(), fconst::infinity(), x );
+	return ifthen( p < VT::zero() || p > fconst::one() || isnan( p ), fconst::nan(), x );
+}
+
+} // namespace detail
+
+////////////////////////////////////////
+
+/// @brief the error function, 2 / sqrt( pi ) * integral of e^(-t^2)
+/// from 0 to x
+template <typename VT>
+inline PAL_ENABLE_FLOAT(VT)
+erff( VT x )
+{
+	return detail::erf_impl( x );
+}
+
+/// @brief the complementary error function, 1 - erf( x ), with the
+/// error relative to the result in the tail
+template <typename VT>
+inline PAL_ENABLE_FLOAT(VT)
+erfcf( VT x )
+{
+	return detail::erfc_impl( x );
+}
+
+/// @brief the gamma function
+template <typename VT>
+inline PAL_ENABLE_FLOAT(VT)
+tgammaf( VT x )
+{
+	return detail::tgamma_impl( x );
+}
+
+/// @brief the natural log of the absolute value of the gamma function
+template <typename VT>
+inline PAL_ENABLE_FLOAT(VT)
+lgammaf( VT x )
+{
+	return detail::lgamma_impl( x );
+}
+
+/// @brief the inverse of the standard normal CDF (probit), x such
+/// that P( X <= x ) = p
+///
+/// returns -inf / inf at 0 and 1, and NaN outside [0, 1]
+template <typename VT>
+inline PAL_ENABLE_FLOAT(VT)
+normcdfinvf( VT p )
+{
+	return detail::normcdfinv_special( p, detail::normcdfinv_kernel( p ) );
+}
+
+/// @brief erff with a requested precision, there is only the full
+/// tier
+///
+/// @sa precision
+template <typename VT, int bits>
+inline PAL_ENABLE_FLOAT(VT)
+erff( VT x, precision<bits> )
+{
+	return erff( x );
+}
+
+/// @brief erfcf with a requested precision, there is only the full
+/// tier
+///
+/// @sa precision
+template <typename VT, int bits>
+inline PAL_ENABLE_FLOAT(VT)
+erfcf( VT x, precision<bits> )
+{
+	return erfcf( x );
+}
+
+/// @brief tgammaf with a requested precision, there is only the full
+/// tier
+///
+/// @sa precision
+template <typename VT, int bits>
+inline PAL_ENABLE_FLOAT(VT)
+tgammaf( VT x, precision<bits> )
+{
+	return tgammaf( x );
+}
+
+/// @brief lgammaf with a requested precision, there is only the full
+/// tier
+///
+/// @sa precision
+template <typename VT, int bits>
+inline PAL_ENABLE_FLOAT(VT)
+lgammaf( VT x, precision<bits> )
+{
+	return lgammaf( x );
+}
+
+/// @brief normcdfinvf with a requested precision, there is only the full
+/// tier
+///
+/// @sa precision
+template <typename VT, int bits>
+inline PAL_ENABLE_FLOAT(VT)
+normcdfinvf( VT p, precision<bits> )
+{
+	return normcdfinvf( p );
+}
+
+////////////////////////////////////////
+
+/// @brief double version of erff
+template <typename VT>
+inline PAL_ENABLE_DOUBLE(VT)
+erf( VT x )
+{
+	return detail::erf_impl( x );
+}
+
+/// @brief double version of erfcf
+template <typename VT>
+inline PAL_ENABLE_DOUBLE(VT)
+erfc( VT x )
+{
+	return detail::erfc_impl( x );
+}
+
+/// @brief double version of tgammaf
+template <typename VT>
+inline PAL_ENABLE_DOUBLE(VT)
+tgamma( VT x )
+{
+	return detail::tgamma_impl( x );
+}
+
+/// @brief double version of lgammaf
+template <typename VT>
+inline PAL_ENABLE_DOUBLE(VT)
+lgamma( VT x )
+{
+	return detail::lgamma_impl( x );
+}
+
+/// @brief double version of normcdfinvf
+///
+/// refines the approximation with one step of Halley's method on
+/// Phi( x ) - p, which brings it to the full precision
+template <typename VT>
+inline PAL_ENABLE_DOUBLE(VT)
+normcdfinv( VT p )
+{
+	typedef VT dvec;
+	typedef float_constants<dvec> fconst;
+
+	// work with the lower half, Phi( -x ) = 1 - Phi( x ), so the
+	// error of Phi is relative
+	dvec pt = min( p, fconst::one() - p );
+	dvec x = - fabs( detail::normcdfinv_kernel( pt ) );
+
+	// Phi( x ) - pt, near the middle as erf( x / sqrt( 2 ) ) / 2 less
+	// 0.5 - pt (exact), so that it is relative to x
+	const dvec quarter( 0.25 );
+	dvec a = x * dvec( -M_SQRT1_2 );
+	dvec e = fconst::one_half() * erfc( a ) - pt;
+	dvec ec = ( fconst::one_half() - pt ) - fconst::one_half() * erf( a );
+	e = ifthen( pt >= quarter, ec, e );
+
+	dvec u = e * dvec( 2.50662827463100050242 ) * exp( fconst::one_half() * x * x );
+	dvec xr = x - u / fma( fconst::one_half() * x, u, fconst::one() );
+	// denormal p has too few bits for the refinement to help
+	x = ifthen( pt < fconst::min(), x, xr );
+
+	// back to the upper half, 0.5 included so it gives +0
+	x = ifthen( p >= fconst::one_half(), -x, x );
+	return detail::normcdfinv_special( p, x );
+}
+
+} // namespace pal
+
+#endif // _PAL_X86_SIMD_SPECIAL_H_
@@ -0,0 +1,277 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use <pal/x86/simd_transfer.h> directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_X86_SIMD_TRANSFER_H_
+# define _PAL_X86_SIMD_TRANSFER_H_ 1
+
+// display transfer functions (sRGB, BT.709, ST 2084 PQ and BT.2100
+// HLG). The inputs are clamped to [0, 1], and the linear side of PQ
+// is normalized such that 1 is 10000 nits.
+//
+// The sRGB, BT.709 and PQ curves are rational minimax fits with
+// relative error weighting (see the minimax_fit tool), HLG uses the
+// medium precision exp / log kernels. The encodes are fit in terms of
+// x^(1/4) (x^(1/8) for PQ) to remove the infinite slope at 0, the PQ
+// decode is split in two pieces. The measured relative error, in
+// units of 2^-23, over every float of the range is
+//
+//   srgb_to_linear    4     linear_to_srgb    7     [1e-6, 1]
+//   rec709_to_linear  4     linear_to_rec709  6     [1e-6, 1]
+//   hlg_to_linear     4     linear_to_hlg     3     [1e-6, 1]
+//   pq_to_linear     24     [1e-3, 1]
+//   linear_to_pq     12     [1e-8, 1]
+//
+// Below those PQ ranges (about 4e-5 nits decoded, 1e-4 nits encoded)
+// the closed form is evaluated with the medium precision log / exp
+// kernels, which is a few hundred units off as the m2 exponent
+// amplifies any rounding. That path, and the exp / log of HLG, only
+// run when a value needs them, the PQ fits are several times the
+// speed of powf.
+
+namespace PAL_NAMESPACE
+{
+
+namespace detail
+{
+
+/// @brief x^p for x > 0 (0 underflows to 0 for positive p)
+template <typename VT>
+PAL_INLINE VT
+transfer_pow( VT x, VT p )
+{
+	VT fk;
+	VT f = log_reduce( x, fk );
+	VT l = fma( f * log_kernel( f, tier_medium() ), float_constants<VT>::log2_e(), fk );
+	return exp2f_tier( l * p, tier_medium() );
+}
+
+/// @brief natural log for x > 0
+template <typename VT>
+PAL_INLINE VT
+transfer_log( VT x )
+{
+	VT fk;
+	VT f = log_reduce( x, fk );
+	return fma( fk, float_constants<VT>::log_2(), f * log_kernel( f, tier_medium() ) );
+}
+
+template <typename VT>
+PAL_INLINE VT
+transfer_clamp( VT x )
+{
+	return clamp( x, VT::zero(), float_constants<VT>::one() );
+}
+
+// ST 2084 constants
+static constexpr float kPQ_m1 = 2610.F / 16384.F;
+static constexpr float kPQ_m2 = 2523.F / 4096.F * 128.F;
+static constexpr float kPQ_c1 = 3424.F / 4096.F;
+static constexpr float kPQ_c2 = 2413.F / 4096.F * 32.F;
+static constexpr float kPQ_c3 = 2392.F / 4096.F * 32.F;
+
+// c1^m2, the PQ code value of linear 0
+static constexpr float kPQ_black = 7.30955903e-07F;
+
+/// @brief closed form of the PQ EOTF, for the values near black
+/// below the rational fits in pq_to_linear
+template <typename VT>
+PAL_INLINE VT
+pq_to_linear_closed( VT v )
+{
+	// values below black leave r at 0, which underflows to 0 through
+	// transfer_pow
+	v = max( v, VT( std::numeric_limits<float>::min() ) );
+	VT p = transfer_pow( v, VT( 1.F / kPQ_m2 ) );
+	VT r = max( p - VT( kPQ_c1 ), VT::zero() ) / nmadd( VT( kPQ_c3 ), p, VT( kPQ_c2 ) );
+	return transfer_pow( r, VT( 1.F / kPQ_m1 ) );
+}
+
+/// @brief closed form of the PQ inverse EOTF, for the values below
+/// the rational fit in linear_to_pq
+template <typename VT>
+PAL_INLINE VT
+linear_to_pq_closed( VT v )
+{
+	v = max( v, VT( std::numeric_limits<float>::min() ) );
+	VT p = transfer_pow( v, VT( kPQ_m1 ) );
+	VT r = fma( VT( kPQ_c2 ), p, VT( kPQ_c1 ) ) / fma( VT( kPQ_c3 ), p, float_constants<VT>::one() );
+	return transfer_pow( r, VT( kPQ_m2 ) );
+}
+
+// BT.2100 HLG constants
+static constexpr float kHLG_a = 0.17883277F;
+static constexpr float kHLG_b = 0.28466892F;
+static constexpr float kHLG_c = 0.55991073F;
+
+} // namespace detail
+
+////////////////////////////////////////
+
+/// @brief sRGB EOTF, decodes sRGB encoded values to linear
+template <typename VT>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+srgb_to_linear( VT v )
+{
+	v = detail::transfer_clamp( v );
+	// srgb_to_linear on [0.04045, 1], degree 5 / 4
+	VT p = polyval( v, 8.339636935e-04F, 4.260716225e-02F, 7.449100967e-01F,
+					4.971083548e+00F, 1.069116549e+01F, 5.020781156e+00F );
+	VT q = polyval( v, 1.000000000e+00F, 7.480667549e+00F, 1.089292380e+01F,
+					2.188331220e+00F, -9.054189977e-02F );
+	return ifthen( v <= VT( 0.04045F ), v * VT( 1.F / 12.92F ), p / q );
+}
+
+/// @brief sRGB inverse EOTF, encodes linear values to sRGB
+template <typename VT>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+linear_to_srgb( VT v )
+{
+	v = detail::transfer_clamp( v );
+	VT t = sqrtf( sqrtf( v ) );
+	// 1.055 * t^(4/2.4) - 0.055 on [0.0031308^(1/4), 1], degree 4 / 3
+	VT p = polyval( t, -5.604596693e-02F, -2.410225489e-01F, 2.155682022e+00F,
+					6.672354949e+00F, 2.415767949e+00F );
+	VT q = polyval( t, 1.000000000e+00F, 5.586740614e+00F, 4.164238320e+00F,
+					1.957577605e-01F );
+	return ifthen( v <= VT( 0.0031308F ), v * VT( 12.92F ), p / q );
+}
+
+/// @brief BT.709 inverse OETF, decodes BT.709 encoded values to linear
+template <typename VT>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+rec709_to_linear( VT v )
+{
+	v = detail::transfer_clamp( v );
+	// rec709_to_linear on [0.081, 1], degree 4 / 3
+	VT p = polyval( v, 4.755357609e-03F, 1.205199505e-01F, 9.782562525e-01F,
+					2.515274993e+00F, 1.348961857e+00F );
+	VT q = polyval( v, 1.000000000e+00F, 2.930853340e+00F, 1.067958666e+00F,
+					-3.104423451e-02F );
+	return ifthen( v < VT( 0.081F ), v * VT( 1.F / 4.5F ), p / q );
+}
+
+/// @brief BT.709 OETF, encodes linear values to BT.709
+template <typename VT>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+linear_to_rec709( VT v )
+{
+	v = detail::transfer_clamp( v );
+	VT t = sqrtf( sqrtf( v ) );
+	// 1.099 * t^1.8 - 0.099 on [0.018^(1/4), 1], degree 3 / 3
+	VT p = polyval( t, -1.005476287e-01F, -1.647889201e-01F, 1.550892289e+00F,
+					2.037926941e+00F );
+	VT q = polyval( t, 1.000000000e+00F, 2.154124159e+00F, 1.859456272e-01F,
+					-1.658720489e-02F );
+	return ifthen( v < VT( 0.018F ), v * VT( 4.5F ), p / q );
+}
+
+/// @brief ST 2084 (PQ) EOTF, decodes PQ encoded values to linear
+/// where 1 is 10000 nits
+///
+/// two rational pieces, linear^(1/4) in v on [0.1, 1] and
+/// linear^(1/2) in sqrt( v ) on [1e-3, 0.1], the closed form is only
+/// evaluated for the values between black (c1^m2, ~7.3e-7) and 1e-3
+template <typename VT>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+pq_to_linear( VT v )
+{
+	v = detail::transfer_clamp( v );
+	VT p = polyval( v, 1.137481723e-02F, 1.986253619e+00F, 4.066396713e+01F,
+					1.714741364e+02F, 8.150887299e+01F, -1.100717926e+02F,
+					1.143610859e+01F );
+	VT q = polyval( v, 1.000000000e+00F, 5.411227417e+01F, 4.059788208e+02F,
+					1.370196075e+02F, -7.735300293e+02F, 4.461128845e+02F,
+					-7.368466187e+01F );
+	VT r = p / q;
+	r = r * r;
+	r = r * r;
+	typename VT::mask_type lo = v < VT( 0.1F );
+	if ( lo.any() )
+	{
+		VT s = sqrtf( v );
+		p = polyval( s, -1.326405595e-06F, 4.555652413e-05F, 1.201971322e-01F,
+					 2.655124903e+00F, 6.626727104e+00F, -1.087854290e+01F );
+		q = polyval( s, 1.000000000e+00F, 6.217920685e+01F, 3.272434387e+02F,
+					 -1.482766724e+03F, 1.843250732e+03F, -7.864729004e+02F );
+		VT l = p / q;
+		r = ifthen( lo, l * l, r );
+	}
+	typename VT::mask_type black = v <= VT( detail::kPQ_black );
+	typename VT::mask_type tiny = ( v < VT( 1e-3F ) ) & ! black;
+	if ( tiny.any() )
+		r = ifthen( tiny, detail::pq_to_linear_closed( v ), r );
+	return min( ifthen( black, VT::zero(), r ), float_constants<VT>::one() );
+}
+
+/// @brief ST 2084 (PQ) inverse EOTF, encodes linear values (1 is
+/// 10000 nits) to PQ
+///
+/// a rational in v^(1/8) on [1e-8, 1], the closed form is only
+/// evaluated for the (non-zero) values below that
+template <typename VT>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+linear_to_pq( VT v )
+{
+	v = detail::transfer_clamp( v );
+	VT t = sqrtf( sqrtf( sqrtf( v ) ) );
+	VT p = polyval( t, -7.117518107e-04F, 4.635376483e-02F, -1.300305367e+00F,
+					2.049199104e+01F, -1.797189941e+02F, 8.852622681e+02F,
+					1.032885132e+03F );
+	VT q = polyval( t, 1.000000000e+00F, 4.141078949e+00F, 4.030201340e+01F,
+					1.304473419e+02F, 4.030446167e+02F, 6.687316284e+02F,
+					5.099989929e+02F );
+	VT r = p / q;
+	typename VT::mask_type zero = v == VT::zero();
+	typename VT::mask_type tiny = ( v < VT( 1e-8F ) ) & ! zero;
+	if ( tiny.any() )
+		r = ifthen( tiny, detail::linear_to_pq_closed( v ), r );
+	return ifthen( zero, VT( detail::kPQ_black ), r );
+}
+
+/// @brief BT.2100 HLG inverse OETF, decodes HLG encoded values to
+/// normalized scene linear
+template <typename VT>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+hlg_to_linear( VT v )
+{
+	v = detail::transfer_clamp( v );
+	VT r = v * v * VT( 1.F / 3.F );
+	typename VT::mask_type hi = v > VT( 0.5F );
+	if ( hi.any() )
+	{
+		VT e = detail::expf_tier( ( v - VT( detail::kHLG_c ) ) * VT( 1.F / detail::kHLG_a ), detail::tier_medium() );
+		r = ifthen( hi, ( e + VT( detail::kHLG_b ) ) * VT( 1.F / 12.F ), r );
+	}
+	return r;
+}
+
+/// @brief BT.2100 HLG OETF, encodes normalized scene linear values to
+/// HLG
+template <typename VT>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+linear_to_hlg( VT v )
+{
+	v = detail::transfer_clamp( v );
+	VT r = sqrtf( v * VT( 3.F ) );
+	typename VT::mask_type hi = v > VT( 1.F / 12.F );
+	if ( hi.any() )
+	{
+		// the log argument is only valid above 1/12, keep it positive
+		// so the unused lanes stay finite
+		VT l = detail::transfer_log( max( fma( v, VT( 12.F ), VT( -detail::kHLG_b ) ), VT( 0.5F ) ) );
+		r = ifthen( hi, fma( l, VT( detail::kHLG_a ), VT( detail::kHLG_c ) ), r );
+	}
+	return r;
+}
+
+} // namespace pal
+
+#endif // _PAL_X86_SIMD_TRANSFER_H_
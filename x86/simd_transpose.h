@@ -0,0 +1,216 @@
+//
+// Copyright (c) 2017 Kimball Thurston
+// All rights reserved.
+// Copyrights licensed under the MIT License.
+// See the accompanying LICENSE.txt file for terms
+//
+
+#if !defined _PAL_H_
+# error "Never use <pal/x86/simd_transpose.h> directly. Include <pal.h> instead."
+#endif
+
+#ifndef _PAL_X86_SIMD_TRANSPOSE_H_
+# define _PAL_X86_SIMD_TRANSPOSE_H_ 1
+
+namespace PAL_NAMESPACE
+{
+
+namespace detail
+{
+
+/// @brief { x[a], x[b], y[c], y[d] } (per 128-bit lane)
+template <int a, int b, int c, int d>
+PAL_INLINE fvec4 shuffle2( fvec4 x, fvec4 y )
+{
+	return fvec4( _mm_shuffle_ps( x, y, _MM_SHUFFLE( d, c, b, a ) ) );
+}
+
+#ifdef PAL_HAS_FVEC8
+template <int a, int b, int c, int d>
+PAL_INLINE fvec8 shuffle2( fvec8 x, fvec8 y )
+{
+	return fvec8( _mm256_shuffle_ps( x, y, _MM_SHUFFLE( d, c, b, a ) ) );
+}
+#endif
+
+} // namespace detail
+
+////////////////////////////////////////
+
+/// @brief transposes the 4x4 matrix held in rows r0 - r3 in place
+///
+/// 4 unpacks and 4 moves, the same as _MM_TRANSPOSE4_PS
+PAL_INLINE void transpose4x4( fvec4 &r0, fvec4 &r1, fvec4 &r2, fvec4 &r3 )
+{
+	__m128 t0 = _mm_unpacklo_ps( r0, r1 );
+	__m128 t1 = _mm_unpacklo_ps( r2, r3 );
+	__m128 t2 = _mm_unpackhi_ps( r0, r1 );
+	__m128 t3 = _mm_unpackhi_ps( r2, r3 );
+	r0 = fvec4( _mm_movelh_ps( t0, t1 ) );
+	r1 = fvec4( _mm_movehl_ps( t1, t0 ) );
+	r2 = fvec4( _mm_movelh_ps( t2, t3 ) );
+	r3 = fvec4( _mm_movehl_ps( t3, t2 ) );
+}
+
+template <typename T>
+PAL_INLINE typename std::enable_if<sizeof(T) == 4>::type
+transpose4x4( ivec128<T> &r0, ivec128<T> &r1, ivec128<T> &r2, ivec128<T> &r3 )
+{
+	__m128i t0 = _mm_unpacklo_epi32( r0, r1 );
+	__m128i t1 = _mm_unpacklo_epi32( r2, r3 );
+	__m128i t2 = _mm_unpackhi_epi32( r0, r1 );
+	__m128i t3 = _mm_unpackhi_epi32( r2, r3 );
+	r0 = ivec128<T>( _mm_unpacklo_epi64( t0, t1 ) );
+	r1 = ivec128<T>( _mm_unpackhi_epi64( t0, t1 ) );
+	r2 = ivec128<T>( _mm_unpacklo_epi64( t2, t3 ) );
+	r3 = ivec128<T>( _mm_unpackhi_epi64( t2, t3 ) );
+}
+
+PAL_INLINE void transpose2x2( dvec2 &r0, dvec2 &r1 )
+{
+	__m128d t0 = _mm_unpacklo_pd( r0, r1 );
+	r1 = dvec2( _mm_unpackhi_pd( r0, r1 ) );
+	r0 = dvec2( t0 );
+}
+
+/// @brief splits 4 interleaved 3-component values { c0 c1 c2 c0 },
+/// { c1 c2 c0 c1 }, { c2 c0 c1 c2 } into one vector per component
+///
+/// With fvec8, each 128-bit lane is handled independently, see
+/// load8f_split.
+template <typename VT>
+PAL_INLINE void deinterleave3( VT x0, VT x1, VT x2, VT &c0, VT &c1, VT &c2 )
+{
+	using detail::shuffle2;
+	c0 = shuffle2<0, 3, 0, 2>( x0, shuffle2<2, 2, 1, 1>( x1, x2 ) );
+	c1 = shuffle2<0, 2, 0, 2>( shuffle2<1, 1, 0, 0>( x0, x1 ), shuffle2<3, 3, 2, 2>( x1, x2 ) );
+	c2 = shuffle2<0, 2, 0, 3>( shuffle2<2, 2, 1, 1>( x0, x1 ), x2 );
+}
+
+/// @brief inverse of deinterleave3
+template <typename VT>
+PAL_INLINE void interleave3( VT c0, VT c1, VT c2, VT &x0, VT &x1, VT &x2 )
+{
+	using detail::shuffle2;
+	x0 = shuffle2<0, 2, 0, 2>( shuffle2<0, 0, 0, 0>( c0, c1 ), shuffle2<0, 0, 1, 1>( c2, c0 ) );
+	x1 = shuffle2<0, 2, 0, 2>( shuffle2<1, 1, 1, 1>( c1, c2 ), shuffle2<2, 2, 2, 2>( c0, c1 ) );
+	x2 = shuffle2<0, 2, 0, 2>( shuffle2<2, 2, 3, 3>( c2, c0 ), shuffle2<3, 3, 3, 3>( c1, c2 ) );
+}
+
+/// @brief splits 2 vectors of interleaved pairs { c0 c1 c0 c1 } (such
+/// as complex values) into one vector per component
+///
+/// With fvec8, each 128-bit lane is handled independently, see
+/// load8f_split.
+template <typename VT>
+PAL_INLINE void deinterleave2( VT x0, VT x1, VT &c0, VT &c1 )
+{
+	using detail::shuffle2;
+	c0 = shuffle2<0, 2, 0, 2>( x0, x1 );
+	c1 = shuffle2<1, 3, 1, 3>( x0, x1 );
+}
+
+/// @brief inverse of deinterleave2
+PAL_INLINE void interleave2( fvec4 c0, fvec4 c1, fvec4 &x0, fvec4 &x1 )
+{
+	x0 = fvec4( _mm_unpacklo_ps( c0, c1 ) );
+	x1 = fvec4( _mm_unpackhi_ps( c0, c1 ) );
+}
+
+#ifdef PAL_HAS_FVEC8
+PAL_INLINE void interleave2( fvec8 c0, fvec8 c1, fvec8 &x0, fvec8 &x1 )
+{
+	x0 = fvec8( _mm256_unpacklo_ps( c0, c1 ) );
+	x1 = fvec8( _mm256_unpackhi_ps( c0, c1 ) );
+}
+#endif
+
+#ifdef PAL_HAS_FVEC8
+
+/// @brief transposes the 8x8 matrix held in rows r0 - r7 in place
+///
+/// 8 unpacks, 8 shuffles and 8 lane permutes
+PAL_INLINE void transpose8x8( fvec8 &r0, fvec8 &r1, fvec8 &r2, fvec8 &r3,
+							  fvec8 &r4, fvec8 &r5, fvec8 &r6, fvec8 &r7 )
+{
+	__m256 t0 = _mm256_unpacklo_ps( r0, r1 );
+	__m256 t1 = _mm256_unpackhi_ps( r0, r1 );
+	__m256 t2 = _mm256_unpacklo_ps( r2, r3 );
+	__m256 t3 = _mm256_unpackhi_ps( r2, r3 );
+	__m256 t4 = _mm256_unpacklo_ps( r4, r5 );
+	__m256 t5 = _mm256_unpackhi_ps( r4, r5 );
+	__m256 t6 = _mm256_unpacklo_ps( r6, r7 );
+	__m256 t7 = _mm256_unpackhi_ps( r6, r7 );
+	__m256 s0 = _mm256_shuffle_ps( t0, t2, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+	__m256 s1 = _mm256_shuffle_ps( t0, t2, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+	__m256 s2 = _mm256_shuffle_ps( t1, t3, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+	__m256 s3 = _mm256_shuffle_ps( t1, t3, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+	__m256 s4 = _mm256_shuffle_ps( t4, t6, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+	__m256 s5 = _mm256_shuffle_ps( t4, t6, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+	__m256 s6 = _mm256_shuffle_ps( t5, t7, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+	__m256 s7 = _mm256_shuffle_ps( t5, t7, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+	r0 = fvec8( _mm256_permute2f128_ps( s0, s4, 0x20 ) );
+	r1 = fvec8( _mm256_permute2f128_ps( s1, s5, 0x20 ) );
+	r2 = fvec8( _mm256_permute2f128_ps( s2, s6, 0x20 ) );
+	r3 = fvec8( _mm256_permute2f128_ps( s3, s7, 0x20 ) );
+	r4 = fvec8( _mm256_permute2f128_ps( s0, s4, 0x31 ) );
+	r5 = fvec8( _mm256_permute2f128_ps( s1, s5, 0x31 ) );
+	r6 = fvec8( _mm256_permute2f128_ps( s2, s6, 0x31 ) );
+	r7 = fvec8( _mm256_permute2f128_ps( s3, s7, 0x31 ) );
+}
+
+template <typename T>
+PAL_INLINE typename std::enable_if<sizeof(T) == 4>::type
+transpose8x8( ivec256<T> &r0, ivec256<T> &r1, ivec256<T> &r2, ivec256<T> &r3,
+			  ivec256<T> &r4, ivec256<T> &r5, ivec256<T> &r6, ivec256<T> &r7 )
+{
+	fvec8 f0( _mm256_castsi256_ps( r0 ) ), f1( _mm256_castsi256_ps( r1 ) );
+	fvec8 f2( _mm256_castsi256_ps( r2 ) ), f3( _mm256_castsi256_ps( r3 ) );
+	fvec8 f4( _mm256_castsi256_ps( r4 ) ), f5( _mm256_castsi256_ps( r5 ) );
+	fvec8 f6( _mm256_castsi256_ps( r6 ) ), f7( _mm256_castsi256_ps( r7 ) );
+	transpose8x8( f0, f1, f2, f3, f4, f5, f6, f7 );
+	r0 = ivec256<T>( _mm256_castps_si256( f0 ) ); r1 = ivec256<T>( _mm256_castps_si256( f1 ) );
+	r2 = ivec256<T>( _mm256_castps_si256( f2 ) ); r3 = ivec256<T>( _mm256_castps_si256( f3 ) );
+	r4 = ivec256<T>( _mm256_castps_si256( f4 ) ); r5 = ivec256<T>( _mm256_castps_si256( f5 ) );
+	r6 = ivec256<T>( _mm256_castps_si256( f6 ) ); r7 = ivec256<T>( _mm256_castps_si256( f7 ) );
+}
+
+/// @brief transposes the 4x4 matrix in each 128-bit lane of r0 - r3
+/// independently
+///
+/// Only in-lane shuffles, so this is cheaper than a full transpose
+/// when the lanes hold separate data (see load8f_split).
+PAL_INLINE void transpose4x4_lanes( fvec8 &r0, fvec8 &r1, fvec8 &r2, fvec8 &r3 )
+{
+	__m256 t0 = _mm256_unpacklo_ps( r0, r1 );
+	__m256 t1 = _mm256_unpacklo_ps( r2, r3 );
+	__m256 t2 = _mm256_unpackhi_ps( r0, r1 );
+	__m256 t3 = _mm256_unpackhi_ps( r2, r3 );
+	r0 = fvec8( _mm256_shuffle_ps( t0, t1, _MM_SHUFFLE( 1, 0, 1, 0 ) ) );
+	r1 = fvec8( _mm256_shuffle_ps( t0, t1, _MM_SHUFFLE( 3, 2, 3, 2 ) ) );
+	r2 = fvec8( _mm256_shuffle_ps( t2, t3, _MM_SHUFFLE( 1, 0, 1, 0 ) ) );
+	r3 = fvec8( _mm256_shuffle_ps( t2, t3, _MM_SHUFFLE( 3, 2, 3, 2 ) ) );
+}
+
+#endif // PAL_HAS_FVEC8
+
+#ifdef PAL_HAS_DVEC4
+
+/// @brief transposes the 4x4 matrix held in rows r0 - r3 in place
+PAL_INLINE void transpose4x4( dvec4 &r0, dvec4 &r1, dvec4 &r2, dvec4 &r3 )
+{
+	__m256d t0 = _mm256_unpacklo_pd( r0, r1 );
+	__m256d t1 = _mm256_unpackhi_pd( r0, r1 );
+	__m256d t2 = _mm256_unpacklo_pd( r2, r3 );
+	__m256d t3 = _mm256_unpackhi_pd( r2, r3 );
+	r0 = dvec4( _mm256_permute2f128_pd( t0, t2, 0x20 ) );
+	r1 = dvec4( _mm256_permute2f128_pd( t1, t3, 0x20 ) );
+	r2 = dvec4( _mm256_permute2f128_pd( t0, t2, 0x31 ) );
+	r3 = dvec4( _mm256_permute2f128_pd( t1, t3, 0x31 ) );
+}
+
+#endif // PAL_HAS_DVEC4
+
+} // namespace pal
+
+#endif // _PAL_X86_SIMD_TRANSPOSE_H_
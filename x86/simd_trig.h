@@ -15,121 +15,283 @@
 namespace PAL_NAMESPACE
 {
 
+/// @brief reduces v to x in [-pi/4, pi/4], returning the
+/// quadrant (multiple of pi/2 removed)
+///
+/// Uses a four-part Cody-Waite reduction: the first two parts have
+/// short mantissas so their products with the quadrant are exact for
+/// |v| up to about 4096 * pi / 2, beyond that precision is lost
+/// progressively (no Payne-Hanek).
 template <typename VT>
-inline PAL_ENABLE_FLOAT(VT)::int_vec_type
-reduce_pi_2( VT &x, VT &y, VT v )
+PAL_INLINE PAL_ENABLE_FLOAT(VT)::int_vec_type
+reduce_pi_2( VT &x, VT v )
 {
+	typedef VT fvec;
+	typedef typename fvec::int_vec_type ivec;
+
+	const fvec DP1( float(1.5703125) );
+	const fvec DP2( float(4.837512969970703125e-4) );
+	const fvec DP3( float(7.54979012640433211345e-8) );
+	const fvec DP4( float(-1.71512451000588187280e-15) );
+
+	ivec j = ( v * fvec( float(M_2_PI) ) ).convert_to_int();
+	fvec fj = fvec::convert_int( j );
+	fvec a = nmadd( fj, DP3, nmadd( fj, DP2, nmadd( fj, DP1, v ) ) );
+	x = nmadd( fj, DP4, a );
+	return j;
 }
 
 namespace detail
 {
 
-constexpr inline int64_t factorial( const int x ) 
+/// @brief sin on [-pi/4, pi/4], z = x^2, minimax 17 bits relative
+///
+/// sinf at this tier is 13.6 bits, cos_kernel( tier_low ) is used for
+/// the odd quadrants
+template <typename VT>
+PAL_INLINE VT
+sin_kernel( VT x, VT z, tier_low )
 {
-	return x == 1 ? x : x * factorial( x - 1 );
+	VT p = horner( z, -1.666572054e-01F, 8.211518944e-03F );
+	return fma( x * z, p, x );
 }
 
-template <typename T>
-constexpr inline T scale( int n, int sign )
+/// @brief sin on [-pi/4, pi/4], z = x^2 (cephes coefficients)
+template <typename VT, typename tier>
+PAL_INLINE VT
+sin_kernel( VT x, VT z, tier )
 {
-	return ( sign > 0 ? T(1) : T(-1) ) / static_cast<T>(factorial(n));
+	VT p = horner( z, -1.6666654611E-1F, 8.3321608736E-3F, -1.9515295891E-4F );
+	return fma( x * z, p, x );
 }
 
+/// @brief cos on [-pi/4, pi/4], z = x^2, minimax ~14 bits relative
+template <typename VT>
+PAL_INLINE VT
+cos_kernel( VT z, tier_low )
+{
+	return horner( z, 1.F, -4.999333289e-01F, 4.081385997e-02F );
 }
 
-/// TODO: this applies for double as well, but probably need more terms in the taylor series
-/// to be accurate...
+/// @brief cos on [-pi/4, pi/4], z = x^2, minimax ~22 bits relative
 template <typename VT>
-inline PAL_ENABLE_FLOAT(VT)
+PAL_INLINE VT
+cos_kernel( VT z, tier_medium )
+{
+	return horner( z, 1.F, -4.999998159e-01F, 4.166135830e-02F, -1.366032186e-03F );
+}
+
+/// @brief cos on [-pi/4, pi/4], z = x^2 (cephes coefficients)
+template <typename VT>
+PAL_INLINE VT
+cos_kernel( VT z, tier_full )
+{
+	VT p = horner( z, 4.166664568298827E-002F, -1.388731625493765E-003F, 2.443315711809948E-005F );
+	return fma( z * z, p, nmadd( z, float_constants<VT>::one_half(), float_constants<VT>::one() ) );
+}
+
+/// @brief picks the sin or cos kernel for quadrant q and applies the sign
+template <typename VT>
+PAL_INLINE VT
+quadrant_select( typename VT::int_vec_type q, VT s, VT c )
+{
+	typedef typename VT::int_vec_type ivec;
+	typedef int_constants<ivec> iconst;
+
+	VT r = ifthen( ( q & iconst::one() ) == iconst::one(), c, s );
+	// quadrants 2 and 3 are negated, move that bit to the sign
+	return r ^ ( ( q << 30 ) & iconst::sign_bitmask() ).as_float();
+}
+
+template <typename VT, typename tier>
+PAL_INLINE VT
+sinf_tier( VT v, tier t )
+{
+	VT x;
+	typename VT::int_vec_type j = reduce_pi_2( x, v );
+	VT z = x * x;
+	VT r = quadrant_select( j, sin_kernel( x, z, t ), cos_kernel( z, t ) );
+	// preserve the sign of zero and produce NaN for infinity
+	r = ifthen( v == VT::zero(), v, r );
+	return ifthen( isinf( v ), float_constants<VT>::nan(), r );
+}
+
+template <typename VT, typename tier>
+PAL_INLINE VT
+cosf_tier( VT v, tier t )
+{
+	typedef typename VT::int_vec_type ivec;
+	VT x;
+	ivec j = reduce_pi_2( x, v );
+	VT z = x * x;
+	VT r = quadrant_select( j + int_constants<ivec>::one(),
+							sin_kernel( x, z, t ), cos_kernel( z, t ) );
+	return ifthen( isinf( v ), float_constants<VT>::nan(), r );
+}
+
+template <typename VT, typename tier>
+PAL_INLINE void
+sincosf_tier( VT v, VT *s, VT *c, tier t )
+{
+	typedef typename VT::int_vec_type ivec;
+	VT x;
+	ivec j = reduce_pi_2( x, v );
+	VT z = x * x;
+	VT sk = sin_kernel( x, z, t );
+	VT ck = cos_kernel( z, t );
+	VT nan = float_constants<VT>::nan();
+	typename VT::mask_type vinf = isinf( v );
+	VT sr = ifthen( v == VT::zero(), v, quadrant_select( j, sk, ck ) );
+	*s = ifthen( vinf, nan, sr );
+	*c = ifthen( vinf, nan, quadrant_select( j + int_constants<ivec>::one(), sk, ck ) );
+}
+
+/// @brief atan of x in [-tan(pi/8), tan(pi/8)] (the cephes atanf
+/// polynomial)
+template <typename VT>
+PAL_INLINE VT
+atan_kernel( VT x )
+{
+	VT z = x * x;
+	VT p = horner( z, -3.33329491539E-1F, 1.99777106478E-1F, -1.38776856032E-1F, 8.05374449538E-2F );
+	return fma( x * z, p, x );
+}
+
+} // namespace detail
+
+/// @brief computes sin for each value
+///
+/// range reduces to [-pi/4, pi/4] then evaluates a polynomial for
+/// sin or cos depending on the quadrant.
+///
+/// TODO: this applies for double as well, but needs more terms
+/// and a longer pi/2
+template <typename VT>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
 sinf( VT v )
 {
-	using fvec = VT;
-	using constants = float_constants<fvec>;
-	using value_type = typename fvec::value_type;
-
-	// error isn't great - would be better to range reduce more... should be able to
-	// go to abs(v) < pi/2 trivially
-	v = fmodf( v, constants::two_pi() );
-
-	// for taylor series (well, Maclaurin series):
-	// sin x is x - x^3/3! + x^5/5! - x^7/7! ... x^(2*n+1)*(-1)^n/(2n + 1)!
-	//
-	// most C libraries seem to go out to 7 terms (n = 0 1 2 3 4 5 6)
-	//
-	// TODO: we'll go beyond since we aren't doing enough range reduction?
-	const fvec x2 = v * v;
-	const fvec x3 = x2 * v;
-	const fvec x5 = x2 * x3;
-	const fvec x7 = x2 * x5;
-	const fvec x9 = x2 * x7;
-	const fvec x11 = x2 * x9;
-	const fvec x13 = x2 * x11;
-	const fvec x15 = x2 * x13;
-	const fvec x17 = x2 * x15;
-//	const fvec x19 = x2 * x17;
-//	const fvec x21 = x2 * x19;
-//	const fvec x23 = x2 * x21;
-
-	fvec r = fma( x3, fvec::splat( detail::scale<value_type>( 3, -1 ) ), v );
-	r = fma( x5, fvec::splat( detail::scale<value_type>( 5, 1 ) ), r );
-	r = fma( x7, fvec::splat( detail::scale<value_type>( 7, -1 ) ), r );
-	r = fma( x9, fvec::splat( detail::scale<value_type>( 9, 1 ) ), r );
-	r = fma( x11, fvec::splat( detail::scale<value_type>( 11, -1 ) ), r );
-	r = fma( x13, fvec::splat( detail::scale<value_type>( 13, 1 ) ), r );
-	r = fma( x15, fvec::splat( detail::scale<value_type>( 15, -1 ) ), r );
-	r = fma( x17, fvec::splat( detail::scale<value_type>( 17, 1 ) ), r );
-//	r = fma( x19, fvec::splat( detail::scale<value_type>( 19, -1 ) ), r );
-//	r = fma( x21, fvec::splat( detail::scale<value_type>( 21, 1 ) ), r );
-//	r = fma( x23, fvec::splat( detail::scale<value_type>( 23, -1 ) ), r );
-
-	return r;
+	return detail::sinf_tier( v, detail::tier_full() );
 }
 
+/// @brief sinf with a requested precision
+///
+/// @sa precision
+template <typename VT, int bits>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+sinf( VT v, precision<bits> )
+{
+	return detail::sinf_tier( v, typename detail::precision_tier<bits>::type() );
+}
+
+/// @brief computes cos for each value
+///
+/// @sa sinf
 template <typename VT>
-inline PAL_ENABLE_FLOAT(VT)
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
 cosf( VT v )
 {
-	using fvec = VT;
-	using constants = float_constants<fvec>;
-	using value_type = typename fvec::value_type;
-
-	v = fmodf( v, constants::two_pi() );
-
-	// for taylor series (well, Maclaurin series):
-	// cos x is 1 - x^2/2! + x^4/4! + x^(2*n)*(-1)^n/(2n)!
-	//
-	// most C libraries seem to go out to 7 terms (n = 0 1 2 3 4 5 6)
-	//
-	// TODO: we'll go beyond since we aren't doing any range reduction?
-	const fvec x2 = v * v;
-	const fvec x4 = x2 * x2;
-	const fvec x6 = x2 * x4;
-	const fvec x8 = x2 * x6;
-	const fvec x10 = x2 * x8;
-	const fvec x12 = x2 * x10;
-	const fvec x14 = x2 * x12;
-	const fvec x16 = x2 * x14;
-	const fvec x18 = x2 * x16;
-
-	fvec r = fma( x2, fvec::splat( detail::scale<value_type>( 2, -1 ) ), constants::one() );
-	r = fma( x4, fvec::splat( detail::scale<value_type>( 4, 1 ) ), r );
-	r = fma( x6, fvec::splat( detail::scale<value_type>( 6, -1 ) ), r );
-	r = fma( x8, fvec::splat( detail::scale<value_type>( 8, 1 ) ), r );
-	r = fma( x10, fvec::splat( detail::scale<value_type>( 10, -1 ) ), r );
-	r = fma( x12, fvec::splat( detail::scale<value_type>( 12, 1 ) ), r );
-	r = fma( x14, fvec::splat( detail::scale<value_type>( 14, -1 ) ), r );
-	r = fma( x16, fvec::splat( detail::scale<value_type>( 16, 1 ) ), r );
-	r = fma( x18, fvec::splat( detail::scale<value_type>( 18, -1 ) ), r );
-
-	return r;
+	return detail::cosf_tier( v, detail::tier_full() );
+}
+
+/// @brief cosf with a requested precision
+///
+/// @sa precision
+template <typename VT, int bits>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+cosf( VT v, precision<bits> )
+{
+	return detail::cosf_tier( v, typename detail::precision_tier<bits>::type() );
 }
 
+/// @brief computes both sin and cos, sharing the range reduction
 template <typename VT>
-inline PAL_ENABLE_FLOAT(VT)
+PAL_INLINE typename std::enable_if<is_float_vec<VT>::value>::type
 sincosf( VT v, VT *s, VT *c )
 {
-	*s = sinf( v );
-	*c = cosf( v );
+	detail::sincosf_tier( v, s, c, detail::tier_full() );
+}
+
+/// @brief sincosf with a requested precision
+///
+/// @sa precision
+template <typename VT, int bits>
+PAL_INLINE typename std::enable_if<is_float_vec<VT>::value>::type
+sincosf( VT v, VT *s, VT *c, precision<bits> )
+{
+	detail::sincosf_tier( v, s, c, typename detail::precision_tier<bits>::type() );
+}
+
+/// @brief computes atan for each value
+///
+/// reduces |v| past tan(3 pi / 8) with atan(v) = pi / 2 - atan(1 / v)
+/// and past tan(pi / 8) with atan(v) = pi / 4 + atan((v - 1) / (v + 1)),
+/// sharing a single divide, then evaluates a polynomial.
+template <typename VT>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+atanf( VT v )
+{
+	typedef float_constants<VT> constants;
+	typedef typename VT::mask_type mask;
+
+	VT one = constants::one();
+	VT a = abs( v );
+	mask big = a > VT( 2.414213562373095F );
+	mask mid = a > VT( 0.4142135623730950F );
+	VT num = ifthen( big, -one, ifthen( mid, a - one, a ) );
+	VT den = ifthen( big, a, ifthen( mid, a + one, one ) );
+	VT off = ifthen( big, constants::pi_half(), ifthen( mid, constants::pi_quarter(), VT::zero() ) );
+	return copysign( off + detail::atan_kernel( num / den ), v );
+}
+
+/// @brief computes atan2( y, x ), the angle of the point (x, y) in
+/// [-pi, pi], for each value
+///
+/// The smaller of |x| and |y| over the larger is taken through the
+/// atanf reduction, then moved to the right octant. Follows the C
+/// library for the signed zeros, infinities and NaN.
+template <typename VT>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+atan2f( VT y, VT x )
+{
+	typedef float_constants<VT> constants;
+	typedef typename VT::mask_type mask;
+
+	VT ax = abs( x ), ay = abs( y );
+	VT hi = max( ax, ay ), lo = min( ax, ay );
+	// lo / hi past tan(pi / 8) uses (lo - hi) / (lo + hi) + pi / 4
+	mask mid = lo > hi * VT( 0.4142135623730950F );
+	VT num = ifthen( mid, lo - hi, lo );
+	VT den = ifthen( mid, lo + hi, hi );
+	VT r = ifthen( mid, constants::pi_quarter(), VT::zero() ) + detail::atan_kernel( num / den );
+	// 0 / 0 and inf / inf
+	r = ifthen( hi == VT::zero(), VT::zero(), r );
+	r = ifthen( isinf( lo ), constants::pi_quarter(), r );
+	r = ifthen( ay > ax, constants::pi_half() - r, r );
+	r = ifthen( copysign( constants::one(), x ) < VT::zero(), constants::pi() - r, r );
+	r = copysign( r, y );
+	return ifthen( isnan( x ) || isnan( y ), x + y, r );
+}
+
+/// @brief atanf with a requested precision, there is only the full
+/// tier
+///
+/// @sa precision
+template <typename VT, int bits>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+atanf( VT v, precision<bits> )
+{
+	return atanf( v );
+}
+
+/// @brief atan2f with a requested precision, there is only the full
+/// tier
+///
+/// @sa precision
+template <typename VT, int bits>
+PAL_INLINE PAL_ENABLE_FLOAT(VT)
+atan2f( VT y, VT x, precision<bits> )
+{
+	return atan2f( y, x );
 }
 
 } // namespace pal